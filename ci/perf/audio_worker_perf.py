@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+AudioProcessor worker gate for FastLED.
+
+The `audio_processor_worker` unit test (tests/fx/audio_processor_worker.cpp)
+times update() on the render thread with 1 and 13 detectors, inline and with
+the worker running, when FASTLED_AUDIO_WORKER_BENCH_JSON names an output file:
+
+    {"block_size": 2048, "inline_one_us": 57.0, "inline_many_us": 201.0,
+     "worker_one_us": 4.0, "worker_many_us": 3.0}
+
+This script prints those results and optionally checks them against
+`audio_worker_thresholds.json`:
+
+- min_inline_detector_scaling: inline 13 detectors / inline 1 detector
+- max_worker_to_inline_ratio: worker 13 detectors / inline 13 detectors
+- max_worker_detector_cost_ratio: extra worker cost of 12 more detectors,
+  relative to the extra inline cost
+
+Usage:
+    python ci/perf/audio_worker_perf.py --results=PATH [--check-thresholds]
+    python ci/perf/audio_worker_perf.py --binary=PATH [--check-thresholds]
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Any, Dict, List
+
+
+def run_benchmark(binary: Path, project_root: Path) -> Dict[str, Any]:
+    """Run the test binary from the project root and load its JSON."""
+    with tempfile.TemporaryDirectory() as tmp:
+        out_path = Path(tmp) / "audio_worker_bench.json"
+        env = dict(os.environ)
+        env["FASTLED_AUDIO_WORKER_BENCH_JSON"] = str(out_path)
+        result = subprocess.run(
+            [str(binary), "--test-case=*render time benchmark*"],
+            cwd=str(project_root),
+            env=env,
+            capture_output=True,
+            text=True,
+        )
+        if result.returncode != 0 or not out_path.exists():
+            print(result.stdout, file=sys.stderr)
+            print(result.stderr, file=sys.stderr)
+            print(f"Error: benchmark binary {binary} failed", file=sys.stderr)
+            sys.exit(1)
+        with open(out_path, "r") as f:
+            return json.load(f)
+
+
+def format_report(results: Dict[str, Any]) -> str:
+    lines: List[str] = []
+    lines.append("=" * 60)
+    lines.append(
+        f"AUDIOPROCESSOR update() MEDIAN, {results['block_size']}-SAMPLE BLOCKS"
+    )
+    lines.append("=" * 60)
+    lines.append(f"{'':<10} {'1 detector':>14} {'13 detectors':>14}")
+    lines.append("-" * 60)
+    lines.append(
+        f"{'inline':<10} {results['inline_one_us']:>11.1f} us "
+        f"{results['inline_many_us']:>11.1f} us"
+    )
+    lines.append(
+        f"{'worker':<10} {results['worker_one_us']:>11.1f} us "
+        f"{results['worker_many_us']:>11.1f} us"
+    )
+    return "\n".join(lines)
+
+
+def check_thresholds(results: Dict[str, Any], thresholds_file: Path) -> bool:
+    """Returns True if all checks pass, False otherwise."""
+    if not thresholds_file.exists():
+        print(
+            f"Warning: Thresholds file not found at {thresholds_file}", file=sys.stderr
+        )
+        return True
+
+    with open(thresholds_file, "r") as f:
+        thresholds = json.load(f)
+
+    inline_one = results["inline_one_us"]
+    inline_many = results["inline_many_us"]
+    worker_one = results["worker_one_us"]
+    worker_many = results["worker_many_us"]
+
+    errors: List[str] = []
+    scaling = thresholds.get("min_inline_detector_scaling")
+    if scaling is not None and inline_many < inline_one * scaling:
+        errors.append(
+            f"inline 13 detectors {inline_many:.1f} us is not {scaling}x "
+            f"inline 1 detector {inline_one:.1f} us; the benchmark measures too little"
+        )
+
+    ratio = thresholds.get("max_worker_to_inline_ratio")
+    if ratio is not None and worker_many > inline_many * ratio:
+        errors.append(
+            f"worker 13 detectors {worker_many:.1f} us exceeds {ratio} of "
+            f"inline {inline_many:.1f} us"
+        )
+
+    cost = thresholds.get("max_worker_detector_cost_ratio")
+    if cost is not None and worker_many - worker_one > (inline_many - inline_one) * cost:
+        errors.append(
+            f"detectors add {worker_many - worker_one:.1f} us on the render thread "
+            f"with the worker, over {cost} of the inline "
+            f"{inline_many - inline_one:.1f} us"
+        )
+
+    if errors:
+        print("\n❌ ERRORS:", file=sys.stderr)
+        for error in errors:
+            print(f"  - {error}", file=sys.stderr)
+    else:
+        print("\n✓ All audio worker threshold checks passed", file=sys.stderr)
+
+    return len(errors) == 0
+
+
+def main() -> None:
+    """Main entry point."""
+    args = sys.argv[1:]
+    output_format = "text"
+    results_path = None
+    binary_path = None
+    check = False
+
+    for arg in args:
+        if arg.startswith("--output="):
+            output_format = arg.split("=", 1)[1]
+        elif arg.startswith("--results="):
+            results_path = Path(arg.split("=", 1)[1])
+        elif arg.startswith("--binary="):
+            binary_path = Path(arg.split("=", 1)[1])
+        elif arg == "--check-thresholds":
+            check = True
+        elif arg in ["--help", "-h"]:
+            print(__doc__)
+            sys.exit(0)
+
+    script_dir = Path(__file__).parent
+    project_root = script_dir.parent.parent
+    thresholds_file = script_dir / "audio_worker_thresholds.json"
+
+    if binary_path is not None:
+        results = run_benchmark(binary_path, project_root)
+    elif results_path is not None:
+        with open(results_path, "r") as f:
+            results = json.load(f)
+    else:
+        print("Error: pass --results=PATH or --binary=PATH", file=sys.stderr)
+        sys.exit(1)
+
+    if output_format == "json":
+        print(json.dumps(results, indent=2))
+    else:
+        print(format_report(results))
+
+    if check:
+        ok = check_thresholds(results, thresholds_file)
+        sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
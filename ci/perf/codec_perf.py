@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+Codec throughput gate for FastLED.
+
+The `codec_benchmark` unit test (tests/fl/codec_benchmark.cpp) decodes every
+file in tests/data/codec and, when FASTLED_CODEC_BENCH_JSON is set, writes one
+JSON record per codec/input/output size:
+
+    {"benchmarks": [{"name": "jpeg/progressive.jpg/16x16", "unit": "pixels/s",
+                     "throughput": 4.4e6, "peak_heap_bytes": 4096,
+                     "allocs_per_frame": 1.0, ...}, ...]}
+
+This script prints those results and optionally checks them against
+`codec_thresholds.json`. Heap and allocation limits are deterministic and are
+the main gate. Throughput floors depend on the runner and the optimization
+level (unit tests build at -O0), so they are only checked with
+--check-throughput against an optimized build.
+
+Usage:
+    python ci/perf/codec_perf.py --results=PATH [--check-thresholds] [--check-throughput]
+    python ci/perf/codec_perf.py --binary=PATH [--check-thresholds] [--check-throughput]
+
+Options:
+    --results=PATH      Read results written by a previous benchmark run
+    --binary=PATH       Run the codec_benchmark test binary to produce results
+    --output=FORMAT     Output format (json or text, default: text)
+    --check-thresholds  Exit with an error if any threshold is exceeded
+    --check-throughput  Also apply min_throughput floors (optimized builds only)
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Any, Dict, List
+
+
+def run_benchmark(binary: Path, project_root: Path) -> Dict[str, Any]:
+    """Run the benchmark binary from the project root and load its JSON."""
+    with tempfile.TemporaryDirectory() as tmp:
+        out_path = Path(tmp) / "codec_bench.json"
+        env = dict(os.environ)
+        env["FASTLED_CODEC_BENCH_JSON"] = str(out_path)
+        result = subprocess.run(
+            [str(binary)], cwd=str(project_root), env=env, capture_output=True, text=True
+        )
+        if result.returncode != 0 or not out_path.exists():
+            print(result.stdout, file=sys.stderr)
+            print(result.stderr, file=sys.stderr)
+            print(f"Error: benchmark binary {binary} failed", file=sys.stderr)
+            sys.exit(1)
+        with open(out_path, "r") as f:
+            return json.load(f)
+
+
+def format_report(results: Dict[str, Any]) -> str:
+    lines: List[str] = []
+    lines.append("=" * 80)
+    lines.append("FASTLED CODEC THROUGHPUT REPORT")
+    lines.append("=" * 80)
+    lines.append(
+        f"{'benchmark':<40} {'throughput':>16} {'peak heap':>11} {'allocs/frame':>13}"
+    )
+    lines.append("-" * 80)
+    for bench in results.get("benchmarks", []):
+        throughput = f"{bench['throughput'] / 1e6:.2f} M{bench['unit']}"
+        lines.append(
+            f"{bench['name']:<40} {throughput:>16} "
+            f"{bench['peak_heap_bytes']:>11} {bench['allocs_per_frame']:>13.2f}"
+        )
+    return "\n".join(lines)
+
+
+def check_thresholds(
+    results: Dict[str, Any], thresholds_file: Path, check_throughput: bool
+) -> bool:
+    """
+    Check results against per-benchmark limits.
+
+    Each entry in the thresholds file is keyed by benchmark name and may set
+    max_peak_heap_bytes, max_allocs_per_frame and min_throughput. Benchmarks
+    without an entry fall back to the "default" entry. min_throughput is only
+    applied when check_throughput is set.
+
+    Returns True if all checks pass, False otherwise.
+    """
+    if not thresholds_file.exists():
+        print(
+            f"Warning: Thresholds file not found at {thresholds_file}", file=sys.stderr
+        )
+        return True
+
+    with open(thresholds_file, "r") as f:
+        thresholds = json.load(f)
+
+    limits_by_name: Dict[str, Dict[str, Any]] = thresholds.get("benchmarks", {})
+    default_limits: Dict[str, Any] = thresholds.get("default", {})
+
+    errors: List[str] = []
+    benchmarks = results.get("benchmarks", [])
+    seen = {bench["name"] for bench in benchmarks}
+    for name in limits_by_name:
+        if name not in seen:
+            errors.append(f"{name}: no result (benchmark missing or renamed)")
+
+    for bench in benchmarks:
+        name = bench["name"]
+        limits = dict(default_limits)
+        limits.update(limits_by_name.get(name, {}))
+
+        max_heap = limits.get("max_peak_heap_bytes")
+        if max_heap is not None and bench["peak_heap_bytes"] > max_heap:
+            errors.append(
+                f"{name}: peak heap {bench['peak_heap_bytes']} bytes exceeds {max_heap}"
+            )
+
+        max_allocs = limits.get("max_allocs_per_frame")
+        if max_allocs is not None and bench["allocs_per_frame"] > max_allocs:
+            errors.append(
+                f"{name}: {bench['allocs_per_frame']:.2f} allocs/frame exceeds {max_allocs}"
+            )
+
+        min_throughput = limits.get("min_throughput") if check_throughput else None
+        if min_throughput is not None and bench["throughput"] < min_throughput:
+            errors.append(
+                f"{name}: throughput {bench['throughput']:.0f} {bench['unit']} "
+                f"below {min_throughput}"
+            )
+
+    if errors:
+        print("\n❌ ERRORS:", file=sys.stderr)
+        for error in errors:
+            print(f"  - {error}", file=sys.stderr)
+    else:
+        print(
+            f"\n✓ All codec threshold checks passed ({len(benchmarks)} benchmarks)",
+            file=sys.stderr,
+        )
+
+    return len(errors) == 0
+
+
+def main() -> None:
+    """Main entry point."""
+    args = sys.argv[1:]
+    output_format = "text"
+    results_path = None
+    binary_path = None
+    check = False
+    check_throughput = False
+
+    for arg in args:
+        if arg.startswith("--output="):
+            output_format = arg.split("=", 1)[1]
+        elif arg.startswith("--results="):
+            results_path = Path(arg.split("=", 1)[1])
+        elif arg.startswith("--binary="):
+            binary_path = Path(arg.split("=", 1)[1])
+        elif arg == "--check-thresholds":
+            check = True
+        elif arg == "--check-throughput":
+            check_throughput = True
+        elif arg in ["--help", "-h"]:
+            print(__doc__)
+            sys.exit(0)
+
+    script_dir = Path(__file__).parent
+    project_root = script_dir.parent.parent
+    thresholds_file = script_dir / "codec_thresholds.json"
+
+    if binary_path is not None:
+        results = run_benchmark(binary_path, project_root)
+    elif results_path is not None:
+        with open(results_path, "r") as f:
+            results = json.load(f)
+    else:
+        print("Error: pass --results=PATH or --binary=PATH", file=sys.stderr)
+        sys.exit(1)
+
+    if output_format == "json":
+        print(json.dumps(results, indent=2))
+    else:
+        print(format_report(results))
+
+    if check:
+        ok = check_thresholds(results, thresholds_file, check_throughput)
+        sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -3,6 +3,8 @@
 #include "fl/thread_local.h"
 #include "fl/int.h"
 #include "fl/mutex.h"
+#include "fl/alloca.h"
+#include "fl/cstring.h"
 
 namespace fl {
 
@@ -118,6 +120,20 @@ const AudioSample::VectorPCM &AudioSample::empty() {
 
 float AudioSample::zcf() const { return mImpl->zcf(); }
 
+fl::i32 AudioSample::peak() const {
+    if (!isValid()) {
+        return 0;
+    }
+    return mImpl->peak();
+}
+
+float AudioSample::dcOffset() const {
+    if (!isValid()) {
+        return 0.0f;
+    }
+    return mImpl->dcOffset();
+}
+
 fl::u32 AudioSample::timestamp() const {
     if (isValid()) {
         return mImpl->timestamp();
@@ -140,12 +156,9 @@ SoundLevelMeter::SoundLevelMeter(double spl_floor, double smoothing_alpha)
 
 void SoundLevelMeter::processBlock(const fl::i16 *samples, fl::size count) {
     // 1) compute block power → dBFS
-    double sum_sq = 0.0;
-    for (fl::size i = 0; i < count; ++i) {
-        double s = samples[i] / 32768.0; // normalize to ±1
-        sum_sq += s * s;
-    }
-    double p = sum_sq / count; // mean power
+    PcmStats stats;
+    computePcmStats(samples, count, &stats);
+    double p = stats.meanPowerFS(); // mean power, normalized to ±1
     double dbfs = 10.0 * log10(p + 1e-12);
     current_dbfs_ = dbfs;
 
@@ -185,4 +198,147 @@ AudioSample::AudioSample(fl::span<const fl::i16> span, fl::u32 timestamp) {
 }
 
 
+AudioSampleRing::AudioSampleRing(fl::size blocks, fl::size block_capacity)
+    : mBlockCapacity(block_capacity) {
+    mBlocks.reserve(blocks);
+    for (fl::size i = 0; i < blocks; ++i) {
+        AudioSampleImplPtr impl = fl::make_shared<AudioSampleImpl>();
+        impl->reserve(block_capacity);
+        mBlocks.push_back(impl);
+    }
+}
+
+void AudioSampleRing::clear() {
+    for (fl::size i = 0; i < mBlocks.size(); ++i) {
+        if (mBlocks[i].unique()) {
+            mBlocks[i]->reset();
+        }
+    }
+    mHead = 0;
+    mCount = 0;
+}
+
+AudioSampleQueue::AudioSampleQueue(fl::size blocks, fl::size block_size)
+    : mBlockSize(block_size), mHead(0), mTail(0), mOverruns(0),
+      mUnderruns(0) {
+    if (blocks == 0) {
+        blocks = 1;
+    }
+    mBlocks.reserve(blocks);
+    for (fl::size i = 0; i < blocks; ++i) {
+        AudioSampleImplPtr impl = fl::make_shared<AudioSampleImpl>();
+        impl->reserve(block_size);
+        mBlocks.push_back(impl);
+    }
+}
+
+bool AudioSampleQueue::push(fl::span<const fl::i16> pcm, fl::u32 timestamp) {
+    return push(pcm.size(), timestamp, [&pcm](fl::i16 *dst) {
+        fl::memcpy(dst, pcm.data(), pcm.size() * sizeof(fl::i16));
+    });
+}
+
+AudioSampleImpl *AudioSampleQueue::claim(fl::size n) {
+    if (n > mBlockSize) {
+        return nullptr;
+    }
+    const fl::u32 head = mHead.load(memory_order_relaxed);
+    const fl::u32 tail = mTail.load(memory_order_acquire);
+    const fl::u32 positions = 2 * mBlocks.size();
+    if ((head + positions - tail) % positions == mBlocks.size()) {
+        mOverruns.fetch_add(1);
+        return nullptr;
+    }
+    // The consumer took its reference before releasing the slot, so a
+    // unique slot is one nobody reads any more.
+    AudioSampleImplPtr &slot = mBlocks[head % mBlocks.size()];
+    if (!slot.unique()) {
+        mOverruns.fetch_add(1);
+        return nullptr;
+    }
+    return slot.get();
+}
+
+void AudioSampleQueue::publish() {
+    mHead.store(advance(mHead.load(memory_order_relaxed)),
+                memory_order_release);
+}
+
+AudioSample AudioSampleQueue::pop() {
+    const fl::u32 tail = mTail.load(memory_order_relaxed);
+    const fl::u32 head = mHead.load(memory_order_acquire);
+    if (head == tail) {
+        mUnderruns.fetch_add(1);
+        return AudioSample();
+    }
+    AudioSample out(mBlocks[tail % mBlocks.size()]);
+    mTail.store(advance(tail), memory_order_release);
+    return out;
+}
+
+void AudioSampleQueue::clear() {
+    mTail.store(mHead.load(memory_order_acquire), memory_order_release);
+}
+
+fl::size AudioSampleQueue::size() const {
+    const fl::u32 head = mHead.load(memory_order_acquire);
+    const fl::u32 tail = mTail.load(memory_order_acquire);
+    const fl::u32 positions = 2 * mBlocks.size();
+    return (head + positions - tail) % positions;
+}
+
+AudioSample AudioSampleRing::block(fl::size age) const {
+    if (age >= mCount) {
+        return AudioSample();
+    }
+    const fl::size n = mBlocks.size();
+    return AudioSample(mBlocks[(mHead + n - 1 - age) % n]);
+}
+
+fl::size AudioSampleRing::availableSamples() const {
+    fl::size total = 0;
+    const fl::size n = mBlocks.size();
+    for (fl::size age = 0; age < mCount; ++age) {
+        total += mBlocks[(mHead + n - 1 - age) % n]->pcm().size();
+    }
+    return total;
+}
+
+bool AudioSampleRing::copyLatest(fl::span<fl::i16> out) const {
+    if (availableSamples() < out.size()) {
+        return false;
+    }
+    // Walk backwards from the newest block, filling the output from its end.
+    const fl::size n = mBlocks.size();
+    fl::size remaining = out.size();
+    for (fl::size age = 0; remaining > 0; ++age) {
+        const AudioSampleImpl::VectorPCM &pcm =
+            mBlocks[(mHead + n - 1 - age) % n]->pcm();
+        const fl::size take = remaining < pcm.size() ? remaining : pcm.size();
+        fl::memcpy(out.data() + remaining - take,
+                   pcm.data() + pcm.size() - take, take * sizeof(fl::i16));
+        remaining -= take;
+    }
+    return true;
+}
+
+bool AudioSampleRing::fft(fl::size samples, FFTBins *out) const {
+    if (samples == 0) {
+        return false;
+    }
+    FASTLED_STACK_ARRAY(fl::i16, frame, samples);
+    fl::span<fl::i16> window(frame, samples);
+    if (!copyLatest(window)) {
+        return false;
+    }
+    FFT_Args args;
+    args.samples = static_cast<int>(samples);
+    args.bands = out->size();
+    args.fmin = FFT_Args::DefaultMinFrequency();
+    args.fmax = FFT_Args::DefaultMaxFrequency();
+    args.sample_rate = FFT_Args::DefaultSampleRate();
+    get_flex_fft().run(fl::span<const fl::i16>(frame, samples), out, args);
+    return true;
+}
+
 } // namespace fl
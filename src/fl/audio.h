@@ -1,5 +1,7 @@
 #pragma once
 
+#include "fl/atomic.h"
+#include "fl/audio/pcm_stats.h"
 #include "fl/fft.h"
 #include "fl/math.h"
 #include "fl/ptr.h"         // For FASTLED_SMART_PTR macros
@@ -40,6 +42,9 @@ class AudioSample {
     // and sounds like cloths rubbing. Useful for sound analysis.
     float zcf() const;
     float rms() const;
+    // Largest |sample| (0..32768) and mean sample value
+    fl::i32 peak() const;
+    float dcOffset() const;
     fl::u32 timestamp() const;  // Timestamp when sample became valid (millis)
 
     void fft(FFTBins *out) const;
@@ -114,10 +119,19 @@ class AudioSampleImpl {
     template <typename It> void assign(It begin, It end, fl::u32 timestamp) {
         mSignedPcm.assign(begin, end);
         mTimestamp = timestamp;
-        // Pre-compute zero crossings and RMS for O(1) access
-        initZeroCrossings();
-        initRms();
+        // Pre-compute the block statistics for O(1) access
+        initStats();
     }
+    // Writes n samples in place through write(fl::i16 *dst) instead of
+    // copying from a source range. Capacity is kept, so refilling a block of
+    // the same size never allocates.
+    template <typename Fn> void fill(fl::size n, fl::u32 timestamp, Fn write) {
+        mSignedPcm.resize(n);
+        write(mSignedPcm.data());
+        mTimestamp = timestamp;
+        initStats();
+    }
+    void reserve(fl::size n) { mSignedPcm.reserve(n); }
     const VectorPCM &pcm() const { return mSignedPcm; }
     fl::u32 timestamp() const { return mTimestamp; }
 
@@ -126,6 +140,8 @@ class AudioSampleImpl {
         mSignedPcm.clear();
         mZeroCrossings = 0;
         mRms = 0.0f;
+        mPeak = 0;
+        mDcOffset = 0.0f;
         mTimestamp = 0;
     }
 
@@ -151,39 +167,144 @@ class AudioSampleImpl {
     // Returns: RMS value (pre-computed, O(1) access)
     float rms() const { return mRms; }
 
+    // Pre-computed, O(1) access
+    fl::i32 peak() const { return mPeak; }
+    float dcOffset() const { return mDcOffset; }
+
   private:
-    void initZeroCrossings() {
-        mZeroCrossings = 0;
-        if (mSignedPcm.size() > 1) {
-            for (fl::size i = 1; i < mSignedPcm.size(); ++i) {
-                const bool crossed =
-                    (mSignedPcm[i - 1] < 0 && mSignedPcm[i] >= 0) ||
-                    (mSignedPcm[i - 1] >= 0 && mSignedPcm[i] < 0);
-                if (crossed) {
-                    ++mZeroCrossings;
-                }
-            }
-        }
+    // Zero crossings, RMS, peak and DC offset in one pass
+    void initStats() {
+        PcmStats stats;
+        computePcmStats(mSignedPcm.data(), mSignedPcm.size(), &stats);
+        mZeroCrossings = stats.zeroCrossings;
+        mRms = stats.rms();
+        mPeak = stats.peak;
+        mDcOffset = stats.dcOffset();
     }
 
-    void initRms() {
-        if (mSignedPcm.empty()) {
-            mRms = 0.0f;
-            return;
+    VectorPCM mSignedPcm;
+    fl::u32 mZeroCrossings = 0;
+    float mRms = 0.0f;  // Pre-computed RMS value
+    fl::i32 mPeak = 0;
+    float mDcOffset = 0.0f;
+    fl::u32 mTimestamp = 0;
+};
+
+// Fixed ring of reusable PCM blocks for streaming sources such as the MP3
+// decoder. Producers write straight into the next block and get it back as an
+// AudioSample that shares the block's storage, so steady state streaming
+// neither copies nor allocates. A block that a consumer still holds when the
+// ring wraps around is left to the consumer and replaced by a fresh one.
+class AudioSampleRing {
+  public:
+    AudioSampleRing(fl::size blocks, fl::size block_capacity);
+
+    template <typename Fn>
+    AudioSample push(fl::size n, fl::u32 timestamp, Fn write) {
+        AudioSampleImplPtr &slot = mBlocks[mHead];
+        if (!slot.unique()) {
+            slot = fl::make_shared<AudioSampleImpl>();
+            slot->reserve(mBlockCapacity);
         }
-        fl::u64 sum_sq = 0;
-        const int N = mSignedPcm.size();
-        for (int i = 0; i < N; ++i) {
-            fl::i32 x32 = fl::i32(mSignedPcm[i]);
-            sum_sq += x32 * x32;
+        slot->fill(n, timestamp, write);
+        mHead = (mHead + 1) % mBlocks.size();
+        if (mCount < mBlocks.size()) {
+            ++mCount;
         }
-        mRms = sqrtf(float(sum_sq) / N);
+        return AudioSample(slot);
     }
 
-    VectorPCM mSignedPcm;
-    fl::i16 mZeroCrossings = 0;
-    float mRms = 0.0f;  // Pre-computed RMS value
-    fl::u32 mTimestamp = 0;
+    void clear();
+
+    // Number of filled blocks, at most the ring size.
+    fl::size size() const { return mCount; }
+    // Filled block by age, 0 being the most recent one.
+    AudioSample block(fl::size age) const;
+    // Total samples held by the filled blocks.
+    fl::size availableSamples() const;
+
+    // Copies the most recent out.size() samples, oldest first, reading across
+    // block boundaries. Returns false if the ring holds fewer samples.
+    bool copyLatest(fl::span<fl::i16> out) const;
+
+    // Runs the FFT over the most recent `samples` samples, gathered from the
+    // blocks into a stack frame. Returns false if not enough audio is held.
+    bool fft(fl::size samples, FFTBins *out) const;
+
+  private:
+    fl::vector<AudioSampleImplPtr> mBlocks;
+    fl::size mBlockCapacity;
+    fl::size mHead = 0;
+    fl::size mCount = 0;
+};
+
+// Lock-free single producer / single consumer queue of fixed-size PCM blocks,
+// for handing audio from an input driver (I2S task, DMA callback, host replay
+// thread) to the thread that analyses it. All blocks are allocated up front;
+// the producer fills the next free block in place and the consumer gets it
+// back as an AudioSample that shares the block's storage, so steady state
+// streaming neither copies on the consumer side nor allocates.
+//
+// A full queue drops the incoming block and counts an overrun. A block the
+// consumer still holds an AudioSample for is not refilled; reaching it also
+// counts as an overrun, so consumers should let go of a block before popping
+// the one after it. pop() on an empty queue counts an underrun.
+//
+// push() may only be called from one thread and pop() / clear() from one
+// other thread; the counters and size() may be read from anywhere.
+//
+// Example:
+//   AudioSampleQueue queue(8, 512);
+//   // driver thread
+//   queue.push(fl::span<const fl::i16>(dma, 512), timestamp);
+//   // processing thread
+//   if (!queue.empty()) { processor.update(queue.pop()); }
+class AudioSampleQueue {
+  public:
+    AudioSampleQueue(fl::size blocks, fl::size block_size);
+
+    // Producer: writes n <= blockSize() samples through write(fl::i16 *dst).
+    // Returns false if the block was dropped.
+    template <typename Fn>
+    bool push(fl::size n, fl::u32 timestamp, Fn write) {
+        AudioSampleImpl *block = claim(n);
+        if (!block) {
+            return false;
+        }
+        block->fill(n, timestamp, write);
+        publish();
+        return true;
+    }
+    bool push(fl::span<const fl::i16> pcm, fl::u32 timestamp);
+
+    // Consumer: oldest queued block, or an invalid sample (and an underrun)
+    // if there is none.
+    AudioSample pop();
+    // Consumer: drops every queued block.
+    void clear();
+
+    fl::size size() const;
+    bool empty() const { return size() == 0; }
+    fl::size capacity() const { return mBlocks.size(); }
+    fl::size blockSize() const { return mBlockSize; }
+    fl::u32 overruns() const { return mOverruns.load(); }
+    fl::u32 underruns() const { return mUnderruns.load(); }
+
+  private:
+    AudioSampleImpl *claim(fl::size n);
+    void publish();
+    fl::u32 advance(fl::u32 index) const {
+        return index + 1 == 2 * mBlocks.size() ? 0 : index + 1;
+    }
+
+    fl::vector<AudioSampleImplPtr> mBlocks;
+    fl::size mBlockSize;
+    // Positions run over [0, 2 * capacity) so that a full queue
+    // (head - tail == capacity) differs from an empty one (head == tail).
+    fl::atomic_u32 mHead;  // next block to write, owned by the producer
+    fl::atomic_u32 mTail;  // next block to read, owned by the consumer
+    fl::atomic_u32 mOverruns;
+    fl::atomic_u32 mUnderruns;
 };
 
 } // namespace fl
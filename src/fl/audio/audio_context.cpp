@@ -1,31 +1,186 @@
 #include "fl/audio/audio_context.h"
 
+#include "fl/math.h"
+#include "led_sysdefs.h"
+
 namespace fl {
 
+// Counts one computation of a feature and, while profiling, times it. Create
+// it after pulling the feature's dependencies so their cost isn't included.
+struct AudioContext::FeatureTimer {
+    FeatureTimer(const AudioContext* context, AudioFeature feature)
+        : mStats(context->mFeatureStats[u8(feature)]),
+          mProfiling(context->mProfiling), mStart(mProfiling ? micros() : 0) {
+        ++mStats.computations;
+    }
+    ~FeatureTimer() {
+        if (mProfiling) {
+            mStats.totalMicros += micros() - mStart;
+        }
+    }
+    AudioFeatureStats& mStats;
+    bool mProfiling;
+    u32 mStart;
+};
+
 AudioContext::AudioContext(const AudioSample& sample)
     : mSample(sample)
-    , mFFT(0)
+    , mSpectrumComputed(false)
+    , mLastLayout(-1)
     , mFFTComputed(false)
     , mFFTHistoryDepth(0)
     , mFFTHistoryIndex(0)
-{}
+    , mFrameTimestamp(0)
+    , mInFrame(false)
+    , mRMSComputed(false)
+    , mRMS(0.0f)
+    , mFluxComputed(false)
+    , mFlux(0.0f)
+    , mChromaComputed(false)
+    , mChromaClassSamples(0)
+    , mProfiling(false)
+{
+    for (int i = 0; i < 12; ++i) {
+        mChroma[i] = 0.0f;
+    }
+}
 
 AudioContext::~AudioContext() = default;
 
 const FFTBins& AudioContext::getFFT(int bands, float fmin, float fmax) {
-    FFT_Args args(mSample.size(), bands, fmin, fmax, 44100);
+    const span<const int16_t> pcm = getPCM();
+    FFT_Args args(static_cast<int>(pcm.size()), bands, fmin, fmax, 44100);
+
+    int index = -1;
+    for (fl::size i = 0; i < mLayouts.size(); ++i) {
+        if (mLayouts[i]->args == args) {
+            index = static_cast<int>(i);
+            break;
+        }
+    }
+    if (index < 0) {
+        index = static_cast<int>(mLayouts.size());
+        mLayouts.push_back(make_shared<BandLayout>(args));
+    }
+
+    BandLayout& layout = *mLayouts[index];
+    if (!layout.computed) {
+        // One transform per sample, shared by every band layout
+        if (!computeSpectrum()) {
+            layout.bins.clear();
+        } else {
+            FeatureTimer timer(this, AudioFeature::Bands);
+            mFFTEngine.bands(mSpectrum, &layout.bins, args);
+        }
+        layout.computed = true;
+    }
+    mFFTComputed = true;
+    mLastLayout = index;
+
+    return layout.bins;
+}
+
+bool AudioContext::computeSpectrum() {
+    const span<const int16_t> pcm = getPCM();
+    if (pcm.empty()) {
+        return false;
+    }
+    if (!mSpectrumComputed) {
+        FeatureTimer timer(this, AudioFeature::Spectrum);
+        mFFTEngine.transform(pcm, &mSpectrum);
+        mSpectrumComputed = true;
+    }
+    return true;
+}
+
+float AudioContext::getRMS() const {
+    if (!mRMSComputed) {
+        FeatureTimer timer(this, AudioFeature::RMS);
+        mRMS = mInFrame ? mStft.rms() : mSample.rms();
+        mRMSComputed = true;
+    }
+    return mRMS;
+}
+
+float AudioContext::getSpectralFlux() {
+    if (mFluxComputed) {
+        return mFlux;
+    }
+    const FFTBins& bands = getFFT(16);
+    FeatureTimer timer(this, AudioFeature::SpectralFlux);
+    const fl::size n = bands.bins_raw.size();
+    if (mFluxPrevBands.size() != n) {
+        mFluxPrevBands.assign(n, 0.0f);
+    }
+    float flux = 0.0f;
+    for (fl::size i = 0; i < n; ++i) {
+        const float diff = bands.bins_raw[i] - mFluxPrevBands[i];
+        if (diff > 0.0f) {
+            flux += diff;
+        }
+        mFluxPrevBands[i] = bands.bins_raw[i];
+    }
+    mFlux = n ? flux / static_cast<float>(n) : 0.0f;
+    mFluxComputed = true;
+    return mFlux;
+}
 
-    // Check if we need to recompute
-    if (!mFFTComputed || mFFTArgs != args) {
-        if (mFFT.size() != static_cast<size>(bands)) {
-            mFFT = FFTBins(bands);
+span<const float> AudioContext::getChroma() {
+    if (mChromaComputed) {
+        return span<const float>(mChroma, 12);
+    }
+    mChromaComputed = true;
+    for (int i = 0; i < 12; ++i) {
+        mChroma[i] = 0.0f;
+    }
+    if (!computeSpectrum()) {
+        return span<const float>(mChroma, 12);
+    }
+    FeatureTimer timer(this, AudioFeature::Chroma);
+    const fl::size bins = mSpectrum.bins.size() / 2;
+    if (mChromaClassSamples != mSpectrum.samples) {
+        // Nearest equal-tempered pitch class of each bin, A4 = 440 Hz
+        mChromaClassSamples = mSpectrum.samples;
+        mChromaClass.assign(bins, -1);
+        // Without STFT framing the rate is unknown; getSTFT() then reports
+        // the same 44.1 kHz default that getFFT() assumes
+        const float binHz = static_cast<float>(mStft.sampleRate()) /
+                            static_cast<float>(mSpectrum.samples);
+        for (fl::size k = 1; k < bins; ++k) {
+            const float freq = k * binHz;
+            if (freq < 60.0f || freq > 5000.0f) {
+                continue;
+            }
+            const float midi = 69.0f + 12.0f * fl::log2f(freq / 440.0f);
+            mChromaClass[k] = static_cast<i8>(static_cast<int>(midi + 0.5f) % 12);
+        }
+    }
+    const i16* spectrum = mSpectrum.bins.data();
+    for (fl::size k = 0; k < bins; ++k) {
+        const int pitchClass = mChromaClass[k];
+        if (pitchClass < 0) {
+            continue;
+        }
+        const float re = spectrum[2 * k];
+        const float im = spectrum[2 * k + 1];
+        mChroma[pitchClass] += fl::sqrtf(re * re + im * im);
+    }
+    float peak = 0.0f;
+    for (int i = 0; i < 12; ++i) {
+        peak = FL_MAX(peak, mChroma[i]);
+    }
+    if (peak > 0.0f) {
+        for (int i = 0; i < 12; ++i) {
+            mChroma[i] /= peak;
         }
-        mSample.fft(&mFFT);
-        mFFTComputed = true;
-        mFFTArgs = args;
     }
+    return span<const float>(mChroma, 12);
+}
 
-    return mFFT;
+void AudioContext::resetFeatureStats() {
+    for (u8 i = 0; i < u8(AudioFeature::Count); ++i) {
+        mFeatureStats[i] = AudioFeatureStats();
+    }
 }
 
 const vector<FFTBins>& AudioContext::getFFTHistory(int depth) {
@@ -47,26 +202,78 @@ const FFTBins* AudioContext::getHistoricalFFT(int framesBack) const {
 }
 
 void AudioContext::setSample(const AudioSample& sample) {
-    // Save current FFT to history
+    saveHistory();
+    mSample = sample;
+    mInFrame = false;
+    invalidateFFT();
+}
+
+void AudioContext::setSpectrum(const FFTSpectrum& spectrum) {
+    if (spectrum.samples != getPCM().size()) {
+        return;
+    }
+    mSpectrum = spectrum;
+    mSpectrumComputed = true;
+}
+
+void AudioContext::setSTFT(fl::size window, fl::size hop, u32 sampleRate) {
+    mStft.configure(window, hop, sampleRate);
+    mInFrame = false;
+    mChromaClassSamples = 0;  // bin frequencies depend on the sample rate
+    invalidateFFT();
+}
+
+void AudioContext::pushSample(const AudioSample& sample,
+                              const function<void()>& onFrame) {
+    if (!mStft.isConfigured()) {
+        setSample(sample);
+        onFrame();
+        return;
+    }
+    mSample = sample;
+    mStft.push(sample.pcm(), sample.timestamp(),
+               [this, &onFrame](span<const i16> frame, u32 timestamp) {
+                   saveHistory();
+                   mFrame = frame;
+                   mFrameTimestamp = timestamp;
+                   mInFrame = true;
+                   invalidateFFT();
+                   onFrame();
+               });
+}
+
+void AudioContext::saveHistory() {
     if (mFFTComputed && mFFTHistoryDepth > 0) {
+        const FFTBins& latest = mLayouts[mLastLayout]->bins;
         if (static_cast<int>(mFFTHistory.size()) < mFFTHistoryDepth) {
-            mFFTHistory.push_back(mFFT);
-            mFFTHistoryIndex = static_cast<int>(mFFTHistory.size());
+            mFFTHistory.push_back(latest);
+            mFFTHistoryIndex = static_cast<int>(mFFTHistory.size()) % mFFTHistoryDepth;
         } else {
-            mFFTHistory[mFFTHistoryIndex] = mFFT;
+            mFFTHistory[mFFTHistoryIndex] = latest;
             mFFTHistoryIndex = (mFFTHistoryIndex + 1) % mFFTHistoryDepth;
         }
     }
-
-    mSample = sample;
-    mFFTComputed = false;
 }
 
 void AudioContext::clearCache() {
-    mFFTComputed = false;
+    invalidateFFT();
+    mFluxPrevBands.clear();
+    mStft.reset();
+    mInFrame = false;
     mFFTHistory.clear();
     mFFTHistoryDepth = 0;
     mFFTHistoryIndex = 0;
 }
 
+void AudioContext::invalidateFFT() {
+    mSpectrumComputed = false;
+    mRMSComputed = false;
+    mFluxComputed = false;
+    mChromaComputed = false;
+    for (fl::size i = 0; i < mLayouts.size(); ++i) {
+        mLayouts[i]->computed = false;
+    }
+    mFFTComputed = false;
+}
+
 } // namespace fl
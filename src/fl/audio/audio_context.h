@@ -1,7 +1,10 @@
 #pragma once
 
 #include "fl/audio.h"
+#include "fl/audio/audio_features.h"
+#include "fl/audio/stft.h"
 #include "fl/fft.h"
+#include "fl/function.h"
 #include "fl/vector.h"
 #include "fl/ptr.h"
 #include "fl/span.h"
@@ -14,19 +17,60 @@ public:
     ~AudioContext();
 
     // ----- Basic Sample Access -----
+    // In STFT mode getPCM/getRMS/getZCF/getTimestamp describe the current
+    // overlapped frame, while getSample() is the last block pushed. Read the
+    // frame from pushSample()'s callback: the rest of the block is written
+    // over it once the callback returns.
     const AudioSample& getSample() const { return mSample; }
-    span<const int16_t> getPCM() const { return mSample.pcm(); }
-    float getRMS() const { return mSample.rms(); }
-    float getZCF() const { return mSample.zcf(); }
-    u32 getTimestamp() const { return mSample.timestamp(); }
+    span<const int16_t> getPCM() const {
+        return mInFrame ? mFrame : span<const int16_t>(mSample.pcm());
+    }
+    float getRMS() const;
+    float getZCF() const { return mInFrame ? mStft.zcf() : mSample.zcf(); }
+    u32 getTimestamp() const {
+        return mInFrame ? mFrameTimestamp : mSample.timestamp();
+    }
 
     // ----- Lazy FFT Computation (with caching) -----
+    // The spectrum is computed once per sample; each band layout requested
+    // is derived from it and cached until the next sample.
     const FFTBins& getFFT(
         int bands = 16,
         float fmin = FFT_Args::DefaultMinFrequency(),
         float fmax = FFT_Args::DefaultMaxFrequency()
     );
     bool hasFFT() const { return mFFTComputed; }
+    // Supplies the spectrum of the current sample when it was computed
+    // elsewhere, e.g. mixed from a multi-stream batch, so getFFT() and the
+    // shared features skip the transform. Call after setSample().
+    void setSpectrum(const FFTSpectrum& spectrum);
+
+    // ----- Shared Features (see audio_features.h) -----
+    // Positive change of the 16 default bands since the previous frame,
+    // averaged over the bands. Onset detectors share it.
+    float getSpectralFlux();
+    // Energy per pitch class (C = 0) from the spectrum between 60 Hz and
+    // 5 kHz, scaled so the strongest class is 1. Chord and key share it.
+    span<const float> getChroma();
+
+    // Per-feature cost readout. Computations are always counted; time is
+    // measured with micros() only while profiling is enabled.
+    void setFeatureProfiling(bool enabled) { mProfiling = enabled; }
+    const AudioFeatureStats& getFeatureStats(AudioFeature feature) const {
+        return mFeatureStats[u8(feature)];
+    }
+    void resetFeatureStats();
+
+    // ----- Sliding Window (STFT) Mode -----
+    // Analyses frames of `window` samples every `hop` samples instead of one
+    // frame per block, so onsets are seen within a hop of arriving. Feed
+    // blocks through pushSample(); onFrame runs once per hop with the
+    // context describing that frame, and FFT history holds the overlapped
+    // frames. setSTFT(0, 0) returns to one frame per block.
+    void setSTFT(fl::size window, fl::size hop, u32 sampleRate = 44100);
+    bool isSTFT() const { return mStft.isConfigured(); }
+    const StftBuffer& getSTFT() const { return mStft; }
+    void pushSample(const AudioSample& sample, const function<void()>& onFrame);
 
     // ----- FFT History (for temporal analysis) -----
     const vector<FFTBins>& getFFTHistory(int depth = 4);
@@ -38,13 +82,52 @@ public:
     void clearCache();
 
 private:
+    struct BandLayout {
+        explicit BandLayout(const FFT_Args& args)
+            : args(args), bins(args.bands), computed(false) {}
+        FFT_Args args;
+        FFTBins bins;
+        bool computed;
+    };
+
     AudioSample mSample;
-    mutable FFTBins mFFT;
+    FFT mFFTEngine;
+    FFTSpectrum mSpectrum;
+    bool mSpectrumComputed;
+    vector<shared_ptr<BandLayout>> mLayouts;
+    // Layout most recently returned by getFFT(); this is what history keeps
+    int mLastLayout;
     mutable bool mFFTComputed;
-    mutable FFT_Args mFFTArgs;
     vector<FFTBins> mFFTHistory;
     int mFFTHistoryDepth;
     int mFFTHistoryIndex;
+
+    // STFT mode: mFrame points into mStft's ring, so it holds the latest
+    // frame only until more PCM is written to the ring, i.e. within the
+    // pushSample() callback.
+    StftBuffer mStft;
+    span<const int16_t> mFrame;
+    u32 mFrameTimestamp;
+    bool mInFrame;
+
+    // Shared features, valid for the current frame when the flag is set
+    mutable bool mRMSComputed;
+    mutable float mRMS;
+    bool mFluxComputed;
+    float mFlux;
+    vector<float> mFluxPrevBands;
+    bool mChromaComputed;
+    float mChroma[12];
+    vector<i8> mChromaClass;  // pitch class per spectrum bin, -1 = ignored
+    fl::size mChromaClassSamples;
+    bool mProfiling;
+    mutable AudioFeatureStats mFeatureStats[u8(AudioFeature::Count)];
+
+    struct FeatureTimer;
+
+    bool computeSpectrum();
+    void saveHistory();
+    void invalidateFFT();
 };
 
 } // namespace fl
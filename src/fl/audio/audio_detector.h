@@ -1,5 +1,6 @@
 #pragma once
 
+#include "fl/audio/audio_features.h"
 #include "fl/ptr.h"
 
 namespace fl {
@@ -13,6 +14,10 @@ public:
     virtual void update(shared_ptr<AudioContext> context) = 0;
     virtual bool needsFFT() const { return false; }
     virtual bool needsFFTHistory() const { return false; }
+    // Shared AudioContext features update() pulls (see audio_features.h)
+    virtual AudioFeatureMask requiredFeatures() const {
+        return needsFFT() ? audioFeatureBit(AudioFeature::Bands) : 0;
+    }
     virtual const char* getName() const = 0;
     virtual void reset() {}
 };
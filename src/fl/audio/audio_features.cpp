@@ -0,0 +1,41 @@
+#include "fl/audio/audio_features.h"
+
+namespace fl {
+
+namespace {
+
+const char* const kFeatureNames[] = {"Spectrum", "Bands", "SpectralFlux", "Chroma", "RMS"};
+
+} // namespace
+
+AudioFeatureMask audioFeatureDependencies(AudioFeature feature) {
+    switch (feature) {
+    case AudioFeature::Bands:
+    case AudioFeature::Chroma:
+        return audioFeatureBit(AudioFeature::Spectrum);
+    case AudioFeature::SpectralFlux:
+        return audioFeatureBit(AudioFeature::Bands) |
+               audioFeatureBit(AudioFeature::Spectrum);
+    default:
+        return 0;
+    }
+}
+
+AudioFeatureMask audioFeatureClosure(AudioFeatureMask mask) {
+    AudioFeatureMask closure = mask;
+    for (u8 i = 0; i < u8(AudioFeature::Count); ++i) {
+        if (mask & audioFeatureBit(AudioFeature(i))) {
+            closure |= audioFeatureDependencies(AudioFeature(i));
+        }
+    }
+    return closure;
+}
+
+const char* audioFeatureName(AudioFeature feature) {
+    if (u8(feature) >= u8(AudioFeature::Count)) {
+        return "Unknown";
+    }
+    return kFeatureNames[u8(feature)];
+}
+
+} // namespace fl
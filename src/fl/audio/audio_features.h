@@ -0,0 +1,44 @@
+#pragma once
+
+#include "fl/int.h"
+
+namespace fl {
+
+// Intermediate features AudioContext computes on demand and shares between
+// detectors. Each is computed at most once per frame, and only when a
+// detector asks for it; asking for one first computes what it depends on.
+//
+//   Spectrum ──┬── Bands ── SpectralFlux
+//              └── Chroma
+//   RMS
+enum class AudioFeature : u8 {
+    Spectrum = 0,  // complex FFT of the frame
+    Bands,         // a band layout (getFFT); counted once per layout
+    SpectralFlux,  // positive change of the 16 default bands since the last frame
+    Chroma,        // 12 pitch-class energies, normalized to a peak of 1
+    RMS,           // frame RMS
+    Count
+};
+
+typedef u32 AudioFeatureMask;
+
+inline AudioFeatureMask audioFeatureBit(AudioFeature feature) {
+    return AudioFeatureMask(1) << u8(feature);
+}
+
+// Everything `feature` is computed from, directly or not
+AudioFeatureMask audioFeatureDependencies(AudioFeature feature);
+// `mask` plus everything it depends on
+AudioFeatureMask audioFeatureClosure(AudioFeatureMask mask);
+const char* audioFeatureName(AudioFeature feature);
+
+struct AudioFeatureStats {
+    u32 computations = 0;
+    u32 totalMicros = 0;  // only accumulated while profiling is enabled
+
+    float meanMicros() const {
+        return computations ? float(totalMicros) / float(computations) : 0.0f;
+    }
+};
+
+} // namespace fl
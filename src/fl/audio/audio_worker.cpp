@@ -0,0 +1,38 @@
+#include "fl/audio/audio_worker.h"
+
+#include "fl/has_include.h"
+#include "fl/thread.h"
+
+// Pick the platform worker: a pinned FreeRTOS task on ESP32, a thread on the
+// host. Both need FASTLED_MULTITHREADED so fl::atomic and fl::mutex are real;
+// ESP32 sketches opt in with -DFASTLED_MULTITHREADED=1.
+#if FASTLED_MULTITHREADED && defined(ESP32) && FL_HAS_INCLUDE("freertos/FreeRTOS.h")
+#define FASTLED_AUDIO_WORKER_ESP32 1
+#include "platforms/esp/32/audio/audio_worker_esp32.hpp"
+#elif FASTLED_MULTITHREADED
+#define FASTLED_AUDIO_WORKER_THREAD 1
+#include "platforms/stub/audio_worker_stub.hpp"
+#endif
+
+namespace fl {
+
+fl::shared_ptr<IAudioWorker> IAudioWorker::create(fl::function<bool()> step,
+                                                  const AudioWorkerConfig& config) {
+#if defined(FASTLED_AUDIO_WORKER_ESP32) || defined(FASTLED_AUDIO_WORKER_THREAD)
+    return platform_create_audio_worker(step, config);
+#else
+    (void)step;
+    (void)config;
+    return nullptr;
+#endif
+}
+
+u32 IAudioWorker::concurrency() {
+#if defined(FASTLED_AUDIO_WORKER_ESP32) || defined(FASTLED_AUDIO_WORKER_THREAD)
+    return platform_audio_worker_concurrency();
+#else
+    return 1;
+#endif
+}
+
+} // namespace fl
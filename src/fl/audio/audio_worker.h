@@ -0,0 +1,41 @@
+#pragma once
+
+#include "fl/function.h"
+#include "fl/int.h"
+#include "fl/shared_ptr.h"
+
+namespace fl {
+
+struct AudioWorkerConfig {
+    const char* name = "fl_audio";
+    u32 stackSize = 8192;  // bytes (FreeRTOS task stack)
+    u8 priority = 5;       // FreeRTOS priority; ignored on the host
+    int core = 0;          // ESP32 core to pin to, -1 for any; ignored on the host
+    u32 idleMs = 1;        // sleep when step() found nothing to do
+};
+
+// Background execution context for audio analysis: a thread on the host and a
+// core-pinned FreeRTOS task on ESP32, both only in FASTLED_MULTITHREADED builds.
+// The worker calls step() in a loop until stop(); step() returns false when
+// it had nothing to do, and the worker then sleeps for idleMs.
+//
+// Example:
+//   auto worker = IAudioWorker::create([&]() { return processOneBlock(); });
+//   if (!worker) { /* no threads on this platform: process inline */ }
+class IAudioWorker {
+  public:
+    // Returns null where the platform has no worker support.
+    static fl::shared_ptr<IAudioWorker>
+    create(fl::function<bool()> step,
+           const AudioWorkerConfig& config = AudioWorkerConfig());
+    // Workers that can usefully run at once: hardware threads on the host,
+    // cores on ESP32, 1 where create() returns null.
+    static u32 concurrency();
+
+    virtual ~IAudioWorker() = default;
+    // Blocks until the current step() finishes and the worker has exited.
+    virtual void stop() = 0;
+    virtual bool running() const = 0;
+};
+
+} // namespace fl
@@ -0,0 +1,233 @@
+#include "fl/audio/pcm_stats.h"
+
+#include "fl/math.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>  // ok include
+#define FL_PCM_STATS_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>  // ok include
+#define FL_PCM_STATS_NEON 1
+#endif
+
+namespace fl {
+
+float PcmStats::rms() const {
+    if (count == 0) {
+        return 0.0f;
+    }
+    return sqrtf(float(sumSquares) / float(count));
+}
+
+float PcmStats::dcOffset() const {
+    if (count == 0) {
+        return 0.0f;
+    }
+    return float(double(sum) / double(count));
+}
+
+double PcmStats::meanPowerFS() const {
+    // sumSquares / 2^30 is exact in a double for any block under 2^23
+    // samples, so this equals summing (s / 32768)^2 one sample at a time.
+    return double(sumSquares) / 1073741824.0 / double(count);
+}
+
+namespace {
+
+// Accumulates samples [begin, end) into the running sums. `prev` is the
+// sample before `begin`, or samples[begin] itself at the start of a block.
+struct PortableAccumulator {
+    fl::u64 sumSquares = 0;
+    fl::i64 sum = 0;
+    fl::i32 maxValue = 0;
+    fl::i32 minValue = 0;
+    fl::u32 zeroCrossings = 0;
+
+    void run(const fl::i16 *samples, fl::size begin, fl::size end,
+             fl::i16 prev) {
+        // Two independent chains so the multiply-adds overlap
+        fl::u64 sqA = 0;
+        fl::u64 sqB = 0;
+        fl::i32 sumA = 0;
+        fl::i32 sumB = 0;
+        fl::u32 signs = fl::u16(prev) >> 15;
+        fl::size i = begin;
+        // 32-bit partial sums hold 2 x 32768 x 2^15 samples; flush before that
+        while (i < end) {
+            const fl::size stop = FL_MIN(end, i + 2 * 32768);
+            for (; i + 1 < stop; i += 2) {
+                const fl::i32 a = samples[i];
+                const fl::i32 b = samples[i + 1];
+                sqA += fl::u32(a * a);
+                sqB += fl::u32(b * b);
+                sumA += a;
+                sumB += b;
+                maxValue = FL_MAX(maxValue, FL_MAX(a, b));
+                minValue = FL_MIN(minValue, FL_MIN(a, b));
+                // Sign bits of prev, a, b side by side: a crossing is a
+                // sign bit that differs from its neighbour
+                const fl::u32 sa = fl::u16(a) >> 15;
+                const fl::u32 sb = fl::u16(b) >> 15;
+                zeroCrossings += (signs ^ sa) + (sa ^ sb);
+                signs = sb;
+            }
+            if (i < stop) {
+                const fl::i32 a = samples[i];
+                sqA += fl::u32(a * a);
+                sumA += a;
+                maxValue = FL_MAX(maxValue, a);
+                minValue = FL_MIN(minValue, a);
+                const fl::u32 sa = fl::u16(a) >> 15;
+                zeroCrossings += signs ^ sa;
+                signs = sa;
+                ++i;
+            }
+            sum += fl::i64(sumA) + fl::i64(sumB);
+            sumA = 0;
+            sumB = 0;
+        }
+        sumSquares += sqA + sqB;
+    }
+
+    void finish(fl::size count, PcmStats *out) const {
+        out->count = count;
+        out->sumSquares = sumSquares;
+        out->sum = sum;
+        out->peak = FL_MAX(maxValue, -minValue);
+        out->zeroCrossings = zeroCrossings;
+    }
+};
+
+#if defined(FL_PCM_STATS_SSE2)
+
+fl::size sse2Body(const fl::i16 *samples, fl::size count,
+                  PortableAccumulator *acc) {
+    // Vector lanes cover [1, end); sample 0 has no predecessor
+    fl::size i = 1;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sq64 = zero;
+    __m128i vmax = zero;
+    __m128i vmin = zero;
+    while (i + 8 <= count) {
+        // 32-bit sums gain at most 2^16 and 16-bit counts at most 1 per
+        // iteration, so flush them every 8192 iterations
+        __m128i sum32 = zero;
+        __m128i zc16 = zero;
+        for (int n = 0; n < 8192 && i + 8 <= count; ++n, i += 8) {
+            const __m128i a = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(samples + i));
+            const __m128i b = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(samples + i - 1));
+            // Pairwise a*a sums reach 2^31, which only fits unsigned
+            const __m128i sq = _mm_madd_epi16(a, a);
+            sq64 = _mm_add_epi64(sq64, _mm_unpacklo_epi32(sq, zero));
+            sq64 = _mm_add_epi64(sq64, _mm_unpackhi_epi32(sq, zero));
+            sum32 = _mm_add_epi32(sum32, _mm_madd_epi16(a, ones));
+            vmax = _mm_max_epi16(vmax, a);
+            vmin = _mm_min_epi16(vmin, a);
+            // -1 where the sign differs from the previous sample
+            zc16 = _mm_sub_epi16(zc16, _mm_xor_si128(_mm_srai_epi16(a, 15),
+                                                     _mm_srai_epi16(b, 15)));
+        }
+        alignas(16) fl::i32 sums[4];
+        alignas(16) fl::u16 crossings[8];
+        _mm_store_si128(reinterpret_cast<__m128i *>(sums), sum32);
+        _mm_store_si128(reinterpret_cast<__m128i *>(crossings), zc16);
+        for (int k = 0; k < 4; ++k) {
+            acc->sum += sums[k];
+        }
+        for (int k = 0; k < 8; ++k) {
+            acc->zeroCrossings += crossings[k];
+        }
+    }
+    alignas(16) fl::u64 squares[2];
+    alignas(16) fl::i16 maxes[8];
+    alignas(16) fl::i16 mins[8];
+    _mm_store_si128(reinterpret_cast<__m128i *>(squares), sq64);
+    _mm_store_si128(reinterpret_cast<__m128i *>(maxes), vmax);
+    _mm_store_si128(reinterpret_cast<__m128i *>(mins), vmin);
+    acc->sumSquares += squares[0] + squares[1];
+    for (int k = 0; k < 8; ++k) {
+        acc->maxValue = FL_MAX(acc->maxValue, fl::i32(maxes[k]));
+        acc->minValue = FL_MIN(acc->minValue, fl::i32(mins[k]));
+    }
+    return i;
+}
+
+#elif defined(FL_PCM_STATS_NEON)
+
+fl::size neonBody(const fl::i16 *samples, fl::size count,
+                  PortableAccumulator *acc) {
+    fl::size i = 1;
+    uint64x2_t sq64 = vdupq_n_u64(0);
+    int64x2_t sum64 = vdupq_n_s64(0);
+    uint32x4_t zc32 = vdupq_n_u32(0);
+    int16x8_t vmax = vdupq_n_s16(0);
+    int16x8_t vmin = vdupq_n_s16(0);
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t a = vld1q_s16(samples + i);
+        const int16x8_t b = vld1q_s16(samples + i - 1);
+        // A single product is at most 2^30
+        const int32x4_t lo = vmull_s16(vget_low_s16(a), vget_low_s16(a));
+        const int32x4_t hi = vmull_s16(vget_high_s16(a), vget_high_s16(a));
+        sq64 = vpadalq_u32(sq64, vreinterpretq_u32_s32(lo));
+        sq64 = vpadalq_u32(sq64, vreinterpretq_u32_s32(hi));
+        sum64 = vpadalq_s32(sum64, vpaddlq_s16(a));
+        vmax = vmaxq_s16(vmax, a);
+        vmin = vminq_s16(vmin, a);
+        const uint16x8_t crossed = vshrq_n_u16(
+            vreinterpretq_u16_s16(veorq_s16(a, b)), 15);
+        zc32 = vpadalq_u16(zc32, crossed);
+    }
+    acc->sumSquares += vgetq_lane_u64(sq64, 0) + vgetq_lane_u64(sq64, 1);
+    acc->sum += vgetq_lane_s64(sum64, 0) + vgetq_lane_s64(sum64, 1);
+    acc->zeroCrossings += vgetq_lane_u32(zc32, 0) + vgetq_lane_u32(zc32, 1) +
+                          vgetq_lane_u32(zc32, 2) + vgetq_lane_u32(zc32, 3);
+    fl::i16 maxes[8];
+    fl::i16 mins[8];
+    vst1q_s16(maxes, vmax);
+    vst1q_s16(mins, vmin);
+    for (int k = 0; k < 8; ++k) {
+        acc->maxValue = FL_MAX(acc->maxValue, fl::i32(maxes[k]));
+        acc->minValue = FL_MIN(acc->minValue, fl::i32(mins[k]));
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+void computePcmStatsPortable(const fl::i16 *samples, fl::size count,
+                             PcmStats *out) {
+    PortableAccumulator acc;
+    if (count > 0) {
+        acc.run(samples, 0, count, samples[0]);
+    }
+    acc.finish(count, out);
+}
+
+void computePcmStats(const fl::i16 *samples, fl::size count, PcmStats *out) {
+#if defined(FL_PCM_STATS_SSE2) || defined(FL_PCM_STATS_NEON)
+    PortableAccumulator acc;
+    if (count > 0) {
+        // Sample 0 and the tail that does not fill a vector go through the
+        // portable loop
+        acc.run(samples, 0, 1, samples[0]);
+#if defined(FL_PCM_STATS_SSE2)
+        const fl::size end = sse2Body(samples, count, &acc);
+#else
+        const fl::size end = neonBody(samples, count, &acc);
+#endif
+        if (end < count) {
+            acc.run(samples, end, count, samples[end - 1]);
+        }
+    }
+    acc.finish(count, out);
+#else
+    computePcmStatsPortable(samples, count, out);
+#endif
+}
+
+} // namespace fl
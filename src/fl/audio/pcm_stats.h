@@ -0,0 +1,36 @@
+#pragma once
+
+#include "fl/int.h"
+#include "fl/span.h"
+
+namespace fl {
+
+// Block statistics of 16-bit PCM, gathered in one pass over the samples.
+// All sums are exact integers, so the derived values match a plain
+// sample-by-sample loop bit for bit whichever kernel produced them.
+struct PcmStats {
+    fl::size count = 0;
+    fl::u64 sumSquares = 0;
+    fl::i64 sum = 0;
+    fl::i32 peak = 0;            // largest |sample|, 0..32768
+    fl::u32 zeroCrossings = 0;   // sign changes between neighbouring samples
+
+    float rms() const;
+    float dcOffset() const;
+    // Mean power relative to full scale, 1.0 for a full-scale square wave
+    double meanPowerFS() const;
+};
+
+// Picks the widest kernel the target compiles for: SSE2 on x86, NEON on
+// ARM with Advanced SIMD, otherwise the portable one.
+void computePcmStats(const fl::i16 *samples, fl::size count, PcmStats *out);
+inline void computePcmStats(fl::span<const fl::i16> samples, PcmStats *out) {
+    computePcmStats(samples.data(), samples.size(), out);
+}
+
+// Portable integer kernel; what computePcmStats() uses on targets without
+// a vector unit. Exposed so tests can hold the vector kernels against it.
+void computePcmStatsPortable(const fl::i16 *samples, fl::size count,
+                             PcmStats *out);
+
+} // namespace fl
@@ -0,0 +1,63 @@
+#include "fl/audio/stft.h"
+
+#include "fl/math.h"
+
+namespace fl {
+
+namespace {
+
+inline bool crosses(i16 a, i16 b) { return (a < 0) != (b < 0); }
+
+} // namespace
+
+void StftBuffer::configure(fl::size window, fl::size hop, u32 sampleRate) {
+    if (window < 2 || hop == 0) {
+        window = 0;
+        hop = 0;
+    }
+    mWindow = window;
+    mHop = hop;
+    mSampleRate = sampleRate ? sampleRate : 44100;
+    reset();
+}
+
+void StftBuffer::reset() {
+    mRing.assign(mWindow * 2, 0);
+    mPos = 0;
+    mSinceFrame = 0;
+    mSumSquares = 0;
+    mZeroCrossings = 0;
+}
+
+void StftBuffer::write(i16 sample) {
+    const i16 oldest = mRing[mPos];
+    const i16 secondOldest = mRing[mPos + 1];
+    const i16 newest = mRing[mPos + mWindow - 1];
+
+    // The pair (oldest, secondOldest) leaves the window, (newest, sample)
+    // enters it.
+    mZeroCrossings += (crosses(newest, sample) ? 1 : 0) -
+                      (crosses(oldest, secondOldest) ? 1 : 0);
+    mSumSquares -= u64(i32(oldest) * i32(oldest));
+    mSumSquares += u64(i32(sample) * i32(sample));
+
+    mRing[mPos] = sample;
+    mRing[mPos + mWindow] = sample;
+    mPos = mPos + 1 == mWindow ? 0 : mPos + 1;
+}
+
+float StftBuffer::rms() const {
+    if (mWindow == 0) {
+        return 0.0f;
+    }
+    return sqrtf(float(mSumSquares) / float(mWindow));
+}
+
+float StftBuffer::zcf() const {
+    if (mWindow < 2) {
+        return 0.0f;
+    }
+    return float(mZeroCrossings) / float(mWindow - 1);
+}
+
+} // namespace fl
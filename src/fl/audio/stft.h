@@ -0,0 +1,79 @@
+#pragma once
+
+#include "fl/int.h"
+#include "fl/span.h"
+#include "fl/vector.h"
+
+namespace fl {
+
+// Ring of recent PCM that cuts a stream of sample blocks into overlapping
+// analysis frames: every `hop` samples it hands out the newest `window`
+// samples. Each sample is stored twice (at pos and pos + window), so the
+// newest window is always contiguous and frames are views into the ring;
+// the cost per sample is the same at any overlap.
+//
+// RMS and zero crossings of the current window are kept up to date as
+// samples enter and leave, so frames need no extra pass for them.
+//
+// Example (512 sample window, 75% overlap):
+//   StftBuffer stft(512, 128);
+//   stft.push(block.pcm(), block.timestamp(),
+//             [&](span<const i16> frame, u32 timestamp) { analyze(frame); });
+class StftBuffer {
+  public:
+    StftBuffer() = default;
+    StftBuffer(fl::size window, fl::size hop, u32 sampleRate = 44100) {
+        configure(window, hop, sampleRate);
+    }
+
+    // window == 0 or hop == 0 turns framing off. Resets the ring to silence.
+    void configure(fl::size window, fl::size hop, u32 sampleRate = 44100);
+    // Drops buffered audio, keeping the configuration.
+    void reset();
+
+    bool isConfigured() const { return mWindow > 0 && mHop > 0; }
+    fl::size window() const { return mWindow; }
+    fl::size hop() const { return mHop; }
+    u32 sampleRate() const { return mSampleRate; }
+
+    // Appends a block whose first sample was captured at `timestamp` (ms)
+    // and calls onFrame(span<const i16> frame, u32 frameTimestamp) each time
+    // `hop` new samples have arrived. The frame holds the newest window()
+    // samples, oldest first (silence before the stream started), and is only
+    // valid during the call. frameTimestamp is the capture time of the end
+    // of the frame, i.e. when it became available.
+    template <typename Fn>
+    void push(span<const i16> pcm, u32 timestamp, Fn onFrame) {
+        if (!isConfigured()) {
+            return;
+        }
+        for (fl::size i = 0; i < pcm.size(); ++i) {
+            write(pcm[i]);
+            if (++mSinceFrame >= mHop) {
+                mSinceFrame = 0;
+                const u32 offsetMs =
+                    static_cast<u32>(u64(i + 1) * 1000 / mSampleRate);
+                onFrame(span<const i16>(mRing.data() + mPos, mWindow),
+                        timestamp + offsetMs);
+            }
+        }
+    }
+
+    // Statistics of the current window, matching AudioSample::rms() / zcf()
+    float rms() const;
+    float zcf() const;
+
+  private:
+    void write(i16 sample);
+
+    fl::vector<i16> mRing;  // 2 * window, mirrored halves
+    fl::size mWindow = 0;
+    fl::size mHop = 0;
+    fl::size mPos = 0;  // oldest sample of the window, next slot written
+    fl::size mSinceFrame = 0;
+    u32 mSampleRate = 44100;
+    u64 mSumSquares = 0;
+    i32 mZeroCrossings = 0;
+};
+
+} // namespace fl
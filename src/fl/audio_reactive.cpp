@@ -47,7 +47,15 @@ void AudioReactive::begin(const AudioReactiveConfig& config) {
 }
 
 void AudioReactive::setConfig(const AudioReactiveConfig& config) {
+    // Compare with the old config, not mStft: configure() normalises an
+    // invalid window or hop to 0, which would never compare equal
+    const bool stftChanged = config.stftWindow != mConfig.stftWindow ||
+                             config.stftHop != mConfig.stftHop ||
+                             config.sampleRate != mConfig.sampleRate;
     mConfig = config;
+    if (stftChanged) {
+        mStft.configure(config.stftWindow, config.stftHop, config.sampleRate);
+    }
 }
 
 void AudioReactive::processSample(const AudioSample& sample) {
@@ -58,9 +66,23 @@ void AudioReactive::processSample(const AudioSample& sample) {
     // Extract timestamp from the AudioSample
     fl::u32 currentTimeMs = sample.timestamp();
     
+    if (mStft.isConfigured()) {
+        // One analysis per hop over the newest window of samples
+        mStft.push(sample.pcm(), currentTimeMs,
+                   [this](span<const fl::i16> frame, fl::u32 frameTimeMs) {
+                       processFrame(frame, mStft.rms(), frameTimeMs);
+                   });
+        return;
+    }
+    
     // Process the AudioSample immediately - timing is gated by sample availability
-    processFFT(sample);
-    updateVolumeAndPeak(sample);
+    processFrame(sample.pcm(), sample.rms(), currentTimeMs);
+}
+
+void AudioReactive::processFrame(span<const fl::i16> pcm, float rms,
+                                 fl::u32 currentTimeMs) {
+    processFFT(pcm);
+    updateVolumeAndPeak(pcm, rms);
     
     // Enhanced processing pipeline
     calculateBandEnergies();
@@ -87,13 +109,13 @@ void AudioReactive::update(fl::u32 currentTimeMs) {
     mCurrentData.timestamp = currentTimeMs;
 }
 
-void AudioReactive::processFFT(const AudioSample& sample) {
-    // Get PCM data from AudioSample
-    const auto& pcmData = sample.pcm();
-    if (pcmData.empty()) return;
+void AudioReactive::processFFT(span<const fl::i16> pcm) {
+    if (pcm.empty()) return;
     
-    // Use AudioSample's built-in FFT capability
-    sample.fft(&mFFTBins);
+    // Same arguments AudioSample::fft() uses, without needing an AudioSample
+    FFT_Args args;
+    args.bands = static_cast<int>(mFFTBins.size());
+    mFFT.run(pcm, &mFFTBins, args);
     
     // Map FFT bins to frequency channels using WLED-compatible mapping
     mapFFTBinsToFrequencyChannels();
@@ -149,9 +171,7 @@ void AudioReactive::mapFFTBinsToFrequencyChannels() {
     mCurrentData.magnitude = maxMagnitude;
 }
 
-void AudioReactive::updateVolumeAndPeak(const AudioSample& sample) {
-    // Get PCM data from AudioSample
-    const auto& pcmData = sample.pcm();
+void AudioReactive::updateVolumeAndPeak(span<const fl::i16> pcmData, float rms) {
     if (pcmData.empty()) {
         mCurrentData.volume = 0.0f;
         mCurrentData.volumeRaw = 0.0f;
@@ -159,9 +179,6 @@ void AudioReactive::updateVolumeAndPeak(const AudioSample& sample) {
         return;
     }
     
-    // Use AudioSample's built-in RMS calculation
-    float rms = sample.rms();
-    
     // Calculate peak from PCM data
     float maxSample = 0.0f;
     for (fl::i16 pcmSample : pcmData) {
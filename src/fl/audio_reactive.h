@@ -6,6 +6,7 @@
 #include "fl/stdint.h"
 #include "fl/int.h"
 #include "fl/audio.h"
+#include "fl/audio/stft.h"
 #include "fl/array.h"
 #include "fl/unique_ptr.h"
 #include "fl/sketch_macros.h"
@@ -56,6 +57,12 @@ struct AudioReactiveConfig {
     float bassThreshold = 0.15f;        // Threshold for bass beat detection
     float midThreshold = 0.12f;         // Threshold for mid beat detection
     float trebleThreshold = 0.08f;      // Threshold for treble beat detection
+
+    // Sliding window (STFT) analysis: when both are non-zero, every `stftHop`
+    // samples the newest `stftWindow` samples are analysed instead of each
+    // sample block on its own, so beats register within a hop of arriving.
+    u16 stftWindow = 0;                 // Analysis frame length in samples
+    u16 stftHop = 0;                    // Samples between frames
 };
 
 class AudioReactive {
@@ -100,9 +107,10 @@ public:
 
 private:
     // Internal processing methods
-    void processFFT(const AudioSample& sample);
+    void processFrame(span<const fl::i16> pcm, float rms, fl::u32 currentTimeMs);
+    void processFFT(span<const fl::i16> pcm);
     void mapFFTBinsToFrequencyChannels();
-    void updateVolumeAndPeak(const AudioSample& sample);
+    void updateVolumeAndPeak(span<const fl::i16> pcm, float rms);
     void detectBeat(fl::u32 currentTimeMs);
     void smoothResults();
     void applyScaling();
@@ -124,6 +132,9 @@ private:
     // FFT processing
     FFT mFFT;
     FFTBins mFFTBins;
+
+    // Recent PCM for STFT mode (unconfigured in block mode)
+    StftBuffer mStft;
     
     // Audio data  
     AudioData mCurrentData;
@@ -14,6 +14,8 @@
 #include "fl/xymap.h"
 #include "lib8tion/scale8.h"
 #include "fl/int.h"
+#include "fl/math.h"
+#include "fl/thread_local.h"
 
 namespace fl {
 
@@ -38,6 +40,27 @@ fl::u16 xy_legacy_wrapper(fl::u16 x, fl::u16 y, fl::u16 width,
     FASTLED_UNUSED(height);
     return XY(x, y);
 }
+// Sliding-window averages divide every sum by the same window size; a
+// 32.32 fixed point reciprocal turns that into a multiply, rounded to
+// nearest.
+struct WindowDivider {
+    explicit WindowDivider(fl::u32 window)
+        : mul(((fl::u64(1) << 32) + window / 2) / window) {}
+    fl::u8 operator()(fl::u32 sum) const {
+        return fl::u8((fl::u64(sum) * mul + (fl::u64(1) << 31)) >> 32);
+    }
+    fl::u64 mul;
+};
+
+// Columns are summed in tiles this many pixels wide, so the running sums
+// and the rows being read stay in cache on wide grids.
+const fl::u16 kColumnTile = 64;
+
+BlurEngine &get_blur_engine() {
+    static ThreadLocal<BlurEngine> gBlurEngine;
+    return gBlurEngine.access();
+}
+
 } // namespace
 
 // blur1d: one-dimensional blur filter. Spreads light to 2 line neighbors.
@@ -70,7 +93,7 @@ void blur1d(CRGB *leds, fl::u16 numLeds, fract8 blur_amount) {
     }
 }
 
-void blur2d(CRGB *leds, fl::u8 width, fl::u8 height, fract8 blur_amount,
+void blur2d(CRGB *leds, fl::u16 width, fl::u16 height, fract8 blur_amount,
             const XYMap &xymap) {
     blurRows(leds, width, height, blur_amount, xymap);
     blurColumns(leds, width, height, blur_amount, xymap);
@@ -82,7 +105,7 @@ void blur2d(CRGB *leds, fl::u8 width, fl::u8 height, fract8 blur_amount) {
     blur2d(leds, width, height, blur_amount, xy);
 }
 
-void blurRows(CRGB *leds, fl::u8 width, fl::u8 height, fract8 blur_amount,
+void blurRows(CRGB *leds, fl::u16 width, fl::u16 height, fract8 blur_amount,
               const XYMap &xyMap) {
 
     /*    for( fl::u8 row = 0; row < height; row++) {
@@ -93,9 +116,9 @@ void blurRows(CRGB *leds, fl::u8 width, fl::u8 height, fract8 blur_amount,
     // blur rows same as columns, for irregular matrix
     fl::u8 keep = 255 - blur_amount;
     fl::u8 seep = blur_amount >> 1;
-    for (fl::u8 row = 0; row < height; row++) {
+    for (fl::u16 row = 0; row < height; row++) {
         CRGB carryover = CRGB::Black;
-        for (fl::u8 i = 0; i < width; i++) {
+        for (fl::u16 i = 0; i < width; i++) {
             CRGB cur = leds[xyMap.mapToIndex(i, row)];
             CRGB part = cur;
             part.nscale8(seep);
@@ -110,14 +133,14 @@ void blurRows(CRGB *leds, fl::u8 width, fl::u8 height, fract8 blur_amount,
 }
 
 // blurColumns: perform a blur1d on each column of a rectangular matrix
-void blurColumns(CRGB *leds, fl::u8 width, fl::u8 height, fract8 blur_amount,
+void blurColumns(CRGB *leds, fl::u16 width, fl::u16 height, fract8 blur_amount,
                  const XYMap &xyMap) {
     // blur columns
     fl::u8 keep = 255 - blur_amount;
     fl::u8 seep = blur_amount >> 1;
-    for (fl::u8 col = 0; col < width; ++col) {
+    for (fl::u16 col = 0; col < width; ++col) {
         CRGB carryover = CRGB::Black;
-        for (fl::u8 i = 0; i < height; ++i) {
+        for (fl::u16 i = 0; i < height; ++i) {
             CRGB cur = leds[xyMap.mapToIndex(col, i)];
             CRGB part = cur;
             part.nscale8(seep);
@@ -131,4 +154,178 @@ void blurColumns(CRGB *leds, fl::u8 width, fl::u8 height, fract8 blur_amount,
     }
 }
 
+void BlurEngine::box(CRGB *pixels, fl::u16 width, fl::u16 height,
+                     fl::u16 radius) {
+    if (radius == 0 || width == 0 || height == 0) {
+        return;
+    }
+    boxPass(pixels, width, height, radius);
+}
+
+void BlurEngine::box(CRGB *leds, const XYMap &xymap, fl::u16 radius) {
+    if (radius == 0) {
+        return;
+    }
+    CRGB *grid = gather(leds, xymap);
+    box(grid, xymap.getWidth(), xymap.getHeight(), radius);
+    scatter(leds, xymap);
+}
+
+void BlurEngine::gaussian(CRGB *pixels, fl::u16 width, fl::u16 height,
+                          float sigma) {
+    if (width == 0 || height == 0) {
+        return;
+    }
+    fl::u16 radii[3];
+    gaussianRadii(sigma, radii);
+    for (int pass = 0; pass < 3; ++pass) {
+        if (radii[pass]) {
+            boxPass(pixels, width, height, radii[pass]);
+        }
+    }
+}
+
+void BlurEngine::gaussian(CRGB *leds, const XYMap &xymap, float sigma) {
+    CRGB *grid = gather(leds, xymap);
+    gaussian(grid, xymap.getWidth(), xymap.getHeight(), sigma);
+    scatter(leds, xymap);
+}
+
+// Box widths whose three-fold convolution has the variance of a Gaussian
+// with this sigma: some passes use the odd width just below the ideal one
+// and the rest the odd width above it.
+void BlurEngine::gaussianRadii(float sigma, fl::u16 radii[3]) {
+    radii[0] = radii[1] = radii[2] = 0;
+    if (!(sigma > 0.0f)) {
+        return;
+    }
+    const float variance12 = 12.0f * sigma * sigma;
+    int lower = int(floorf(sqrtf(variance12 / 3.0f + 1.0f)));
+    if (lower % 2 == 0) {
+        --lower;
+    }
+    const int upper = lower + 2;
+    const float ideal = (variance12 - 3.0f * lower * lower - 12.0f * lower - 9.0f) /
+                        (-4.0f * lower - 4.0f);
+    const int lowerPasses = fl::clamp(int(floorf(ideal + 0.5f)), 0, 3);
+    for (int i = 0; i < 3; ++i) {
+        const int widthI = i < lowerPasses ? lower : upper;
+        radii[i] = fl::u16(FL_MIN((widthI - 1) / 2, 0xFFFF));
+    }
+}
+
+void BlurEngine::boxPass(CRGB *pixels, fl::u16 width, fl::u16 height,
+                         fl::u16 radius) {
+    mScratch.resize(fl::size(width) * height);
+    blurRowsInto(pixels, mScratch.data(), width, height, radius);
+    blurColumnsInto(mScratch.data(), pixels, width, height, radius);
+}
+
+void BlurEngine::blurRowsInto(const CRGB *src, CRGB *dst, fl::u16 width,
+                              fl::u16 height, fl::u16 radius) {
+    const int n = width;
+    const int r = radius;
+    const WindowDivider divide(2 * fl::u32(r) + 1);
+    for (fl::u16 y = 0; y < height; ++y) {
+        const fl::u8 *in = &src[fl::size(y) * width].raw[0];
+        fl::u8 *out = &dst[fl::size(y) * width].raw[0];
+        // Window at x = 0: the first pixel repeated r + 1 times, the next r
+        // pixels, and the last one standing in for any that run off the end
+        const int inside = FL_MIN(r, n - 1);
+        const fl::u32 beyond = fl::u32(r - inside);
+        fl::u32 sum[3];
+        for (int c = 0; c < 3; ++c) {
+            fl::u32 total = fl::u32(r + 1) * in[c] + beyond * in[(n - 1) * 3 + c];
+            for (int k = 1; k <= inside; ++k) {
+                total += in[k * 3 + c];
+            }
+            sum[c] = total;
+        }
+        for (int x = 0; x < n; ++x) {
+            out[x * 3 + 0] = divide(sum[0]);
+            out[x * 3 + 1] = divide(sum[1]);
+            out[x * 3 + 2] = divide(sum[2]);
+            const fl::u8 *add = in + FL_MIN(x + r + 1, n - 1) * 3;
+            const fl::u8 *sub = in + FL_MAX(x - r, 0) * 3;
+            sum[0] += fl::u32(add[0]) - sub[0];
+            sum[1] += fl::u32(add[1]) - sub[1];
+            sum[2] += fl::u32(add[2]) - sub[2];
+        }
+    }
+}
+
+void BlurEngine::blurColumnsInto(const CRGB *src, CRGB *dst, fl::u16 width,
+                                 fl::u16 height, fl::u16 radius) {
+    const int h = height;
+    const int r = radius;
+    const fl::size stride = fl::size(width) * 3;
+    const WindowDivider divide(2 * fl::u32(r) + 1);
+    const int inside = FL_MIN(r, h - 1);
+    const fl::u32 beyond = fl::u32(r - inside);
+    mSums.resize(fl::size(kColumnTile) * 3);
+    fl::u32 *sums = mSums.data();
+    const fl::u8 *in = &src[0].raw[0];
+    fl::u8 *out = &dst[0].raw[0];
+    // Every step below is a contiguous run over one tile of a row, which
+    // the compiler vectorizes
+    for (fl::u16 x0 = 0; x0 < width; x0 += kColumnTile) {
+        const fl::size len = fl::size(FL_MIN(kColumnTile, fl::u16(width - x0))) * 3;
+        const fl::u8 *column = in + fl::size(x0) * 3;
+        const fl::u8 *first = column;
+        const fl::u8 *last = column + fl::size(h - 1) * stride;
+        for (fl::size j = 0; j < len; ++j) {
+            sums[j] = fl::u32(r + 1) * first[j] + beyond * last[j];
+        }
+        for (int k = 1; k <= inside; ++k) {
+            const fl::u8 *row = column + fl::size(k) * stride;
+            for (fl::size j = 0; j < len; ++j) {
+                sums[j] += row[j];
+            }
+        }
+        for (int y = 0; y < h; ++y) {
+            fl::u8 *target = out + fl::size(y) * stride + fl::size(x0) * 3;
+            for (fl::size j = 0; j < len; ++j) {
+                target[j] = divide(sums[j]);
+            }
+            const fl::u8 *add = column + fl::size(FL_MIN(y + r + 1, h - 1)) * stride;
+            const fl::u8 *sub = column + fl::size(FL_MAX(y - r, 0)) * stride;
+            for (fl::size j = 0; j < len; ++j) {
+                sums[j] += fl::u32(add[j]) - sub[j];
+            }
+        }
+    }
+}
+
+CRGB *BlurEngine::gather(CRGB *leds, const XYMap &xymap) {
+    if (xymap.isRectangularGrid()) {
+        return leds + xymap.mapToIndex(0, 0);
+    }
+    mGrid.resize(fl::size(xymap.getWidth()) * xymap.getHeight());
+    xymap.gather(leds, mGrid.data());
+    return mGrid.data();
+}
+
+void BlurEngine::scatter(CRGB *leds, const XYMap &xymap) {
+    if (xymap.isRectangularGrid()) {
+        return;
+    }
+    xymap.scatter(mGrid.data(), leds);
+}
+
+void boxBlur2d(CRGB *pixels, fl::u16 width, fl::u16 height, fl::u16 radius) {
+    get_blur_engine().box(pixels, width, height, radius);
+}
+
+void boxBlur2d(CRGB *leds, const XYMap &xymap, fl::u16 radius) {
+    get_blur_engine().box(leds, xymap, radius);
+}
+
+void gaussianBlur2d(CRGB *pixels, fl::u16 width, fl::u16 height, float sigma) {
+    get_blur_engine().gaussian(pixels, width, height, sigma);
+}
+
+void gaussianBlur2d(CRGB *leds, const XYMap &xymap, float sigma) {
+    get_blur_engine().gaussian(leds, xymap, sigma);
+}
+
 } // namespace fl
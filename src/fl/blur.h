@@ -5,6 +5,7 @@
 #include "fl/int.h"
 #include "crgb.h"
 #include "fl/deprecated.h"
+#include "fl/vector.h"
 
 namespace fl {
 
@@ -43,7 +44,7 @@ void blur1d(CRGB *leds, u16 numLeds, fract8 blur_amount);
 /// @param width the width of the matrix
 /// @param height the height of the matrix
 /// @param blur_amount the amount of blur to apply
-void blur2d(CRGB *leds, u8 width, u8 height, fract8 blur_amount,
+void blur2d(CRGB *leds, u16 width, u16 height, fract8 blur_amount,
             const XYMap &xymap);
 
 /// Legacy version of blur2d, which does not require an XYMap but instead
@@ -58,14 +59,58 @@ void blur2d(CRGB *leds, u8 width, u8 height, fract8 blur_amount)
 /// @param width the width of the matrix
 /// @param height the height of the matrix
 /// @param blur_amount the amount of blur to apply
-void blurRows(CRGB *leds, u8 width, u8 height, fract8 blur_amount,
+void blurRows(CRGB *leds, u16 width, u16 height, fract8 blur_amount,
               const XYMap &xymap);
 
 /// Perform a blur1d() on every column of a rectangular matrix
 /// @copydetails blurRows()
-void blurColumns(CRGB *leds, u8 width, u8 height, fract8 blur_amount,
+void blurColumns(CRGB *leds, u16 width, u16 height, fract8 blur_amount,
                  const XYMap &xymap);
 
+/// Box blur: every pixel becomes the average of the (2 * radius + 1)^2
+/// square around it, with the edge pixels extended outwards. Done as a
+/// sliding-window pass over the rows and one over the columns, so the cost
+/// is O(width * height) whatever the radius.
+/// @param pixels row-major grid of width * height pixels
+void boxBlur2d(CRGB *pixels, u16 width, u16 height, u16 radius);
+/// @copydoc boxBlur2d()
+/// Layouts other than line-by-line are gathered into a grid first and
+/// scattered back once.
+void boxBlur2d(CRGB *leds, const XYMap &xymap, u16 radius);
+
+/// Gaussian blur with standard deviation `sigma` pixels, approximated by
+/// three box blurs. Like boxBlur2d(), O(width * height) for any sigma.
+void gaussianBlur2d(CRGB *pixels, u16 width, u16 height, float sigma);
+void gaussianBlur2d(CRGB *leds, const XYMap &xymap, float sigma);
+
+/// The engine behind boxBlur2d() and gaussianBlur2d(). The free functions
+/// share one per thread; keep your own to hold the scratch buffers with
+/// the effect that blurs.
+class BlurEngine {
+  public:
+    void box(CRGB *pixels, u16 width, u16 height, u16 radius);
+    void box(CRGB *leds, const XYMap &xymap, u16 radius);
+    void gaussian(CRGB *pixels, u16 width, u16 height, float sigma);
+    void gaussian(CRGB *leds, const XYMap &xymap, float sigma);
+
+    /// Radii of the three box passes approximating a Gaussian
+    static void gaussianRadii(float sigma, u16 radii[3]);
+
+  private:
+    // Rows of `pixels` into mScratch, then columns of mScratch back
+    void boxPass(CRGB *pixels, u16 width, u16 height, u16 radius);
+    void blurRowsInto(const CRGB *src, CRGB *dst, u16 width, u16 height,
+                      u16 radius);
+    void blurColumnsInto(const CRGB *src, CRGB *dst, u16 width, u16 height,
+                         u16 radius);
+    CRGB *gather(CRGB *leds, const XYMap &xymap);
+    void scatter(CRGB *leds, const XYMap &xymap);
+
+    fl::vector<CRGB> mGrid;     // gathered pixels of a mapped layout
+    fl::vector<CRGB> mScratch;  // output of the row pass
+    fl::vector<u32> mSums;      // running column sums of one tile
+};
+
 /// @} ColorBlurs
 
 } // namespace fl
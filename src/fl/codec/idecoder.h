@@ -7,6 +7,7 @@
 #include "fl/ptr.h"
 #include "fl/function.h"
 #include "fl/audio.h"
+#include "fl/geometry.h"
 #include "fx/frame.h"
 
 namespace fl {
@@ -44,11 +45,21 @@ public:
     virtual Frame getCurrentFrame() = 0;
     virtual bool hasMoreFrames() const = 0;
 
+    // The decoder's own current frame, shared rather than copied like
+    // getCurrentFrame(). The decoder may update it in place on the next
+    // decode(). Returns null if the decoder does not keep one.
+    virtual FramePtr getCurrentFramePtr() { return FramePtr(); }
+
     // Optional methods for advanced usage
     virtual fl::u32 getFrameCount() const { return 0; }
     virtual fl::u32 getCurrentFrameIndex() const { return 0; }
     virtual bool seek(fl::u32 frameIndex) { (void)frameIndex; return false; }
 
+    // Region of the current frame that changed since the previous decode.
+    // Returns false if the decoder does not track this, in which case the
+    // whole frame must be treated as dirty.
+    virtual bool getUpdatedRect(fl::rect<fl::u16>* rect) const { (void)rect; return false; }
+
     // Audio support (optional - default implementations for decoders without audio)
     virtual bool hasAudio() const { return false; }
     virtual void setAudioCallback(AudioFrameCallback callback) { (void)callback; }
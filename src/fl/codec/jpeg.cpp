@@ -27,6 +27,9 @@ JpegInfo::JpegInfo(fl::u16 w, fl::u16 h, fl::u8 comp)
 JpegConfig::JpegConfig(Quality q, PixelFormat fmt)
     : quality(q), format(fmt) {}
 
+JpegConfig::JpegConfig(fl::u16 width, fl::u16 height, PixelFormat fmt)
+    : format(fmt), target_width(width), target_height(height) {}
+
 //////////////////////////////////////////////////////////////////////////
 // JpegDecoder::Impl - PIMPL Implementation
 //////////////////////////////////////////////////////////////////////////
@@ -82,8 +85,10 @@ public:
         driver_config.max_time_per_tick_ms = progressive_config_.max_time_per_tick_ms;
         driver_->setProgressiveConfig(driver_config);
 
-        // Set scale based on quality setting
+        // Set scale based on quality setting, or let the driver derive it
+        // from the target size
         driver_->setScale(getScale());
+        driver_->setTargetSize(config_.target_width, config_.target_height);
 
         if (!driver_->beginDecodingStream(stream, config_.format)) {
             fl::string err;
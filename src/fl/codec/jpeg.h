@@ -30,8 +30,16 @@ struct JpegConfig {
     Quality quality = High;
     PixelFormat format = PixelFormat::RGB888;
 
+    // Optional output size, e.g. the LED panel resolution. When both are
+    // non-zero, quality is ignored: the decoder picks the largest native
+    // 1/2, 1/4 or 1/8 IDCT scale that still covers the target and area
+    // averages the rest while decoding. Axes never get upscaled.
+    fl::u16 target_width = 0;
+    fl::u16 target_height = 0;
+
     JpegConfig() = default;
     JpegConfig(Quality q, PixelFormat fmt = PixelFormat::RGB888);
+    JpegConfig(fl::u16 width, fl::u16 height, PixelFormat fmt = PixelFormat::RGB888);
 };
 
 // Progressive processing configuration
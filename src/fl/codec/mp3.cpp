@@ -12,6 +12,26 @@ namespace third_party {
 // Maximum PCM output: 1152 samples/channel * 2 channels = 2304 samples
 constexpr fl::size MAX_PCM_SAMPLES = 2304;
 
+// Decoded frames kept by the streaming decoder for zero-copy consumers
+constexpr fl::size PCM_RING_BLOCKS = 4;
+
+namespace {
+
+// Averages interleaved stereo into mono, or copies mono through
+void downmixToMono(const Mp3Frame& frame, fl::i16* dst) {
+    if (frame.channels == 2) {
+        for (int i = 0; i < frame.samples; i++) {
+            fl::i32 left = frame.pcm[i * 2];
+            fl::i32 right = frame.pcm[i * 2 + 1];
+            dst[i] = static_cast<fl::i16>((left + right) / 2);
+        }
+    } else {
+        fl::memcpy(dst, frame.pcm, frame.samples * sizeof(fl::i16));
+    }
+}
+
+} // namespace
+
 // Mp3HelixDecoder implementation
 Mp3HelixDecoder::Mp3HelixDecoder()
     : mPcmBuffer(nullptr), mDecoder(nullptr) {
@@ -97,26 +117,12 @@ int Mp3HelixDecoder::decodeFrame(const fl::u8** inbuf, fl::size* bytes_left) {
 fl::vector<AudioSample> Mp3HelixDecoder::decodeToAudioSamples(const fl::u8* data, fl::size len) {
     fl::vector<AudioSample> samples;
 
+    fl::vector<fl::i16> mono_pcm;
+
     decode(data, len, [&](const Mp3Frame& frame) {
-        // Convert stereo to mono by averaging channels
-        if (frame.channels == 2) {
-            fl::vector<fl::i16> mono_pcm;
-            mono_pcm.reserve(frame.samples);
-
-            for (int i = 0; i < frame.samples; i++) {
-                fl::i32 left = frame.pcm[i * 2];
-                fl::i32 right = frame.pcm[i * 2 + 1];
-                fl::i32 avg = (left + right) / 2;
-                mono_pcm.push_back(static_cast<fl::i16>(avg));
-            }
-
-            AudioSample sample(fl::span<const fl::i16>(mono_pcm.data(), mono_pcm.size()));
-            samples.push_back(sample);
-        } else {
-            // Mono audio - use directly
-            AudioSample sample(fl::span<const fl::i16>(frame.pcm, frame.samples));
-            samples.push_back(sample);
-        }
+        mono_pcm.resize(frame.samples);
+        downmixToMono(frame, mono_pcm.data());
+        samples.push_back(AudioSample(fl::span<const fl::i16>(mono_pcm.data(), mono_pcm.size())));
     });
 
     return samples;
@@ -136,6 +142,7 @@ class Mp3StreamDecoderImpl {
     fl::size getPosition() const { return mBytesProcessed; }
     void reset();
     Mp3Info getInfo() const { return mInfo; }
+    const AudioSampleRing& pcmRing() const { return mRing; }
 
   private:
     static constexpr fl::size BUFFER_SIZE = 4096;
@@ -154,12 +161,15 @@ class Mp3StreamDecoderImpl {
     bool mEndOfStream;
     Mp3Info mInfo;
     bool mHasDecodedFirstFrame;
+    AudioSampleRing mRing;
+    fl::u64 mSamplesDecoded;
 };
 
 Mp3StreamDecoderImpl::Mp3StreamDecoderImpl()
     : mStream(nullptr), mDecoder(nullptr), mBufferPos(0), mBufferFilled(0),
       mBytesProcessed(0), mHasError(false), mEndOfStream(false),
-      mHasDecodedFirstFrame(false) {
+      mHasDecodedFirstFrame(false), mRing(PCM_RING_BLOCKS, MAX_PCM_SAMPLES / 2),
+      mSamplesDecoded(0) {
     mBuffer.reserve(BUFFER_SIZE);
 }
 
@@ -191,6 +201,8 @@ bool Mp3StreamDecoderImpl::begin(fl::ByteStreamPtr stream) {
     mHasError = false;
     mEndOfStream = false;
     mHasDecodedFirstFrame = false;
+    mRing.clear();
+    mSamplesDecoded = 0;
 
     return true;
 }
@@ -225,6 +237,8 @@ void Mp3StreamDecoderImpl::reset() {
     mHasError = false;
     mEndOfStream = false;
     mHasDecodedFirstFrame = false;
+    mRing.clear();
+    mSamplesDecoded = 0;
 }
 
 bool Mp3StreamDecoderImpl::fillBuffer() {
@@ -249,7 +263,8 @@ bool Mp3StreamDecoderImpl::fillBuffer() {
         return bytesRead > 0;
     }
 
-    return mBufferFilled > mBufferPos;
+    // Nothing new; leftover bytes that did not decode will not decode now
+    return false;
 }
 
 bool Mp3StreamDecoderImpl::findAndDecodeFrame(AudioSample* out_sample) {
@@ -283,11 +298,29 @@ bool Mp3StreamDecoderImpl::findAndDecodeFrame(AudioSample* out_sample) {
 
     int result = mDecoder->decodeFrame(&decode_ptr, &decode_bytes);
 
+    // Helix reads the header before noticing the frame is incomplete; leave
+    // the frame in the buffer so it is retried once more data arrives
+    if (result == ERR_MP3_INDATA_UNDERFLOW) {
+        return false;
+    }
+
     // Update buffer position based on how many bytes were consumed
     fl::size consumed = (decode_ptr - inptr);
     mBufferPos += consumed;
     mBytesProcessed += consumed;
 
+    // A false sync that Helix rejects without consuming anything would be
+    // found again at the same spot; step past it.
+    if (result != ERR_MP3_NONE && consumed == 0) {
+        mBufferPos++;
+        mBytesProcessed++;
+    }
+
+    // Helix can accept a false sync inside audio data as an empty frame
+    if (result == 0 && (mDecoder->mFrameInfo.nChans <= 0 || mDecoder->mFrameInfo.samprate <= 0)) {
+        return false;
+    }
+
     if (result == 0) {
         // Successfully decoded a frame
         Mp3Frame frame;
@@ -310,23 +343,13 @@ bool Mp3StreamDecoderImpl::findAndDecodeFrame(AudioSample* out_sample) {
             mHasDecodedFirstFrame = true;
         }
 
-        // Convert to AudioSample (convert stereo to mono if needed)
-        if (frame.channels == 2) {
-            fl::vector<fl::i16> mono_pcm;
-            mono_pcm.reserve(frame.samples);
-
-            for (int i = 0; i < frame.samples; i++) {
-                fl::i32 left = frame.pcm[i * 2];
-                fl::i32 right = frame.pcm[i * 2 + 1];
-                fl::i32 avg = (left + right) / 2;
-                mono_pcm.push_back(static_cast<fl::i16>(avg));
-            }
-
-            *out_sample = AudioSample(fl::span<const fl::i16>(mono_pcm.data(), mono_pcm.size()));
-        } else {
-            // Mono audio - use directly
-            *out_sample = AudioSample(fl::span<const fl::i16>(frame.pcm, frame.samples));
-        }
+        // Downmix straight into the next ring block; the AudioSample shares
+        // its storage
+        const fl::u32 timestamp = static_cast<fl::u32>(mSamplesDecoded * 1000 / frame.sample_rate);
+        mSamplesDecoded += frame.samples;
+        *out_sample = mRing.push(frame.samples, timestamp, [&](fl::i16* dst) {
+            downmixToMono(frame, dst);
+        });
 
         return true;
     }
@@ -345,16 +368,20 @@ bool Mp3StreamDecoderImpl::decodeNextFrame(AudioSample* out_sample) {
         return false;
     }
 
-    // Try to decode from existing buffer
-    if (findAndDecodeFrame(out_sample)) {
-        return true;
-    }
-
-    // Need more data - try to fill buffer and decode again
-    while (fillBuffer()) {
+    // Decode from the buffer, refilling whenever no progress is made. Stops
+    // once a frame neither decodes nor gets more input, so a truncated frame
+    // at the end of the stream cannot spin forever.
+    for (;;) {
+        const fl::size pos = mBufferPos;
         if (findAndDecodeFrame(out_sample)) {
             return true;
         }
+        if (mBufferPos != pos && mBufferPos < mBufferFilled) {
+            continue;
+        }
+        if (!fillBuffer()) {
+            break;
+        }
     }
 
     // No more data available
@@ -403,6 +430,10 @@ Mp3Info Mp3Decoder::getInfo() const {
     return mImpl->getInfo();
 }
 
+const AudioSampleRing& Mp3Decoder::pcmRing() const {
+    return mImpl->pcmRing();
+}
+
 // Mp3 factory implementation
 Mp3DecoderPtr Mp3::createDecoder(fl::string* error_message) {
     FL_UNUSED(error_message);
@@ -163,6 +163,11 @@ public:
     // Get MP3 stream information (only available after decoding first frame)
     Mp3Info getInfo() const;
 
+    // Recently decoded mono PCM blocks. Samples returned by decodeNextFrame()
+    // share storage with these blocks, and FFT frames can be taken from the
+    // ring directly with pcmRing().fft().
+    const AudioSampleRing& pcmRing() const;
+
 private:
     fl::third_party::Mp3StreamDecoderImpl* mImpl;
 };
@@ -8,6 +8,7 @@
 #include "crgb.h"
 #include "fl/assert.h"
 #include "fl/math_macros.h"
+#include "fl/thread_local.h"
 #include "fl/xymap.h"
 
 #pragma GCC diagnostic push
@@ -151,6 +152,187 @@ void downscaleArbitrary(const CRGB *src, const XYMap &srcXY, CRGB *dst,
     }
 }
 
+namespace {
+
+AreaDownscaler &get_area_downscaler() {
+    static ThreadLocal<AreaDownscaler> gAreaDownscaler;
+    return gAreaDownscaler.access();
+}
+
+} // namespace
+
+void AreaDownscaler::buildFootprints(fl::u16 srcSize, fl::u16 dstSize,
+                                     Footprints *footprints,
+                                     fl::vector<fl::u32> *weights) {
+    footprints->clear();
+    weights->clear();
+    // Positions in units of 1/dstSize source pixels, so every boundary is
+    // an exact integer: destination pixel d spans [d * srcSize,
+    // (d + 1) * srcSize) and source pixel s spans [s * dstSize,
+    // (s + 1) * dstSize).
+    const fl::u32 S = srcSize;
+    const fl::u32 D = dstSize;
+    for (fl::u32 d = 0; d < D; ++d) {
+        const fl::u32 a = d * S;
+        const fl::u32 b = a + S;
+        Footprint fp;
+        fp.first = fl::u16(a / D);
+        fp.count = fl::u16((b + D - 1) / D - fp.first);
+        fp.weight = fl::u32(weights->size());
+        fl::u32 total = 0;
+        fl::u32 largest = fp.weight;
+        for (fl::u32 s = fp.first; s < fl::u32(fp.first) + fp.count; ++s) {
+            const fl::u32 overlap = FL_MIN(b, (s + 1) * D) - FL_MAX(a, s * D);
+            const fl::u32 w = (overlap << 16) / S;
+            weights->push_back(w);
+            if (w > (*weights)[largest]) {
+                largest = fl::u32(weights->size() - 1);
+            }
+            total += w;
+        }
+        // Rounding leaves the weights a little short of 65536
+        (*weights)[largest] += 65536 - total;
+        footprints->push_back(fp);
+    }
+}
+
+void AreaDownscaler::prepare(fl::u16 srcWidth, fl::u16 srcHeight,
+                             fl::u16 dstWidth, fl::u16 dstHeight) {
+    if (srcWidth == mSrcWidth && srcHeight == mSrcHeight &&
+        dstWidth == mDstWidth && dstHeight == mDstHeight) {
+        return;
+    }
+    mSrcWidth = srcWidth;
+    mSrcHeight = srcHeight;
+    mDstWidth = dstWidth;
+    mDstHeight = dstHeight;
+    const bool box = srcWidth % dstWidth == 0 && srcHeight % dstHeight == 0;
+    mBoxX = box ? fl::u16(srcWidth / dstWidth) : 0;
+    mBoxY = box ? fl::u16(srcHeight / dstHeight) : 0;
+    buildFootprints(srcWidth, dstWidth, &mColumns, &mColumnWeights);
+    buildFootprints(srcHeight, dstHeight, &mRows, &mRowWeights);
+    mRowSums.resize(fl::size(dstWidth) * 3);
+    mSums.resize(fl::size(dstWidth) * 3);
+    mOutRow.resize(dstWidth);
+}
+
+void AreaDownscaler::boxRow(const CRGB *src, fl::u16 dy, CRGB *out) {
+    const fl::u32 kx = mBoxX;
+    const fl::u32 n = kx * mBoxY;
+    fl::u32 *sums = mSums.data();
+    for (fl::size i = 0; i < mSums.size(); ++i) {
+        sums[i] = 0;
+    }
+    for (fl::u32 sy = fl::u32(dy) * mBoxY; sy < fl::u32(dy + 1) * mBoxY; ++sy) {
+        const fl::u8 *in = src[sy * mSrcWidth].raw;
+        for (fl::u16 dx = 0; dx < mDstWidth; ++dx) {
+            fl::u32 r = 0, g = 0, b = 0;
+            for (fl::u32 k = 0; k < kx; ++k) {
+                r += in[0];
+                g += in[1];
+                b += in[2];
+                in += 3;
+            }
+            sums[dx * 3] += r;
+            sums[dx * 3 + 1] += g;
+            sums[dx * 3 + 2] += b;
+        }
+    }
+    for (fl::u16 dx = 0; dx < mDstWidth; ++dx) {
+        out[dx] = CRGB(fl::u8((sums[dx * 3] + n / 2) / n),
+                       fl::u8((sums[dx * 3 + 1] + n / 2) / n),
+                       fl::u8((sums[dx * 3 + 2] + n / 2) / n));
+    }
+}
+
+void AreaDownscaler::weightedRow(const CRGB *src, fl::u16 dy, CRGB *out) {
+    fl::u32 *sums = mSums.data();
+    fl::u16 *rowSums = mRowSums.data();
+    for (fl::size i = 0; i < mSums.size(); ++i) {
+        sums[i] = 0;
+    }
+    const Footprint &rows = mRows[dy];
+    for (fl::u16 j = 0; j < rows.count; ++j) {
+        const fl::u8 *in = src[fl::u32(rows.first + j) * mSrcWidth].raw;
+        // Horizontal: 255 * 65536 fits 32 bits, kept as 8.8 in 16
+        for (fl::u16 dx = 0; dx < mDstWidth; ++dx) {
+            const Footprint &cols = mColumns[dx];
+            const fl::u32 *w = mColumnWeights.data() + cols.weight;
+            const fl::u8 *p = in + fl::u32(cols.first) * 3;
+            fl::u32 r = 0, g = 0, b = 0;
+            for (fl::u16 k = 0; k < cols.count; ++k) {
+                r += p[0] * w[k];
+                g += p[1] * w[k];
+                b += p[2] * w[k];
+                p += 3;
+            }
+            rowSums[dx * 3] = fl::u16((r + 128) >> 8);
+            rowSums[dx * 3 + 1] = fl::u16((g + 128) >> 8);
+            rowSums[dx * 3 + 2] = fl::u16((b + 128) >> 8);
+        }
+        // Vertical: 65280 * 65536 still fits 32 bits
+        const fl::u32 wy = mRowWeights[rows.weight + j];
+        for (fl::size i = 0; i < mSums.size(); ++i) {
+            sums[i] += rowSums[i] * wy;
+        }
+    }
+    for (fl::u16 dx = 0; dx < mDstWidth; ++dx) {
+        out[dx] = CRGB(fl::u8((sums[dx * 3] + (1u << 23)) >> 24),
+                       fl::u8((sums[dx * 3 + 1] + (1u << 23)) >> 24),
+                       fl::u8((sums[dx * 3 + 2] + (1u << 23)) >> 24));
+    }
+}
+
+void AreaDownscaler::downscale(const CRGB *src, fl::u16 srcWidth,
+                               fl::u16 srcHeight, CRGB *dst, fl::u16 dstWidth,
+                               fl::u16 dstHeight) {
+    if (!srcWidth || !srcHeight || !dstWidth || !dstHeight) {
+        return;
+    }
+    prepare(srcWidth, srcHeight, dstWidth, dstHeight);
+    for (fl::u16 dy = 0; dy < dstHeight; ++dy) {
+        CRGB *out = dst + fl::u32(dy) * dstWidth;
+        if (mBoxX) {
+            boxRow(src, dy, out);
+        } else {
+            weightedRow(src, dy, out);
+        }
+    }
+}
+
+void AreaDownscaler::downscale(const CRGB *src, const XYMap &srcXY, CRGB *dst,
+                               const XYMap &dstXY) {
+    const fl::u16 srcWidth = srcXY.getWidth();
+    const fl::u16 srcHeight = srcXY.getHeight();
+    const fl::u16 dstWidth = dstXY.getWidth();
+    const fl::u16 dstHeight = dstXY.getHeight();
+    if (!srcWidth || !srcHeight || !dstWidth || !dstHeight) {
+        return;
+    }
+    prepare(srcWidth, srcHeight, dstWidth, dstHeight);
+    const CRGB *grid = src + srcXY.mapToIndex(fl::u16(0), fl::u16(0));
+    if (!srcXY.isLineByLine()) {
+        mSource.resize(fl::u32(srcWidth) * srcHeight);
+        srcXY.gather(src, mSource.data());
+        grid = mSource.data();
+    }
+    for (fl::u16 dy = 0; dy < dstHeight; ++dy) {
+        CRGB *out = dstXY.isLineByLine()
+                        ? dst + dstXY.mapToIndex(fl::u16(0), dy)
+                        : mOutRow.data();
+        if (mBoxX) {
+            boxRow(grid, dy, out);
+        } else {
+            weightedRow(grid, dy, out);
+        }
+        if (!dstXY.isLineByLine()) {
+            for (fl::u16 dx = 0; dx < dstWidth; ++dx) {
+                dst[dstXY.mapToIndex(dx, dy)] = out[dx];
+            }
+        }
+    }
+}
+
 void downscale(const CRGB *src, const XYMap &srcXY, CRGB *dst,
                const XYMap &dstXY) {
     fl::u16 srcWidth = srcXY.getWidth();
@@ -180,7 +362,7 @@ void downscale(const CRGB *src, const XYMap &srcXY, CRGB *dst,
         return;
     }
 
-    downscaleArbitrary(src, srcXY, dst, dstXY);
+    get_area_downscaler().downscale(src, srcXY, dst, dstXY);
 }
 
 } // namespace fl
@@ -9,6 +9,7 @@ If you use this and find an issue then please report it.
 */
 
 #include "fl/int.h"
+#include "fl/vector.h"
 #include "crgb.h"
 
 namespace fl {
@@ -30,4 +31,55 @@ void downscaleHalf(const CRGB *src, const XYMap &srcXY, CRGB *dst,
 void downscaleArbitrary(const CRGB *src, const XYMap &srcXY, CRGB *dst,
                         const XYMap &dstXY);
 
+// Area-averaging downscaler that keeps its footprint tables between frames.
+// downscale(...) uses one per thread for sizes that are not exactly half.
+//
+// The source pixels under each destination column and row, with their
+// coverage as 16-bit weights, are computed once per size pair. A frame is
+// then a horizontal pass into 8.8 fixed-point row sums and a vertical pass
+// accumulating them in 32 bits. Integer ratios skip the weights and sum
+// boxes; a 2:1 ratio gives exactly downscaleHalf(). Other ratios stay
+// within 1 of downscaleArbitrary().
+class AreaDownscaler {
+  public:
+    void downscale(const CRGB *src, const XYMap &srcXY, CRGB *dst,
+                   const XYMap &dstXY);
+    // Row-major source and destination
+    void downscale(const CRGB *src, fl::u16 srcWidth, fl::u16 srcHeight,
+                   CRGB *dst, fl::u16 dstWidth, fl::u16 dstHeight);
+
+  private:
+    // Source pixels [first, first + count) under one destination pixel;
+    // their weights start at weights[weight] and sum to 65536
+    struct Footprint {
+        fl::u16 first;
+        fl::u16 count;
+        fl::u32 weight;
+    };
+    typedef fl::vector<Footprint> Footprints;
+
+    void prepare(fl::u16 srcWidth, fl::u16 srcHeight, fl::u16 dstWidth,
+                 fl::u16 dstHeight);
+    static void buildFootprints(fl::u16 srcSize, fl::u16 dstSize,
+                                Footprints *footprints,
+                                fl::vector<fl::u32> *weights);
+    void boxRow(const CRGB *src, fl::u16 dy, CRGB *out);
+    void weightedRow(const CRGB *src, fl::u16 dy, CRGB *out);
+
+    fl::u16 mSrcWidth = 0;
+    fl::u16 mSrcHeight = 0;
+    fl::u16 mDstWidth = 0;
+    fl::u16 mDstHeight = 0;
+    fl::u16 mBoxX = 0;  // source pixels per destination pixel when the
+    fl::u16 mBoxY = 0;  // ratio is an integer on both axes, else 0
+    Footprints mColumns;
+    Footprints mRows;
+    fl::vector<fl::u32> mColumnWeights;
+    fl::vector<fl::u32> mRowWeights;
+    fl::vector<fl::u16> mRowSums;   // horizontal pass, 8.8 per channel
+    fl::vector<fl::u32> mSums;      // vertical accumulation per channel
+    fl::vector<CRGB> mSource;       // source gathered out of its XYMap
+    fl::vector<CRGB> mOutRow;
+};
+
 } // namespace fl
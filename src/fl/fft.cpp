@@ -42,6 +42,89 @@ void FFT::run(const span<const fl::i16> &sample, FFTBins *out,
     get_or_create(args2).run(sample, out);
 }
 
+void FFT::transform(const span<const fl::i16> &sample, FFTSpectrum *out) {
+    // Any band layout with this sample size computes the same spectrum
+    get_or_create(FFT_Args(static_cast<int>(sample.size()))).transform(sample, out);
+}
+
+void FFT::bands(const FFTSpectrum &spectrum, FFTBins *out,
+                const FFT_Args &args) {
+    FFT_Args args2 = args;
+    args2.samples = spectrum.samples;
+    get_or_create(args2).bands(spectrum, out);
+}
+
+void FFT::transformBatch(span<const span<const fl::i16>> blocks,
+                         FFTSpectrumBatch *out) {
+    out->streams = blocks.size();
+    out->samples = blocks.empty() ? 0 : blocks[0].size();
+    const fl::size streams = out->streams;
+    const fl::size bins = out->binCount();
+    out->re.resize(bins * streams);
+    out->im.resize(bins * streams);
+    if (bins == 0) {
+        return;
+    }
+    // One plan for every stream; each spectrum is scattered into its column
+    FFTImpl &impl = get_or_create(FFT_Args(static_cast<int>(out->samples)));
+    FFTSpectrum &spectrum = mBatchScratch;
+    for (fl::size s = 0; s < streams; ++s) {
+        if (!impl.transform(blocks[s], &spectrum).ok) {
+            // Block size differs from the first stream's; already warned
+            spectrum.bins.assign(bins * 2, 0);
+        }
+        const fl::i16 *src = spectrum.bins.data();
+        fl::i16 *re = out->re.data() + s;
+        fl::i16 *im = out->im.data() + s;
+        for (fl::size k = 0; k < bins; ++k) {
+            re[k * streams] = src[2 * k];
+            im[k * streams] = src[2 * k + 1];
+        }
+    }
+}
+
+void FFT::bandsBatch(const FFTSpectrumBatch &batch,
+                     fl::vector<float> *magnitudes, const FFT_Args &args) {
+    magnitudes->assign(fl::size(args.bands) * batch.streams, 0.0f);
+    if (batch.streams == 0 || batch.samples == 0) {
+        return;
+    }
+    FFT_Args args2 = args;
+    args2.samples = static_cast<int>(batch.samples);
+    get_or_create(args2).bandsBatch(batch, magnitudes->data());
+}
+
+void FFTSpectrumBatch::extract(fl::size stream, FFTSpectrum *out) const {
+    const fl::size bins = binCount();
+    out->samples = samples;
+    out->bins.resize(bins * 2);
+    for (fl::size k = 0; k < bins; ++k) {
+        out->bins[2 * k] = re[k * streams + stream];
+        out->bins[2 * k + 1] = im[k * streams + stream];
+    }
+}
+
+void FFTSpectrumBatch::mix(span<const float> weights, FFTSpectrum *out) const {
+    const fl::size bins = binCount();
+    const fl::size n = weights.size() < streams ? weights.size() : streams;
+    out->samples = samples;
+    out->bins.resize(bins * 2);
+    for (fl::size k = 0; k < bins; ++k) {
+        const fl::i16 *r = re.data() + k * streams;
+        const fl::i16 *i = im.data() + k * streams;
+        float sumR = 0.0f;
+        float sumI = 0.0f;
+        for (fl::size s = 0; s < n; ++s) {
+            sumR += weights[s] * r[s];
+            sumI += weights[s] * i[s];
+        }
+        sumR = sumR > 32767.0f ? 32767.0f : (sumR < -32768.0f ? -32768.0f : sumR);
+        sumI = sumI > 32767.0f ? 32767.0f : (sumI < -32768.0f ? -32768.0f : sumI);
+        out->bins[2 * k] = static_cast<fl::i16>(sumR + (sumR < 0.0f ? -0.5f : 0.5f));
+        out->bins[2 * k + 1] = static_cast<fl::i16>(sumI + (sumI < 0.0f ? -0.5f : 0.5f));
+    }
+}
+
 void FFT::clear() { mMap->clear(); }
 
 fl::size FFT::size() const { return mMap->size(); }
@@ -58,6 +58,33 @@ struct FFTBins {
     fl::size mSize;
 };
 
+// Complex spectrum of one block of samples, computed once and shared between
+// band layouts (see FFT::transform / FFT::bands). Holds samples / 2 + 1 bins
+// as interleaved real/imaginary Q15 pairs.
+struct FFTSpectrum {
+    fl::vector<i16> bins;
+    fl::size samples = 0;
+};
+
+// Spectra of several equally sized blocks, one per input stream, stored as
+// structure-of-arrays: the real (and imaginary) parts of bin k for every
+// stream sit next to each other, so per-bin work over the streams runs as
+// one contiguous loop.
+struct FFTSpectrumBatch {
+    fl::vector<i16> re;  // re[bin * streams + stream], Q15
+    fl::vector<i16> im;
+    fl::size samples = 0;
+    fl::size streams = 0;
+
+    fl::size binCount() const { return samples ? samples / 2 + 1 : 0; }
+    // One stream as a regular interleaved spectrum
+    void extract(fl::size stream, FFTSpectrum *out) const;
+    // Weighted sum of the streams. The transform is linear, so this is the
+    // spectrum of the equally weighted PCM mixdown, up to Q15 rounding and
+    // clipping.
+    void mix(span<const float> weights, FFTSpectrum *out) const;
+};
+
 struct FFT_Args {
     static int DefaultSamples() { return 512; }
     static int DefaultBands() { return 16; }
@@ -108,6 +135,21 @@ class FFT {
             void run(const span<const i16> &sample, FFTBins *out,
              const FFT_Args &args = FFT_Args());
 
+    // Same result as run(), split so that one transform can feed several band
+    // layouts: transform() once per block, then bands() per layout.
+    void transform(const span<const i16> &sample, FFTSpectrum *out);
+    void bands(const FFTSpectrum &spectrum, FFTBins *out,
+               const FFT_Args &args = FFT_Args());
+
+    // Batched transform()/bands() for several streams of the same block
+    // size. The streams share one FFT plan and one pass over each band
+    // kernel; `magnitudes` receives bins_raw of every stream band-major,
+    // magnitudes[band * streams + stream], bit-identical to bands().
+    void transformBatch(span<const span<const i16>> blocks,
+                        FFTSpectrumBatch *out);
+    void bandsBatch(const FFTSpectrumBatch &batch, fl::vector<float> *magnitudes,
+                    const FFT_Args &args = FFT_Args());
+
     void clear();
     fl::size size() const;
 
@@ -120,6 +162,8 @@ class FFT {
     FFTImpl &get_or_create(const FFT_Args &args);
     struct HashMap;
     scoped_ptr<HashMap> mMap;
+    // One stream's spectrum on its way into a batch
+    FFTSpectrum mBatchScratch;
 };
 
 }; // namespace fl
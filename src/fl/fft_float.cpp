@@ -0,0 +1,100 @@
+#include "fl/fft_float.h"
+
+#include "fl/math.h"
+#include "fl/type_traits.h"
+
+namespace fl {
+
+bool FFTFloat::supports(fl::size samples) {
+    // The bit reversal table stores complex indices in 16 bits
+    return samples >= 4 && samples <= (fl::size(1) << 17) &&
+           (samples & (samples - 1)) == 0;
+}
+
+FFTFloat::FFTFloat(fl::size samples) {
+    if (!supports(samples)) {
+        return;
+    }
+    mSamples = samples;
+    mHalf = samples / 2;
+
+    mTwiddles.resize(2 * mHalf);
+    for (fl::size k = 0; k < mHalf; k++) {
+        const float angle =
+            2.0f * FL_PI * static_cast<float>(k) / static_cast<float>(samples);
+        mTwiddles[2 * k] = cosf(angle);
+        mTwiddles[2 * k + 1] = -sinf(angle);
+    }
+
+    int bits = 0;
+    while ((fl::size(1) << bits) < mHalf) {
+        bits++;
+    }
+    mBitReverse.resize(mHalf);
+    for (fl::size i = 0; i < mHalf; i++) {
+        fl::size reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        mBitReverse[i] = static_cast<u16>(reversed);
+    }
+}
+
+void FFTFloat::run(float *data, float *out) const {
+    // The real values are read as mHalf complex ones (even samples real, odd
+    // samples imaginary), transformed with an iterative radix-2 FFT, then
+    // split into the real spectrum.
+    const fl::size n = mSamples;
+    const fl::size half = mHalf;
+    const float *tw = mTwiddles.data();
+
+    for (fl::size i = 0; i < half; i++) {
+        const fl::size j = mBitReverse[i];
+        if (j > i) {
+            fl::swap(data[2 * i], data[2 * j]);
+            fl::swap(data[2 * i + 1], data[2 * j + 1]);
+        }
+    }
+
+    for (fl::size len = 2; len <= half; len <<= 1) {
+        const fl::size step = n / len;  // W_len^j = W_n^(j * step)
+        const fl::size halfLen = len / 2;
+        for (fl::size start = 0; start < half; start += len) {
+            for (fl::size j = 0; j < halfLen; j++) {
+                const float wr = tw[2 * j * step];
+                const float wi = tw[2 * j * step + 1];
+                float *a = data + 2 * (start + j);
+                float *b = data + 2 * (start + j + halfLen);
+                const float tr = b[0] * wr - b[1] * wi;
+                const float ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+
+    // X[k] = E[k] + W_n^k O[k], with E = (Z[k] + conj(Z[half - k])) / 2
+    // and O = -i (Z[k] - conj(Z[half - k])) / 2
+    out[0] = data[0] + data[1];
+    out[1] = 0.0f;
+    out[2 * half] = data[0] - data[1];
+    out[2 * half + 1] = 0.0f;
+    for (fl::size k = 1; k < half; k++) {
+        const float zr = data[2 * k];
+        const float zi = data[2 * k + 1];
+        const float cr = data[2 * (half - k)];
+        const float ci = -data[2 * (half - k) + 1];
+        const float er = 0.5f * (zr + cr);
+        const float ei = 0.5f * (zi + ci);
+        const float odr = 0.5f * (zi - ci);
+        const float odi = -0.5f * (zr - cr);
+        const float wr = tw[2 * k];
+        const float wi = tw[2 * k + 1];
+        out[2 * k] = er + odr * wr - odi * wi;
+        out[2 * k + 1] = ei + odr * wi + odi * wr;
+    }
+}
+
+} // namespace fl
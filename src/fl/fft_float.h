@@ -0,0 +1,46 @@
+#pragma once
+
+#include "fl/int.h"
+#include "fl/vector.h"
+
+namespace fl {
+
+// Float real FFT for power of two block sizes, for analysis that needs more
+// dynamic range than the 16 bit kiss_fftr / FFTQ15 paths behind FFTImpl
+// (e.g. autocorrelation through the power spectrum). The N real samples are
+// packed into an N/2 point complex FFT computed with radix-2 butterflies,
+// then split into the N/2 + 1 bins of the real spectrum. The output is the
+// unscaled DFT.
+//
+// Twiddles and the bit reversal table are built once per size.
+//
+// Example:
+//   FFTFloat fft(1024);
+//   fl::vector<float> bins(fft.outputSize());
+//   fft.run(block, bins.data());  // bins = {re0, im0, re1, im1, ...}
+class FFTFloat {
+  public:
+    FFTFloat() = default;
+    explicit FFTFloat(fl::size samples);
+
+    static bool supports(fl::size samples);
+
+    bool ok() const { return mSamples != 0; }
+    fl::size samples() const { return mSamples; }
+    // Number of floats written by run(): N/2 + 1 interleaved re/im pairs.
+    fl::size outputSize() const { return mSamples + 2; }
+
+    // `data` holds samples() values and is used as the working buffer, so it
+    // is overwritten. `out` must hold outputSize() values.
+    void run(float *data, float *out) const;
+
+  private:
+    fl::size mSamples = 0;
+    fl::size mHalf = 0;  // complex FFT size, samples / 2
+    // W_N^k as interleaved (cos, -sin) pairs for k < N/2
+    fl::vector<float> mTwiddles;
+    // Bit reversed position of each complex input
+    fl::vector<u16> mBitReverse;
+};
+
+} // namespace fl
@@ -20,6 +20,7 @@
 #include "fl/audio.h"
 #include "fl/fft.h"
 #include "fl/fft_impl.h"
+#include "fl/fft_q15.h"
 #include "fl/str.h"
 #include "fl/unused.h"
 #include "fl/vector.h"
@@ -39,10 +40,18 @@
 
 namespace fl {
 
+// FFTSpectrum stores kiss_fft_cpx values as interleaved i16 pairs.
+static_assert(sizeof(kiss_fft_cpx) == 2 * sizeof(i16),
+              "FFTSpectrum expects a 16 bit fixed point kiss_fft_cpx");
+
 class FFTContext {
   public:
     FFTContext(int samples, int bands, float fmin, float fmax, int sample_rate)
-        : m_fftr_cfg(nullptr), m_kernels(nullptr) {
+        : m_fftr_cfg(nullptr), m_kernels(nullptr)
+#if FASTLED_FFT_Q15
+        , m_q15(samples)
+#endif
+    {
         fl::memset(&m_cq_cfg, 0, sizeof(m_cq_cfg));
         m_cq_cfg.samples = samples;
         m_cq_cfg.bands = bands;
@@ -50,8 +59,14 @@ class FFTContext {
         m_cq_cfg.fmax = fmax;
         m_cq_cfg.fs = sample_rate;
         m_cq_cfg.min_val = MIN_VAL;
-        m_fftr_cfg = kiss_fftr_alloc(samples, 0, nullptr, nullptr);
-        if (!m_fftr_cfg) {
+#if FASTLED_FFT_Q15
+        // Sizes the Q15 engine does not cover fall back to kiss_fftr
+        if (!m_q15.ok())
+#endif
+        {
+            m_fftr_cfg = kiss_fftr_alloc(samples, 0, nullptr, nullptr);
+        }
+        if (!m_fftr_cfg && !usesQ15()) {
             FASTLED_WARN("Failed to allocate FFTImpl context");
             return;
         }
@@ -72,13 +87,29 @@ class FFTContext {
 
         // FASTLED_ASSERT(512 == m_cq_cfg.samples, "FFTImpl samples mismatch and
         // are still hardcoded to 512");
-        out->clear();
         // allocate
         FASTLED_STACK_ARRAY(kiss_fft_cpx, fft, m_cq_cfg.samples);
-        FASTLED_STACK_ARRAY(kiss_fft_cpx, cq, m_cq_cfg.bands);
         // initialize
+        transform(buffer, fft);
+        bands(fft, out);
+    }
+
+    // Real FFT of one block. Writes samples / 2 + 1 complex bins, which is
+    // everything the cq kernels read.
+    void transform(span<const i16> buffer, kiss_fft_cpx *fft) {
+#if FASTLED_FFT_Q15
+        if (usesQ15()) {
+            m_q15.run(buffer, reinterpret_cast<i16 *>(fft));
+            return;
+        }
+#endif
         kiss_fftr(m_fftr_cfg, buffer.data(), fft);
-        apply_kernels(fft, cq, m_kernels, m_cq_cfg);
+    }
+
+    void bands(const kiss_fft_cpx *fft, FFTBins *out) {
+        out->clear();
+        FASTLED_STACK_ARRAY(cq_sum, cq, m_cq_cfg.bands);
+        apply_kernels_q15(fft, cq);
         const float maxf = m_cq_cfg.fmax;
         const float minf = m_cq_cfg.fmin;
         const float delta_f = (maxf - minf) / m_cq_cfg.bands;
@@ -89,9 +120,10 @@ class FFTContext {
             // Widen to 32-bit to preserve fixed-point scaling during multiplication
             i32 real = cq[i].r;
             i32 imag = cq[i].i;
-            // Calculate magnitude - multiply as integers to preserve Q15 scaling
-            float r2 = float(real * real);
-            float i2 = float(imag * imag);
+            // Squares are exact in float for |x| < 2^24, matching the old
+            // integer multiply without overflowing on wide sums.
+            float r2 = float(real) * float(real);
+            float i2 = float(imag) * float(imag);
             float magnitude = sqrt(r2 + i2);
 
             // Integer multiplication preserves the Q15 fixed-point scale.
@@ -115,6 +147,38 @@ class FFTContext {
         }
     }
 
+    // bands() for every stream of a structure-of-arrays batch. Each kernel
+    // element is loaded once and applied to all streams, with the same
+    // per-product rounding as apply_kernels_q15().
+    void bandsBatch(const i16 *re, const i16 *im, fl::size streams,
+                    float *out) {
+        FASTLED_STACK_ARRAY(i32, sumR, streams);
+        FASTLED_STACK_ARRAY(i32, sumI, streams);
+        for (int i = 0; i < m_cq_cfg.bands; ++i) {
+            const sparse_arr &kernel = m_kernels[i];
+            for (fl::size s = 0; s < streams; ++s) {
+                sumR[s] = 0;
+                sumI[s] = 0;
+            }
+            for (int j = 0; j < kernel.n_elems; ++j) {
+                const i32 br = kernel.elems[j].val.r;
+                const i32 bi = kernel.elems[j].val.i;
+                const i16 *ar = re + fl::size(kernel.elems[j].n) * streams;
+                const i16 *ai = im + fl::size(kernel.elems[j].n) * streams;
+                for (fl::size s = 0; s < streams; ++s) {
+                    sumR[s] += (i32(ar[s]) * br - i32(ai[s]) * bi + (1 << 14)) >> 15;
+                    sumI[s] += (i32(ar[s]) * bi + i32(ai[s]) * br + (1 << 14)) >> 15;
+                }
+            }
+            float *row = out + fl::size(i) * streams;
+            for (fl::size s = 0; s < streams; ++s) {
+                float r2 = float(sumR[s]) * float(sumR[s]);
+                float i2 = float(sumI[s]) * float(sumI[s]);
+                row[s] = sqrt(r2 + i2);
+            }
+        }
+    }
+
     fl::string info() const {
         // Calculate frequency delta
         float delta_f = (m_cq_cfg.fmax - m_cq_cfg.fmin) / m_cq_cfg.bands;
@@ -131,9 +195,44 @@ class FFTContext {
     }
 
   private:
+    struct cq_sum {
+        i32 r;
+        i32 i;
+    };
+
+    // Fixed point equivalent of apply_kernels(): each product is rounded to
+    // Q15 as C_MUL does, but the sum is kept in 32 bits so loud bands no
+    // longer wrap around.
+    void apply_kernels_q15(const kiss_fft_cpx *fft, cq_sum *cq) const {
+        for (int i = 0; i < m_cq_cfg.bands; ++i) {
+            const sparse_arr &kernel = m_kernels[i];
+            i32 r = 0;
+            i32 im = 0;
+            for (int j = 0; j < kernel.n_elems; ++j) {
+                const kiss_fft_cpx &a = fft[kernel.elems[j].n];
+                const kiss_fft_cpx &b = kernel.elems[j].val;
+                r += (i32(a.r) * b.r - i32(a.i) * b.i + (1 << 14)) >> 15;
+                im += (i32(a.r) * b.i + i32(a.i) * b.r + (1 << 14)) >> 15;
+            }
+            cq[i].r = r;
+            cq[i].i = im;
+        }
+    }
+
+    bool usesQ15() const {
+#if FASTLED_FFT_Q15
+        return m_q15.ok();
+#else
+        return false;
+#endif
+    }
+
     kiss_fftr_cfg m_fftr_cfg;
     cq_kernels_t m_kernels;
     cq_kernel_cfg m_cq_cfg;
+#if FASTLED_FFT_Q15
+    FFTQ15 m_q15;
+#endif
 };
 
 FFTImpl::FFTImpl(const FFT_Args &args) {
@@ -177,4 +276,46 @@ FFTImpl::Result FFTImpl::run(span<const i16> sample, FFTBins *out) {
     return FFTImpl::Result(true, "");
 }
 
+FFTImpl::Result FFTImpl::transform(span<const i16> sample, FFTSpectrum *out) {
+    if (!mContext) {
+        return FFTImpl::Result(false, "FFTImpl context is not initialized");
+    }
+    if (sample.size() != mContext->sampleSize()) {
+        FASTLED_WARN("FFTImpl sample size mismatch");
+        return FFTImpl::Result(false, "FFTImpl sample size mismatch");
+    }
+    out->samples = sample.size();
+    out->bins.resize((sample.size() / 2 + 1) * 2);
+    mContext->transform(sample,
+                        reinterpret_cast<kiss_fft_cpx *>(out->bins.data()));
+    return FFTImpl::Result(true, "");
+}
+
+FFTImpl::Result FFTImpl::bands(const FFTSpectrum &spectrum, FFTBins *out) {
+    if (!mContext) {
+        return FFTImpl::Result(false, "FFTImpl context is not initialized");
+    }
+    if (spectrum.samples != mContext->sampleSize()) {
+        FASTLED_WARN("FFTImpl spectrum size mismatch");
+        return FFTImpl::Result(false, "FFTImpl spectrum size mismatch");
+    }
+    mContext->bands(
+        reinterpret_cast<const kiss_fft_cpx *>(spectrum.bins.data()), out);
+    return FFTImpl::Result(true, "");
+}
+
+FFTImpl::Result FFTImpl::bandsBatch(const FFTSpectrumBatch &batch,
+                                    float *magnitudes) {
+    if (!mContext) {
+        return FFTImpl::Result(false, "FFTImpl context is not initialized");
+    }
+    if (batch.samples != mContext->sampleSize()) {
+        FASTLED_WARN("FFTImpl spectrum size mismatch");
+        return FFTImpl::Result(false, "FFTImpl spectrum size mismatch");
+    }
+    mContext->bandsBatch(batch.re.data(), batch.im.data(), batch.streams,
+                         magnitudes);
+    return FFTImpl::Result(true, "");
+}
+
 } // namespace fl
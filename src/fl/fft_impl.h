@@ -11,6 +11,8 @@ namespace fl {
 class AudioSample;
 class FFTContext;
 struct FFT_Args;
+struct FFTSpectrum;
+struct FFTSpectrumBatch;
 
 // Example:
 //   FFTImpl fft(512, 16);
@@ -35,6 +37,13 @@ class FFTImpl {
     // constructor.
     Result run(const AudioSample &sample, FFTBins *out);
     Result run(span<const i16> sample, FFTBins *out);
+    // run() split in two: transform() computes the spectrum of a block and
+    // bands() applies this FFTImpl's band kernels to it. bands() accepts a
+    // spectrum from any FFTImpl with the same sample size.
+    Result transform(span<const i16> sample, FFTSpectrum *out);
+    Result bands(const FFTSpectrum &spectrum, FFTBins *out);
+    // Band magnitudes of every stream in a batch, band-major
+    Result bandsBatch(const FFTSpectrumBatch &batch, float *magnitudes);
     // Info on what the frequency the bins represent
     fl::string info() const;
 
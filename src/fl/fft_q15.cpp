@@ -0,0 +1,203 @@
+#include "fl/fft_q15.h"
+
+namespace fl {
+
+namespace {
+
+// sin(2 * pi * i / 1024) in Q15 for i = 0..256. Every supported size reads
+// its twiddles from this table with a stride of 1024 / N.
+const i16 kQuarterSine[257] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+    2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+    4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+    7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+    9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767,
+};
+
+// Rounds a Q30 product sum back to Q15
+inline i32 roundQ15(i32 x) { return (x + (1 << 14)) >> 15; }
+
+inline i16 clampI16(i32 x) {
+    return static_cast<i16>(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
+
+// cos / sin of 2 * pi * t / 1024 for t in [0, 768)
+void sineCosine(fl::size t, i16 *cosOut, i16 *sinOut) {
+    if (t <= 256) {
+        *sinOut = kQuarterSine[t];
+        *cosOut = kQuarterSine[256 - t];
+    } else if (t <= 512) {
+        *sinOut = kQuarterSine[512 - t];
+        *cosOut = static_cast<i16>(-kQuarterSine[t - 256]);
+    } else {
+        *sinOut = static_cast<i16>(-kQuarterSine[t - 512]);
+        *cosOut = static_cast<i16>(-kQuarterSine[768 - t]);
+    }
+}
+
+int log2OfPowerOfTwo(fl::size n) {
+    int bits = 0;
+    while ((fl::size(1) << bits) < n) {
+        ++bits;
+    }
+    return bits;
+}
+
+} // namespace
+
+bool FFTQ15::supports(fl::size samples) {
+    return samples >= 4 && samples <= MaxSamples() &&
+           (samples & (samples - 1)) == 0;
+}
+
+FFTQ15::FFTQ15(fl::size samples) {
+    if (!supports(samples)) {
+        return;
+    }
+    mSamples = samples;
+    mHalf = samples / 2;
+
+    const fl::size step = MaxSamples() / samples;
+    const fl::size count = samples * 3 / 4;
+    mTwiddles.resize(count * 2);
+    for (fl::size k = 0; k < count; ++k) {
+        i16 c, s;
+        sineCosine(k * step, &c, &s);
+        mTwiddles[2 * k] = c;
+        mTwiddles[2 * k + 1] = static_cast<i16>(-s);
+    }
+
+    const int bits = log2OfPowerOfTwo(mHalf);
+    mBitReverse.resize(mHalf);
+    for (fl::size i = 0; i < mHalf; ++i) {
+        fl::size r = 0;
+        for (int b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        mBitReverse[i] = static_cast<u16>(r);
+    }
+}
+
+void FFTQ15::run(span<const i16> in, i16 *out) const {
+    if (!ok() || in.size() != mSamples) {
+        return;
+    }
+    // Pack pairs of real samples as complex values in bit reversed order
+    const i16 *src = in.data();
+    for (fl::size n = 0; n < mHalf; ++n) {
+        const fl::size dst = 2 * mBitReverse[n];
+        out[dst] = src[2 * n];
+        out[dst + 1] = src[2 * n + 1];
+    }
+    butterflies(out);
+    split(out);
+}
+
+void FFTQ15::butterflies(i16 *d) const {
+    const fl::size m = mHalf;
+    const i16 *tw = mTwiddles.data();
+    fl::size h = 1;
+    if (log2OfPowerOfTwo(m) & 1) {
+        // Odd number of radix-2 stages: do one on its own first
+        for (fl::size j = 0; j < 2 * m; j += 4) {
+            const i32 ar = d[j], ai = d[j + 1];
+            const i32 br = d[j + 2], bi = d[j + 3];
+            d[j] = static_cast<i16>((ar + br + 1) >> 1);
+            d[j + 1] = static_cast<i16>((ai + bi + 1) >> 1);
+            d[j + 2] = static_cast<i16>((ar - br + 1) >> 1);
+            d[j + 3] = static_cast<i16>((ai - bi + 1) >> 1);
+        }
+        h = 2;
+    }
+    // Radix-4 stages combine four size h DFTs into one of size 4h:
+    //   X[k + qh] = A + w^2k B + w^k C + w^3k D  (rotated by -j per quarter)
+    for (; h < m; h *= 4) {
+        const fl::size q = 4 * h;
+        // W_M^x = W_N^2x, and the block twiddle is W_q = W_M^(m/q)
+        const fl::size stride = 2 * (m / q);
+        for (fl::size j = 0; j < m; j += q) {
+            for (fl::size k = 0; k < h; ++k) {
+                i16 *a = d + 2 * (j + k);
+                i16 *b = a + 2 * h;
+                i16 *c = b + 2 * h;
+                i16 *e = c + 2 * h;
+                const i16 *w1 = tw + 2 * (k * stride);
+                const i16 *w2 = tw + 2 * (2 * k * stride);
+                const i16 *w3 = tw + 2 * (3 * k * stride);
+
+                const i32 ar = a[0], ai = a[1];
+                const i32 br = roundQ15(b[0] * w2[0] - b[1] * w2[1]);
+                const i32 bi = roundQ15(b[0] * w2[1] + b[1] * w2[0]);
+                const i32 cr = roundQ15(c[0] * w1[0] - c[1] * w1[1]);
+                const i32 ci = roundQ15(c[0] * w1[1] + c[1] * w1[0]);
+                const i32 er = roundQ15(e[0] * w3[0] - e[1] * w3[1]);
+                const i32 ei = roundQ15(e[0] * w3[1] + e[1] * w3[0]);
+
+                const i32 s0r = ar + br, s0i = ai + bi;
+                const i32 s1r = ar - br, s1i = ai - bi;
+                const i32 s2r = cr + er, s2i = ci + ei;
+                const i32 s3r = cr - er, s3i = ci - ei;
+
+                // Scale by 1/4 per stage so the sums stay in range
+                a[0] = static_cast<i16>((s0r + s2r + 2) >> 2);
+                a[1] = static_cast<i16>((s0i + s2i + 2) >> 2);
+                c[0] = static_cast<i16>((s0r - s2r + 2) >> 2);
+                c[1] = static_cast<i16>((s0i - s2i + 2) >> 2);
+                // -j * s3 = (s3i, -s3r)
+                b[0] = static_cast<i16>((s1r + s3i + 2) >> 2);
+                b[1] = static_cast<i16>((s1i - s3r + 2) >> 2);
+                e[0] = static_cast<i16>((s1r - s3i + 2) >> 2);
+                e[1] = static_cast<i16>((s1i + s3r + 2) >> 2);
+            }
+        }
+    }
+}
+
+void FFTQ15::split(i16 *d) const {
+    // Z = FFT(x[2n] + j x[2n+1]) / M. Unpack the real spectrum
+    //   X[k] = (Z[k] + conj(Z[M-k])) / 2 - j W_N^k (Z[k] - conj(Z[M-k])) / 2
+    // scaled by a further 1/2 so the result is DFT / N.
+    const fl::size m = mHalf;
+    const i32 z0r = d[0], z0i = d[1];
+    d[0] = static_cast<i16>((z0r + z0i + 1) >> 1);
+    d[1] = 0;
+    d[2 * m] = static_cast<i16>((z0r - z0i + 1) >> 1);
+    d[2 * m + 1] = 0;
+
+    for (fl::size k = 1; k <= m / 2; ++k) {
+        i16 *pk = d + 2 * k;
+        i16 *pnk = d + 2 * (m - k);
+        const i32 f1r = (pk[0] + pnk[0] + 1) >> 1;
+        const i32 f1i = (pk[1] - pnk[1] + 1) >> 1;
+        const i32 f2r = (pk[0] - pnk[0] + 1) >> 1;
+        const i32 f2i = (pk[1] + pnk[1] + 1) >> 1;
+        // -j * W_N^k = (-sin, -cos) = (tw.i, -tw.r)
+        const i32 wr = mTwiddles[2 * k + 1];
+        const i32 wi = -mTwiddles[2 * k];
+        const i32 tr = roundQ15(f2r * wr - f2i * wi);
+        const i32 ti = roundQ15(f2r * wi + f2i * wr);
+        pk[0] = clampI16((f1r + tr + 1) >> 1);
+        pk[1] = clampI16((f1i + ti + 1) >> 1);
+        pnk[0] = clampI16((f1r - tr + 1) >> 1);
+        pnk[1] = clampI16((ti - f1i + 1) >> 1);
+    }
+}
+
+} // namespace fl
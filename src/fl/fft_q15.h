@@ -0,0 +1,60 @@
+#pragma once
+
+#include "fl/int.h"
+#include "fl/span.h"
+#include "fl/vector.h"
+
+// Selects the real FFT behind FFTImpl. 0 uses kiss_fftr; 1 uses FFTQ15 below,
+// an integer only engine meant for targets without a fast FPU (ESP32-C3,
+// RP2040). Band kernels are shared, so both produce the same FFTBins layout
+// and scale, though not bit-identical values.
+#ifndef FASTLED_FFT_Q15
+#define FASTLED_FFT_Q15 0
+#endif
+
+namespace fl {
+
+// In-place fixed-point real FFT for power of two block sizes up to
+// FFTQ15::MaxSamples(). The N real samples are packed into an N/2 point
+// complex FFT computed with radix-4 butterflies (plus one radix-2 stage when
+// log2(N/2) is odd), then split into the N/2 + 1 bins of the real spectrum.
+// Every stage scales down by its radix so nothing overflows; the output is
+// DFT / N in Q15, the same scale kiss_fftr produces in fixed point.
+//
+// Twiddles come from a constant quarter wave sine table covering every size
+// up to MaxSamples(), so construction does no trig.
+//
+// Example:
+//   FFTQ15 fft(512);
+//   fl::vector<i16> bins(fft.outputSize());
+//   fft.run(pcm, bins.data());  // bins = {re0, im0, re1, im1, ...}
+class FFTQ15 {
+  public:
+    explicit FFTQ15(fl::size samples);
+
+    static fl::size MaxSamples() { return 1024; }
+    static bool supports(fl::size samples);
+
+    bool ok() const { return mSamples != 0; }
+    fl::size samples() const { return mSamples; }
+    // Number of i16 values written by run(): N/2 + 1 interleaved re/im pairs.
+    fl::size outputSize() const { return mSamples + 2; }
+
+    // `in` must hold samples() values. `out` must hold outputSize() values
+    // and is used as the working buffer.
+    void run(span<const i16> in, i16 *out) const;
+
+  private:
+    void butterflies(i16 *data) const;
+    void split(i16 *data) const;
+
+    fl::size mSamples = 0;
+    fl::size mHalf = 0;  // complex FFT size, samples / 2
+    // W_N^k as interleaved (cos, -sin) Q15 pairs for k < 3N/4, which covers
+    // the radix-4 stages (indices 2k, 4k, 6k) and the real split (k <= N/4).
+    fl::vector<i16> mTwiddles;
+    // Bit reversed position of each complex input, applied while packing
+    fl::vector<u16> mBitReverse;
+};
+
+} // namespace fl
@@ -0,0 +1,118 @@
+#include "fl/noise_volume.h"
+
+#include "fl/fastled.h"
+#include "fl/stdint.h"
+
+// Forward declaration from src/noise.cpp
+void inoise16_row(uint16_t *out, uint16_t count, uint32_t x, int32_t dx,
+                  uint32_t y, uint32_t z);
+
+namespace fl {
+
+namespace {
+
+// Bound on |d2/dt2 inoise16(x, y, t)|, in output units per t unit squared,
+// times 65536. Along t a noise cell is Y1 + (Y2 - Y1) * ease(w), with
+// |Y1|, |Y2| <= 32768 raw and slopes of at most 1/4 raw per t unit, and the
+// quadratic ease has slope <= 2 and curvature 4 per cell: 6 raw units,
+// times the 440/256 output scaling.
+const u32 kCurvature = 11;
+// Fixed-point rounding of the keyframes and of the direct evaluation
+const u16 kRoundingSlack = 24;
+
+} // namespace
+
+NoiseVolume::NoiseVolume(u16 width, u16 height, u32 x, i32 dx, u32 y, i32 dy,
+                         u16 maxError)
+    : mWidth(width), mHeight(height), mX(x), mDx(dx), mY(y), mDy(dy) {
+    for (fl::vector<u16> &key : mKeys) {
+        key.resize(u32(width) * height);
+    }
+    setMaxError(maxError);
+}
+
+u8 NoiseVolume::keyframeShiftFor(u16 maxError) {
+    if (maxError <= kRoundingSlack) {
+        return 0;
+    }
+    // error <= interval^2 / 8 * kCurvature / 65536
+    const u32 limit = u32(maxError - kRoundingSlack) * (8 * 65536 / kCurvature);
+    u8 shift = 0;
+    while (shift < 15 && (u32(1) << (2 * (shift + 1))) <= limit) {
+        ++shift;
+    }
+    return shift;
+}
+
+void NoiseVolume::setMaxError(u16 maxError) {
+    mMaxError = maxError;
+    mShift = keyframeShiftFor(maxError);
+    reset();
+}
+
+void NoiseVolume::reset() { mValid = false; }
+
+void NoiseVolume::evaluate(u16 *keyframe, u32 t, u16 firstRow,
+                           u16 endRow) const {
+    for (u16 j = firstRow; j < endRow; ++j) {
+        inoise16_row(keyframe + u32(j) * mWidth, mWidth, mX, mDx,
+                     mY + u32(j) * u32(mDy), t);
+    }
+}
+
+void NoiseVolume::start(u32 t0) {
+    const u32 interval = keyframeInterval();
+    mT0 = t0;
+    mCurrent = 0;
+    evaluate(mKeys[0].data(), t0, 0, mHeight);
+    evaluate(mKeys[1].data(), t0 + interval, 0, mHeight);
+    mPendingRows = 0;
+    mValid = true;
+}
+
+void NoiseVolume::refill(u16 row) {
+    if (row <= mPendingRows) {
+        return;
+    }
+    const u8 pending = u8((mCurrent + 2) % 3);
+    evaluate(mKeys[pending].data(), mT0 + 2 * keyframeInterval(),
+             mPendingRows, row);
+    mPendingRows = row;
+}
+
+void NoiseVolume::sample(u32 t, u16 *out) {
+    const u32 interval = keyframeInterval();
+    u32 d = t - mT0;
+    if (!mValid || d >= 2 * interval) {
+        start(t & ~(interval - 1));
+        d = t - mT0;
+    } else if (d >= interval) {
+        refill(mHeight);
+        mCurrent = u8((mCurrent + 1) % 3);
+        mT0 += interval;
+        mPendingRows = 0;
+        d -= interval;
+    }
+
+    // Position between the two keyframes, 0..65535 (mShift is at most 15)
+    const u32 frac = d << (16 - mShift);
+    // Spread the next keyframe over the interval
+    refill(u16((u32(mHeight) * frac) >> 16));
+
+    const u16 *a = mKeys[mCurrent].data();
+    const u16 *b = mKeys[(mCurrent + 1) % 3].data();
+    const u32 count = u32(mWidth) * mHeight;
+    if (frac == 0) {
+        for (u32 i = 0; i < count; ++i) {
+            out[i] = a[i];
+        }
+        return;
+    }
+    // 15-bit weight so the product fits in 32 bits
+    const i32 weight = i32(frac >> 1);
+    for (u32 i = 0; i < count; ++i) {
+        out[i] = u16(a[i] + ((i32(b[i]) - i32(a[i])) * weight >> 15));
+    }
+}
+
+} // namespace fl
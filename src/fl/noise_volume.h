@@ -0,0 +1,79 @@
+#pragma once
+
+// Cache for animated 2D noise fields, inoise16(x, y, t) with a slowly
+// advancing t.
+//
+// The field is evaluated on a grid at keyframes spaced keyframeInterval()
+// apart in t, and every sample() interpolates linearly between the two
+// keyframes around t. The keyframe after those is filled in a few rows per
+// sample() call, so the cost of a full evaluation is spread over all the
+// frames of an interval instead of landing on one of them.
+//
+// The interval is the largest power of two for which the interpolation
+// error is guaranteed to stay within a given bound, derived from the
+// curvature of the noise along t. Within a noise cell the field is a
+// quadratic ease between two values that are linear in t, which bounds its
+// second derivative; the linear interpolation error is at most
+// interval^2 / 8 times that, plus a little fixed-point rounding.
+//
+// Example:
+//   NoiseVolume volume(32, 32, 0, 0x2000, 0, 0x2000);   // maxError 256
+//   u16 field[32 * 32];
+//   void loop() {
+//       volume.sample(millis() * 8, field);
+//       ...
+//   }
+
+#include "fl/int.h"
+#include "fl/vector.h"
+
+namespace fl {
+
+class NoiseVolume {
+  public:
+    // Grid point (i, j) samples inoise16(x + i * dx, y + j * dy, t).
+    // maxError is in inoise16() output units.
+    NoiseVolume(u16 width, u16 height, u32 x, i32 dx, u32 y, i32 dy,
+                u16 maxError = 256);
+
+    u16 width() const { return mWidth; }
+    u16 height() const { return mHeight; }
+
+    // Changing the bound changes the interval and drops the keyframes
+    void setMaxError(u16 maxError);
+    u16 maxError() const { return mMaxError; }
+    u32 keyframeInterval() const { return u32(1) << mShift; }
+    // log2 of the widest interval that keeps within maxError; 0 (a keyframe
+    // at every t, i.e. direct evaluation) for bounds below the rounding slack
+    static u8 keyframeShiftFor(u16 maxError);
+
+    // Writes the field at time t to `out`, width() * height() values in
+    // row-major order. Moving t backwards or by more than an interval
+    // between calls re-evaluates the keyframes in full.
+    void sample(u32 t, u16 *out);
+
+    // Forgets the keyframes, e.g. to free the work of the next sample()
+    void reset();
+
+  private:
+    void evaluate(u16 *keyframe, u32 t, u16 firstRow, u16 endRow) const;
+    // Fills the pending keyframe up to `row`
+    void refill(u16 row);
+    void start(u32 t0);
+
+    u16 mWidth;
+    u16 mHeight;
+    u32 mX;
+    i32 mDx;
+    u32 mY;
+    i32 mDy;
+    u16 mMaxError = 0;
+    u8 mShift = 0;
+    bool mValid = false;
+    u32 mT0 = 0;            // time of mKeys[mCurrent]
+    u8 mCurrent = 0;        // keyframes at t0, t0 + interval, t0 + 2 * interval
+    u16 mPendingRows = 0;   // rows of the last one evaluated so far
+    fl::vector<u16> mKeys[3];
+};
+
+} // namespace fl
@@ -27,6 +27,10 @@ void feature_point(i32 gx, i32 gy, i32 &fx, i32 &fy) {
     fx = (h & 0xFF) * 128; // scale to Q15 (0–32767)
     fy = ((h >> 8) & 0xFF) * 128;
 }
+
+// Normalize: maximum possible distance is roughly 2*Q15_ONE
+i32 normalize(i32 dist) { return (dist << 15) / (2 * Q15_ONE); }
+
 } // namespace
 
 // Compute 2D Worley noise at (x, y) in Q15
@@ -61,8 +65,124 @@ i32 worley_noise_2d_q15(i32 x, i32 y) {
         }
     }
 
-    // Normalize: maximum possible distance is roughly 2*Q15_ONE
-    return (min_dist << 15) / (2 * Q15_ONE);
+    return normalize(min_dist);
+}
+
+void WorleyGrid::loadRow(u8 slot, i32 cellY) {
+    Feature *row = mWindow.data() + slot * mColumns;
+    for (u32 c = 0; c < mColumns; ++c) {
+        const i32 gx = mFirstColumn + i32(c);
+        i32 fx, fy;
+        feature_point(gx, cellY, fx, fy);
+        row[c].x = (gx << 15) + fx;
+        row[c].y = (cellY << 15) + fy;
+    }
+    mSlotRow[slot] = cellY;
+    mSlotValid[slot] = true;
+}
+
+void WorleyGrid::sample(i32 *f1, i32 *f2, i32 *edge, u16 width, u16 height,
+                        i32 x, i32 dx, i32 y, i32 dy) {
+    if (width == 0 || height == 0 || (!f1 && !f2 && !edge)) {
+        return;
+    }
+    // Every row spans the same cell columns, plus one either side
+    const i32 last = x + i32(width - 1) * dx;
+    const i32 first = ((dx < 0 ? last : x) >> 15) - 1;
+    const u32 columns = u32(((dx < 0 ? x : last) >> 15) - first) + 2;
+    if (first != mFirstColumn || columns != mColumns) {
+        mFirstColumn = first;
+        mColumns = columns;
+        mWindow.resize(3 * columns);
+        mRowX.resize(3 * columns);
+        mRowDy.resize(3 * columns);
+        mSlotValid[0] = mSlotValid[1] = mSlotValid[2] = false;
+    }
+
+    u32 out = 0;
+    i32 py = y;
+    for (u16 j = 0; j < height; ++j, py += dy) {
+        const i32 cellY = py >> 15;
+        // Point each of the three cell rows at a slot, hashing only the
+        // rows the window doesn't hold yet
+        const Feature *rows[3];
+        bool held[3] = {false, false, false};
+        u8 used = 0;   // slots claimed by this row
+        for (int r = 0; r < 3; ++r) {
+            for (u8 s = 0; s < 3; ++s) {
+                if (mSlotValid[s] && mSlotRow[s] == cellY - 1 + r) {
+                    rows[r] = mWindow.data() + s * mColumns;
+                    held[r] = true;
+                    used |= u8(1 << s);
+                    break;
+                }
+            }
+        }
+        for (int r = 0; r < 3; ++r) {
+            if (!held[r]) {
+                u8 s = 0;
+                while ((used >> s) & 1) {
+                    ++s;
+                }
+                loadRow(s, cellY - 1 + r);
+                rows[r] = mWindow.data() + s * mColumns;
+                used |= u8(1 << s);
+            }
+        }
+
+        // |py - feature y| is the same for the whole row
+        for (int r = 0; r < 3; ++r) {
+            i32 *xs = mRowX.data() + r * mColumns;
+            i32 *ady = mRowDy.data() + r * mColumns;
+            for (u32 c = 0; c < mColumns; ++c) {
+                xs[c] = rows[r][c].x;
+                ady[c] = q15_abs(py - rows[r][c].y);
+            }
+        }
+
+        const i32 *xs = mRowX.data();
+        const i32 *ady = mRowDy.data();
+        i32 px = x;
+        if (!f2 && !edge) {
+            for (u16 i = 0; i < width; ++i, px += dx, ++out) {
+                const u32 c = u32((px >> 15) - 1 - mFirstColumn);
+                i32 d1 = INT32_MAX;
+                for (u32 r = 0; r < 3 * mColumns; r += mColumns) {
+                    for (u32 k = c + r; k < c + r + 3; ++k) {
+                        const i32 dist = q15_abs(px - xs[k]) + ady[k];
+                        d1 = dist < d1 ? dist : d1;
+                    }
+                }
+                f1[out] = normalize(d1);
+            }
+            continue;
+        }
+        for (u16 i = 0; i < width; ++i, px += dx, ++out) {
+            const u32 c = u32((px >> 15) - 1 - mFirstColumn);
+            i32 d1 = INT32_MAX;
+            i32 d2 = INT32_MAX;
+            for (u32 r = 0; r < 3 * mColumns; r += mColumns) {
+                for (u32 k = c + r; k < c + r + 3; ++k) {
+                    const i32 dist = q15_abs(px - xs[k]) + ady[k];
+                    if (dist < d1) {
+                        d2 = d1;
+                        d1 = dist;
+                    } else if (dist < d2) {
+                        d2 = dist;
+                    }
+                }
+            }
+            if (f1) {
+                f1[out] = normalize(d1);
+            }
+            if (f2) {
+                f2[out] = normalize(d2);
+            }
+            if (edge) {
+                edge[out] = normalize(d2 - d1);
+            }
+        }
+    }
 }
 
 } // namespace fl
@@ -2,10 +2,52 @@
 
 #include "fl/stdint.h"
 #include "fl/int.h"
+#include "fl/vector.h"
 
 namespace fl {
 
 // Compute 2D Worley noise at (x, y) in Q15
 i32 worley_noise_2d_q15(i32 x, i32 y);
 
+// Worley noise over a regular grid of sample points, walked row by row.
+//
+// worley_noise_2d_q15() hashes the nine feature points around every pixel.
+// Here the feature points of the three cell rows around the current row
+// are hashed once, for every cell column the grid spans, and kept in a
+// sliding window: moving to a row in the next cell row hashes one new row
+// of cells, and rows in the same cell row hash nothing. The vertical half
+// of every distance is also computed once per row, so each pixel only
+// adds the horizontal halves of its nine candidates and finds the nearest
+// two in one pass.
+//
+// F1 is exactly worley_noise_2d_q15(). F2 and the edge distance use the
+// same Manhattan metric, normalization and 3x3 neighbourhood.
+class WorleyGrid {
+  public:
+    // Samples point (i, j) at (x + i * dx, y + j * dy), in Q15. Each output
+    // is width * height values in row-major order, or null if not needed:
+    //   f1    distance to the nearest feature point
+    //   f2    distance to the second nearest
+    //   edge  f2 - f1, which falls to 0 on the borders between cells
+    void sample(i32 *f1, i32 *f2, i32 *edge, u16 width, u16 height, i32 x,
+                i32 dx, i32 y, i32 dy);
+
+  private:
+    struct Feature {
+        i32 x;
+        i32 y;
+    };
+    // Hashes cell row `cellY` into window slot `slot`
+    void loadRow(u8 slot, i32 cellY);
+
+    i32 mFirstColumn = 0;   // cell column of the window's first entry
+    u32 mColumns = 0;
+    fl::vector<Feature> mWindow;  // 3 slots of mColumns features
+    i32 mSlotRow[3] = {0, 0, 0};  // cell row held by each slot
+    bool mSlotValid[3] = {false, false, false};
+    // The current row's three cell rows in order: feature x and |y - py|
+    fl::vector<i32> mRowX;
+    fl::vector<i32> mRowDy;
+};
+
 } // namespace fl
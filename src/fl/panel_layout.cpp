@@ -0,0 +1,179 @@
+#include "fl/panel_layout.h"
+
+#include "fl/math_macros.h"
+#include "fl/screenmap.h"
+#include "fl/geometry.h"
+#include "fl/warn.h"
+
+namespace fl {
+
+PanelLayout::PanelLayout(u16 panelWidth, u16 panelHeight)
+    : mPanelWidth(panelWidth), mPanelHeight(panelHeight) {}
+
+void PanelLayout::addPanel(const Panel &panel) {
+    // 0xFFFF itself is kept free for uncovered positions
+    if (ledCount() + u32(mPanelWidth) * mPanelHeight >= 0xFFFF) {
+        FL_WARN("PanelLayout: more LEDs than a 16-bit index can address");
+        return;
+    }
+    // The new panel ends its controller's chain; chains of later
+    // controllers move up by one panel
+    const u32 panelLeds = u32(mPanelWidth) * mPanelHeight;
+    const u32 base = controllerOffset(panel.controller) +
+                     controllerLength(panel.controller);
+    for (fl::size i = 0; i < mPanels.size(); ++i) {
+        if (mPanels[i].controller > panel.controller) {
+            mPanelBases[i] += panelLeds;
+        }
+    }
+    mPanels.push_back(panel);
+    mPanelBases.push_back(base);
+    u16 w, h;
+    footprint(panel, &w, &h);
+    mWidth = u16(FL_MAX(u32(mWidth), u32(panel.x) + w));
+    mHeight = u16(FL_MAX(u32(mHeight), u32(panel.y) + h));
+    if (panel.controller >= mControllerLengths.size()) {
+        mControllerLengths.resize(panel.controller + 1, 0);
+    }
+    mControllerLengths[panel.controller] += panelLeds;
+}
+
+u32 PanelLayout::ledCount() const {
+    return u32(mPanels.size()) * mPanelWidth * mPanelHeight;
+}
+
+u32 PanelLayout::controllerOffset(u8 controller) const {
+    u32 offset = 0;
+    for (u8 c = 0; c < controller && c < mControllerLengths.size(); ++c) {
+        offset += mControllerLengths[c];
+    }
+    return offset;
+}
+
+u32 PanelLayout::controllerLength(u8 controller) const {
+    return controller < mControllerLengths.size() ? mControllerLengths[controller]
+                                                  : 0;
+}
+
+bool PanelLayout::isComplete() const {
+    const u32 total = u32(mWidth) * mHeight;
+    if (total == 0 || ledCount() != total) {
+        return false;
+    }
+    // Same area as the bounding box, so any overlap leaves a gap
+    fl::vector<u8> covered(total, 0);
+    for (const Panel &panel : mPanels) {
+        u16 w, h;
+        footprint(panel, &w, &h);
+        for (u16 v = 0; v < h; ++v) {
+            u8 *row = covered.data() + u32(panel.y + v) * mWidth + panel.x;
+            for (u16 u = 0; u < w; ++u) {
+                if (row[u]) {
+                    return false;
+                }
+                row[u] = 1;
+            }
+        }
+    }
+    return true;
+}
+
+void PanelLayout::footprint(const Panel &panel, u16 *w, u16 *h) const {
+    const bool quarter = panel.rotation == kRotate90 || panel.rotation == kRotate270;
+    *w = quarter ? mPanelHeight : mPanelWidth;
+    *h = quarter ? mPanelWidth : mPanelHeight;
+}
+
+u16 PanelLayout::localIndex(const Panel &panel, u16 u, u16 v) const {
+    const u16 pw = mPanelWidth;
+    const u16 ph = mPanelHeight;
+    if (panel.mirror) {
+        u16 w, h;
+        footprint(panel, &w, &h);
+        u = u16(w - 1 - u);
+    }
+    // Undo the rotation: footprint (u, v) back to the panel's own (x, y)
+    u16 x, y;
+    switch (panel.rotation) {
+    case kRotate90:
+        x = v;
+        y = u16(ph - 1 - u);
+        break;
+    case kRotate180:
+        x = u16(pw - 1 - u);
+        y = u16(ph - 1 - v);
+        break;
+    case kRotate270:
+        x = u16(pw - 1 - v);
+        y = u;
+        break;
+    case kRotate0:
+    default:
+        x = u;
+        y = v;
+        break;
+    }
+    return panel.serpentine ? xy_serpentine(x, y, pw, ph)
+                            : xy_line_by_line(x, y, pw, ph);
+}
+
+u16 PanelLayout::mapToIndex(u16 x, u16 y) const {
+    // Later panels cover earlier ones, as in fillLookUpTable()
+    for (fl::size i = mPanels.size(); i-- > 0;) {
+        const Panel &panel = mPanels[i];
+        u16 w, h;
+        footprint(panel, &w, &h);
+        if (x >= panel.x && y >= panel.y && x - panel.x < w && y - panel.y < h) {
+            return u16(mPanelBases[i] + localIndex(panel, u16(x - panel.x),
+                                             u16(y - panel.y)));
+        }
+    }
+    return u16(ledCount());
+}
+
+void PanelLayout::fillLookUpTable(u16 *lut) const {
+    const u32 total = u32(mWidth) * mHeight;
+    const u16 missing = u16(ledCount());
+    for (u32 i = 0; i < total; ++i) {
+        lut[i] = missing;
+    }
+    for (fl::size i = 0; i < mPanels.size(); ++i) {
+        const Panel &panel = mPanels[i];
+        u16 w, h;
+        footprint(panel, &w, &h);
+        for (u16 v = 0; v < h; ++v) {
+            u16 *row = lut + u32(panel.y + v) * mWidth + panel.x;
+            for (u16 u = 0; u < w; ++u) {
+                row[u] = u16(mPanelBases[i] + localIndex(panel, u, v));
+            }
+        }
+    }
+}
+
+XYMap PanelLayout::toXYMap(u16 offset) const {
+    fl::vector<u16> lut(fl::size(mWidth) * mHeight, 0);
+    fillLookUpTable(lut.data());
+    XYMap out = XYMap::constructWithLookUpTable(mWidth, mHeight, lut.data(),
+                                                offset);
+    out.compile();
+    return out;
+}
+
+ScreenMap PanelLayout::toScreenMap() const {
+    const u32 count = ledCount();
+    ScreenMap out(count);
+    for (fl::size i = 0; i < mPanels.size(); ++i) {
+        const Panel &panel = mPanels[i];
+        u16 w, h;
+        footprint(panel, &w, &h);
+        for (u16 v = 0; v < h; ++v) {
+            for (u16 u = 0; u < w; ++u) {
+                const u16 index = u16(mPanelBases[i] + localIndex(panel, u, v));
+                out.set(index, vec2f(float(panel.x + u), float(panel.y + v)));
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace fl
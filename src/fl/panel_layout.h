@@ -0,0 +1,106 @@
+#pragma once
+
+// Declarative layout of an LED wall built from identical matrix panels.
+//
+// Each panel is placed on the wall at a pixel origin, optionally rotated
+// in quarter turns and mirrored, and driven by one of several controllers.
+// Panels on the same controller are chained in the order they were added.
+// The layout compiles into an XYMap backed by a LUT16 plus run table (see
+// XYMap::compile()), so drawing costs no per-pixel function call, and
+// into the matching ScreenMap for visualization.
+//
+// LED indices follow the controllers: controller 0's chain first, then
+// controller 1's, and so on, so each controller drives the slice
+// [controllerOffset(c), controllerOffset(c) + controllerLength(c)) of one
+// LED buffer.
+//
+// Example, a 64x32 wall of 16x16 panels on two controllers:
+//   PanelLayout layout(16, 16);
+//   for (u16 row = 0; row < 2; ++row) {
+//       for (u16 col = 0; col < 4; ++col) {
+//           PanelLayout::Panel panel(col * 16, row * 16);
+//           panel.rotation = row ? PanelLayout::kRotate180 : PanelLayout::kRotate0;
+//           panel.controller = row;
+//           layout.addPanel(panel);
+//       }
+//   }
+//   CRGB leds[64 * 32];
+//   FastLED.addLeds<WS2812, 2>(leds + layout.controllerOffset(0), layout.controllerLength(0));
+//   FastLED.addLeds<WS2812, 4>(leds + layout.controllerOffset(1), layout.controllerLength(1));
+//   XYMap xy = layout.toXYMap();
+
+#include "fl/int.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+
+namespace fl {
+
+class ScreenMap;
+
+class PanelLayout {
+  public:
+    // Quarter turns clockwise, as seen from the front of the wall
+    enum Rotation : u8 { kRotate0 = 0, kRotate90, kRotate180, kRotate270 };
+
+    struct Panel {
+        Panel() = default;
+        Panel(u16 x, u16 y) : x(x), y(y) {}
+        u16 x = 0;  // top-left corner on the wall, in pixels
+        u16 y = 0;
+        Rotation rotation = kRotate0;
+        bool mirror = false;      // flipped left to right after rotating
+        bool serpentine = true;   // wiring inside the panel
+        u8 controller = 0;
+    };
+
+    PanelLayout(u16 panelWidth, u16 panelHeight);
+
+    // Appends a panel to the end of its controller's chain
+    void addPanel(const Panel &panel);
+
+    u16 panelWidth() const { return mPanelWidth; }
+    u16 panelHeight() const { return mPanelHeight; }
+    fl::size panelCount() const { return mPanels.size(); }
+    const Panel &panel(fl::size i) const { return mPanels[i]; }
+
+    // Bounding box of all panels
+    u16 width() const { return mWidth; }
+    u16 height() const { return mHeight; }
+    u32 ledCount() const;
+
+    u8 controllerCount() const { return u8(mControllerLengths.size()); }
+    u32 controllerOffset(u8 controller) const;
+    u32 controllerLength(u8 controller) const;
+
+    // True when the panels cover the bounding box without gaps or overlaps
+    bool isComplete() const;
+
+    // Evaluates the geometry for one pixel. Positions no panel covers map
+    // to ledCount(); draw into a buffer one LED longer if that can happen.
+    u16 mapToIndex(u16 x, u16 y) const;
+
+    // Fills `lut` (width() * height() entries, row-major) with the LED
+    // index of every pixel, panel by panel rather than pixel by pixel
+    void fillLookUpTable(u16 *lut) const;
+    // Look-up-table XYMap of the layout, compiled into runs
+    XYMap toXYMap(u16 offset = 0) const;
+    // Position of every LED on the wall, in pixels
+    ScreenMap toScreenMap() const;
+
+  private:
+    void footprint(const Panel &panel, u16 *w, u16 *h) const;
+    // LED index inside `panel` of footprint pixel (u, v)
+    u16 localIndex(const Panel &panel, u16 u, u16 v) const;
+
+    u16 mPanelWidth;
+    u16 mPanelHeight;
+    u16 mWidth = 0;
+    u16 mHeight = 0;
+    fl::vector<Panel> mPanels;
+    // First LED index of each panel, following the controller order. Kept
+    // up to date by addPanel().
+    fl::vector<u32> mPanelBases;
+    fl::vector<u32> mControllerLengths;
+};
+
+} // namespace fl
@@ -0,0 +1,46 @@
+#include "fl/row_band_pool.h"
+
+#include "fl/has_include.h"
+#include "fl/thread.h"
+
+// Pick the platform workers: FreeRTOS tasks on ESP32, threads on the host.
+#if FASTLED_MULTITHREADED && defined(ESP32) && FL_HAS_INCLUDE("freertos/FreeRTOS.h")
+#include "platforms/esp/32/row_band_pool_esp32.hpp"
+#elif FASTLED_MULTITHREADED
+#include "platforms/stub/row_band_pool_stub.hpp"
+#else
+namespace fl {
+struct RowBandPool::Workers {};
+} // namespace fl
+#endif
+
+namespace fl {
+
+RowBandPool::RowBandPool(u8 threads) {
+#if FASTLED_MULTITHREADED
+    if (threads > 1) {
+        mWorkers.reset(new Workers(u8(threads - 1)));
+        mThreads = u8(1 + mWorkers->count());
+        if (mThreads == 1) {
+            mWorkers.reset();
+        }
+    }
+#else
+    (void)threads;
+#endif
+}
+
+RowBandPool::~RowBandPool() = default;
+
+void RowBandPool::run(u32 rows, const fl::function<void(u32, u32)> &kernel) {
+#if FASTLED_MULTITHREADED
+    if (mWorkers && rows > 1) {
+        const u8 bands = u8(rows < mThreads ? rows : mThreads);
+        mWorkers->run(rows, bands, kernel);
+        return;
+    }
+#endif
+    kernel(0, rows);
+}
+
+} // namespace fl
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "fl/function.h"
+#include "fl/int.h"
+#include "fl/unique_ptr.h"
+
+namespace fl {
+
+// Runs a row-wise kernel over [0, rows) split into contiguous bands, one
+// per thread. The calling thread takes the first band and run() returns
+// once every band is done, so consecutive run() calls act as barriers.
+//
+// Worker threads exist only in FASTLED_MULTITHREADED builds: std::thread on
+// the host, FreeRTOS tasks on ESP32. Elsewhere the pool has one thread and
+// run() calls the kernel inline.
+//
+// Example:
+//   RowBandPool pool(4);
+//   pool.run(height, [&](u32 first, u32 end) {
+//       for (u32 y = first; y < end; ++y) { stepRow(y); }
+//   });
+class RowBandPool {
+  public:
+    explicit RowBandPool(u8 threads);
+    ~RowBandPool();
+
+    // Threads actually running bands, the caller included
+    u8 threads() const { return mThreads; }
+
+    void run(u32 rows, const fl::function<void(u32, u32)> &kernel);
+
+  private:
+    struct Workers;
+
+    u8 mThreads = 1;
+    fl::unique_ptr<Workers> mWorkers;
+};
+
+} // namespace fl
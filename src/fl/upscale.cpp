@@ -5,6 +5,7 @@
 #include "fl/stdint.h"
 
 #include "crgb.h"
+#include "fl/cstring.h"
 #include "fl/upscale.h"
 #include "fl/xymap.h"
 
@@ -364,4 +365,180 @@ void upscaleFloat(const CRGB *input, CRGB *output, u8 inputWidth,
     }
 }
 
+namespace {
+
+// Source position of output coordinate `i` in 8.8 fixed point, as the
+// per-pixel versions compute it
+void samplePositions(u16 inputSize, u16 outputSize, fl::vector<u16> *i0,
+                     fl::vector<u16> *i1, fl::vector<u8> *frac) {
+    i0->resize(outputSize);
+    i1->resize(outputSize);
+    frac->resize(outputSize);
+    for (u16 i = 0; i < outputSize; ++i) {
+        const u32 f = outputSize > 1 ? (u32(i) * (inputSize - 1) * 256) /
+                                           (outputSize - 1)
+                                     : 0;
+        const u16 p = u16(f >> 8);
+        (*i0)[i] = p;
+        (*i1)[i] = (p + 1 < inputSize) ? u16(p + 1) : p;
+        (*frac)[i] = u8(f & 0xFF);
+    }
+}
+
+} // namespace
+
+void BilinearUpscaler::reset() {
+    mInputWidth = mInputHeight = mOutputWidth = mOutputHeight = 0;
+    mMap.reset();
+    mX0.clear();
+    mIndices.clear();
+}
+
+void BilinearUpscaler::prepare(u16 inputWidth, u16 inputHeight,
+                               u16 outputWidth, u16 outputHeight,
+                               const XYMap *xyMap) {
+    const bool sameMap = xyMap ? (mMap && *mMap == *xyMap) : !mMap;
+    if (inputWidth != mInputWidth || inputHeight != mInputHeight ||
+        outputWidth != mOutputWidth || outputHeight != mOutputHeight ||
+        !sameMap || mX0.empty()) {
+        mInputWidth = inputWidth;
+        mInputHeight = inputHeight;
+        mOutputWidth = outputWidth;
+        mOutputHeight = outputHeight;
+        if (xyMap) {
+            mMap = *xyMap;
+        } else {
+            mMap.reset();
+        }
+        samplePositions(inputWidth, outputWidth, &mX0, &mX1, &mXFrac);
+        samplePositions(inputHeight, outputHeight, &mY0, &mY1, &mYFrac);
+        // Columns are addressed in bytes within a source row
+        for (u16 x = 0; x < outputWidth; ++x) {
+            mX0[x] = u16(mX0[x] * 3);
+            mX1[x] = u16(mX1[x] * 3);
+        }
+        mIndices.clear();
+        if (xyMap && !xyMap->isSerpentineOrLineByLine()) {
+            const u32 n = u32(outputWidth) * outputHeight;
+            mIndices.resize(n);
+            for (u16 y = 0; y < outputHeight; ++y) {
+                for (u16 x = 0; x < outputWidth; ++x) {
+                    const u16 idx = xyMap->mapToIndex(x, y);
+                    mIndices[u32(y) * outputWidth + x] = idx < n ? idx : 0xFFFF;
+                }
+            }
+        }
+        mRows[0].resize(u32(outputWidth) * 3);
+        mRows[1].resize(u32(outputWidth) * 3);
+        mOutRow.resize(outputWidth);
+    }
+    // New input every frame
+    mRowSource[0] = mRowSource[1] = -1;
+}
+
+void BilinearUpscaler::interpolateRow(const CRGB *input, u16 y,
+                                      u16 *row) const {
+    const u8 *src = reinterpret_cast<const u8 *>(input + u32(y) * mInputWidth);
+    for (u16 x = 0; x < mOutputWidth; ++x) {
+        const u8 *a = src + mX0[x];
+        const u8 *b = src + mX1[x];
+        const u16 wb = mXFrac[x];
+        const u16 wa = u16(256 - wb);
+        row[0] = u16(a[0] * wa + b[0] * wb);
+        row[1] = u16(a[1] * wa + b[1] * wb);
+        row[2] = u16(a[2] * wa + b[2] * wb);
+        row += 3;
+    }
+}
+
+void BilinearUpscaler::blendRows(u16 y, u8 *out) {
+    // Two slots; an output row needs the source rows above and below it,
+    // which the previous output row usually computed already
+    const int y0 = mY0[y];
+    const int y1 = mY1[y];
+    int a = mRowSource[0] == y0 ? 0 : (mRowSource[1] == y0 ? 1 : -1);
+    if (a < 0) {
+        a = mRowSource[0] == y1 ? 1 : 0;
+        interpolateRow(mInput, u16(y0), mRows[a].data());
+        mRowSource[a] = y0;
+    }
+    int b = mRowSource[0] == y1 ? 0 : (mRowSource[1] == y1 ? 1 : -1);
+    if (b < 0) {
+        b = 1 - a;
+        interpolateRow(mInput, u16(y1), mRows[b].data());
+        mRowSource[b] = y1;
+    }
+    const u16 *top = mRows[a].data();
+    const u16 *bottom = mRows[b].data();
+    const u32 wb = mYFrac[y];
+    const u32 wt = 256 - wb;
+    const u32 count = u32(mOutputWidth) * 3;
+    for (u32 i = 0; i < count; ++i) {
+        out[i] = u8((top[i] * wt + bottom[i] * wb + 32768) >> 16);
+    }
+}
+
+void BilinearUpscaler::writeRow(u16 y, const CRGB *row, CRGB *output,
+                                const XYMap *xyMap) const {
+    const u32 n = u32(mOutputWidth) * mOutputHeight;
+    if (!mIndices.empty()) {
+        const u16 *indices = mIndices.data() + u32(y) * mOutputWidth;
+        for (u16 x = 0; x < mOutputWidth; ++x) {
+            if (indices[x] != 0xFFFF) {
+                output[indices[x]] = row[x];
+            }
+        }
+        return;
+    }
+    const u16 first = xyMap->mapToIndex(u16(0), y);
+    const u16 last = xyMap->mapToIndex(u16(mOutputWidth - 1), y);
+    if (first < n && last < n) {
+        if (first <= last) {
+            fl::memcpy(output + first, row, mOutputWidth * sizeof(CRGB));
+        } else {
+            for (u16 x = 0; x < mOutputWidth; ++x) {
+                output[first - x] = row[x];
+            }
+        }
+        return;
+    }
+    for (u16 x = 0; x < mOutputWidth; ++x) {
+        const u16 idx = xyMap->mapToIndex(x, y);
+        if (idx < n) {
+            output[idx] = row[x];
+        }
+    }
+}
+
+void BilinearUpscaler::upscale(const CRGB *input, CRGB *output,
+                               u16 inputWidth, u16 inputHeight, u16 outputWidth,
+                               u16 outputHeight) {
+    if (!inputWidth || !inputHeight || !outputWidth || !outputHeight) {
+        return;
+    }
+    prepare(inputWidth, inputHeight, outputWidth, outputHeight, nullptr);
+    mInput = input;
+    for (u16 y = 0; y < outputHeight; ++y) {
+        blendRows(y, reinterpret_cast<u8 *>(output + u32(y) * outputWidth));
+    }
+    mInput = nullptr;
+}
+
+void BilinearUpscaler::upscale(const CRGB *input, CRGB *output,
+                               u16 inputWidth, u16 inputHeight,
+                               const XYMap &xyMap) {
+    const u16 outputWidth = xyMap.getWidth();
+    const u16 outputHeight = xyMap.getHeight();
+    if (!inputWidth || !inputHeight || !outputWidth || !outputHeight) {
+        return;
+    }
+    prepare(inputWidth, inputHeight, outputWidth, outputHeight, &xyMap);
+    mInput = input;
+    for (u16 y = 0; y < outputHeight; ++y) {
+        blendRows(y, reinterpret_cast<u8 *>(mOutRow.data()));
+        writeRow(y, mOutRow.data(), output, &xyMap);
+    }
+    mInput = nullptr;
+}
+
 } // namespace fl
@@ -7,6 +7,8 @@
 #include "fl/stdint.h"
 
 #include "crgb.h"
+#include "fl/optional.h"
+#include "fl/vector.h"
 #include "fl/xymap.h"
 
 namespace fl {
@@ -85,6 +87,57 @@ inline void upscale(const CRGB *input, CRGB *output, u16 inputWidth,
     }
 }
 
+/// @brief Bilinear upscaler that precomputes its sampling tables.
+///
+/// Produces exactly what upscaleArbitrary() and upscaleRectangular() do,
+/// but the source index and 8-bit weight of every output column and row
+/// are computed once per (input size, output size, XYMap) rather than
+/// per pixel, as are the output indices of maps that are not serpentine
+/// or line-by-line. Each frame is then two fixed-point passes:
+/// horizontal, into 16-bit rows that are reused by every output row that
+/// falls between the same two source rows, and vertical, a contiguous
+/// multiply-add over those rows that compilers vectorize.
+///
+/// Tables are rebuilt when the sizes or the map's layout change. The
+/// upscaler keeps a copy of the last map to compare against, which also
+/// keeps its look-up table alive.
+class BilinearUpscaler {
+  public:
+    void upscale(const CRGB *input, CRGB *output, u16 inputWidth,
+                 u16 inputHeight, const fl::XYMap &xyMap);
+    /// Row-major output, no map
+    void upscale(const CRGB *input, CRGB *output, u16 inputWidth,
+                 u16 inputHeight, u16 outputWidth, u16 outputHeight);
+    void reset();
+
+  private:
+    void prepare(u16 inputWidth, u16 inputHeight, u16 outputWidth,
+                 u16 outputHeight, const fl::XYMap *xyMap);
+    // Horizontal pass of source row `y` into `row`, 3 * outputWidth values
+    void interpolateRow(const CRGB *input, u16 y, u16 *row) const;
+    // Vertical pass of output row `y` into 3 * outputWidth bytes
+    void blendRows(u16 y, u8 *out);
+    void writeRow(u16 y, const CRGB *row, CRGB *output,
+                  const fl::XYMap *xyMap) const;
+
+    u16 mInputWidth = 0;
+    u16 mInputHeight = 0;
+    u16 mOutputWidth = 0;
+    u16 mOutputHeight = 0;
+    fl::optional<fl::XYMap> mMap;  // empty for row-major output
+    fl::vector<u16> mX0;     // per output column: left source pixel, in bytes
+    fl::vector<u16> mX1;     // right source pixel, in bytes
+    fl::vector<u8> mXFrac;   // weight of the right pixel, 0..255
+    fl::vector<u16> mY0;     // per output row: upper source row
+    fl::vector<u16> mY1;
+    fl::vector<u8> mYFrac;
+    fl::vector<u16> mIndices;  // output index of each pixel, 0xFFFF if clipped
+    fl::vector<u16> mRows[2];  // horizontally interpolated source rows
+    int mRowSource[2] = {-1, -1};
+    fl::vector<CRGB> mOutRow;
+    const CRGB *mInput = nullptr;  // during upscale() only
+};
+
 // These are here for testing purposes and are slow. Their primary use
 // is to test against the fixed integer version above.
 void upscaleFloat(const CRGB *input, CRGB *output, u8 inputWidth,
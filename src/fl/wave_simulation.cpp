@@ -47,6 +47,8 @@ void WaveSimulation2D::init(u32 width, u32 height, SuperSample factor,
     u32 w = width * mMultiplier;
     u32 h = height * mMultiplier;
     mSim.reset(new WaveSimulation2D_Real(w, h, speed, dampening));
+    mSim->setThreads(mThreads);
+    mSim->setActiveTracking(mActiveTracking);
     // Only allocate change grid if it's enabled (saves memory when disabled)
     if (mUseChangeGrid) {
         mChangeGrid.reset(w, h);
@@ -211,29 +213,29 @@ void WaveSimulation2D::update() {
     if (mUseChangeGrid) {
         const vec2<i16> min_max = mChangeGrid.minMax();
         const bool has_updates = min_max != vec2<i16>(0, 0);
-        for (u8 i = 0; i < mExtraFrames + 1; ++i) {
-            if (has_updates) {
-                // apply them
-                const u32 w = mChangeGrid.width();
-                const u32 h = mChangeGrid.height();
-                for (u32 x = 0; x < w; ++x) {
-                    for (u32 y = 0; y < h; ++y) {
-                        i16 v16 = mChangeGrid(x, y);
-                        if (v16 != 0) {
-                            mSim->seti16(x, y, v16);
-                        }
+        // Without changes to re-apply between them, the steps can be fused
+        for (u8 i = 0; has_updates && i < mExtraFrames + 1; ++i) {
+            // apply them
+            const u32 w = mChangeGrid.width();
+            const u32 h = mChangeGrid.height();
+            for (u32 x = 0; x < w; ++x) {
+                for (u32 y = 0; y < h; ++y) {
+                    i16 v16 = mChangeGrid(x, y);
+                    if (v16 != 0) {
+                        mSim->seti16(x, y, v16);
                     }
                 }
             }
             mSim->update();
         }
+        if (!has_updates) {
+            mSim->update(u32(mExtraFrames) + 1);
+        }
         // zero out mChangeGrid
         mChangeGrid.clear();
     } else {
         // When change grid is disabled, just run the simulation updates
-        for (u8 i = 0; i < mExtraFrames + 1; ++i) {
-            mSim->update();
-        }
+        mSim->update(u32(mExtraFrames) + 1);
     }
 }
 
@@ -242,6 +244,16 @@ u32 WaveSimulation2D::getHeight() const { return mOuterHeight; }
 
 void WaveSimulation2D::setExtraFrames(u8 extra) { mExtraFrames = extra; }
 
+void WaveSimulation2D::setThreads(u8 threads) {
+    mThreads = threads;
+    mSim->setThreads(threads);
+}
+
+void WaveSimulation2D::setActiveTracking(bool on) {
+    mActiveTracking = on;
+    mSim->setActiveTracking(on);
+}
+
 void WaveSimulation2D::setUseChangeGrid(bool enabled) {
     if (mUseChangeGrid == enabled) {
         return; // No change needed
@@ -272,6 +284,7 @@ void WaveSimulation1D::init(u32 length, SuperSample factor, float speed,
     mSim.reset(); // clear out memory first.
     mSim.reset(
         new WaveSimulation1D_Real(length * mMultiplier, speed, dampening));
+    mSim->setActiveTracking(mActiveTracking);
     // Extra updates (frames) are applied because the simulation slows down in
     // proportion to the supersampling factor.
     mExtraFrames = static_cast<u8>(factor) - 1;
@@ -279,6 +292,11 @@ void WaveSimulation1D::init(u32 length, SuperSample factor, float speed,
 
 void WaveSimulation1D::setSpeed(float speed) { mSim->setSpeed(speed); }
 
+void WaveSimulation1D::setActiveTracking(bool on) {
+    mActiveTracking = on;
+    mSim->setActiveTracking(on);
+}
+
 void WaveSimulation1D::setDampening(int damp) { mSim->setDampening(damp); }
 
 int WaveSimulation1D::getDampenening() const { return mSim->getDampenening(); }
@@ -99,6 +99,11 @@ class WaveSimulation1D {
 
     void setHalfDuplex(bool on) { mSim->setHalfDuplex(on); }
 
+    // Skips quiescent segments of the high-res simulation; see
+    // WaveSimulation1D_Real::setActiveTracking()
+    void setActiveTracking(bool on);
+    bool getActiveTracking() const { return mActiveTracking; }
+
     // Advance the simulation one time step.
     void update();
 
@@ -112,6 +117,7 @@ class WaveSimulation1D {
     u8 mExtraFrames = 0;
     u32 mMultiplier; // Supersampling multiplier (e.g., 2, 4, or 8).
     U8EasingFunction mU8Mode = WAVE_U8_MODE_LINEAR;
+    bool mActiveTracking = false;
     // Internal high-resolution simulation.
     fl::unique_ptr<WaveSimulation1D_Real> mSim;
 };
@@ -159,6 +165,16 @@ class WaveSimulation2D {
 
     void setXCylindrical(bool on) { mSim->setXCylindrical(on); }
 
+    // Threads stepping the high-res simulation; see
+    // WaveSimulation2D_Real::setThreads()
+    void setThreads(u8 threads);
+    u8 getThreads() const { return mThreads; }
+
+    // Skips quiescent tiles of the high-res simulation; see
+    // WaveSimulation2D_Real::setActiveTracking()
+    void setActiveTracking(bool on);
+    bool getActiveTracking() const { return mActiveTracking; }
+
     // Downsampled getter for the floating point value at (x,y) in the outer
     // grid. It averages over the corresponding multiplier×multiplier block in
     // the high-res simulation.
@@ -211,6 +227,8 @@ class WaveSimulation2D {
     u32 mMultiplier = 1; // Supersampling multiplier (e.g., 1, 2, 4, or 8).
     U8EasingFunction mU8Mode = WAVE_U8_MODE_LINEAR;
     bool mUseChangeGrid = false; // Whether to use change grid tracking (default: disabled for better visuals)
+    u8 mThreads = 1;
+    bool mActiveTracking = false;
     // Internal high-resolution simulation.
     fl::unique_ptr<WaveSimulation2D_Real> mSim;
     fl::Grid<i16> mChangeGrid; // Needed for multiple updates.
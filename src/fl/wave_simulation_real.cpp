@@ -5,6 +5,14 @@
 #include "fl/clamp.h"
 #include "fl/wave_simulation_real.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>  // ok include
+#define FL_WAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>  // ok include
+#define FL_WAVE_NEON 1
+#endif
+
 namespace fl {
 
 // Define Q15 conversion constants.
@@ -102,29 +110,28 @@ void WaveSimulation1D_Real::set(fl::size x, float value) {
     }
     i16 *curr = (whichGrid == 0) ? grid1.data() : grid2.data();
     curr[x + 1] = float_to_fixed(value);
+    if (mTracking && curr[x + 1] != 0) {
+        mSegmentLive[whichGrid][x / kSegmentSize] = 1;
+    }
 }
 
-void WaveSimulation1D_Real::update() {
-    i16 *curr = (whichGrid == 0) ? grid1.data() : grid2.data();
-    i16 *next = (whichGrid == 0) ? grid2.data() : grid1.data();
-
-    // Update boundaries with a Neumann (zero-gradient) condition:
-    curr[0] = curr[1];
-    curr[length + 1] = curr[length];
+namespace {
 
+// Cells [first, end) of the 1D stencil; returns whether any output is
+// non-zero
+bool stepCells1D(const i16 *curr, i16 *next, fl::size first, fl::size end,
+                 i32 mCourantSq32, int dampening, bool halfDuplex) {
     // Compute dampening factor as an integer value: 2^(mDampenening)
-    i32 dampening_factor = 1 << mDampenening;
-
-    i32 mCourantSq32 = static_cast<i32>(mCourantSq);
-    // Iterate over each inner cell.
-    for (fl::size i = 1; i < length + 1; i++) {
+    const i32 dampening_factor = 1 << dampening;
+    i16 any = 0;
+    for (fl::size i = first; i < end; i++) {
         // Compute the 1D Laplacian:
         // lap = curr[i+1] - 2 * curr[i] + curr[i-1]
         i32 lap =
             (i32)curr[i + 1] - ((i32)curr[i] << 1) + curr[i - 1];
 
         // Multiply the Laplacian by the simulation speed using Q15 arithmetic:
-        i32 term = (mCourantSq32 * lap) >> 15;
+        i32 term = i32(u32(mCourantSq32) * u32(lap)) >> 15;
 
         // Compute the new value:
         // f = -next[i] + 2 * curr[i] + term
@@ -139,15 +146,79 @@ void WaveSimulation1D_Real::update() {
         else if (f < -32768)
             f = -32768;
 
+        // Set the negative values to zero.
+        if (halfDuplex && f < 0)
+            f = 0;
+
         next[i] = (i16)f;
+        any |= (i16)f;
     }
+    return any != 0;
+}
 
-    if (mHalfDuplex) {
-        // Set the negative values to zero.
-        for (fl::size i = 1; i < length + 1; i++) {
-            if (next[i] < 0) {
-                next[i] = 0;
+} // namespace
+
+void WaveSimulation1D_Real::setActiveTracking(bool on) {
+    mTracking = on;
+    if (!on) {
+        return;
+    }
+    const fl::size segments = (length + kSegmentSize - 1) / kSegmentSize;
+    for (int g = 0; g < 2; ++g) {
+        const i16 *cells = (g == 0 ? grid1.data() : grid2.data()) + 1;
+        mSegmentLive[g].assign(segments, 0);
+        for (fl::size i = 0; i < length; ++i) {
+            if (cells[i] != 0) {
+                mSegmentLive[g][i / kSegmentSize] = 1;
+            }
+        }
+    }
+}
+
+float WaveSimulation1D_Real::getActiveFraction() const {
+    if (!mTracking || mSegmentLive[0].empty()) {
+        return 1.0f;
+    }
+    return float(mSteppedSegments) / float(mSegmentLive[0].size());
+}
+
+void WaveSimulation1D_Real::update() {
+    i16 *curr = (whichGrid == 0) ? grid1.data() : grid2.data();
+    i16 *next = (whichGrid == 0) ? grid2.data() : grid1.data();
+
+    // Update boundaries with a Neumann (zero-gradient) condition:
+    curr[0] = curr[1];
+    curr[length + 1] = curr[length];
+
+    i32 mCourantSq32 = static_cast<i32>(mCourantSq);
+    if (!mTracking) {
+        // Iterate over each inner cell.
+        stepCells1D(curr, next, 1, length + 1, mCourantSq32, mDampenening,
+                    mHalfDuplex);
+    } else {
+        // A segment whose cells and neighbours are all zero in both grids
+        // steps to zero, which is what it already holds
+        const u8 *liveCurr = mSegmentLive[whichGrid].data();
+        u8 *liveNext = mSegmentLive[whichGrid ^ 1].data();
+        const fl::size segments = mSegmentLive[0].size();
+        mSteppedSegments = 0;
+        bool wasLive = false;  // segment s - 1
+        bool isLive = segments > 0 && (liveCurr[0] | liveNext[0]);
+        for (fl::size s = 0; s < segments; ++s) {
+            const bool nextLive =
+                s + 1 < segments && (liveCurr[s + 1] | liveNext[s + 1]);
+            if (wasLive || isLive || nextLive) {
+                const fl::size first = s * kSegmentSize + 1;
+                const fl::size end = FL_MIN(first + kSegmentSize, length + 1);
+                liveNext[s] = stepCells1D(curr, next, first, end, mCourantSq32,
+                                          mDampenening, mHalfDuplex);
+                ++mSteppedSegments;
             }
+            wasLive = isLive;
+            isLive = nextLive;
+        }
+        if (mSleepThreshold > 0) {
+            sleepQuietSegments(curr, next);
         }
     }
 
@@ -155,6 +226,32 @@ void WaveSimulation1D_Real::update() {
     whichGrid ^= 1;
 }
 
+void WaveSimulation1D_Real::sleepQuietSegments(i16 *curr, i16 *next) {
+    u8 *live[2] = {mSegmentLive[whichGrid].data(),
+                   mSegmentLive[whichGrid ^ 1].data()};
+    const i32 threshold = mSleepThreshold;
+    for (fl::size s = 0; s < mSegmentLive[0].size(); ++s) {
+        if (!live[0][s] && !live[1][s]) {
+            continue;
+        }
+        const fl::size first = s * kSegmentSize + 1;
+        const fl::size end = FL_MIN(first + kSegmentSize, length + 1);
+        bool quiet = true;
+        for (fl::size i = first; i < end && quiet; ++i) {
+            quiet = curr[i] <= threshold && curr[i] >= -threshold &&
+                    next[i] <= threshold && next[i] >= -threshold;
+        }
+        if (quiet) {
+            for (fl::size i = first; i < end; ++i) {
+                curr[i] = 0;
+                next[i] = 0;
+            }
+            live[0][s] = 0;
+            live[1][s] = 0;
+        }
+    }
+}
+
 WaveSimulation2D_Real::WaveSimulation2D_Real(u32 W, u32 H,
                                              float speed, float dampening)
     : width(W), height(H), stride(W + 2),
@@ -220,75 +317,437 @@ void WaveSimulation2D_Real::seti16(fl::size x, fl::size y, i16 value) {
     }
     i16 *curr = (whichGrid == 0 ? grid1.data() : grid2.data());
     curr[(y + 1) * stride + (x + 1)] = value;
+    if (mTracking && value != 0) {
+        mTileLive[whichGrid][(y / kTileSize) * mTilesX + x / kTileSize] = 1;
+    }
 }
 
-void WaveSimulation2D_Real::update() {
-    i16 *curr = (whichGrid == 0 ? grid1.data() : grid2.data());
-    i16 *next = (whichGrid == 0 ? grid2.data() : grid1.data());
+namespace {
+
+// One row of the 2D stencil: next[i] for i in [0, count), where curr and
+// next point at the first inner cell of the row. Every path computes the
+// same integers as the scalar loop, whose Q15 product wraps in 32 bits,
+// and returns whether any output is non-zero.
+bool stepRowScalar(const i16 *curr, i16 *next, u32 count, u32 stride,
+                   i32 courantSq, int dampening, bool halfDuplex) {
+    // Compute the dampening factor as an integer: 2^(dampening).
+    const i32 dampening_factor = 1 << dampening; // e.g., 6 -> 64
+    const i16 *up = curr - stride;
+    const i16 *down = curr + stride;
+    const i16 *left = curr - 1;
+    i16 any = 0;
+    for (u32 i = 0; i < count; ++i) {
+        // Laplacian: sum of four neighbors minus 4 times the center.
+        i32 laplacian = (i32)curr[i + 1] + left[i] + down[i] + up[i] -
+                        ((i32)curr[i] << 2);
+        // Compute the new value:
+        // f = - next[index] + 2 * curr[index] + mCourantSq * laplacian
+        // The multiplication is in Q15, so we shift right by 15.
+        i32 term = i32(u32(courantSq) * u32(laplacian)) >> 15;
+        i32 f = -(i32)next[i] + ((i32)curr[i] << 1) + term;
 
+        // Apply damping:
+        f = f - (f / dampening_factor);
+
+        // Clamp f to the Q15 range.
+        if (f > 32767)
+            f = 32767;
+        else if (f < -32768)
+            f = -32768;
+
+        // Set negative values to zero.
+        if (halfDuplex && f < 0)
+            f = 0;
+
+        next[i] = (i16)f;
+        any |= (i16)f;
+    }
+    return any != 0;
+}
+
+#if defined(FL_WAVE_SSE2)
+
+// Eight cells at a time. The Q15 product is built from pmaddwd pairs,
+// which wrap exactly like the scalar 32-bit product, f / 2^d rounds toward
+// zero by biasing negative values, and packing saturates to the Q15 range.
+u32 stepRowSse2(const i16 *curr, i16 *next, u32 count, u32 stride,
+                i32 courantSq, int dampening, bool halfDuplex, bool *any) {
+    const __m128i c16 = _mm_set1_epi16(i16(courantSq));
+    const __m128i twoMinusOne = _mm_set1_epi32(int(0xFFFF0002));  // (2, -1) pairs
+    const __m128i bias = _mm_set1_epi32((1 << dampening) - 1);
+    const __m128i shift = _mm_cvtsi32_si128(dampening);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bits = zero;
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i c = _mm_loadu_si128((const __m128i *)(curr + i));
+        const __m128i l = _mm_loadu_si128((const __m128i *)(curr + i - 1));
+        const __m128i r = _mm_loadu_si128((const __m128i *)(curr + i + 1));
+        const __m128i u = _mm_loadu_si128((const __m128i *)(curr + i - stride));
+        const __m128i d = _mm_loadu_si128((const __m128i *)(curr + i + stride));
+        const __m128i n = _mm_loadu_si128((const __m128i *)(next + i));
+        __m128i halves[2];
+        for (int h = 0; h < 2; ++h) {
+            const __m128i rl = h ? _mm_unpackhi_epi16(r, l) : _mm_unpacklo_epi16(r, l);
+            const __m128i du = h ? _mm_unpackhi_epi16(d, u) : _mm_unpacklo_epi16(d, u);
+            const __m128i cc = h ? _mm_unpackhi_epi16(c, c) : _mm_unpacklo_epi16(c, c);
+            const __m128i cn = h ? _mm_unpackhi_epi16(c, n) : _mm_unpacklo_epi16(c, n);
+            // courantSq * laplacian, modulo 2^32
+            __m128i product = _mm_add_epi32(_mm_madd_epi16(rl, c16),
+                                            _mm_madd_epi16(du, c16));
+            product = _mm_sub_epi32(
+                product, _mm_slli_epi32(_mm_madd_epi16(cc, c16), 1));
+            __m128i f = _mm_add_epi32(_mm_madd_epi16(cn, twoMinusOne),
+                                      _mm_srai_epi32(product, 15));
+            const __m128i negative = _mm_srai_epi32(f, 31);
+            const __m128i quotient = _mm_sra_epi32(
+                _mm_add_epi32(f, _mm_and_si128(negative, bias)), shift);
+            halves[h] = _mm_sub_epi32(f, quotient);
+        }
+        __m128i out = _mm_packs_epi32(halves[0], halves[1]);
+        if (halfDuplex) {
+            out = _mm_max_epi16(out, zero);
+        }
+        _mm_storeu_si128((__m128i *)(next + i), out);
+        bits = _mm_or_si128(bits, out);
+    }
+    *any = _mm_movemask_epi8(_mm_cmpeq_epi16(bits, zero)) != 0xFFFF;
+    return i;
+}
+
+#elif defined(FL_WAVE_NEON)
+
+u32 stepRowNeon(const i16 *curr, i16 *next, u32 count, u32 stride,
+                i32 courantSq, int dampening, bool halfDuplex, bool *any) {
+    const int16x4_t c16 = vdup_n_s16(i16(courantSq));
+    const int32x4_t bias = vdupq_n_s32((1 << dampening) - 1);
+    const int32x4_t shift = vdupq_n_s32(-dampening);
+    const int16x8_t zero = vdupq_n_s16(0);
+    int16x8_t bits = zero;
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t c = vld1q_s16(curr + i);
+        const int16x8_t l = vld1q_s16(curr + i - 1);
+        const int16x8_t r = vld1q_s16(curr + i + 1);
+        const int16x8_t u = vld1q_s16(curr + i - stride);
+        const int16x8_t d = vld1q_s16(curr + i + stride);
+        const int16x8_t n = vld1q_s16(next + i);
+        int16x4_t halves[2];
+        for (int h = 0; h < 2; ++h) {
+            const int16x4_t ch = h ? vget_high_s16(c) : vget_low_s16(c);
+            // courantSq * laplacian, modulo 2^32
+            int32x4_t product = vmull_s16(h ? vget_high_s16(r) : vget_low_s16(r), c16);
+            product = vmlal_s16(product, h ? vget_high_s16(l) : vget_low_s16(l), c16);
+            product = vmlal_s16(product, h ? vget_high_s16(u) : vget_low_s16(u), c16);
+            product = vmlal_s16(product, h ? vget_high_s16(d) : vget_low_s16(d), c16);
+            product = vsubq_s32(product, vshlq_n_s32(vmull_s16(ch, c16), 2));
+            int32x4_t f = vsubq_s32(vshll_n_s16(ch, 1),
+                                    vmovl_s16(h ? vget_high_s16(n) : vget_low_s16(n)));
+            f = vaddq_s32(f, vshrq_n_s32(product, 15));
+            const int32x4_t negative = vshrq_n_s32(f, 31);
+            const int32x4_t quotient =
+                vshlq_s32(vaddq_s32(f, vandq_s32(negative, bias)), shift);
+            halves[h] = vqmovn_s32(vsubq_s32(f, quotient));
+        }
+        int16x8_t out = vcombine_s16(halves[0], halves[1]);
+        if (halfDuplex) {
+            out = vmaxq_s16(out, zero);
+        }
+        vst1q_s16(next + i, out);
+        bits = vorrq_s16(bits, out);
+    }
+    const int32x4_t folded = vreinterpretq_s32_s16(bits);
+    *any = (vgetq_lane_s32(folded, 0) | vgetq_lane_s32(folded, 1) |
+            vgetq_lane_s32(folded, 2) | vgetq_lane_s32(folded, 3)) != 0;
+    return i;
+}
+
+#endif
+
+bool stepRow(const i16 *curr, i16 *next, u32 count, u32 stride,
+             i32 courantSq, int dampening, bool halfDuplex) {
+    u32 done = 0;
+    bool any = false;
+    // The vector shifts need a dampening exponent below 31
+    if (dampening >= 0 && dampening < 31) {
+#if defined(FL_WAVE_SSE2)
+        done = stepRowSse2(curr, next, count, stride, courantSq, dampening,
+                           halfDuplex, &any);
+#elif defined(FL_WAVE_NEON)
+        done = stepRowNeon(curr, next, count, stride, courantSq, dampening,
+                           halfDuplex, &any);
+#endif
+    }
+    return stepRowScalar(curr + done, next + done, count - done, stride,
+                         courantSq, dampening, halfDuplex) || any;
+}
+
+} // namespace
+
+void WaveSimulation2D_Real::setThreads(u8 threads) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    mPool.reset(threads > 1 ? new RowBandPool(threads) : nullptr);
+}
+
+u8 WaveSimulation2D_Real::getThreads() const {
+    return mPool ? mPool->threads() : 1;
+}
+
+void WaveSimulation2D_Real::updateColumnBorders(i16 *grid, fl::size j) const {
+    i16 *row = grid + j * stride;
+    if (mXCylindrical) {
+        row[0] = row[width];
+        row[width + 1] = row[1];
+    } else {
+        row[0] = row[1];
+        row[width + 1] = row[width];
+    }
+}
+
+void WaveSimulation2D_Real::updateRowBorder(i16 *grid, fl::size j) const {
+    // Row 0 mirrors row 1 and row height + 1 mirrors row height
+    const fl::size from = j == 0 ? 1 : height;
+    for (fl::size i = 0; i < width + 2; ++i) {
+        grid[j * stride + i] = grid[from * stride + i];
+    }
+}
+
+void WaveSimulation2D_Real::updateBorders(i16 *grid) const {
     // Update horizontal boundaries.
     for (fl::size j = 0; j < height + 2; ++j) {
-        if (mXCylindrical) {
-            curr[j * stride + 0] = curr[j * stride + width];
-            curr[j * stride + (width + 1)] = curr[j * stride + 1];
-        } else {
-            curr[j * stride + 0] = curr[j * stride + 1];
-            curr[j * stride + (width + 1)] = curr[j * stride + width];
+        updateColumnBorders(grid, j);
+    }
+    // Update vertical boundaries.
+    updateRowBorder(grid, 0);
+    updateRowBorder(grid, height + 1);
+}
+
+void WaveSimulation2D_Real::setActiveTracking(bool on) {
+    mTracking = on;
+    if (!on) {
+        return;
+    }
+    mTilesX = (width + kTileSize - 1) / kTileSize;
+    mTilesY = (height + kTileSize - 1) / kTileSize;
+    mTileStep.assign(mTilesX * mTilesY, 0);
+    for (int g = 0; g < 2; ++g) {
+        const i16 *cells = g == 0 ? grid1.data() : grid2.data();
+        mTileLive[g].assign(mTilesX * mTilesY, 0);
+        for (u32 y = 0; y < height; ++y) {
+            const i16 *row = cells + (y + 1) * stride + 1;
+            for (u32 x = 0; x < width; ++x) {
+                if (row[x] != 0) {
+                    mTileLive[g][(y / kTileSize) * mTilesX + x / kTileSize] = 1;
+                }
+            }
         }
     }
+}
 
-    // Update vertical boundaries.
-    for (fl::size i = 0; i < width + 2; ++i) {
-        curr[0 * stride + i] = curr[1 * stride + i];
-        curr[(height + 1) * stride + i] = curr[height * stride + i];
+float WaveSimulation2D_Real::getActiveFraction() const {
+    if (!mTracking || mTileStep.empty()) {
+        return 1.0f;
     }
+    return float(mSteppedTiles) / float(mTileStep.size());
+}
 
-    // Compute the dampening factor as an integer: 2^(dampening).
-    i32 dampening_factor = 1 << mDampening; // e.g., 6 -> 64
-    i32 mCourantSq32 = static_cast<i32>(mCourantSq);
+void WaveSimulation2D_Real::stepTiles() {
+    i16 *grids[2] = {grid1.data(), grid2.data()};
+    const i16 *curr = grids[whichGrid];
+    i16 *next = grids[whichGrid ^ 1];
+    updateBorders(grids[whichGrid]);
+
+    // A tile whose cells are zero in both grids, like those of its four
+    // neighbours, steps to zero, which is what it already holds. Tiles
+    // that do step wake their neighbours on the next step.
+    const u8 *liveCurr = mTileLive[whichGrid].data();
+    u8 *liveNext = mTileLive[whichGrid ^ 1].data();
+    mSteppedTiles = 0;
+    for (u32 ty = 0; ty < mTilesY; ++ty) {
+        for (u32 tx = 0; tx < mTilesX; ++tx) {
+            const u32 t = ty * mTilesX + tx;
+            // Cylindrical grids wrap around through the column borders
+            const u32 left = tx > 0 ? t - 1 : (mXCylindrical ? t + mTilesX - 1 : t);
+            const u32 right = tx + 1 < mTilesX ? t + 1 : (mXCylindrical ? t + 1 - mTilesX : t);
+            const u32 up = ty > 0 ? t - mTilesX : t;
+            const u32 down = ty + 1 < mTilesY ? t + mTilesX : t;
+            mTileStep[t] = liveCurr[t] | liveNext[t] | liveCurr[left] |
+                           liveNext[left] | liveCurr[right] | liveNext[right] |
+                           liveCurr[up] | liveNext[up] | liveCurr[down] |
+                           liveNext[down];
+            mSteppedTiles += mTileStep[t];
+        }
+    }
 
-    // Update each inner cell.
-    for (fl::size j = 1; j <= height; ++j) {
-        for (fl::size i = 1; i <= width; ++i) {
-            int index = j * stride + i;
-            // Laplacian: sum of four neighbors minus 4 times the center.
-            i32 laplacian = (i32)curr[index + 1] + curr[index - 1] +
-                                curr[index + stride] + curr[index - stride] -
-                                ((i32)curr[index] << 2);
-            // Compute the new value:
-            // f = - next[index] + 2 * curr[index] + mCourantSq * laplacian
-            // The multiplication is in Q15, so we shift right by 15.
-            i32 term = (mCourantSq32 * laplacian) >> 15;
-            i32 f =
-                -(i32)next[index] + ((i32)curr[index] << 1) + term;
-
-            // Apply damping:
-            f = f - (f / dampening_factor);
-
-            // Clamp f to the Q15 range.
-            if (f > 32767)
-                f = 32767;
-            else if (f < -32768)
-                f = -32768;
-
-            next[index] = (i16)f;
+    const i32 courantSq = static_cast<i32>(mCourantSq);
+    auto kernel = [&](u32 firstTileRow, u32 endTileRow) {
+        for (u32 ty = firstTileRow; ty < endTileRow; ++ty) {
+            const u32 y0 = ty * kTileSize;
+            const u32 y1 = FL_MIN(y0 + kTileSize, height);
+            const u32 rowTile = ty * mTilesX;
+            u32 tx = 0;
+            while (tx < mTilesX) {
+                if (!mTileStep[rowTile + tx]) {
+                    ++tx;
+                    continue;
+                }
+                // Runs of neighbouring tiles step as one span, which keeps
+                // the rows long enough for the vector kernels.
+                const u32 first = tx;
+                while (tx < mTilesX && mTileStep[rowTile + tx]) {
+                    ++tx;
+                }
+                const u32 x0 = first * kTileSize;
+                const u32 w = FL_MIN(tx * kTileSize, width) - x0;
+                bool any = false;
+                for (u32 j = y0 + 1; j <= y1; ++j) {
+                    const u32 index = j * stride + x0 + 1;
+                    any |= stepRow(curr + index, next + index, w, stride,
+                                   courantSq, mDampening, mHalfDuplex);
+                }
+                if (tx - first == 1 || !any) {
+                    for (u32 t = rowTile + first; t < rowTile + tx; ++t) {
+                        liveNext[t] = any;
+                    }
+                    continue;
+                }
+                // Flag each tile on its own, or wakes would run ahead of
+                // the ripples along the span. Tiles with a ripple in them
+                // tend to stop at their first cells.
+                for (u32 t = first; t < tx; ++t) {
+                    liveNext[rowTile + t] =
+                        tileHasValue(next, t * kTileSize, y0,
+                                     FL_MIN((t + 1) * kTileSize, width), y1);
+                }
+            }
         }
+    };
+    if (mPool) {
+        mPool->run(mTilesY, kernel);
+    } else {
+        kernel(0, mTilesY);
     }
+    if (mSleepThreshold > 0) {
+        sleepQuietTiles(grids[whichGrid], next);
+    }
+    whichGrid ^= 1;
+}
 
-    if (mHalfDuplex) {
-        // Set negative values to zero.
-        for (fl::size j = 1; j <= height; ++j) {
-            for (fl::size i = 1; i <= width; ++i) {
-                int index = j * stride + i;
-                if (next[index] < 0) {
-                    next[index] = 0;
+bool WaveSimulation2D_Real::tileHasValue(const i16 *grid, u32 x0, u32 y0,
+                                         u32 x1, u32 y1) const {
+    for (u32 y = y0; y < y1; ++y) {
+        const i16 *row = grid + (y + 1) * stride + 1;
+        for (u32 x = x0; x < x1; ++x) {
+            if (row[x] != 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WaveSimulation2D_Real::sleepQuietTiles(i16 *curr, i16 *next) {
+    u8 *live[2] = {mTileLive[whichGrid].data(), mTileLive[whichGrid ^ 1].data()};
+    const i32 threshold = mSleepThreshold;
+    for (u32 t = 0; t < mTileStep.size(); ++t) {
+        if (!live[0][t] && !live[1][t]) {
+            continue;
+        }
+        const u32 x0 = (t % mTilesX) * kTileSize;
+        const u32 y0 = (t / mTilesX) * kTileSize;
+        const u32 x1 = FL_MIN(x0 + kTileSize, width);
+        const u32 y1 = FL_MIN(y0 + kTileSize, height);
+        bool quiet = true;
+        for (u32 y = y0; y < y1 && quiet; ++y) {
+            const u32 row = (y + 1) * stride + 1;
+            for (u32 x = x0; x < x1; ++x) {
+                const i32 a = curr[row + x];
+                const i32 b = next[row + x];
+                if (a > threshold || a < -threshold || b > threshold ||
+                    b < -threshold) {
+                    quiet = false;
+                    break;
                 }
             }
         }
+        if (!quiet) {
+            continue;
+        }
+        for (u32 y = y0; y < y1; ++y) {
+            const u32 row = (y + 1) * stride + 1;
+            for (u32 x = x0; x < x1; ++x) {
+                curr[row + x] = 0;
+                next[row + x] = 0;
+            }
+        }
+        live[0][t] = 0;
+        live[1][t] = 0;
     }
+}
 
-    // Swap the roles of the grids.
-    whichGrid ^= 1;
+void WaveSimulation2D_Real::update() { update(1); }
+
+void WaveSimulation2D_Real::update(u32 steps) {
+    if (steps == 0 || width == 0 || height == 0) {
+        return;
+    }
+    if (mTracking) {
+        // Sparse steps can't be fused: each one decides which tiles to visit
+        for (u32 s = 0; s < steps; ++s) {
+            stepTiles();
+        }
+        return;
+    }
+    i16 *grids[2] = {grid1.data(), grid2.data()};
+    const i32 courantSq = static_cast<i32>(mCourantSq);
+
+    if (mPool) {
+        // Each step is split into row bands, one per thread
+        for (u32 s = 0; s < steps; ++s) {
+            const i16 *curr = grids[whichGrid];
+            i16 *next = grids[whichGrid ^ 1];
+            updateBorders(grids[whichGrid]);
+            mPool->run(u32(height), [&](u32 first, u32 end) {
+                for (u32 j = first + 1; j <= end; ++j) {
+                    stepRow(curr + j * stride + 1, next + j * stride + 1, width,
+                            stride, courantSq, mDampening, mHalfDuplex);
+                }
+            });
+            whichGrid ^= 1;
+        }
+        return;
+    }
+
+    // All steps in one pass down the grid: step s works one row behind
+    // step s - 1, so it reads rows that step just finished and overwrites
+    // only rows no earlier step still needs. The rows in flight stay in
+    // cache across the steps.
+    updateBorders(grids[whichGrid]);
+    const fl::size rows = height;
+    for (fl::size t = 1; t < rows + steps; ++t) {
+        for (u32 s = 0; s < steps; ++s) {
+            if (t < fl::size(s) + 1 || t - s > rows) {
+                continue;
+            }
+            const fl::size j = t - s;
+            const i16 *curr = grids[(whichGrid + s) & 1];
+            i16 *next = grids[(whichGrid + s + 1) & 1];
+            stepRow(curr + j * stride + 1, next + j * stride + 1, width, stride,
+                    courantSq, mDampening, mHalfDuplex);
+            // The row is final for this step; give it the borders the next
+            // step expects
+            updateColumnBorders(next, j);
+            if (j == 1) {
+                updateRowBorder(next, 0);
+            }
+            if (j == rows) {
+                updateRowBorder(next, rows + 1);
+            }
+        }
+    }
+    whichGrid = (whichGrid + steps) & 1;
 }
 
 } // namespace fl
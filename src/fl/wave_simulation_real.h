@@ -16,6 +16,7 @@ Based on works and code by Shawn Silverman.
 #include "fl/warn.h"
 
 #include "fl/ptr.h"         // For FASTLED_SMART_PTR macros
+#include "fl/row_band_pool.h"
 #include "fl/supersample.h"
 #include "fl/xymap.h"
 #include "fx/fx.h"
@@ -96,7 +97,24 @@ class WaveSimulation1D_Real {
     // Advance the simulation one time step.
     void update();
 
+    // Steps only the segments of kSegmentSize cells that hold a non-zero
+    // value, in either grid, or border one that does. The other segments
+    // would step to zero, so the result is identical to the dense update.
+    void setActiveTracking(bool on);
+    bool getActiveTracking() const { return mTracking; }
+    // Lossy: after each step, segments whose values all lie within
+    // +-threshold are zeroed so they can sleep. 0 (default) keeps the
+    // result exact.
+    void setSleepThreshold(u16 threshold) { mSleepThreshold = threshold; }
+    u16 getSleepThreshold() const { return mSleepThreshold; }
+    // Share of the segments the last update() stepped
+    float getActiveFraction() const;
+
+    static constexpr u32 kSegmentSize = 64;
+
   private:
+    void sleepQuietSegments(i16 *curr, i16 *next);
+
     u32 length; // Length of the inner simulation grid.
     // Two grids stored in fixed Q15 format, each with length+2 entries
     // (including boundary cells).
@@ -108,7 +126,10 @@ class WaveSimulation1D_Real {
     int mDampenening; // Dampening exponent (damping factor = 2^(mDampenening)).
     bool mHalfDuplex =
         true; // Flag to restrict values to positive range during update.
-
+    bool mTracking = false;
+    u16 mSleepThreshold = 0;
+    fl::vector<u8> mSegmentLive[2]; // Per grid: segment has a non-zero cell
+    fl::size mSteppedSegments = 0;
 };
 
 class WaveSimulation2D_Real {
@@ -183,11 +204,47 @@ class WaveSimulation2D_Real {
 
     // Advance the simulation one time step using fixed-point arithmetic.
     void update();
+    // Advance the simulation `steps` time steps, with the same result as
+    // calling update() that many times. On one thread the steps are fused
+    // into a single pass down the grid, each step one row behind the
+    // previous, so every row is loaded into cache once for all of them.
+    void update(u32 steps);
+
+    // Splits each step into row bands run in parallel, on
+    // FASTLED_MULTITHREADED builds (threads on the host, FreeRTOS tasks on
+    // ESP32); elsewhere it stays 1. Default 1.
+    void setThreads(u8 threads);
+    u8 getThreads() const;
+
+    // Steps only the kTileSize x kTileSize tiles that hold a non-zero value,
+    // in either grid, or border one that does. The other tiles would step
+    // to zero, so the result is identical to the dense update. Ripples
+    // wake the tiles they reach and tiles that die out go back to sleep.
+    // Steps can't be fused while tracking, so it pays off when ripples
+    // cover less than about two thirds of the grid.
+    void setActiveTracking(bool on);
+    bool getActiveTracking() const { return mTracking; }
+    // Lossy: after each step, tiles whose values all lie within
+    // +-threshold are zeroed so they can sleep. 0 (default) keeps the
+    // result exact.
+    void setSleepThreshold(u16 threshold) { mSleepThreshold = threshold; }
+    u16 getSleepThreshold() const { return mSleepThreshold; }
+    // Share of the tiles the last update() stepped
+    float getActiveFraction() const;
+
+    static constexpr u32 kTileSize = 16;
 
     u32 getWidth() const { return width; }
     u32 getHeight() const { return height; }
 
   private:
+    void updateColumnBorders(i16 *grid, fl::size j) const;
+    void updateRowBorder(i16 *grid, fl::size j) const;
+    void updateBorders(i16 *grid) const;
+    void stepTiles();
+    bool tileHasValue(const i16 *grid, u32 x0, u32 y0, u32 x1, u32 y1) const;
+    void sleepQuietTiles(i16 *curr, i16 *next);
+
     u32 width;  // Width of the inner grid.
     u32 height; // Height of the inner grid.
     u32 stride; // Row length (width + 2 for the borders).
@@ -203,6 +260,14 @@ class WaveSimulation2D_Real {
     bool mHalfDuplex =
         true; // Flag to restrict values to positive range during update.
     bool mXCylindrical = false; // Default to non-cylindrical mode
+    fl::unique_ptr<RowBandPool> mPool; // Null when running on one thread
+    bool mTracking = false;
+    u16 mSleepThreshold = 0;
+    u32 mTilesX = 0;
+    u32 mTilesY = 0;
+    fl::vector<u8> mTileLive[2]; // Per grid: tile has a non-zero cell
+    fl::vector<u8> mTileStep;    // Tiles the current step visits
+    fl::size mSteppedTiles = 0;
 };
 
 } // namespace fl
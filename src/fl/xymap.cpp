@@ -5,9 +5,29 @@
 #include "fl/force_inline.h"
 #include "fl/screenmap.h"
 #include "fl/xymap.h"
+#include "fl/algorithm.h"
+#include "fl/math_macros.h"
 
 namespace fl {
 
+namespace {
+
+void copyReversed(const CRGB *src, CRGB *dst, u16 count) {
+    // dst[i] = src[-i]
+    for (u16 i = 0; i < count; ++i) {
+        dst[i] = *(src - i);
+    }
+}
+
+void scatterReversed(const CRGB *src, CRGB *dst, u16 count) {
+    // dst[-i] = src[i]
+    for (u16 i = 0; i < count; ++i) {
+        *(dst - i) = src[i];
+    }
+}
+
+} // namespace
+
 ScreenMap XYMap::toScreenMap() const {
     const u16 length = width * height;
     ScreenMap out(length);
@@ -60,13 +80,188 @@ XYMap::XYMap(u16 width, u16 height, bool is_serpentine,
       height(height), mOffset(offset) {}
 
 void XYMap::mapPixels(const CRGB *input, CRGB *output) const {
-    u16 pos = 0;
-    for (u16 y = 0; y < height; y++) {
-        for (u16 x = 0; x < width; x++) {
-            u16 i = pos++;
-            output[i] = input[mapToIndex(x, y)];
+    gather(input, output);
+}
+
+void XYMap::gather(const CRGB *leds, CRGB *grid) const {
+    if (mRuns) {
+        for (const Run &run : *mRuns) {
+            if (run.step > 0) {
+                fl::memcpy(grid + run.grid, leds + run.led,
+                           run.length * sizeof(CRGB));
+            } else {
+                copyReversed(leds + run.led, grid + run.grid, run.length);
+            }
+        }
+        return;
+    }
+    switch (type) {
+    case kLineByLine:
+        fl::memcpy(grid, leds + mOffset, u32(width) * height * sizeof(CRGB));
+        return;
+    case kSerpentine:
+        for (u16 y = 0; y < height; ++y) {
+            CRGB *row = grid + u32(y) * width;
+            if (y & 1) {
+                copyReversed(leds + mOffset + u32(y + 1) * width - 1, row, width);
+            } else {
+                fl::memcpy(row, leds + mOffset + u32(y) * width,
+                           width * sizeof(CRGB));
+            }
+        }
+        return;
+    case kLookUpTable: {
+        // Indices are independent, so unrolling lets several loads be in
+        // flight at once
+        const u16 *lut = mLookUpTable->getData();
+        const CRGB *base = leds + mOffset;
+        const u32 count = u32(width) * height;
+        u32 i = 0;
+        for (; i + 4 <= count; i += 4) {
+            grid[i] = base[lut[i]];
+            grid[i + 1] = base[lut[i + 1]];
+            grid[i + 2] = base[lut[i + 2]];
+            grid[i + 3] = base[lut[i + 3]];
+        }
+        for (; i < count; ++i) {
+            grid[i] = base[lut[i]];
+        }
+        return;
+    }
+    default:
+        break;
+    }
+    u32 pos = 0;
+    for (u16 y = 0; y < height; ++y) {
+        for (u16 x = 0; x < width; ++x) {
+            grid[pos++] = leds[mapToIndex(x, y)];
+        }
+    }
+}
+
+void XYMap::scatter(const CRGB *grid, CRGB *leds) const {
+    if (mRuns) {
+        for (const Run &run : *mRuns) {
+            if (run.step > 0) {
+                fl::memcpy(leds + run.led, grid + run.grid,
+                           run.length * sizeof(CRGB));
+            } else {
+                scatterReversed(grid + run.grid, leds + run.led, run.length);
+            }
+        }
+        return;
+    }
+    switch (type) {
+    case kLineByLine:
+        fl::memcpy(leds + mOffset, grid, u32(width) * height * sizeof(CRGB));
+        return;
+    case kSerpentine:
+        for (u16 y = 0; y < height; ++y) {
+            const CRGB *row = grid + u32(y) * width;
+            if (y & 1) {
+                scatterReversed(row, leds + mOffset + u32(y + 1) * width - 1, width);
+            } else {
+                fl::memcpy(leds + mOffset + u32(y) * width, row,
+                           width * sizeof(CRGB));
+            }
+        }
+        return;
+    case kLookUpTable: {
+        const u16 *lut = mLookUpTable->getData();
+        CRGB *base = leds + mOffset;
+        const u32 count = u32(width) * height;
+        u32 i = 0;
+        for (; i + 4 <= count; i += 4) {
+            base[lut[i]] = grid[i];
+            base[lut[i + 1]] = grid[i + 1];
+            base[lut[i + 2]] = grid[i + 2];
+            base[lut[i + 3]] = grid[i + 3];
+        }
+        for (; i < count; ++i) {
+            base[lut[i]] = grid[i];
+        }
+        return;
+    }
+    default:
+        break;
+    }
+    u32 pos = 0;
+    for (u16 y = 0; y < height; ++y) {
+        for (u16 x = 0; x < width; ++x) {
+            leds[mapToIndex(x, y)] = grid[pos++];
+        }
+    }
+}
+
+void XYMap::compile() {
+    if (type == kSerpentine || type == kLineByLine || mRuns) {
+        return;
+    }
+    const u32 count = u32(width) * height;
+    fl::shared_ptr<Runs> runs = fl::make_shared<Runs>();
+    u32 i = 0;
+    while (i < count) {
+        const u16 x = u16(i % width);
+        const u16 y = u16(i / width);
+        Run run;
+        run.grid = u16(i);
+        run.led = mapToIndex(x, y);
+        run.length = 1;
+        run.step = 1;
+        // Extend while the next grid pixel lands on the neighbouring LED
+        while (i + run.length < count && run.length < 0xFFFF) {
+            const u32 next = i + run.length;
+            const int led = mapToIndex(u16(next % width), u16(next / width));
+            const int expected = int(run.led) + run.step * int(run.length);
+            if (run.length == 1 && (led == run.led + 1 || led == run.led - 1)) {
+                run.step = i16(led - run.led);
+            } else if (led != expected) {
+                break;
+            }
+            ++run.length;
+        }
+        runs->push_back(run);
+        i += run.length;
+    }
+    // Column-wired panels break into single pixels; the unrolled LUT loop
+    // beats a run table there
+    if (runs->size() * 4 > count) {
+        if (type == kFunction) {
+            convertToLookUpTable();
+        }
+        return;
+    }
+    // LED order: gather() then walks the LED buffer front to back
+    fl::sort(runs->begin(), runs->end(), [](const Run &a, const Run &b) {
+        const int firstA = a.step > 0 ? a.led : a.led - (a.length - 1);
+        const int firstB = b.step > 0 ? b.led : b.led - (b.length - 1);
+        return firstA < firstB;
+    });
+    mRuns = runs;
+}
+
+u32 XYMap::indexEnd() const {
+    const u32 count = u32(width) * height;
+    if (count == 0) {
+        return 0;
+    }
+    if (type == kSerpentine || type == kLineByLine) {
+        return mOffset + count;
+    }
+    u32 end = 0;
+    if (mRuns) {
+        for (const Run &run : *mRuns) {
+            const u32 last = run.step > 0 ? u32(run.led) + run.length - 1 : run.led;
+            end = FL_MAX(end, last + 1);
         }
+        return end;
     }
+    for (u16 y = 0; y < height; ++y) {
+        for (u16 x = 0; x < width; ++x) {
+            end = FL_MAX(end, u32(mapToIndex(x, y)) + 1);
+        }
+    }
+    return end;
 }
 
 void XYMap::convertToLookUpTable() {
@@ -82,12 +277,14 @@ void XYMap::convertToLookUpTable() {
     }
     type = kLookUpTable;
     xyFunction = nullptr;
+    mRuns.reset();
 }
 
 void XYMap::setRectangularGrid() {
     type = kLineByLine;
     xyFunction = nullptr;
     mLookUpTable.reset();
+    mRuns.reset();
 }
 
 u16 XYMap::mapToIndex(const u16 &x, const u16 &y) const {
@@ -125,6 +322,13 @@ u16 XYMap::getTotal() const { return width * height; }
 
 XYMap::XyMapType XYMap::getType() const { return type; }
 
+bool XYMap::operator==(const XYMap &other) const {
+    return type == other.type && width == other.width &&
+           height == other.height && mOffset == other.mOffset &&
+           xyFunction == other.xyFunction &&
+           mLookUpTable.get() == other.mLookUpTable.get();
+}
+
 XYMap::XYMap(u16 width, u16 height, XyMapType type)
     : type(type), width(width), height(height), mOffset(0) {}
 
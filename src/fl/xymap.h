@@ -10,6 +10,7 @@
 #include "fl/ptr.h"         // For FASTLED_SMART_PTR macros
 #include "fl/deprecated.h"
 #include "fl/xmap.h" // Include xmap.h for LUT16
+#include "fl/vector.h"
 
 namespace fl {
 class ScreenMap;
@@ -76,8 +77,31 @@ class XYMap {
 
     fl::ScreenMap toScreenMap() const;
 
+    // output[y * width + x] = input[mapToIndex(x, y)]; same as gather()
     void mapPixels(const CRGB *input, CRGB *output) const;
 
+    // ----- Bulk remapping -----
+    // Copies a whole layout into row-major grid order and back, without a
+    // mapToIndex() call per pixel: line-by-line maps are one memcpy,
+    // serpentine maps a straight or reversed copy per row and compiled
+    // maps a copy per run.
+    //   gather:  grid[y * width + x] = leds[mapToIndex(x, y)]
+    //   scatter: leds[mapToIndex(x, y)] = grid[y * width + x]
+    void gather(const CRGB *leds, CRGB *grid) const;
+    void scatter(const CRGB *grid, CRGB *leds) const;
+    // Evaluates a function or look-up-table layout once and stores it as
+    // runs of pixels that map to consecutive LEDs, forwards or backwards,
+    // ordered by LED index so gather() reads the LED buffer front to back.
+    // Layouts that do not form runs, such as column-wired panels, are left
+    // as (or turned into) a look-up table and isCompiled() stays false.
+    // Serpentine and line-by-line maps need no compiling. Changing the
+    // layout with convertToLookUpTable() or setRectangularGrid() drops it.
+    void compile();
+    bool isCompiled() const { return mRuns != nullptr; }
+    // One past the largest LED index the map produces. O(1) except for
+    // function and look-up-table maps that are not compiled.
+    u32 indexEnd() const;
+
     void convertToLookUpTable();
 
     void setRectangularGrid();
@@ -118,15 +142,30 @@ class XYMap {
     u16 getTotal() const;
     XyMapType getType() const;
 
+    // Same layout: type, size, offset and function. Look-up tables compare
+    // by identity; a map's table can't change once it is built.
+    bool operator==(const XYMap &other) const;
+    bool operator!=(const XYMap &other) const { return !(*this == other); }
+
   private:
     XYMap(u16 width, u16 height, XyMapType type);
 
+    // `length` grid pixels from `grid` on map to LEDs led, led + step, ...
+    struct Run {
+        u16 grid;
+        u16 led;
+        u16 length;
+        i16 step;
+    };
+    typedef fl::vector<Run> Runs;
+
     XyMapType type;
     u16 width;
     u16 height;
     XYFunction xyFunction = nullptr;
     fl::LUT16Ptr mLookUpTable; // optional refptr to look up table.
     u16 mOffset = 0;      // offset to be added to the output
+    fl::shared_ptr<const Runs> mRuns;  // set by compile()
 };
 
 } // namespace fl
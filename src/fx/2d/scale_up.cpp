@@ -63,9 +63,16 @@ void ScaleUp::expand(const CRGB *input, CRGB *output, uint16_t width,
 #if FASTLED_SCALE_UP == FASTLED_SCALE_UP_ALWAYS_POWER_OF_2
     fl::upscalePowerOf2(input, output, static_cast<uint8_t>(width), static_cast<uint8_t>(height), mXyMap);
 #elif FASTLED_SCALE_UP == FASTLED_SCALE_UP_HIGH_PRECISION
-    fl::upscaleArbitrary(input, output, width, height, mXyMap);
+    mUpscaler.upscale(input, output, width, height, mXyMap);
 #elif FASTLED_SCALE_UP == FASTLED_SCALE_UP_DECIDE_AT_RUNTIME
-    fl::upscale(input, output, width, height, mXyMap);
+    // Power-of-2 inputs keep the bit-shift versions, which round differently.
+    // The cached tables reproduce upscaleArbitrary() for every other size.
+    const bool powerOf2 = !(width & (width - 1)) && !(height & (height - 1));
+    if (powerOf2) {
+        fl::upscale(input, output, width, height, mXyMap);
+    } else {
+        mUpscaler.upscale(input, output, width, height, mXyMap);
+    }
 #elif FASTLED_SCALE_UP == FASTLED_SCALE_UP_FORCE_FLOATING_POINT
     fl::upscaleFloat(input, output, static_cast<uint8_t>(width), static_cast<uint8_t>(height), mXyMap);
 #else
@@ -14,6 +14,7 @@
 #include "crgb.h"
 #include "fl/ptr.h"         // For FASTLED_SMART_PTR macros
 #include "fl/shared_ptr.h"  // For shared_ptr
+#include "fl/upscale.h"     // For BilinearUpscaler
 #include "fl/xymap.h"       // Needed for constructor parameter
 #include "fx/fx2d.h"
 
@@ -90,8 +91,10 @@ class ScaleUp : public Fx2d {
     /// The actual interpolation algorithm used depends on the FASTLED_SCALE_UP compile-time
     /// setting:
     /// - POWER_OF_2: Fast bit-shift version (requires power-of-2 dimensions)
-    /// - HIGH_PRECISION: Integer math for arbitrary dimensions
-    /// - DECIDE_AT_RUNTIME: Automatically selects based on input dimensions
+    /// - HIGH_PRECISION: Integer math for arbitrary dimensions, using
+    ///   sampling tables that are built on the first frame (BilinearUpscaler)
+    /// - DECIDE_AT_RUNTIME: POWER_OF_2 for power-of-2 input dimensions,
+    ///   HIGH_PRECISION otherwise
     /// - FORCE_FLOATING_POINT: Floating-point math (slowest, not recommended)
     ///
     /// @note This method is exposed primarily for unit testing and is not part of the public API.
@@ -115,6 +118,7 @@ class ScaleUp : public Fx2d {
                   uint16_t height);
 
     Fx2dPtr mDelegate;  ///< The wrapped effect that renders at low resolution
+    BilinearUpscaler mUpscaler;  ///< Cached sampling tables for expand()
     fl::vector<CRGB, fl::allocator_psram<CRGB>> mSurface;  ///< Low-resolution render buffer
 };
 
@@ -17,18 +17,180 @@
 #include "fx/audio/detectors/mood_analyzer.h"
 #include "fx/audio/detectors/buildup.h"
 #include "fx/audio/detectors/drop.h"
+#include "fl/warn.h"
 
 namespace fl {
 
 AudioProcessor::AudioProcessor()
     : mContext(make_shared<AudioContext>(AudioSample()))
+    , mFrameListener(this)
+    , mMarshal(false)
+    , mSnapshotIndex(0)
 {}
 
-AudioProcessor::~AudioProcessor() = default;
+AudioProcessor::~AudioProcessor() {
+    stopWorker();
+}
 
 void AudioProcessor::update(const AudioSample& sample) {
+    if (!mWorker) {
+        process(sample);
+        return;
+    }
+    if (!sample.isValid()) {
+        return;
+    }
+    const AudioSample::VectorPCM& pcm = sample.pcm();
+    if (pcm.size() > mQueue->blockSize()) {
+        FL_WARN("AudioProcessor: block of " << pcm.size()
+                << " samples exceeds the worker block size "
+                << mQueue->blockSize());
+        return;
+    }
+    // A full queue drops the block and counts an overrun
+    mQueue->push(fl::span<const i16>(pcm.data(), pcm.size()), sample.timestamp());
+}
+
+void AudioProcessor::update(const AudioSample& sample,
+                            const FFTSpectrum& spectrum) {
+    if (mWorker || mContext->isSTFT()) {
+        update(sample);
+        return;
+    }
     mContext->setSample(sample);
+    mContext->setSpectrum(spectrum);
+    updateDetectors();
+    publishSnapshot();
+}
+
+void AudioProcessor::process(const AudioSample& sample) {
+    if (mContext->isSTFT()) {
+        mContext->pushSample(sample, [this]() {
+            updateDetectors();
+            publishSnapshot();
+        });
+        return;
+    }
+    mContext->setSample(sample);
+    updateDetectors();
+    publishSnapshot();
+}
+
+bool AudioProcessor::workerStep() {
+    if (mQueue->empty()) {
+        return false;
+    }
+    AudioSample sample = mQueue->pop();
+    if (!sample.isValid()) {
+        return false;
+    }
+    process(sample);
+    return true;
+}
+
+bool AudioProcessor::startWorker(const AudioWorkerConfig& config,
+                                 fl::size maxBlockSize, fl::size queueBlocks) {
+    if (mWorker) {
+        return true;
+    }
+    mQueue = make_shared<AudioSampleQueue>(queueBlocks, maxBlockSize);
+    mMarshal.store(true);
+    mWorker = IAudioWorker::create([this]() { return workerStep(); }, config);
+    if (!mWorker) {
+        mMarshal.store(false);
+        mQueue.reset();
+        return false;
+    }
+    EngineEvents::addListener(&mFrameListener);
+    return true;
+}
+
+void AudioProcessor::stopWorker() {
+    if (!mWorker) {
+        return;
+    }
+    mWorker->stop();
+    mWorker.reset();
+    mQueue.reset();
+    mMarshal.store(false);
+    EngineEvents::removeListener(&mFrameListener);
+    // Deliver whatever the worker produced before it stopped
+    dispatchEvents();
+}
+
+fl::size AudioProcessor::dispatchEvents() {
+    {
+        fl::lock_guard<fl::mutex> lock(mEventMutex);
+        if (mPendingEvents.empty()) {
+            return 0;
+        }
+        fl::swap(mPendingEvents, mDispatching);
+    }
+    // Callbacks run unlocked so the worker is never blocked on user code
+    const fl::size count = mDispatching.size();
+    for (fl::size i = 0; i < count; ++i) {
+        mDispatching[i]();
+    }
+    mDispatching.clear();
+    return count;
+}
+
+void AudioProcessor::publishSnapshot() {
+    if (mBeatDetector && mBeatDetector->isBeat()) {
+        ++mBeatCount;
+    }
+    const u32 index = mSnapshotIndex.load() ^ 1u;
+    AudioSnapshot& snap = mSnapshots[index];
+    mSnapshotVersions[index].fetch_add(1);  // odd: being written
+    snap.sequence = ++mSequence;
+    snap.timestamp = mContext->getTimestamp();
+    snap.rms = mContext->getRMS();
+    snap.zcf = mContext->getZCF();
+    snap.beatCount = mBeatCount;
+    if (mBeatDetector) {
+        snap.bpm = mBeatDetector->getBPM();
+        snap.beatPhase = mBeatDetector->getPhase();
+    }
+    if (mFrequencyBands) {
+        snap.bass = mFrequencyBands->getBass();
+        snap.mid = mFrequencyBands->getMid();
+        snap.treble = mFrequencyBands->getTreble();
+    }
+    if (mEnergyAnalyzer) {
+        snap.peak = mEnergyAnalyzer->getPeak();
+        snap.averageEnergy = mEnergyAnalyzer->getAverageEnergy();
+    }
+    if (mSilenceDetector) {
+        snap.silent = mSilenceDetector->isSilent();
+    }
+    if (mPitchDetector) {
+        snap.pitch = mPitchDetector->getPitch();
+        snap.voiced = mPitchDetector->isVoiced();
+    }
+    mSnapshotVersions[index].fetch_add(1);  // even: complete
+    mSnapshotIndex.store(index);
+}
+
+AudioSnapshot AudioProcessor::snapshot() const {
+    while (true) {
+        const u32 index = mSnapshotIndex.load();
+        const u32 before = mSnapshotVersions[index].load();
+        if (before & 1u) {
+            continue;
+        }
+        AudioSnapshot copy = mSnapshots[index];
+        // An acq_rel read-modify-write keeps the copy ordered before the check
+        if (mSnapshotVersions[index].fetch_add(0) == before) {
+            return copy;
+        }
+    }
+}
 
+void AudioProcessor::setSTFT(fl::size window, fl::size hop, u32 sampleRate) {
+    mContext->setSTFT(window, hop, sampleRate);
+}
+
+void AudioProcessor::updateDetectors() {
     if (mBeatDetector) {
         mBeatDetector->update(mContext);
     }
@@ -85,209 +247,227 @@ void AudioProcessor::update(const AudioSample& sample) {
     }
 }
 
+AudioFeatureMask AudioProcessor::getActiveFeatures() const {
+    const AudioDetector* detectors[] = {
+        mBeatDetector.get(), mFrequencyBands.get(), mEnergyAnalyzer.get(),
+        mTempoAnalyzer.get(), mTransientDetector.get(), mSilenceDetector.get(),
+        mDynamicsAnalyzer.get(), mPitchDetector.get(), mNoteDetector.get(),
+        mDownbeatDetector.get(), mBackbeatDetector.get(), mVocalDetector.get(),
+        mPercussionDetector.get(), mChordDetector.get(), mKeyDetector.get(),
+        mMoodAnalyzer.get(), mBuildupDetector.get(), mDropDetector.get()};
+    // The snapshot carries the frame RMS whatever is registered
+    AudioFeatureMask mask = audioFeatureBit(AudioFeature::RMS);
+    for (const AudioDetector* detector : detectors) {
+        if (detector) {
+            mask |= detector->requiredFeatures();
+        }
+    }
+    return audioFeatureClosure(mask);
+}
+
 void AudioProcessor::onBeat(function<void()> callback) {
     auto detector = getBeatDetector();
-    detector->onBeat = callback;
+    detector->onBeat = marshal(callback);
 }
 
 void AudioProcessor::onBeatPhase(function<void(float)> callback) {
     auto detector = getBeatDetector();
-    detector->onBeatPhase = callback;
+    detector->onBeatPhase = marshal(callback);
 }
 
 void AudioProcessor::onOnset(function<void(float)> callback) {
     auto detector = getBeatDetector();
-    detector->onOnset = callback;
+    detector->onOnset = marshal(callback);
 }
 
 void AudioProcessor::onTempoChange(function<void(float, float)> callback) {
     auto detector = getBeatDetector();
-    detector->onTempoChange = callback;
+    detector->onTempoChange = marshal(callback);
 }
 
 void AudioProcessor::onTempo(function<void(float)> callback) {
     auto detector = getTempoAnalyzer();
-    detector->onTempo = callback;
+    detector->onTempo = marshal(callback);
 }
 
 void AudioProcessor::onTempoWithConfidence(function<void(float, float)> callback) {
     auto detector = getTempoAnalyzer();
-    detector->onTempoWithConfidence = callback;
+    detector->onTempoWithConfidence = marshal(callback);
 }
 
 void AudioProcessor::onTempoStable(function<void()> callback) {
     auto detector = getTempoAnalyzer();
-    detector->onTempoStable = callback;
+    detector->onTempoStable = marshal(callback);
 }
 
 void AudioProcessor::onTempoUnstable(function<void()> callback) {
     auto detector = getTempoAnalyzer();
-    detector->onTempoUnstable = callback;
+    detector->onTempoUnstable = marshal(callback);
 }
 
 void AudioProcessor::onBass(function<void(float)> callback) {
     auto detector = getFrequencyBands();
-    detector->onBassLevel = callback;
+    detector->onBassLevel = marshal(callback);
 }
 
 void AudioProcessor::onMid(function<void(float)> callback) {
     auto detector = getFrequencyBands();
-    detector->onMidLevel = callback;
+    detector->onMidLevel = marshal(callback);
 }
 
 void AudioProcessor::onTreble(function<void(float)> callback) {
     auto detector = getFrequencyBands();
-    detector->onTrebleLevel = callback;
+    detector->onTrebleLevel = marshal(callback);
 }
 
 void AudioProcessor::onFrequencyBands(function<void(float, float, float)> callback) {
     auto detector = getFrequencyBands();
-    detector->onLevelsUpdate = callback;
+    detector->onLevelsUpdate = marshal(callback);
 }
 
 void AudioProcessor::onEnergy(function<void(float)> callback) {
     auto detector = getEnergyAnalyzer();
-    detector->onEnergy = callback;
+    detector->onEnergy = marshal(callback);
 }
 
 void AudioProcessor::onPeak(function<void(float)> callback) {
     auto detector = getEnergyAnalyzer();
-    detector->onPeak = callback;
+    detector->onPeak = marshal(callback);
 }
 
 void AudioProcessor::onAverageEnergy(function<void(float)> callback) {
     auto detector = getEnergyAnalyzer();
-    detector->onAverageEnergy = callback;
+    detector->onAverageEnergy = marshal(callback);
 }
 
 void AudioProcessor::onTransient(function<void()> callback) {
     auto detector = getTransientDetector();
-    detector->onTransient = callback;
+    detector->onTransient = marshal(callback);
 }
 
 void AudioProcessor::onTransientWithStrength(function<void(float)> callback) {
     auto detector = getTransientDetector();
-    detector->onTransientWithStrength = callback;
+    detector->onTransientWithStrength = marshal(callback);
 }
 
 void AudioProcessor::onAttack(function<void(float)> callback) {
     auto detector = getTransientDetector();
-    detector->onAttack = callback;
+    detector->onAttack = marshal(callback);
 }
 
 void AudioProcessor::onSilence(function<void(bool)> callback) {
     auto detector = getSilenceDetector();
-    detector->onSilenceChange = callback;
+    detector->onSilenceChange = marshal(callback);
 }
 
 void AudioProcessor::onSilenceStart(function<void()> callback) {
     auto detector = getSilenceDetector();
-    detector->onSilenceStart = callback;
+    detector->onSilenceStart = marshal(callback);
 }
 
 void AudioProcessor::onSilenceEnd(function<void()> callback) {
     auto detector = getSilenceDetector();
-    detector->onSilenceEnd = callback;
+    detector->onSilenceEnd = marshal(callback);
 }
 
 void AudioProcessor::onSilenceDuration(function<void(u32)> callback) {
     auto detector = getSilenceDetector();
-    detector->onSilenceDuration = callback;
+    detector->onSilenceDuration = marshal(callback);
 }
 
 void AudioProcessor::onCrescendo(function<void()> callback) {
     auto detector = getDynamicsAnalyzer();
-    detector->onCrescendo = callback;
+    detector->onCrescendo = marshal(callback);
 }
 
 void AudioProcessor::onDiminuendo(function<void()> callback) {
     auto detector = getDynamicsAnalyzer();
-    detector->onDiminuendo = callback;
+    detector->onDiminuendo = marshal(callback);
 }
 
 void AudioProcessor::onDynamicTrend(function<void(float)> callback) {
     auto detector = getDynamicsAnalyzer();
-    detector->onDynamicTrend = callback;
+    detector->onDynamicTrend = marshal(callback);
 }
 
 void AudioProcessor::onCompressionRatio(function<void(float)> callback) {
     auto detector = getDynamicsAnalyzer();
-    detector->onCompressionRatio = callback;
+    detector->onCompressionRatio = marshal(callback);
 }
 
 void AudioProcessor::onPitch(function<void(float)> callback) {
     auto detector = getPitchDetector();
-    detector->onPitch = callback;
+    detector->onPitch = marshal(callback);
 }
 
 void AudioProcessor::onPitchWithConfidence(function<void(float, float)> callback) {
     auto detector = getPitchDetector();
-    detector->onPitchWithConfidence = callback;
+    detector->onPitchWithConfidence = marshal(callback);
 }
 
 void AudioProcessor::onPitchChange(function<void(float)> callback) {
     auto detector = getPitchDetector();
-    detector->onPitchChange = callback;
+    detector->onPitchChange = marshal(callback);
 }
 
 void AudioProcessor::onVoicedChange(function<void(bool)> callback) {
     auto detector = getPitchDetector();
-    detector->onVoicedChange = callback;
+    detector->onVoicedChange = marshal(callback);
 }
 
 void AudioProcessor::onNoteOn(function<void(uint8_t, uint8_t)> callback) {
     auto detector = getNoteDetector();
-    detector->onNoteOn = callback;
+    detector->onNoteOn = marshal(callback);
 }
 
 void AudioProcessor::onNoteOff(function<void(uint8_t)> callback) {
     auto detector = getNoteDetector();
-    detector->onNoteOff = callback;
+    detector->onNoteOff = marshal(callback);
 }
 
 void AudioProcessor::onNoteChange(function<void(uint8_t, uint8_t)> callback) {
     auto detector = getNoteDetector();
-    detector->onNoteChange = callback;
+    detector->onNoteChange = marshal(callback);
 }
 
 void AudioProcessor::onDownbeat(function<void()> callback) {
     auto detector = getDownbeatDetector();
-    detector->onDownbeat = callback;
+    detector->onDownbeat = marshal(callback);
 }
 
 void AudioProcessor::onMeasureBeat(function<void(u8)> callback) {
     auto detector = getDownbeatDetector();
-    detector->onMeasureBeat = callback;
+    detector->onMeasureBeat = marshal(callback);
 }
 
 void AudioProcessor::onMeterChange(function<void(u8)> callback) {
     auto detector = getDownbeatDetector();
-    detector->onMeterChange = callback;
+    detector->onMeterChange = marshal(callback);
 }
 
 void AudioProcessor::onMeasurePhase(function<void(float)> callback) {
     auto detector = getDownbeatDetector();
-    detector->onMeasurePhase = callback;
+    detector->onMeasurePhase = marshal(callback);
 }
 
 void AudioProcessor::onBackbeat(function<void(u8 beatNumber, float confidence, float strength)> callback) {
     auto detector = getBackbeatDetector();
-    detector->onBackbeat = callback;
+    detector->onBackbeat = marshal(callback);
 }
 
 void AudioProcessor::onVocal(function<void(bool)> callback) {
     auto detector = getVocalDetector();
-    detector->onVocalChange = callback;
+    detector->onVocalChange = marshal(callback);
 }
 
 void AudioProcessor::onVocalStart(function<void()> callback) {
     auto detector = getVocalDetector();
-    detector->onVocalStart = callback;
+    detector->onVocalStart = marshal(callback);
 }
 
 void AudioProcessor::onVocalEnd(function<void()> callback) {
     auto detector = getVocalDetector();
-    detector->onVocalEnd = callback;
+    detector->onVocalEnd = marshal(callback);
 }
 
 void AudioProcessor::onVocalConfidence(function<void(float)> callback) {
@@ -303,112 +483,112 @@ void AudioProcessor::onVocalConfidence(function<void(float)> callback) {
 
 void AudioProcessor::onPercussion(function<void(const char*)> callback) {
     auto detector = getPercussionDetector();
-    detector->onPercussionHit = callback;
+    detector->onPercussionHit = marshal(callback);
 }
 
 void AudioProcessor::onKick(function<void()> callback) {
     auto detector = getPercussionDetector();
-    detector->onKick = callback;
+    detector->onKick = marshal(callback);
 }
 
 void AudioProcessor::onSnare(function<void()> callback) {
     auto detector = getPercussionDetector();
-    detector->onSnare = callback;
+    detector->onSnare = marshal(callback);
 }
 
 void AudioProcessor::onHiHat(function<void()> callback) {
     auto detector = getPercussionDetector();
-    detector->onHiHat = callback;
+    detector->onHiHat = marshal(callback);
 }
 
 void AudioProcessor::onTom(function<void()> callback) {
     auto detector = getPercussionDetector();
-    detector->onTom = callback;
+    detector->onTom = marshal(callback);
 }
 
 void AudioProcessor::onChord(function<void(const Chord&)> callback) {
     auto detector = getChordDetector();
-    detector->onChord = callback;
+    detector->onChord = marshal(callback);
 }
 
 void AudioProcessor::onChordChange(function<void(const Chord&)> callback) {
     auto detector = getChordDetector();
-    detector->onChordChange = callback;
+    detector->onChordChange = marshal(callback);
 }
 
 void AudioProcessor::onChordEnd(function<void()> callback) {
     auto detector = getChordDetector();
-    detector->onChordEnd = callback;
+    detector->onChordEnd = marshal(callback);
 }
 
 void AudioProcessor::onKey(function<void(const Key&)> callback) {
     auto detector = getKeyDetector();
-    detector->onKey = callback;
+    detector->onKey = marshal(callback);
 }
 
 void AudioProcessor::onKeyChange(function<void(const Key&)> callback) {
     auto detector = getKeyDetector();
-    detector->onKeyChange = callback;
+    detector->onKeyChange = marshal(callback);
 }
 
 void AudioProcessor::onKeyEnd(function<void()> callback) {
     auto detector = getKeyDetector();
-    detector->onKeyEnd = callback;
+    detector->onKeyEnd = marshal(callback);
 }
 
 void AudioProcessor::onMood(function<void(const Mood&)> callback) {
     auto detector = getMoodAnalyzer();
-    detector->onMood = callback;
+    detector->onMood = marshal(callback);
 }
 
 void AudioProcessor::onMoodChange(function<void(const Mood&)> callback) {
     auto detector = getMoodAnalyzer();
-    detector->onMoodChange = callback;
+    detector->onMoodChange = marshal(callback);
 }
 
 void AudioProcessor::onValenceArousal(function<void(float, float)> callback) {
     auto detector = getMoodAnalyzer();
-    detector->onValenceArousal = callback;
+    detector->onValenceArousal = marshal(callback);
 }
 
 void AudioProcessor::onBuildupStart(function<void()> callback) {
     auto detector = getBuildupDetector();
-    detector->onBuildupStart = callback;
+    detector->onBuildupStart = marshal(callback);
 }
 
 void AudioProcessor::onBuildupProgress(function<void(float)> callback) {
     auto detector = getBuildupDetector();
-    detector->onBuildupProgress = callback;
+    detector->onBuildupProgress = marshal(callback);
 }
 
 void AudioProcessor::onBuildupPeak(function<void()> callback) {
     auto detector = getBuildupDetector();
-    detector->onBuildupPeak = callback;
+    detector->onBuildupPeak = marshal(callback);
 }
 
 void AudioProcessor::onBuildupEnd(function<void()> callback) {
     auto detector = getBuildupDetector();
-    detector->onBuildupEnd = callback;
+    detector->onBuildupEnd = marshal(callback);
 }
 
 void AudioProcessor::onBuildup(function<void(const Buildup&)> callback) {
     auto detector = getBuildupDetector();
-    detector->onBuildup = callback;
+    detector->onBuildup = marshal(callback);
 }
 
 void AudioProcessor::onDrop(function<void()> callback) {
     auto detector = getDropDetector();
-    detector->onDrop = callback;
+    detector->onDrop = marshal(callback);
 }
 
 void AudioProcessor::onDropEvent(function<void(const Drop&)> callback) {
     auto detector = getDropDetector();
-    detector->onDropEvent = callback;
+    detector->onDropEvent = marshal(callback);
 }
 
 void AudioProcessor::onDropImpact(function<void(float)> callback) {
     auto detector = getDropDetector();
-    detector->onDropImpact = callback;
+    detector->onDropImpact = marshal(callback);
 }
 
 const AudioSample& AudioProcessor::getSample() const {
@@ -3,8 +3,13 @@
 #include "fl/audio.h"
 #include "fl/audio/audio_context.h"
 #include "fl/audio/audio_detector.h"
+#include "fl/audio/audio_worker.h"
+#include "fl/atomic.h"
+#include "fl/engine_events.h"
+#include "fl/mutex.h"
 #include "fl/ptr.h"
 #include "fl/function.h"
+#include "fl/vector.h"
 
 namespace fl {
 
@@ -32,6 +37,26 @@ struct Buildup;
 class DropDetector;
 struct Drop;
 
+// Plain copy of the headline analysis results, published after every
+// detector pass. Fields of detectors that were never requested stay zero.
+struct AudioSnapshot {
+    u32 sequence = 0;  // increments on every publish, 0 = nothing yet
+    u32 timestamp = 0;
+    float rms = 0.0f;
+    float zcf = 0.0f;
+    u32 beatCount = 0;
+    float bpm = 0.0f;
+    float beatPhase = 0.0f;
+    float bass = 0.0f;
+    float mid = 0.0f;
+    float treble = 0.0f;
+    float peak = 0.0f;
+    float averageEnergy = 0.0f;
+    bool silent = false;
+    float pitch = 0.0f;
+    bool voiced = false;
+};
+
 class AudioProcessor {
 public:
     AudioProcessor();
@@ -39,6 +64,36 @@ public:
 
     // ----- Main Update -----
     void update(const AudioSample& sample);
+    // update() with the sample's spectrum already computed, as
+    // MultiAudioInput provides for its mixdown. The spectrum is only used
+    // when processing inline one block per frame; the worker and STFT
+    // mode transform the PCM themselves.
+    void update(const AudioSample& sample, const FFTSpectrum& spectrum);
+
+    // Run detectors on overlapping `window` sample frames every `hop`
+    // samples rather than once per block (see AudioContext::setSTFT).
+    // Detectors then fire within a hop of an onset. setSTFT(0, 0) disables.
+    void setSTFT(fl::size window, fl::size hop, u32 sampleRate = 44100);
+
+    // ----- Worker Mode -----
+    // Moves detector work off the render thread: update() only copies the
+    // block into a queue of `queueBlocks` preallocated buffers of up to
+    // `maxBlockSize` samples, and a worker (see IAudioWorker) runs the
+    // detectors. Callbacks are queued and run on the render thread at the
+    // end of each frame (FastLED.show()), or whenever dispatchEvents() is
+    // called. Register callbacks and configure before starting; while the
+    // worker runs, read results through snapshot() rather than the
+    // detectors or getContext(). Returns false, leaving the processor
+    // inline, on platforms without worker support.
+    bool startWorker(const AudioWorkerConfig& config = AudioWorkerConfig(),
+                     fl::size maxBlockSize = 1024, fl::size queueBlocks = 8);
+    void stopWorker();
+    bool isWorkerRunning() const { return mWorker != nullptr; }
+    // Runs callbacks queued by the worker. Returns how many ran.
+    fl::size dispatchEvents();
+
+    // Latest published results; safe to call from any thread.
+    AudioSnapshot snapshot() const;
 
     // ----- Beat Detection Events -----
     void onBeat(function<void()> callback);
@@ -140,14 +195,51 @@ public:
     void onDropEvent(function<void(const Drop&)> callback);
     void onDropImpact(function<void(float impact)> callback);
 
+    // ----- Feature Graph -----
+    // Shared features the registered detectors pull, with their
+    // dependencies. Features outside this set are never computed.
+    AudioFeatureMask getActiveFeatures() const;
+    // Per-feature computation counts, and time while profiling is enabled
+    void setFeatureProfiling(bool enabled) { mContext->setFeatureProfiling(enabled); }
+    const AudioFeatureStats& getFeatureStats(AudioFeature feature) const {
+        return mContext->getFeatureStats(feature);
+    }
+
     // ----- State Access -----
     shared_ptr<AudioContext> getContext() const { return mContext; }
     const AudioSample& getSample() const;
     void reset();
 
 private:
+    // Runs queued callbacks once per frame
+    class FrameListener : public EngineEvents::Listener {
+      public:
+        explicit FrameListener(AudioProcessor* owner) : mOwner(owner) {}
+        void onEndFrame() override { mOwner->dispatchEvents(); }
+      private:
+        AudioProcessor* mOwner;
+    };
+
     shared_ptr<AudioContext> mContext;
 
+    // Worker mode
+    shared_ptr<IAudioWorker> mWorker;
+    shared_ptr<AudioSampleQueue> mQueue;
+    FrameListener mFrameListener;
+    atomic_bool mMarshal;
+    fl::mutex mEventMutex;
+    fl::vector<function<void()>> mPendingEvents;
+    fl::vector<function<void()>> mDispatching;
+
+    // Double-buffered snapshot: the writer fills the buffer readers are not
+    // pointed at, then flips mSnapshotIndex. The per-buffer versions are odd
+    // while a buffer is being written so a reader that lost the race retries.
+    AudioSnapshot mSnapshots[2];
+    atomic_u32 mSnapshotIndex;
+    mutable atomic_u32 mSnapshotVersions[2];
+    u32 mSequence = 0;
+    u32 mBeatCount = 0;
+
     // Lazy detector storage
     shared_ptr<BeatDetector> mBeatDetector;
     shared_ptr<FrequencyBands> mFrequencyBands;
@@ -168,6 +260,28 @@ private:
     shared_ptr<BuildupDetector> mBuildupDetector;
     shared_ptr<DropDetector> mDropDetector;
 
+    void updateDetectors();
+    void process(const AudioSample& sample);
+    bool workerStep();
+    void publishSnapshot();
+
+    // Wraps a detector callback so that in worker mode it is queued for the
+    // render thread instead of running on the worker.
+    template <typename... Args>
+    function<void(Args...)> marshal(function<void(Args...)> callback) {
+        if (!callback) {
+            return callback;
+        }
+        return [this, callback](Args... args) {
+            if (!mMarshal.load()) {
+                callback(args...);
+                return;
+            }
+            fl::lock_guard<fl::mutex> lock(mEventMutex);
+            mPendingEvents.push_back([callback, args...]() { callback(args...); });
+        };
+    }
+
     // Lazy creation helpers
     shared_ptr<BeatDetector> getBeatDetector();
     shared_ptr<FrequencyBands> getFrequencyBands();
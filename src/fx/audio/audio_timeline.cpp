@@ -0,0 +1,653 @@
+#include "fx/audio/audio_timeline.h"
+#include "fx/audio/audio_processor.h"
+#include "fx/audio/detectors/key.h"
+#include "fx/audio/detectors/mood_analyzer.h"
+
+#include "fl/algorithm.h"
+#include "fl/atomic.h"
+#include "fl/codec/mp3.h"
+#include "fl/cstring.h"
+#include "fl/json.h"
+#include "fl/math.h"
+
+namespace fl {
+
+namespace {
+
+const char* const kEventNames[] = {"beat",        "downbeat",  "tempo",
+                                   "buildupStart", "buildupPeak", "buildupEnd",
+                                   "drop",        "key",       "mood"};
+
+const u16 kTimelineVersion = 1;
+const fl::size kHeaderBytes = 16;
+const fl::size kEventBytes = 14;
+
+bool isStateEvent(AudioEventType type) {
+    return type == AudioEventType::Tempo || type == AudioEventType::Key ||
+           type == AudioEventType::Mood;
+}
+
+// ----- Little-endian packing -----
+
+void putU16(fl::vector<u8>* out, u16 v) {
+    out->push_back(u8(v));
+    out->push_back(u8(v >> 8));
+}
+
+void putU32(fl::vector<u8>* out, u32 v) {
+    for (int i = 0; i < 4; ++i) {
+        out->push_back(u8(v >> (8 * i)));
+    }
+}
+
+void putF32(fl::vector<u8>* out, float v) {
+    u32 bits;
+    fl::memcpy(&bits, &v, sizeof(bits));
+    putU32(out, bits);
+}
+
+u16 getU16(const u8* p) { return u16(p[0] | (u16(p[1]) << 8)); }
+
+u32 getU32(const u8* p) {
+    return u32(p[0]) | (u32(p[1]) << 8) | (u32(p[2]) << 16) | (u32(p[3]) << 24);
+}
+
+float getF32(const u8* p) {
+    const u32 bits = getU32(p);
+    float v;
+    fl::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+// ----- Segmented analysis -----
+
+struct Segment {
+    fl::size warmStart = 0;  // first sample fed to the detectors
+    fl::size start = 0;      // first sample whose events are kept
+    fl::size end = 0;
+    fl::vector<AudioTimelineEvent> events;
+};
+
+struct AnalysisJob {
+    fl::span<const i16> pcm;
+    u32 sampleRate = 0;
+    OfflineAnalysisOptions options;
+    fl::vector<Segment> segments;
+    atomic_u32 next;
+};
+
+u32 sampleToMs(fl::size sample, u32 sampleRate) {
+    return static_cast<u32>(u64(sample) * 1000 / sampleRate);
+}
+
+void runSegment(const AnalysisJob& job, Segment& segment) {
+    const OfflineAnalysisOptions& options = job.options;
+    AudioProcessor processor;
+    shared_ptr<AudioContext> context = processor.getContext();
+    const u32 startMs = sampleToMs(segment.start, job.sampleRate);
+
+    // State carried in from the warm-up stretch, re-issued at startMs
+    AudioTimelineEvent warmState[int(AudioEventType::Count)];
+    bool hasWarmState[int(AudioEventType::Count)] = {};
+    bool inBuildup = false;
+    float lastBpm = 0.0f;
+
+    auto record = [&](AudioEventType type, u8 arg, float value, float value2) {
+        AudioTimelineEvent event;
+        event.timeMs = context->getTimestamp();
+        event.type = type;
+        event.arg = arg;
+        event.value = value;
+        event.value2 = value2;
+        if (type == AudioEventType::BuildupStart) {
+            inBuildup = true;
+        } else if (type == AudioEventType::BuildupEnd) {
+            inBuildup = false;
+        }
+        if (event.timeMs >= startMs) {
+            segment.events.push_back(event);
+        } else if (isStateEvent(type)) {
+            warmState[int(type)] = event;
+            hasWarmState[int(type)] = true;
+        }
+    };
+
+    if (options.beat) {
+        processor.onBeat([&]() { record(AudioEventType::Beat, 0, 0.0f, 0.0f); });
+    }
+    if (options.downbeat) {
+        processor.onDownbeat([&]() { record(AudioEventType::Downbeat, 0, 0.0f, 0.0f); });
+    }
+    if (options.tempo) {
+        processor.onTempoWithConfidence([&](float bpm, float confidence) {
+            if (bpm > 0.0f && fl::fl_abs(bpm - lastBpm) > options.tempoHysteresisBpm) {
+                lastBpm = bpm;
+                record(AudioEventType::Tempo, 0, bpm, confidence);
+            }
+        });
+    }
+    if (options.buildup) {
+        processor.onBuildupStart([&]() { record(AudioEventType::BuildupStart, 0, 0.0f, 0.0f); });
+        processor.onBuildupPeak([&]() { record(AudioEventType::BuildupPeak, 0, 0.0f, 0.0f); });
+        processor.onBuildupEnd([&]() { record(AudioEventType::BuildupEnd, 0, 0.0f, 0.0f); });
+    }
+    if (options.drop) {
+        processor.onDropImpact([&](float impact) { record(AudioEventType::Drop, 0, impact, 0.0f); });
+    }
+    if (options.key) {
+        processor.onKeyChange([&](const Key& key) {
+            const u8 arg = u8((key.rootNote % 12) | (key.isMinor ? 0x80 : 0));
+            record(AudioEventType::Key, arg, key.confidence, 0.0f);
+        });
+    }
+    if (options.mood) {
+        processor.onMoodChange([&](const Mood& mood) {
+            record(AudioEventType::Mood, 0, mood.valence, mood.arousal);
+        });
+    }
+
+    const fl::size block = options.blockSize;
+    bool warm = segment.warmStart < segment.start;
+    for (fl::size pos = segment.warmStart; pos < segment.end; pos += block) {
+        if (warm && pos >= segment.start) {
+            warm = false;
+            // Carry what the warm-up established into this segment's range
+            fl::vector<AudioTimelineEvent> carried;
+            for (int type = 0; type < int(AudioEventType::Count); ++type) {
+                if (hasWarmState[type]) {
+                    warmState[type].timeMs = startMs;
+                    carried.push_back(warmState[type]);
+                }
+            }
+            if (inBuildup) {
+                AudioTimelineEvent event;
+                event.timeMs = startMs;
+                event.type = AudioEventType::BuildupStart;
+                carried.push_back(event);
+            }
+            for (fl::size i = 0; i < segment.events.size(); ++i) {
+                carried.push_back(segment.events[i]);
+            }
+            fl::swap(segment.events, carried);
+        }
+        const fl::size n = FL_MIN(block, segment.end - pos);
+        processor.update(AudioSample(job.pcm.subspan(pos, n),
+                                     sampleToMs(pos, job.sampleRate)));
+    }
+}
+
+bool runNextSegment(AnalysisJob& job) {
+    const u32 index = job.next.fetch_add(1);
+    if (index >= job.segments.size()) {
+        return false;
+    }
+    runSegment(job, job.segments[index]);
+    return true;
+}
+
+// Drops state events that repeat the previous value of their type, which
+// happens where one segment's carried-in state matches the last one's.
+bool repeatsState(const AudioTimelineEvent& event, const AudioTimelineEvent& last,
+                  float tempoHysteresis) {
+    switch (event.type) {
+    case AudioEventType::Tempo:
+        return fl::fl_abs(event.value - last.value) <= tempoHysteresis;
+    case AudioEventType::Key:
+        return event.arg == last.arg;
+    case AudioEventType::Mood:
+        return fl::fl_abs(event.value - last.value) < 0.05f &&
+               fl::fl_abs(event.value2 - last.value2) < 0.05f;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+const char* audioEventTypeName(AudioEventType type) {
+    const int index = int(type);
+    if (index < 0 || index >= int(AudioEventType::Count)) {
+        return "unknown";
+    }
+    return kEventNames[index];
+}
+
+// ----- AudioTimeline -----
+
+void AudioTimeline::clear() {
+    mEvents.clear();
+    mDurationMs = 0;
+}
+
+void AudioTimeline::add(const AudioTimelineEvent& event) {
+    // Events almost always arrive in order, so search from the back
+    fl::size pos = mEvents.size();
+    while (pos > 0 && mEvents[pos - 1].timeMs > event.timeMs) {
+        --pos;
+    }
+    mEvents.insert(mEvents.begin() + pos, event);
+}
+
+void AudioTimeline::append(const fl::vector<AudioTimelineEvent>& events) {
+    for (fl::size i = 0; i < events.size(); ++i) {
+        add(events[i]);
+    }
+}
+
+fl::size AudioTimeline::count(AudioEventType type) const {
+    fl::size n = 0;
+    for (fl::size i = 0; i < mEvents.size(); ++i) {
+        n += mEvents[i].type == type ? 1 : 0;
+    }
+    return n;
+}
+
+void AudioTimeline::toBinary(fl::vector<u8>* out) const {
+    out->clear();
+    out->reserve(kHeaderBytes + mEvents.size() * kEventBytes);
+    out->push_back('F');
+    out->push_back('L');
+    out->push_back('T');
+    out->push_back('L');
+    putU16(out, kTimelineVersion);
+    putU16(out, 0);
+    putU32(out, mDurationMs);
+    putU32(out, u32(mEvents.size()));
+    for (fl::size i = 0; i < mEvents.size(); ++i) {
+        const AudioTimelineEvent& event = mEvents[i];
+        putU32(out, event.timeMs);
+        out->push_back(u8(event.type));
+        out->push_back(event.arg);
+        putF32(out, event.value);
+        putF32(out, event.value2);
+    }
+}
+
+bool AudioTimeline::fromBinary(fl::span<const u8> data) {
+    if (data.size() < kHeaderBytes || fl::memcmp(data.data(), "FLTL", 4) != 0 ||
+        getU16(data.data() + 4) != kTimelineVersion) {
+        return false;
+    }
+    const u32 count = getU32(data.data() + 12);
+    if (data.size() < kHeaderBytes + fl::size(count) * kEventBytes) {
+        return false;
+    }
+    clear();
+    mDurationMs = getU32(data.data() + 8);
+    mEvents.reserve(count);
+    const u8* p = data.data() + kHeaderBytes;
+    for (u32 i = 0; i < count; ++i, p += kEventBytes) {
+        if (p[4] >= u8(AudioEventType::Count)) {
+            clear();
+            return false;
+        }
+        AudioTimelineEvent event;
+        event.timeMs = getU32(p);
+        event.type = AudioEventType(p[4]);
+        event.arg = p[5];
+        event.value = getF32(p + 6);
+        event.value2 = getF32(p + 10);
+        add(event);
+    }
+    return true;
+}
+
+fl::string AudioTimeline::toJson() const {
+    fl::Json root = fl::Json::object();
+    root.set("version", int(kTimelineVersion));
+    root.set("durationMs", int64_t(mDurationMs));
+    fl::Json events = fl::Json::array();
+    for (fl::size i = 0; i < mEvents.size(); ++i) {
+        const AudioTimelineEvent& event = mEvents[i];
+        fl::Json entry = fl::Json::array();
+        entry.push_back(fl::Json(int64_t(event.timeMs)));
+        entry.push_back(fl::Json(audioEventTypeName(event.type)));
+        entry.push_back(fl::Json(int(event.arg)));
+        entry.push_back(fl::Json(event.value));
+        entry.push_back(fl::Json(event.value2));
+        events.push_back(entry);
+    }
+    root.set("events", events);
+    return root.to_string();
+}
+
+bool AudioTimeline::fromJson(const fl::string& json) {
+    const fl::Json root = fl::Json::parse(json);
+    if (!root.is_object() || !root["events"].is_array()) {
+        return false;
+    }
+    clear();
+    mDurationMs = u32(root["durationMs"] | int64_t(0));
+    const fl::Json events = root["events"];
+    for (fl::size i = 0; i < events.size(); ++i) {
+        const fl::Json entry = events[i];
+        if (!entry.is_array() || entry.size() < 5) {
+            clear();
+            return false;
+        }
+        const fl::string name = entry[1] | fl::string();
+        int type = 0;
+        while (type < int(AudioEventType::Count) && name != kEventNames[type]) {
+            ++type;
+        }
+        if (type == int(AudioEventType::Count)) {
+            clear();
+            return false;
+        }
+        AudioTimelineEvent event;
+        event.timeMs = u32(entry[0] | int64_t(0));
+        event.type = AudioEventType(type);
+        event.arg = u8(entry[2] | 0);
+        event.value = entry[3] | 0.0f;
+        event.value2 = entry[4] | 0.0f;
+        add(event);
+    }
+    return true;
+}
+
+// ----- OfflineAudioAnalyzer -----
+
+bool OfflineAudioAnalyzer::analyze(fl::span<const i16> pcm, u32 sampleRate,
+                                   AudioTimeline* out,
+                                   const OfflineAnalysisOptions& options) {
+    out->clear();
+    if (pcm.empty() || sampleRate == 0 || options.blockSize == 0) {
+        return false;
+    }
+    out->setDurationMs(sampleToMs(pcm.size(), sampleRate));
+
+    AnalysisJob job;
+    job.pcm = pcm;
+    job.sampleRate = sampleRate;
+    job.options = options;
+
+    // Segment boundaries sit on the block grid, so every segment feeds the
+    // detectors the same blocks a single pass would
+    const fl::size block = options.blockSize;
+    const fl::size blocks = (pcm.size() + block - 1) / block;
+    const fl::size requested = options.segments
+                                   ? fl::size(options.segments)
+                                   : fl::size(FL_MIN(IAudioWorker::concurrency(), u32(255)));
+    const fl::size segments = FL_MAX(fl::size(1), FL_MIN(requested, blocks));
+    const fl::size warmBlocks = (u64(options.warmupMs) * sampleRate / 1000 + block - 1) / block;
+    job.segments.resize(segments);
+    for (fl::size i = 0; i < segments; ++i) {
+        Segment& segment = job.segments[i];
+        const fl::size firstBlock = blocks * i / segments;
+        segment.start = firstBlock * block;
+        segment.warmStart = (firstBlock > warmBlocks ? firstBlock - warmBlocks : 0) * block;
+        segment.end = FL_MIN(pcm.size(), (blocks * (i + 1) / segments) * block);
+    }
+
+    // Workers and this thread pull segments until none are left; stop()
+    // then waits for the ones still running.
+    AudioWorkerConfig config;
+    config.name = "fl_offline";
+    config.stackSize = 16384;
+    config.core = -1;
+    fl::vector<shared_ptr<IAudioWorker>> workers;
+    for (fl::size i = 1; i < segments; ++i) {
+        shared_ptr<IAudioWorker> worker =
+            IAudioWorker::create([&job]() { return runNextSegment(job); }, config);
+        if (!worker) {
+            break;  // no threads here; this thread does everything
+        }
+        workers.push_back(worker);
+    }
+    while (runNextSegment(job)) {
+    }
+    for (fl::size i = 0; i < workers.size(); ++i) {
+        workers[i]->stop();
+    }
+
+    // Merge, dropping what a segment re-issued for state the previous
+    // segment had already reported
+    AudioTimelineEvent lastState[int(AudioEventType::Count)];
+    bool hasLastState[int(AudioEventType::Count)] = {};
+    bool inBuildup = false;
+    for (fl::size i = 0; i < job.segments.size(); ++i) {
+        const fl::vector<AudioTimelineEvent>& events = job.segments[i].events;
+        for (fl::size j = 0; j < events.size(); ++j) {
+            const AudioTimelineEvent& event = events[j];
+            const int type = int(event.type);
+            if (event.type == AudioEventType::BuildupStart ||
+                event.type == AudioEventType::BuildupEnd) {
+                const bool starts = event.type == AudioEventType::BuildupStart;
+                if (starts == inBuildup) {
+                    continue;
+                }
+                inBuildup = starts;
+            } else if (isStateEvent(event.type)) {
+                if (hasLastState[type] &&
+                    repeatsState(event, lastState[type], options.tempoHysteresisBpm)) {
+                    continue;
+                }
+                lastState[type] = event;
+                hasLastState[type] = true;
+            }
+            out->add(event);
+        }
+    }
+    return true;
+}
+
+bool OfflineAudioAnalyzer::decodeMp3(fl::span<const u8> mp3, fl::vector<i16>* pcm,
+                                     u32* sampleRate, fl::string* error) {
+    pcm->clear();
+    *sampleRate = 0;
+    third_party::Mp3HelixDecoder decoder;
+    if (!decoder.init()) {
+        if (error) {
+            *error = "MP3 decoder init failed";
+        }
+        return false;
+    }
+    decoder.decode(mp3.data(), mp3.size(), [&](const third_party::Mp3Frame& frame) {
+        if (*sampleRate == 0) {
+            *sampleRate = u32(frame.sample_rate);
+        }
+        for (int i = 0; i < frame.samples; ++i) {
+            if (frame.channels == 2) {
+                pcm->push_back(i16((i32(frame.pcm[i * 2]) + frame.pcm[i * 2 + 1]) / 2));
+            } else {
+                pcm->push_back(frame.pcm[i]);
+            }
+        }
+    });
+    if (pcm->empty() || *sampleRate == 0) {
+        if (error) {
+            *error = "no MP3 frames decoded";
+        }
+        return false;
+    }
+    return true;
+}
+
+bool OfflineAudioAnalyzer::decodeWav(fl::span<const u8> wav, fl::vector<i16>* pcm,
+                                     u32* sampleRate, fl::string* error) {
+    pcm->clear();
+    *sampleRate = 0;
+    auto fail = [error](const char* msg) {
+        if (error) {
+            *error = msg;
+        }
+        return false;
+    };
+    if (wav.size() < 12 || fl::memcmp(wav.data(), "RIFF", 4) != 0 ||
+        fl::memcmp(wav.data() + 8, "WAVE", 4) != 0) {
+        return fail("not a RIFF/WAVE file");
+    }
+    u16 channels = 0;
+    u16 bits = 0;
+    fl::size pos = 12;
+    while (pos + 8 <= wav.size()) {
+        const u8* chunk = wav.data() + pos;
+        const u32 chunkSize = getU32(chunk + 4);
+        const fl::size bodySize = FL_MIN(fl::size(chunkSize), wav.size() - pos - 8);
+        const u8* body = chunk + 8;
+        if (fl::memcmp(chunk, "fmt ", 4) == 0 && bodySize >= 16) {
+            const u16 format = getU16(body);
+            channels = getU16(body + 2);
+            *sampleRate = getU32(body + 4);
+            bits = getU16(body + 14);
+            // 1 = PCM, 0xFFFE = WAVE_FORMAT_EXTENSIBLE
+            if ((format != 1 && format != 0xFFFE) || bits != 16 || channels == 0) {
+                return fail("only 16-bit PCM WAV is supported");
+            }
+        } else if (fl::memcmp(chunk, "data", 4) == 0) {
+            if (channels == 0) {
+                return fail("WAV data before fmt chunk");
+            }
+            const fl::size frames = bodySize / (2 * channels);
+            pcm->reserve(frames);
+            for (fl::size f = 0; f < frames; ++f) {
+                i32 sum = 0;
+                for (u16 c = 0; c < channels; ++c) {
+                    sum += i16(getU16(body + (f * channels + c) * 2));
+                }
+                pcm->push_back(i16(sum / channels));
+            }
+            return !pcm->empty() || fail("empty WAV data chunk");
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);  // chunks are word aligned
+    }
+    return fail("WAV file has no data chunk");
+}
+
+bool OfflineAudioAnalyzer::analyzeMp3(fl::span<const u8> mp3, AudioTimeline* out,
+                                      const OfflineAnalysisOptions& options,
+                                      fl::string* error) {
+    fl::vector<i16> pcm;
+    u32 sampleRate = 0;
+    if (!decodeMp3(mp3, &pcm, &sampleRate, error)) {
+        out->clear();
+        return false;
+    }
+    return analyze(pcm, sampleRate, out, options);
+}
+
+bool OfflineAudioAnalyzer::analyzeWav(fl::span<const u8> wav, AudioTimeline* out,
+                                      const OfflineAnalysisOptions& options,
+                                      fl::string* error) {
+    fl::vector<i16> pcm;
+    u32 sampleRate = 0;
+    if (!decodeWav(wav, &pcm, &sampleRate, error)) {
+        out->clear();
+        return false;
+    }
+    return analyze(pcm, sampleRate, out, options);
+}
+
+// ----- AudioTimelinePlayer -----
+
+void AudioTimelinePlayer::load(const AudioTimeline& timeline) {
+    mTimeline = timeline;
+    seek(0);
+}
+
+bool AudioTimelinePlayer::load(fl::span<const u8> binary) {
+    AudioTimeline timeline;
+    if (!timeline.fromBinary(binary)) {
+        return false;
+    }
+    load(timeline);
+    return true;
+}
+
+void AudioTimelinePlayer::seek(u32 positionMs) {
+    mBPM = 0.0f;
+    mHasBeat = false;
+    mInBuildup = false;
+    mStarted = true;
+    mPositionMs = positionMs;
+    // Replay state silently up to, but not including, the new position
+    const fl::vector<AudioTimelineEvent>& events = mTimeline.events();
+    mNext = 0;
+    while (mNext < events.size() && events[mNext].timeMs < positionMs) {
+        apply(events[mNext], false);
+        ++mNext;
+    }
+}
+
+void AudioTimelinePlayer::update(u32 positionMs) {
+    if (!mStarted || positionMs < mPositionMs) {
+        seek(positionMs);
+    }
+    mPositionMs = positionMs;
+    const fl::vector<AudioTimelineEvent>& events = mTimeline.events();
+    while (mNext < events.size() && events[mNext].timeMs <= positionMs) {
+        apply(events[mNext], true);
+        ++mNext;
+    }
+}
+
+float AudioTimelinePlayer::getBeatPhase() const {
+    if (!mHasBeat || mBPM <= 0.0f || mPositionMs < mLastBeatMs) {
+        return 0.0f;
+    }
+    const float beatMs = 60000.0f / mBPM;
+    const float phase = float(mPositionMs - mLastBeatMs) / beatMs;
+    return phase - fl::floorf(phase);
+}
+
+void AudioTimelinePlayer::apply(const AudioTimelineEvent& event, bool fire) {
+    switch (event.type) {
+    case AudioEventType::Beat:
+        mLastBeatMs = event.timeMs;
+        mHasBeat = true;
+        if (fire && mOnBeat) {
+            mOnBeat();
+        }
+        break;
+    case AudioEventType::Downbeat:
+        if (fire && mOnDownbeat) {
+            mOnDownbeat();
+        }
+        break;
+    case AudioEventType::Tempo:
+        mBPM = event.value;
+        if (fire && mOnTempo) {
+            mOnTempo(event.value);
+        }
+        break;
+    case AudioEventType::BuildupStart:
+        mInBuildup = true;
+        if (fire && mOnBuildupStart) {
+            mOnBuildupStart();
+        }
+        break;
+    case AudioEventType::BuildupPeak:
+        if (fire && mOnBuildupPeak) {
+            mOnBuildupPeak();
+        }
+        break;
+    case AudioEventType::BuildupEnd:
+        mInBuildup = false;
+        if (fire && mOnBuildupEnd) {
+            mOnBuildupEnd();
+        }
+        break;
+    case AudioEventType::Drop:
+        if (fire && mOnDrop) {
+            mOnDrop(event.value);
+        }
+        break;
+    case AudioEventType::Key:
+        if (fire && mOnKeyChange) {
+            mOnKeyChange(event.arg & 0x7f, (event.arg & 0x80) != 0);
+        }
+        break;
+    case AudioEventType::Mood:
+        if (fire && mOnMoodChange) {
+            mOnMoodChange(event.value, event.value2);
+        }
+        break;
+    default:
+        break;
+    }
+    if (fire && mOnEvent) {
+        mOnEvent(event);
+    }
+}
+
+} // namespace fl
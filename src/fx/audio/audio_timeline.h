@@ -0,0 +1,191 @@
+#pragma once
+
+// Offline audio analysis for pre-programmed shows.
+//
+// OfflineAudioAnalyzer runs the AudioProcessor detector stack over a whole
+// decoded file as fast as the CPU allows and records what fired into an
+// AudioTimeline. The timeline serializes to a compact binary form or JSON,
+// and AudioTimelinePlayer replays it against the playback position at show
+// time, so nothing is analysed live.
+//
+// Example:
+//   // Build step (host):
+//   AudioTimeline timeline;
+//   OfflineAudioAnalyzer::analyzeMp3(mp3Bytes, &timeline);
+//   fl::vector<fl::u8> blob;
+//   timeline.toBinary(&blob);
+//
+//   // Show time:
+//   AudioTimelinePlayer player;
+//   player.load(blob);
+//   player.onBeat([]() { flash(); });
+//   void loop() { player.update(playbackPositionMs()); FastLED.show(); }
+
+#include "fl/audio/audio_worker.h"
+#include "fl/function.h"
+#include "fl/int.h"
+#include "fl/span.h"
+#include "fl/str.h"
+#include "fl/vector.h"
+
+namespace fl {
+
+enum class AudioEventType : u8 {
+    Beat = 0,
+    Downbeat,
+    Tempo,          // value = BPM, value2 = confidence
+    BuildupStart,
+    BuildupPeak,
+    BuildupEnd,
+    Drop,           // value = impact
+    Key,            // arg = root note (0-11) | 0x80 if minor, value = confidence
+    Mood,           // value = valence, value2 = arousal
+    Count
+};
+
+const char* audioEventTypeName(AudioEventType type);
+
+struct AudioTimelineEvent {
+    u32 timeMs = 0;
+    AudioEventType type = AudioEventType::Beat;
+    u8 arg = 0;
+    float value = 0.0f;
+    float value2 = 0.0f;
+
+    bool operator==(const AudioTimelineEvent& other) const {
+        return timeMs == other.timeMs && type == other.type &&
+               arg == other.arg && value == other.value && value2 == other.value2;
+    }
+    bool operator!=(const AudioTimelineEvent& other) const { return !(*this == other); }
+};
+
+// Time-ordered list of detector events for one audio file.
+class AudioTimeline {
+  public:
+    void clear();
+    // Keeps events sorted by time; events at equal times keep insertion order
+    void add(const AudioTimelineEvent& event);
+    void append(const fl::vector<AudioTimelineEvent>& events);
+
+    const fl::vector<AudioTimelineEvent>& events() const { return mEvents; }
+    fl::size size() const { return mEvents.size(); }
+    fl::size count(AudioEventType type) const;
+
+    u32 durationMs() const { return mDurationMs; }
+    void setDurationMs(u32 ms) { mDurationMs = ms; }
+
+    // Binary layout, little endian:
+    //   "FLTL" u16 version u16 reserved u32 durationMs u32 count
+    //   count x { u32 timeMs, u8 type, u8 arg, f32 value, f32 value2 }
+    void toBinary(fl::vector<u8>* out) const;
+    bool fromBinary(fl::span<const u8> data);
+
+    // {"version":1,"durationMs":N,"events":[[timeMs,"beat",arg,value,value2],...]}
+    fl::string toJson() const;
+    bool fromJson(const fl::string& json);
+
+  private:
+    fl::vector<AudioTimelineEvent> mEvents;
+    u32 mDurationMs = 0;
+};
+
+struct OfflineAnalysisOptions {
+    // Detectors to run. Beat events come with the downbeat detector too.
+    bool beat = true;
+    bool downbeat = true;
+    bool tempo = true;
+    bool buildup = true;
+    bool drop = true;
+    bool key = true;
+    bool mood = true;
+
+    fl::size blockSize = 1024;
+    // The file is split into this many segments, analysed concurrently on
+    // IAudioWorker threads where the platform has them. 0 uses one segment
+    // per IAudioWorker::concurrency(), so a single pass where there are no
+    // workers.
+    u8 segments = 0;
+    // Each segment starts analysing this much earlier and discards what
+    // fired in that stretch, so tempo and key tracking have settled by the
+    // time its own range begins.
+    u32 warmupMs = 8000;
+    // Tempo events are recorded when the BPM moves by more than this
+    float tempoHysteresisBpm = 2.0f;
+};
+
+class OfflineAudioAnalyzer {
+  public:
+    // Analyses mono 16-bit PCM. Returns false on empty input.
+    static bool analyze(fl::span<const i16> pcm, u32 sampleRate,
+                        AudioTimeline* out,
+                        const OfflineAnalysisOptions& options = OfflineAnalysisOptions());
+    // Decodes and downmixes an MP3 or 16-bit PCM WAV file, then analyses it
+    static bool analyzeMp3(fl::span<const u8> mp3, AudioTimeline* out,
+                           const OfflineAnalysisOptions& options = OfflineAnalysisOptions(),
+                           fl::string* error = nullptr);
+    static bool analyzeWav(fl::span<const u8> wav, AudioTimeline* out,
+                           const OfflineAnalysisOptions& options = OfflineAnalysisOptions(),
+                           fl::string* error = nullptr);
+
+    static bool decodeMp3(fl::span<const u8> mp3, fl::vector<i16>* pcm,
+                          u32* sampleRate, fl::string* error = nullptr);
+    static bool decodeWav(fl::span<const u8> wav, fl::vector<i16>* pcm,
+                          u32* sampleRate, fl::string* error = nullptr);
+};
+
+// Replays a timeline against the playback position. Call update() once per
+// frame with the position of the audio that is currently audible; events
+// between the previous and the new position fire in order. A position that
+// moves backwards, or an explicit seek(), jumps without firing anything.
+class AudioTimelinePlayer {
+  public:
+    void load(const AudioTimeline& timeline);
+    bool load(fl::span<const u8> binary);
+
+    void update(u32 positionMs);
+    void seek(u32 positionMs);
+
+    void onEvent(function<void(const AudioTimelineEvent&)> callback) { mOnEvent = callback; }
+    void onBeat(function<void()> callback) { mOnBeat = callback; }
+    void onDownbeat(function<void()> callback) { mOnDownbeat = callback; }
+    void onTempo(function<void(float bpm)> callback) { mOnTempo = callback; }
+    void onBuildupStart(function<void()> callback) { mOnBuildupStart = callback; }
+    void onBuildupPeak(function<void()> callback) { mOnBuildupPeak = callback; }
+    void onBuildupEnd(function<void()> callback) { mOnBuildupEnd = callback; }
+    void onDrop(function<void(float impact)> callback) { mOnDrop = callback; }
+    void onKeyChange(function<void(u8 rootNote, bool minor)> callback) { mOnKeyChange = callback; }
+    void onMoodChange(function<void(float valence, float arousal)> callback) { mOnMoodChange = callback; }
+
+    // State as of the last update()/seek()
+    float getBPM() const { return mBPM; }
+    // 0..1 through the current beat, extrapolated from the last beat and BPM
+    float getBeatPhase() const;
+    bool inBuildup() const { return mInBuildup; }
+    const AudioTimeline& timeline() const { return mTimeline; }
+
+  private:
+    void apply(const AudioTimelineEvent& event, bool fire);
+
+    AudioTimeline mTimeline;
+    fl::size mNext = 0;
+    u32 mPositionMs = 0;
+    bool mStarted = false;
+
+    float mBPM = 0.0f;
+    u32 mLastBeatMs = 0;
+    bool mHasBeat = false;
+    bool mInBuildup = false;
+
+    function<void(const AudioTimelineEvent&)> mOnEvent;
+    function<void()> mOnBeat;
+    function<void()> mOnDownbeat;
+    function<void(float)> mOnTempo;
+    function<void()> mOnBuildupStart;
+    function<void()> mOnBuildupPeak;
+    function<void()> mOnBuildupEnd;
+    function<void(float)> mOnDrop;
+    function<void(u8, bool)> mOnKeyChange;
+    function<void(float, float)> mOnMoodChange;
+};
+
+} // namespace fl
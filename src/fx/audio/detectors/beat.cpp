@@ -17,18 +17,16 @@ BeatDetector::BeatDetector()
     , mBeatInterval(500)
     , mAdaptiveThreshold(0.0f)
 {
-    mPreviousMagnitudes.resize(16, 0.0f);
     mFluxHistory.reserve(FLUX_HISTORY_SIZE);
 }
 
 BeatDetector::~BeatDetector() = default;
 
 void BeatDetector::update(shared_ptr<AudioContext> context) {
-    const FFTBins& fft = context->getFFT(16);
     u32 timestamp = context->getTimestamp();
 
-    // Calculate spectral flux
-    mSpectralFlux = calculateSpectralFlux(fft);
+    // Spectral flux of the 16 default bands, shared with other onset detectors
+    mSpectralFlux = context->getSpectralFlux();
 
     // Update adaptive threshold
     updateAdaptiveThreshold();
@@ -52,11 +50,6 @@ void BeatDetector::update(shared_ptr<AudioContext> context) {
     if (onBeatPhase) {
         onBeatPhase(mPhase);
     }
-
-    // Update previous magnitudes for next frame
-    for (size i = 0; i < fft.bins_raw.size() && i < mPreviousMagnitudes.size(); i++) {
-        mPreviousMagnitudes[i] = fft.bins_raw[i];
-    }
 }
 
 void BeatDetector::reset() {
@@ -68,24 +61,9 @@ void BeatDetector::reset() {
     mLastBeatTime = 0;
     mBeatInterval = 500;
     mAdaptiveThreshold = 0.0f;
-    fl::fill(mPreviousMagnitudes.begin(), mPreviousMagnitudes.end(), 0.0f);
     mFluxHistory.clear();
 }
 
-float BeatDetector::calculateSpectralFlux(const FFTBins& fft) {
-    float flux = 0.0f;
-    size numBins = fl::fl_min(fft.bins_raw.size(), mPreviousMagnitudes.size());
-
-    for (size i = 0; i < numBins; i++) {
-        float diff = fft.bins_raw[i] - mPreviousMagnitudes[i];
-        if (diff > 0.0f) {
-            flux += diff;
-        }
-    }
-
-    return flux / static_cast<float>(numBins);
-}
-
 void BeatDetector::updateAdaptiveThreshold() {
     // Add current flux to history
     if (mFluxHistory.size() >= FLUX_HISTORY_SIZE) {
@@ -15,6 +15,9 @@ public:
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return true; }
     bool needsFFTHistory() const override { return true; }
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::SpectralFlux);
+    }
     const char* getName() const override { return "BeatDetector"; }
     void reset() override;
 
@@ -42,8 +45,7 @@ private:
     float mThreshold;
     float mSensitivity;
 
-    // Spectral flux tracking
-    vector<float> mPreviousMagnitudes;
+    // Spectral flux of the current frame (shared through AudioContext)
     float mSpectralFlux;
 
     // Temporal tracking
@@ -57,7 +59,6 @@ private:
     vector<float> mFluxHistory;
     static constexpr size FLUX_HISTORY_SIZE = 43;  // ~1 second at 43fps
 
-    float calculateSpectralFlux(const FFTBins& fft);
     void updateAdaptiveThreshold();
     bool detectBeat(u32 timestamp);
     void updateTempo(u32 timestamp);
@@ -54,6 +54,9 @@ public:
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return true; }
     bool needsFFTHistory() const override { return false; }
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::Bands) | audioFeatureBit(AudioFeature::RMS);
+    }
     const char* getName() const override { return "BuildupDetector"; }
     void reset() override;
 
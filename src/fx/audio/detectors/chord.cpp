@@ -44,11 +44,13 @@ ChordDetector::ChordDetector()
 ChordDetector::~ChordDetector() = default;
 
 void ChordDetector::update(shared_ptr<AudioContext> context) {
-    const FFTBins& fft = context->getFFT(32);  // Higher resolution for pitch detection
     uint32_t timestamp = context->getTimestamp();
 
-    // Calculate chroma features
-    calculateChroma(fft);
+    // Chroma features, shared with KeyDetector
+    span<const float> chroma = context->getChroma();
+    for (int i = 0; i < 12; i++) {
+        mChroma[i] = chroma[i];
+    }
 
     // Detect current chord
     Chord detected = detectChord(mChroma, timestamp);
@@ -113,46 +115,6 @@ void ChordDetector::reset() {
     }
 }
 
-void ChordDetector::calculateChroma(const FFTBins& fft) {
-    // Clear chroma
-    for (int i = 0; i < 12; i++) {
-        mChroma[i] = 0.0f;
-    }
-
-    // Map FFT bins to pitch classes (chroma)
-    // Assuming 44100Hz sample rate and 512-1024 sample FFT
-    // Each FFT bin represents a frequency range
-    // We need to map frequencies to musical notes (12-tone equal temperament)
-
-    const float sampleRate = 44100.0f;
-    const int fftSize = 1024;  // Assumed FFT size
-    const fl::size numBins = fft.size();
-
-    for (fl::size binIdx = 0; binIdx < numBins; binIdx++) {
-        float magnitude = fft.bins_raw[binIdx];
-        if (magnitude < 1e-6f) continue;
-
-        // Calculate frequency of this bin
-        float freq = (static_cast<float>(binIdx) * sampleRate) / static_cast<float>(fftSize);
-
-        // Skip frequencies below 60Hz (too low for chord detection)
-        if (freq < 60.0f) continue;
-
-        // Convert frequency to MIDI note number (A4 = 440Hz = MIDI 69)
-        float midiNote = 69.0f + 12.0f * (fl::logf(freq / 440.0f) / fl::logf(2.0f));
-
-        // Get pitch class (0-11)
-        int pitchClass = static_cast<int>(midiNote + 0.5f) % 12;
-        if (pitchClass < 0) pitchClass += 12;
-
-        // Accumulate magnitude into chroma
-        mChroma[pitchClass] += magnitude;
-    }
-
-    // Normalize chroma
-    normalizeChroma(mChroma);
-}
-
 Chord ChordDetector::detectChord(const float* chroma, uint32_t timestamp) {
     float bestScore = 0.0f;
     int bestRoot = -1;
@@ -234,23 +196,6 @@ bool ChordDetector::isSimilarChord(const Chord& a, const Chord& b) {
     return false;
 }
 
-void ChordDetector::normalizeChroma(float* chroma) {
-    // Find max value
-    float maxVal = 0.0f;
-    for (int i = 0; i < 12; i++) {
-        if (chroma[i] > maxVal) {
-            maxVal = chroma[i];
-        }
-    }
-
-    // Normalize to 0-1 range
-    if (maxVal > 1e-6f) {
-        for (int i = 0; i < 12; i++) {
-            chroma[i] /= maxVal;
-        }
-    }
-}
-
 float ChordDetector::chromaDistance(const float* a, const float* b) {
     float dist = 0.0f;
     for (int i = 0; i < 12; i++) {
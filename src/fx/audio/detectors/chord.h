@@ -47,6 +47,9 @@ public:
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return true; }
     bool needsFFTHistory() const override { return true; }
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::Chroma);
+    }
     const char* getName() const override { return "ChordDetector"; }
     void reset() override;
 
@@ -79,13 +82,11 @@ private:
     float mPrevChroma[12];
 
     // Detection methods
-    void calculateChroma(const FFTBins& fft);
     Chord detectChord(const float* chroma, uint32_t timestamp);
     float matchChordPattern(const float* chroma, int root, ChordType type);
     bool isSimilarChord(const Chord& a, const Chord& b);
 
     // Helper methods
-    void normalizeChroma(float* chroma);
     float chromaDistance(const float* a, const float* b);
 };
 
@@ -37,7 +37,7 @@ void DynamicsAnalyzer::update(shared_ptr<AudioContext> context) {
     // Add to history
     if (mRMSHistory.size() < mHistorySize) {
         mRMSHistory.push_back(mCurrentRMS);
-        mHistoryIndex = mRMSHistory.size();
+        mHistoryIndex = mRMSHistory.size() % mHistorySize;
     } else {
         mRMSHistory[mHistoryIndex] = mCurrentRMS;
         mHistoryIndex = (mHistoryIndex + 1) % mHistorySize;
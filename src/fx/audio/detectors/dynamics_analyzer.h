@@ -17,6 +17,9 @@ public:
     // AudioDetector interface
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return false; }
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::RMS);
+    }
     const char* getName() const override { return "DynamicsAnalyzer"; }
     void reset() override;
 
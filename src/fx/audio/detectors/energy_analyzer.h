@@ -14,6 +14,9 @@ public:
 
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return false; }  // Uses RMS from AudioSample
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::RMS);
+    }
     const char* getName() const override { return "EnergyAnalyzer"; }
     void reset() override;
 
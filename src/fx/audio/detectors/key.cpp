@@ -89,14 +89,14 @@ KeyDetector::KeyDetector()
 KeyDetector::~KeyDetector() = default;
 
 void KeyDetector::update(shared_ptr<AudioContext> context) {
-    // Get FFT data
-    const FFTBins& fft = context->getFFT(32);  // Use more bins for better pitch resolution
     u32 timestamp = context->getTimestamp();
 
-    // Extract chroma features
+    // Chroma features, shared with ChordDetector
     float chroma[12] = {0};
-    extractChroma(fft, chroma);
-    normalizeChroma(chroma);
+    span<const float> shared = context->getChroma();
+    for (int i = 0; i < 12; i++) {
+        chroma[i] = shared[i];
+    }
 
     // Update temporal averaging
     updateChromaHistory(chroma);
@@ -182,59 +182,6 @@ void KeyDetector::reset() {
 // Chroma extraction and processing
 //------------------------------------------------------------------------------
 
-void KeyDetector::extractChroma(const FFTBins& fft, float* chroma) {
-    // Initialize chroma to zero
-    for (int i = 0; i < 12; i++) {
-        chroma[i] = 0.0f;
-    }
-
-    // Map FFT bins to pitch classes
-    // Assume 44100 Hz sample rate and 512-point FFT
-    const float sampleRate = 44100.0f;
-    const int fftSize = 512;
-    const float binWidth = sampleRate / fftSize;
-
-    // Process each FFT bin
-    for (size_t bin = 0; bin < fft.bins_raw.size(); bin++) {
-        float magnitude = fft.bins_raw[bin];
-        if (magnitude < 1e-6f) continue;
-
-        // Calculate frequency for this bin
-        float freq = bin * binWidth;
-
-        // Skip frequencies below 60 Hz (below C2)
-        if (freq < 60.0f) continue;
-
-        // Convert frequency to MIDI note number
-        // MIDI note = 69 + 12 * log2(freq / 440)
-        float midiNote = 69.0f + 12.0f * (fl::logf(freq / 440.0f) / fl::logf(2.0f));
-
-        // Get pitch class (0-11)
-        int pitchClass = static_cast<int>(midiNote + 0.5f) % 12;
-        if (pitchClass < 0) pitchClass += 12;
-
-        // Accumulate magnitude into pitch class
-        chroma[pitchClass] += magnitude;
-    }
-}
-
-void KeyDetector::normalizeChroma(float* chroma) {
-    // Find maximum value
-    float maxVal = 0.0f;
-    for (int i = 0; i < 12; i++) {
-        if (chroma[i] > maxVal) {
-            maxVal = chroma[i];
-        }
-    }
-
-    // Normalize to 0-1 range
-    if (maxVal > 1e-6f) {
-        for (int i = 0; i < 12; i++) {
-            chroma[i] /= maxVal;
-        }
-    }
-}
-
 void KeyDetector::updateChromaHistory(const float* chroma) {
     // Add current chroma to history (circular buffer)
     for (int i = 0; i < 12; i++) {
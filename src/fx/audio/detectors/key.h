@@ -85,6 +85,9 @@ public:
     // AudioDetector interface
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return true; }
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::Chroma);
+    }
     const char* getName() const override { return "KeyDetector"; }
     void reset() override;
 
@@ -124,8 +127,6 @@ private:
     static const float MINOR_PROFILE[12];
 
     // Helper methods
-    void extractChroma(const FFTBins& fft, float* chroma);
-    void normalizeChroma(float* chroma);
     void updateChromaHistory(const float* chroma);
     void getAveragedChroma(float* chroma);
     Key detectKey(const float* chroma, u32 timestamp);
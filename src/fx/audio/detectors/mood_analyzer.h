@@ -68,6 +68,9 @@ public:
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return true; }
     bool needsFFTHistory() const override { return true; }
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::Bands) | audioFeatureBit(AudioFeature::RMS);
+    }
     const char* getName() const override { return "MoodAnalyzer"; }
     void reset() override;
 
@@ -16,6 +16,8 @@ PitchDetector::PitchDetector()
     , mConfidenceThreshold(0.5f)  // Require 50% confidence minimum
     , mSmoothingFactor(0.85f)  // High smoothing for stable pitch
     , mPitchChangeSensitivity(5.0f)  // 5 Hz threshold for pitch change events
+    , mMethod(PitchMethod::Autocorrelation)
+    , mYinThreshold(0.15f)     // Common YIN threshold
     , mMinPeriod(0)
     , mMaxPeriod(0)
     , mSampleRate(44100.0f)    // Standard audio sample rate
@@ -48,7 +50,9 @@ void PitchDetector::update(shared_ptr<AudioContext> context) {
     }
 
     // Calculate autocorrelation and find pitch
-    float detectedPitch = calculateAutocorrelation(pcm.data(), numSamples);
+    float detectedPitch = mMethod == PitchMethod::YIN
+                              ? calculateYin(pcm.data(), numSamples)
+                              : calculateAutocorrelation(pcm.data(), numSamples);
 
     // Check if pitch is valid and confidence is sufficient
     if (detectedPitch > 0.0f && mConfidence >= mConfidenceThreshold) {
@@ -106,30 +110,16 @@ void PitchDetector::updatePeriodRange() {
 }
 
 float PitchDetector::calculateAutocorrelation(const int16_t* pcm, size numSamples) {
-    // Clear and resize autocorrelation buffer
-    mAutocorrelation.clear();
-    mAutocorrelation.resize(static_cast<size>(mMaxPeriod + 1), 0.0f);
-
-    // Normalize input to float range [-1, 1]
-    const float normFactor = 1.0f / 32768.0f;
-
-    // Calculate autocorrelation for all lags in the period range
     // ACF[k] = sum(signal[n] * signal[n + k]) for all valid n
-    for (int lag = mMinPeriod; lag <= mMaxPeriod; lag++) {
-        float sum = 0.0f;
-        int validSamples = 0;
-
-        for (size i = 0; i + lag < numSamples; i++) {
-            float s1 = static_cast<float>(pcm[i]) * normFactor;
-            float s2 = static_cast<float>(pcm[i + lag]) * normFactor;
-            sum += s1 * s2;
-            validSamples++;
-        }
-
-        // Normalize by number of samples
-        if (validSamples > 0) {
-            mAutocorrelation[static_cast<size>(lag)] = sum / static_cast<float>(validSamples);
-        }
+    computeLagProducts(pcm, numSamples, mMaxPeriod);
+
+    // Normalize by the number of overlapping samples; lags below the
+    // period range are not candidates
+    for (int lag = 0; lag <= mMaxPeriod; lag++) {
+        float& value = mAutocorrelation[static_cast<size>(lag)];
+        value = lag < mMinPeriod
+                    ? 0.0f
+                    : value / static_cast<float>(numSamples - static_cast<size>(lag));
     }
 
     // Find the lag with maximum autocorrelation (best period match)
@@ -148,6 +138,129 @@ float PitchDetector::calculateAutocorrelation(const int16_t* pcm, size numSample
     return 0.0f;
 }
 
+float PitchDetector::calculateYin(const int16_t* pcm, size numSamples) {
+    computeLagProducts(pcm, numSamples, mMaxPeriod);
+
+    // Difference function over the overlapping part of the block:
+    //   d(tau) = sum((x[j] - x[j + tau])^2), j < N - tau
+    //          = head energy + tail energy - 2 * ACF[tau]
+    // divided by the overlap length so every lag is on the same scale.
+    // The energies shrink by one sample per lag at each end.
+    const float normFactor = 1.0f / 32768.0f;
+    double head = mAutocorrelation[0];  // sum of x[j]^2, j < N - tau
+    double tail = mAutocorrelation[0];  // sum of x[j]^2, j >= tau
+    double runningSum = 0.0;
+    mAutocorrelation[0] = 1.0f;
+    for (int tau = 1; tau <= mMaxPeriod; tau++) {
+        const float first = static_cast<float>(pcm[tau - 1]) * normFactor;
+        const float last = static_cast<float>(pcm[numSamples - static_cast<size>(tau)]) * normFactor;
+        head -= last * last;
+        tail -= first * first;
+        const size overlap = numSamples - static_cast<size>(tau);
+        const double diff = fl::fl_max(
+            0.0, (head + tail - 2.0 * mAutocorrelation[static_cast<size>(tau)]) / overlap);
+
+        // Cumulative mean normalization: d'(tau) = d(tau) / mean(d(1..tau))
+        runningSum += diff;
+        mAutocorrelation[static_cast<size>(tau)] =
+            runningSum > 0.0 ? static_cast<float>(diff * tau / runningSum) : 1.0f;
+    }
+
+    // First dip below the absolute threshold, followed down to its minimum;
+    // without one, fall back to the global minimum (low confidence).
+    int bestTau = 0;
+    for (int tau = mMinPeriod; tau <= mMaxPeriod; tau++) {
+        if (mAutocorrelation[static_cast<size>(tau)] < mYinThreshold) {
+            while (tau + 1 <= mMaxPeriod &&
+                   mAutocorrelation[static_cast<size>(tau + 1)] <
+                       mAutocorrelation[static_cast<size>(tau)]) {
+                tau++;
+            }
+            bestTau = tau;
+            break;
+        }
+    }
+    if (bestTau == 0) {
+        float minValue = 2.0f;
+        for (int tau = mMinPeriod; tau <= mMaxPeriod; tau++) {
+            if (mAutocorrelation[static_cast<size>(tau)] < minValue) {
+                minValue = mAutocorrelation[static_cast<size>(tau)];
+                bestTau = tau;
+            }
+        }
+    }
+    if (bestTau <= 0) {
+        mConfidence = 0.0f;
+        return 0.0f;
+    }
+
+    const float center = mAutocorrelation[static_cast<size>(bestTau)];
+    mConfidence = fl::fl_max(0.0f, fl::fl_min(1.0f, 1.0f - center));
+
+    // Parabolic interpolation through the neighbouring lags
+    float period = static_cast<float>(bestTau);
+    if (bestTau > 1 && bestTau < mMaxPeriod) {
+        const float prev = mAutocorrelation[static_cast<size>(bestTau - 1)];
+        const float next = mAutocorrelation[static_cast<size>(bestTau + 1)];
+        const float denom = prev - 2.0f * center + next;
+        if (denom > 0.0f) {
+            const float shift = 0.5f * (prev - next) / denom;
+            period += fl::fl_max(-0.5f, fl::fl_min(0.5f, shift));
+        }
+    }
+    return mSampleRate / period;
+}
+
+void PitchDetector::computeLagProducts(const int16_t* pcm, size numSamples, int maxLag) {
+    // Wiener-Khinchin: the autocorrelation is the inverse transform of the
+    // power spectrum. Zero padding to at least N + maxLag keeps the circular
+    // correlation from wrapping into the lags we read.
+    size fftSize = 64;
+    while (fftSize < numSamples + static_cast<size>(maxLag)) {
+        fftSize <<= 1;
+    }
+    if (mFFT.samples() != fftSize) {
+        mFFT = FFTFloat(fftSize);
+        mFFTBuffer.resize(fftSize);
+        mFFTSpectrum.resize(mFFT.outputSize());
+    }
+    mAutocorrelation.clear();
+    mAutocorrelation.resize(static_cast<size>(maxLag + 1), 0.0f);
+    if (!mFFT.ok()) {
+        return;
+    }
+
+    // Normalize input to float range [-1, 1]
+    const float normFactor = 1.0f / 32768.0f;
+    float* data = mFFTBuffer.data();
+    for (size i = 0; i < numSamples; i++) {
+        data[i] = static_cast<float>(pcm[i]) * normFactor;
+    }
+    for (size i = numSamples; i < fftSize; i++) {
+        data[i] = 0.0f;
+    }
+    mFFT.run(data, mFFTSpectrum.data());
+
+    // The power spectrum is real and even, so its forward transform equals
+    // fftSize times the inverse one; mirror it and run the same FFT again.
+    const size half = fftSize / 2;
+    for (size k = 0; k <= half; k++) {
+        const float re = mFFTSpectrum[2 * k];
+        const float im = mFFTSpectrum[2 * k + 1];
+        const float power = re * re + im * im;
+        data[k] = power;
+        if (k > 0 && k < half) {
+            data[fftSize - k] = power;
+        }
+    }
+    mFFT.run(data, mFFTSpectrum.data());
+
+    const float scale = 1.0f / static_cast<float>(fftSize);
+    for (int lag = 0; lag <= maxLag; lag++) {
+        mAutocorrelation[static_cast<size>(lag)] = mFFTSpectrum[2 * static_cast<size>(lag)] * scale;
+    }
+}
+
 int PitchDetector::findBestPeakLag(const vector<float>& autocorr) const {
     // Find the lag with maximum autocorrelation value
     // (excluding lag 0, which is always maximum by definition)
@@ -2,11 +2,23 @@
 
 #include "fl/audio/audio_detector.h"
 #include "fl/audio/audio_context.h"
+#include "fl/fft_float.h"
 #include "fl/function.h"
 #include "fl/vector.h"
 
 namespace fl {
 
+/**
+ * Pitch estimation method used by PitchDetector.
+ *
+ * Both methods start from the same autocorrelation, computed in O(N log N)
+ * through a zero-padded real FFT (Wiener-Khinchin) instead of one pass per lag.
+ */
+enum class PitchMethod : u8 {
+    Autocorrelation,  // Strongest autocorrelation peak in the period range
+    YIN               // YIN difference function with parabolic interpolation
+};
+
 /**
  * PitchDetector - Continuous pitch tracking using autocorrelation
  *
@@ -16,6 +28,8 @@ namespace fl {
  *
  * Key Features:
  * - Autocorrelation-based pitch detection (time-domain analysis)
+ * - Optional YIN mode: cumulative mean normalized difference function with an
+ *   absolute threshold and sub-sample (parabolic) period estimate
  * - Configurable pitch range (default: 80-1000 Hz)
  * - Confidence-based filtering to reject unreliable detections
  * - Exponential smoothing for stable pitch output
@@ -23,9 +37,10 @@ namespace fl {
  * - Support for both voiced (pitched) and unvoiced (unpitched) audio
  *
  * Performance:
- * - No FFT required (uses raw PCM data)
- * - Update time: ~0.2-0.5ms per frame
- * - Memory: ~100 bytes + autocorrelation buffer (~2KB for 512 samples)
+ * - No shared FFT required (uses raw PCM data and an fl::FFTFloat)
+ * - Update cost O(N log N) in the block size, independent of the pitch range
+ * - Memory: autocorrelation buffer plus FFT buffers of ~4 floats per padded
+ *   sample (padded size = next power of two >= block size + max period)
  */
 class PitchDetector : public AudioDetector {
 public:
@@ -55,6 +70,10 @@ public:
     void setConfidenceThreshold(float threshold) { mConfidenceThreshold = threshold; }
     void setSmoothingFactor(float alpha) { mSmoothingFactor = alpha; }
     void setPitchChangeSensitivity(float sensitivity) { mPitchChangeSensitivity = sensitivity; }
+    void setMethod(PitchMethod method) { mMethod = method; }
+    PitchMethod getMethod() const { return mMethod; }
+    // YIN absolute threshold on the normalized difference (typical 0.10-0.15)
+    void setYinThreshold(float threshold) { mYinThreshold = threshold; }
 
 private:
     // Current state
@@ -71,18 +90,29 @@ private:
     float mConfidenceThreshold;  // Minimum confidence to report pitch
     float mSmoothingFactor;   // Exponential smoothing alpha (0-1)
     float mPitchChangeSensitivity;  // Sensitivity for pitch change detection (Hz)
+    PitchMethod mMethod;      // Autocorrelation peak picking or YIN
+    float mYinThreshold;      // YIN absolute threshold
 
     // Autocorrelation parameters
     int mMinPeriod;           // Minimum period in samples
     int mMaxPeriod;           // Maximum period in samples
     float mSampleRate;        // Audio sample rate (Hz)
 
-    // Autocorrelation buffer
+    // Autocorrelation buffer (per-sample normalized in Autocorrelation mode,
+    // YIN normalized difference in YIN mode)
     vector<float> mAutocorrelation;
 
+    // Float real FFT used for the autocorrelation, rebuilt when the padded
+    // size changes
+    FFTFloat mFFT;
+    vector<float> mFFTBuffer;    // padded input, mFFT.samples() values
+    vector<float> mFFTSpectrum;  // mFFT.outputSize() interleaved re/im values
+
     // Helper methods
     void updatePeriodRange();
     float calculateAutocorrelation(const int16_t* pcm, size numSamples);
+    float calculateYin(const int16_t* pcm, size numSamples);
+    void computeLagProducts(const int16_t* pcm, size numSamples, int maxLag);
     float periodToFrequency(int period) const;
     int frequencyToPeriod(float frequency) const;
     float calculateConfidence(const vector<float>& autocorr, int peakLag) const;
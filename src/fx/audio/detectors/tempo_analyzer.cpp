@@ -25,11 +25,10 @@ TempoAnalyzer::TempoAnalyzer()
 TempoAnalyzer::~TempoAnalyzer() = default;
 
 void TempoAnalyzer::update(shared_ptr<AudioContext> context) {
-    const FFTBins& fft = context->getFFT(16);
     u32 timestamp = context->getTimestamp();
 
-    // Calculate spectral flux for onset detection
-    float flux = calculateSpectralFlux(fft);
+    // Spectral flux for onset detection, shared with BeatDetector
+    float flux = context->getSpectralFlux();
 
     // Update adaptive threshold
     updateAdaptiveThreshold();
@@ -96,21 +95,6 @@ void TempoAnalyzer::reset() {
     mBPMHistory.clear();
 }
 
-float TempoAnalyzer::calculateSpectralFlux(const FFTBins& fft) {
-    // Focus on low-to-mid frequencies for beat detection
-    float flux = 0.0f;
-    size numBins = fl::fl_min(static_cast<size>(8), fft.bins_raw.size());
-
-    for (size i = 0; i < numBins; i++) {
-        float diff = fft.bins_raw[i] - mPreviousFlux;
-        if (diff > 0.0f) {
-            flux += diff;
-        }
-    }
-
-    return flux / static_cast<float>(numBins);
-}
-
 void TempoAnalyzer::updateAdaptiveThreshold() {
     // Add current flux to history
     if (mFluxHistory.size() >= FLUX_HISTORY_SIZE) {
@@ -15,6 +15,9 @@ public:
     void update(shared_ptr<AudioContext> context) override;
     bool needsFFT() const override { return true; }
     bool needsFFTHistory() const override { return true; }
+    AudioFeatureMask requiredFeatures() const override {
+        return audioFeatureBit(AudioFeature::SpectralFlux);
+    }
     const char* getName() const override { return "TempoAnalyzer"; }
     void reset() override;
 
@@ -75,7 +78,6 @@ private:
     static constexpr u32 MAX_BEAT_INTERVAL_MS = 2000; // Min 30 BPM
 
     // Internal methods
-    float calculateSpectralFlux(const FFTBins& fft);
     void updateAdaptiveThreshold();
     bool detectOnset(u32 timestamp);
     void updateHypotheses(u32 timestamp);
@@ -0,0 +1,122 @@
+#include "fx/audio/multi_audio_input.h"
+
+#include "fx/audio/audio_processor.h"
+#include "fl/warn.h"
+
+namespace fl {
+
+MultiAudioInput::MultiAudioInput(fl::size streams, int bands, float fmin,
+                                 float fmax)
+    : mBands(bands), mFmin(fmin), mFmax(fmax) {
+    mBlocks.reserve(streams);
+    mWeights.assign(streams, 1.0f);
+    mRms.assign(streams, 0.0f);
+    mFlux.assign(streams, 0.0f);
+    mFusedBands.assign(fl::size(bands), 0.0f);
+}
+
+void MultiAudioInput::setWeight(fl::size stream, float weight) {
+    if (stream < mWeights.size()) {
+        mWeights[stream] = weight;
+    }
+}
+
+bool MultiAudioInput::update(span<const AudioSample> blocks) {
+    const fl::size n = streams();
+    if (n == 0 || blocks.size() != n) {
+        FL_WARN("MultiAudioInput: expected " << n << " blocks, got "
+                << blocks.size());
+        return false;
+    }
+    const fl::size samples = blocks[0].size();
+    for (fl::size s = 0; s < n; ++s) {
+        if (!blocks[s].isValid() || blocks[s].size() != samples) {
+            return false;
+        }
+    }
+
+    mBlocks.clear();
+    for (fl::size s = 0; s < n; ++s) {
+        const AudioSample::VectorPCM& pcm = blocks[s].pcm();
+        mBlocks.push_back(span<const i16>(pcm.data(), pcm.size()));
+        mRms[s] = blocks[s].rms();
+    }
+
+    // One plan, one pass over each band kernel for every stream
+    const FFT_Args args(static_cast<int>(samples), mBands, mFmin, mFmax);
+    mFFT.transformBatch(mBlocks, &mBatch);
+    mFFT.bandsBatch(mBatch, &mMagnitudes, args);
+
+    // Flux and fused bands walk the band-major rows stream by stream
+    if (mPrevMagnitudes.size() != mMagnitudes.size()) {
+        mPrevMagnitudes.assign(mMagnitudes.size(), 0.0f);
+    }
+    for (fl::size s = 0; s < n; ++s) {
+        mFlux[s] = 0.0f;
+    }
+    for (int b = 0; b < mBands; ++b) {
+        const float* row = mMagnitudes.data() + fl::size(b) * n;
+        float* prev = mPrevMagnitudes.data() + fl::size(b) * n;
+        float fused = 0.0f;
+        for (fl::size s = 0; s < n; ++s) {
+            const float diff = row[s] - prev[s];
+            mFlux[s] += diff > 0.0f ? diff : 0.0f;
+            prev[s] = row[s];
+            fused += mWeights[s] * row[s];
+        }
+        mFusedBands[b] = fused;
+    }
+    mFusedFlux = 0.0f;
+    for (fl::size s = 0; s < n; ++s) {
+        mFlux[s] = mBands ? mFlux[s] / static_cast<float>(mBands) : 0.0f;
+        mFusedFlux += mWeights[s] * mFlux[s];
+    }
+
+    mixPcm(blocks, samples);
+    mBatch.mix(mWeights, &mMixSpectrum);
+    return true;
+}
+
+void MultiAudioInput::mixPcm(span<const AudioSample> blocks,
+                             fl::size samples) {
+    // Stream by stream, so each pass is one contiguous multiply-add
+    mMixSum.assign(samples, 0.0f);
+    float* sum = mMixSum.data();
+    for (fl::size s = 0; s < streams(); ++s) {
+        const float weight = mWeights[s];
+        const i16* pcm = mBlocks[s].data();
+        for (fl::size i = 0; i < samples; ++i) {
+            sum[i] += weight * pcm[i];
+        }
+    }
+    mMixPcm.resize(samples);
+    for (fl::size i = 0; i < samples; ++i) {
+        const float v = sum[i] > 32767.0f ? 32767.0f
+                        : (sum[i] < -32768.0f ? -32768.0f : sum[i]);
+        mMixPcm[i] = static_cast<i16>(v + (v < 0.0f ? -0.5f : 0.5f));
+    }
+    mMix = AudioSample(span<const i16>(mMixPcm.data(), mMixPcm.size()),
+                       blocks[0].timestamp());
+}
+
+void MultiAudioInput::feed(AudioProcessor& processor) const {
+    if (mMix.isValid()) {
+        processor.update(mMix, mMixSpectrum);
+    }
+}
+
+void MultiAudioInput::reset() {
+    mPrevMagnitudes.clear();
+    mMagnitudes.clear();
+    for (fl::size s = 0; s < streams(); ++s) {
+        mRms[s] = 0.0f;
+        mFlux[s] = 0.0f;
+    }
+    for (fl::size b = 0; b < mFusedBands.size(); ++b) {
+        mFusedBands[b] = 0.0f;
+    }
+    mFusedFlux = 0.0f;
+    mMix = AudioSample();
+}
+
+} // namespace fl
@@ -0,0 +1,102 @@
+#pragma once
+
+// Front end for several simultaneous audio streams, e.g. separate stems
+// from a kick mic, the line mix and an ambient mic.
+//
+// Each update() takes one block per stream and analyses them in a single
+// batched pass: the streams share one FFT plan, their spectra are laid out
+// structure-of-arrays (FFTSpectrumBatch) and every band kernel is walked
+// once for all of them. Per-stream RMS, band magnitudes and spectral flux
+// come out of that pass, along with weighted fusions of them, a PCM
+// mixdown and the mixdown's spectrum, which feed a single AudioProcessor
+// without another transform.
+//
+// Example:
+//   MultiAudioInput input(3);
+//   input.setWeight(0, 2.0f);            // favour the kick mic
+//   AudioProcessor processor;
+//   processor.onBeat([]() { flash(); });
+//   void loop() {
+//       AudioSample blocks[3] = {kick.read(), line.read(), ambient.read()};
+//       if (input.update(blocks)) {
+//           input.feed(processor);
+//           float kickFlux = input.flux(0);
+//       }
+//   }
+
+#include "fl/audio.h"
+#include "fl/fft.h"
+#include "fl/int.h"
+#include "fl/span.h"
+#include "fl/vector.h"
+
+namespace fl {
+
+class AudioProcessor;
+
+class MultiAudioInput {
+  public:
+    explicit MultiAudioInput(fl::size streams, int bands = 16,
+                             float fmin = FFT_Args::DefaultMinFrequency(),
+                             float fmax = FFT_Args::DefaultMaxFrequency());
+
+    fl::size streams() const { return mWeights.size(); }
+    int bands() const { return mBands; }
+
+    // Weight of a stream in the mixdown and the fused features, default 1
+    void setWeight(fl::size stream, float weight);
+    float getWeight(fl::size stream) const { return mWeights[stream]; }
+
+    // Analyses one block from each stream. All blocks must be valid and of
+    // the same size; otherwise nothing is updated and false is returned.
+    bool update(span<const AudioSample> blocks);
+
+    // ----- Per-stream features of the last update() -----
+    float rms(fl::size stream) const { return mRms[stream]; }
+    float bandMagnitude(fl::size stream, int band) const {
+        return mMagnitudes[fl::size(band) * streams() + stream];
+    }
+    // Positive change of the bands since the previous update(), averaged
+    // over the bands, as AudioContext::getSpectralFlux() computes it
+    float flux(fl::size stream) const { return mFlux[stream]; }
+    // Band-major magnitudes of every stream, [band * streams() + stream]
+    span<const float> magnitudes() const { return mMagnitudes; }
+
+    // ----- Fused features -----
+    // Weighted sums of the per-stream band magnitudes and fluxes. Unlike
+    // the mixdown they cannot cancel out between streams.
+    span<const float> fusedBands() const { return mFusedBands; }
+    float fusedFlux() const { return mFusedFlux; }
+    // Weighted PCM sum, saturated to 16 bits, and its spectrum
+    const AudioSample& mix() const { return mMix; }
+    const FFTSpectrum& mixSpectrum() const { return mMixSpectrum; }
+    float mixRms() const { return mMix.rms(); }
+
+    // Runs the processor's detectors on the mixdown, reusing its spectrum
+    void feed(AudioProcessor& processor) const;
+
+    void reset();
+
+  private:
+    void mixPcm(span<const AudioSample> blocks, fl::size samples);
+
+    int mBands;
+    float mFmin;
+    float mFmax;
+    FFT mFFT;
+    FFTSpectrumBatch mBatch;
+    fl::vector<span<const i16>> mBlocks;
+    fl::vector<float> mWeights;
+    fl::vector<float> mRms;
+    fl::vector<float> mMagnitudes;
+    fl::vector<float> mPrevMagnitudes;
+    fl::vector<float> mFlux;
+    fl::vector<float> mFusedBands;
+    float mFusedFlux = 0.0f;
+    fl::vector<float> mMixSum;
+    fl::vector<i16> mMixPcm;
+    AudioSample mMix;
+    FFTSpectrum mMixSpectrum;
+};
+
+} // namespace fl
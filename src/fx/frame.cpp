@@ -64,6 +64,14 @@ void Frame::draw(CRGB *leds, DrawMode draw_mode) const {
 void Frame::drawXY(CRGB *leds, const XYMap &xyMap, DrawMode draw_mode) const {
     const uint16_t width = xyMap.getWidth();
     const uint16_t height = xyMap.getHeight();
+    // Bulk copy when the map's bounds can be checked up front
+    if (draw_mode == DRAW_MODE_OVERWRITE &&
+        (xyMap.isSerpentineOrLineByLine() || xyMap.isCompiled()) &&
+        fl::u32(width) * height <= mPixelsCount &&
+        xyMap.indexEnd() <= mPixelsCount) {
+        xyMap.gather(mRgb.data(), leds);
+        return;
+    }
     fl::u32 count = 0;
     for (uint16_t h = 0; h < height; ++h) {
         for (uint16_t w = 0; w < width; ++w) {
@@ -94,6 +102,36 @@ void Frame::drawXY(CRGB *leds, const XYMap &xyMap, DrawMode draw_mode) const {
     }
 }
 
+void Frame::drawRect(CRGB *leds, const fl::rect<fl::u16> &region,
+                     DrawMode draw_mode) const {
+    if (mRgb.empty() || mWidth == 0) {
+        draw(leds, draw_mode);
+        return;
+    }
+    const fl::u16 x0 = region.mMin.x;
+    const fl::u16 x1 = FL_MIN(region.mMax.x, mWidth);
+    const fl::u16 y1 = FL_MIN(region.mMax.y, mHeight);
+    if (x0 >= x1) {
+        return;
+    }
+    for (fl::u16 y = region.mMin.y; y < y1; ++y) {
+        const size_t row = static_cast<size_t>(y) * mWidth;
+        switch (draw_mode) {
+        case DRAW_MODE_OVERWRITE: {
+            fl::memcpy(leds + row + x0, mRgb.data() + row + x0,
+                       (x1 - x0) * sizeof(CRGB));
+            break;
+        }
+        case DRAW_MODE_BLEND_BY_MAX_BRIGHTNESS: {
+            for (size_t i = row + x0; i < row + x1; ++i) {
+                leds[i] = CRGB::blendAlphaMaxChannel(mRgb[i], leds[i]);
+            }
+            break;
+        }
+        }
+    }
+}
+
 void Frame::clear() {
     if (mPixelsCount > 0 && !mRgb.empty()) {
         fl::memset((uint8_t*)mRgb.data(), 0, mPixelsCount * sizeof(CRGB));
@@ -4,6 +4,7 @@
 #include "crgb.h"
 #include "fl/ptr.h"         // For FASTLED_SMART_PTR macros
 #include "fl/xymap.h"
+#include "fl/geometry.h"
 #include "fl/vector.h"
 #include "fl/stdint.h"
 
@@ -48,6 +49,10 @@ class Frame {
     void draw(CRGB *leds, DrawMode draw_mode = DRAW_MODE_OVERWRITE) const;
     void drawXY(CRGB *leds, const XYMap &xyMap,
                 DrawMode draw_mode = DRAW_MODE_OVERWRITE) const;
+    // Draws only the pixels inside region. Both this frame and leds are
+    // row-major with getWidth() pixels per row.
+    void drawRect(CRGB *leds, const fl::rect<fl::u16> &region,
+                  DrawMode draw_mode = DRAW_MODE_OVERWRITE) const;
     void clear();
 
     // Codec functionality methods
@@ -57,6 +62,7 @@ class Frame {
     fl::u16 getWidth() const { return mWidth; }
     fl::u16 getHeight() const { return mHeight; }
     bool isFromCodec() const { return mIsFromCodec; }
+    void setTimestamp(fl::u32 timestamp) { mTimestamp = timestamp; }
 
   private:
     const size_t mPixelsCount;
@@ -12,6 +12,7 @@
 
 #include "fl/cstring.h"
 #include "fl/map_range.h"
+#include "fl/sketch_macros.h"
 // Compiler throws a warning about stack usage possibly being unbounded even
 // though bounds are checked, silence that so users don't see it
 #pragma GCC diagnostic push
@@ -295,6 +296,33 @@ static int8_t inline __attribute__((always_inline)) lerp7by8( int8_t a, int8_t b
     return result;
 }
 
+// Raw to scaled output, shared by the single-point and batch versions.
+// pan = (ans * 220L) >> 7 is the same as (ans * 440L) >> 8, which avoids a
+// 7X four-byte shift-loop on AVR. Identical math, except for the highest
+// bit, which we don't care about anyway, since we're returning the 'middle'
+// 16 out of a 32-bit value anyway.
+static uint16_t inline __attribute__((always_inline)) scale_noise16_3d(int16_t raw) {
+    uint32_t pan = (int32_t)raw + 19052L;
+    pan *= 440L;
+    return (pan>>8);
+}
+
+static uint16_t inline __attribute__((always_inline)) scale_noise16_2d(int16_t raw) {
+    uint32_t pan = (int32_t)raw + 17308L;
+    pan *= 484L;
+    return (pan>>8);
+}
+
+static uint16_t inline __attribute__((always_inline)) scale_noise16_1d(int16_t raw) {
+    return ((uint32_t)((int32_t)raw + 17308L)) << 1;
+}
+
+static uint8_t inline __attribute__((always_inline)) scale_noise8(int8_t raw) {
+    int8_t n = raw;                    // -64..+64
+    n+= 64;                            //   0..128
+    return fl::qadd8( n, n);           //   0..255
+}
+
 int16_t inoise16_raw(uint32_t x, uint32_t y, uint32_t z)
 {
     // Find the unit cube containing the point
@@ -434,15 +462,7 @@ uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z, uint32_t t) {
 }
 
 uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) {
-    int32_t ans = inoise16_raw(x,y,z);
-    ans = ans + 19052L;
-    uint32_t pan = ans;
-    // pan = (ans * 220L) >> 7.  That's the same as:
-    // pan = (ans * 440L) >> 8.  And this way avoids a 7X four-byte shift-loop on AVR.
-    // Identical math, except for the highest bit, which we don't care about anyway,
-    // since we're returning the 'middle' 16 out of a 32-bit value anyway.
-    pan *= 440L;
-    return (pan>>8);
+    return scale_noise16_3d(inoise16_raw(x,y,z));
 
     // // return scale16by8(pan,220)<<1;
     // return ((inoise16_raw(x,y,z)+19052)*220)>>7;
@@ -483,15 +503,7 @@ int16_t inoise16_raw(uint32_t x, uint32_t y)
 }
 
 uint16_t inoise16(uint32_t x, uint32_t y) {
-    int32_t ans = inoise16_raw(x,y);
-    ans = ans + 17308L;
-    uint32_t pan = ans;
-    // pan = (ans * 242L) >> 7.  That's the same as:
-    // pan = (ans * 484L) >> 8.  And this way avoids a 7X four-byte shift-loop on AVR.
-    // Identical math, except for the highest bit, which we don't care about anyway,
-    // since we're returning the 'middle' 16 out of a 32-bit value anyway.
-    pan *= 484L;
-    return (pan>>8);
+    return scale_noise16_2d(inoise16_raw(x,y));
 
     // return (uint32_t)(((int32_t)inoise16_raw(x,y)+(uint32_t)17308)*242)>>7;
     // return scale16by8(inoise16_raw(x,y)+17308,242)<<1;
@@ -523,7 +535,7 @@ int16_t inoise16_raw(uint32_t x)
 }
 
 uint16_t inoise16(uint32_t x) {
-    return ((uint32_t)((int32_t)inoise16_raw(x) + 17308L)) << 1;
+    return scale_noise16_1d(inoise16_raw(x));
 }
 
 int8_t inoise8_raw(uint16_t x, uint16_t y, uint16_t z)
@@ -569,10 +581,7 @@ int8_t inoise8_raw(uint16_t x, uint16_t y, uint16_t z)
 
 uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z) {
     //return scale8(76+(inoise8_raw(x,y,z)),215)<<1;
-    int8_t n = inoise8_raw( x, y, z);  // -64..+64
-    n+= 64;                            //   0..128
-    uint8_t ans = fl::qadd8( n, n);        //   0..255
-    return ans;
+    return scale_noise8(inoise8_raw( x, y, z));
 }
 
 int8_t inoise8_raw(uint16_t x, uint16_t y)
@@ -613,10 +622,7 @@ int8_t inoise8_raw(uint16_t x, uint16_t y)
 
 uint8_t inoise8(uint16_t x, uint16_t y) {
   //return scale8(69+inoise8_raw(x,y),237)<<1;
-    int8_t n = inoise8_raw( x, y);  // -64..+64
-    n+= 64;                         //   0..128
-    uint8_t ans = fl::qadd8( n, n);     //   0..255
-    return ans;
+    return scale_noise8(inoise8_raw( x, y));
 }
 
 // output range = -64 .. +64
@@ -646,10 +652,416 @@ int8_t inoise8_raw(uint16_t x)
 }
 
 uint8_t inoise8(uint16_t x) {
-    int8_t n = inoise8_raw(x);    //-64..+64
-    n += 64;                      // 0..128
-    uint8_t ans = fl::qadd8(n,n);     // 0..255
-    return ans;
+    return scale_noise8(inoise8_raw(x));
+}
+
+// Batch noise
+//
+// The row functions walk `count` points from x in steps of dx. Along a row
+// everything that depends on y and z (their hashes, fractions and eases)
+// is computed once, and the lattice hashes of a cell once for all the
+// points that fall in it. Points then go through in blocks of
+// NOISE_LANES: a scalar pass fills per-lane hash, fraction and ease
+// arrays, and the gradients and lerps run as fixed-width loops over the
+// lanes that the compiler can vectorize. Every step is the same integer
+// operation as the single-point code, so the results are bit-exact.
+//
+// The lane arrays live on the stack of every row call, and the 2D fills
+// recurse once per octave with a row chunk in each frame, so small-RAM
+// targets use narrow lanes and chunks.
+
+#if SKETCH_HAS_LOTS_OF_MEMORY
+#define NOISE_LANES 8
+#else
+#define NOISE_LANES 2
+#endif
+
+namespace noise_detail {
+
+// Lattice hashes of one cell, in the order the gradients consume them
+struct CellHashes {
+    int cell = -1;
+    uint8_t h[8];
+};
+
+} // namespace noise_detail
+
+static void inoise16_raw_row(int16_t *out, uint16_t count, uint32_t x, int32_t dx, uint32_t y, uint32_t z) {
+    const uint8_t Y = (y>>16)&0xFF;
+    const uint8_t Z = (z>>16)&0xFF;
+    uint16_t v = y & 0xFFFF;
+    uint16_t w = z & 0xFFFF;
+    const int16_t yy = (v >> 1) & 0x7FFF;
+    const int16_t zz = (w >> 1) & 0x7FFF;
+    const uint16_t N = 0x8000L;
+    v = EASE16(v); w = EASE16(w);
+
+    noise_detail::CellHashes cell;
+    uint32_t xi = x;
+    for (uint16_t base = 0; base < count; base += NOISE_LANES) {
+        const uint16_t n = (count - base) < NOISE_LANES ? (count - base) : NOISE_LANES;
+        uint8_t hash[8][NOISE_LANES];
+        uint16_t u[NOISE_LANES];
+        int16_t xx[NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l, xi += dx) {
+            const uint8_t X = (xi>>16)&0xFF;
+            if (X != cell.cell) {
+                uint8_t A = NOISE_P(X)+Y;
+                uint8_t AA = NOISE_P(A)+Z;
+                uint8_t AB = NOISE_P(A+1)+Z;
+                uint8_t B = NOISE_P(X+1)+Y;
+                uint8_t BA = NOISE_P(B) + Z;
+                uint8_t BB = NOISE_P(B+1)+Z;
+                cell.cell = X;
+                cell.h[0] = NOISE_P(AA);   cell.h[1] = NOISE_P(BA);
+                cell.h[2] = NOISE_P(AB);   cell.h[3] = NOISE_P(BB);
+                cell.h[4] = NOISE_P(AA+1); cell.h[5] = NOISE_P(BA+1);
+                cell.h[6] = NOISE_P(AB+1); cell.h[7] = NOISE_P(BB+1);
+            }
+            for (int c = 0; c < 8; ++c) {
+                hash[c][l] = cell.h[c];
+            }
+            const uint16_t f = xi & 0xFFFF;
+            xx[l] = (f >> 1) & 0x7FFF;
+            u[l] = EASE16(f);
+        }
+        int16_t g[8][NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l) {
+            g[0][l] = grad16(hash[0][l], xx[l], yy, zz);
+            g[1][l] = grad16(hash[1][l], xx[l] - N, yy, zz);
+            g[2][l] = grad16(hash[2][l], xx[l], yy-N, zz);
+            g[3][l] = grad16(hash[3][l], xx[l] - N, yy - N, zz);
+            g[4][l] = grad16(hash[4][l], xx[l], yy, zz-N);
+            g[5][l] = grad16(hash[5][l], xx[l] - N, yy, zz-N);
+            g[6][l] = grad16(hash[6][l], xx[l], yy-N, zz-N);
+            g[7][l] = grad16(hash[7][l], xx[l] - N, yy - N, zz - N);
+        }
+        for (uint16_t l = 0; l < n; ++l) {
+            int16_t X1 = LERP(g[0][l], g[1][l], u[l]);
+            int16_t X2 = LERP(g[2][l], g[3][l], u[l]);
+            int16_t X3 = LERP(g[4][l], g[5][l], u[l]);
+            int16_t X4 = LERP(g[6][l], g[7][l], u[l]);
+            int16_t Y1 = LERP(X1,X2,v);
+            int16_t Y2 = LERP(X3,X4,v);
+            out[base + l] = LERP(Y1,Y2,w);
+        }
+    }
+}
+
+static void inoise16_raw_row(int16_t *out, uint16_t count, uint32_t x, int32_t dx, uint32_t y) {
+    const uint8_t Y = y>>16;
+    uint16_t v = y & 0xFFFF;
+    const int16_t yy = (v >> 1) & 0x7FFF;
+    const uint16_t N = 0x8000L;
+    v = EASE16(v);
+
+    noise_detail::CellHashes cell;
+    uint32_t xi = x;
+    for (uint16_t base = 0; base < count; base += NOISE_LANES) {
+        const uint16_t n = (count - base) < NOISE_LANES ? (count - base) : NOISE_LANES;
+        uint8_t hash[4][NOISE_LANES];
+        uint16_t u[NOISE_LANES];
+        int16_t xx[NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l, xi += dx) {
+            const uint8_t X = xi>>16;
+            if (X != cell.cell) {
+                uint8_t A = NOISE_P(X)+Y;
+                uint8_t AA = NOISE_P(A);
+                uint8_t AB = NOISE_P(A+1);
+                uint8_t B = NOISE_P(X+1)+Y;
+                uint8_t BA = NOISE_P(B);
+                uint8_t BB = NOISE_P(B+1);
+                cell.cell = X;
+                cell.h[0] = NOISE_P(AA); cell.h[1] = NOISE_P(BA);
+                cell.h[2] = NOISE_P(AB); cell.h[3] = NOISE_P(BB);
+            }
+            for (int c = 0; c < 4; ++c) {
+                hash[c][l] = cell.h[c];
+            }
+            const uint16_t f = xi & 0xFFFF;
+            xx[l] = (f >> 1) & 0x7FFF;
+            u[l] = EASE16(f);
+        }
+        int16_t g[4][NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l) {
+            g[0][l] = grad16(hash[0][l], xx[l], yy);
+            g[1][l] = grad16(hash[1][l], xx[l] - N, yy);
+            g[2][l] = grad16(hash[2][l], xx[l], yy-N);
+            g[3][l] = grad16(hash[3][l], xx[l] - N, yy - N);
+        }
+        for (uint16_t l = 0; l < n; ++l) {
+            int16_t X1 = LERP(g[0][l], g[1][l], u[l]);
+            int16_t X2 = LERP(g[2][l], g[3][l], u[l]);
+            out[base + l] = LERP(X1,X2,v);
+        }
+    }
+}
+
+static void inoise16_raw_row(int16_t *out, uint16_t count, uint32_t x, int32_t dx) {
+    const uint16_t N = 0x8000L;
+    noise_detail::CellHashes cell;
+    uint32_t xi = x;
+    for (uint16_t base = 0; base < count; base += NOISE_LANES) {
+        const uint16_t n = (count - base) < NOISE_LANES ? (count - base) : NOISE_LANES;
+        uint8_t hash[2][NOISE_LANES];
+        uint16_t u[NOISE_LANES];
+        int16_t xx[NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l, xi += dx) {
+            const uint8_t X = xi>>16;
+            if (X != cell.cell) {
+                uint8_t A = NOISE_P(X);
+                uint8_t AA = NOISE_P(A);
+                uint8_t B = NOISE_P(X+1);
+                uint8_t BA = NOISE_P(B);
+                cell.cell = X;
+                cell.h[0] = NOISE_P(AA); cell.h[1] = NOISE_P(BA);
+            }
+            hash[0][l] = cell.h[0];
+            hash[1][l] = cell.h[1];
+            const uint16_t f = xi & 0xFFFF;
+            xx[l] = (f >> 1) & 0x7FFF;
+            u[l] = EASE16(f);
+        }
+        for (uint16_t l = 0; l < n; ++l) {
+            out[base + l] = LERP(grad16(hash[0][l], xx[l]), grad16(hash[1][l], xx[l] - N), u[l]);
+        }
+    }
+}
+
+static void inoise8_raw_row(int8_t *out, uint16_t count, uint16_t x, int dx, uint16_t y, uint16_t z) {
+    const uint8_t Y = y>>8;
+    const uint8_t Z = z>>8;
+    uint8_t v = y;
+    uint8_t w = z;
+    const int8_t yy = ((uint8_t)(y)>>1) & 0x7F;
+    const int8_t zz = ((uint8_t)(z)>>1) & 0x7F;
+    const uint8_t N = 0x80;
+    v = EASE8(v); w = EASE8(w);
+
+    noise_detail::CellHashes cell;
+    uint16_t xi = x;
+    for (uint16_t base = 0; base < count; base += NOISE_LANES) {
+        const uint16_t n = (count - base) < NOISE_LANES ? (count - base) : NOISE_LANES;
+        uint8_t hash[8][NOISE_LANES];
+        uint8_t u[NOISE_LANES];
+        int8_t xx[NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l, xi += dx) {
+            const uint8_t X = xi>>8;
+            if (X != cell.cell) {
+                uint8_t A = NOISE_P(X)+Y;
+                uint8_t AA = NOISE_P(A)+Z;
+                uint8_t AB = NOISE_P(A+1)+Z;
+                uint8_t B = NOISE_P(X+1)+Y;
+                uint8_t BA = NOISE_P(B) + Z;
+                uint8_t BB = NOISE_P(B+1)+Z;
+                cell.cell = X;
+                cell.h[0] = NOISE_P(AA);   cell.h[1] = NOISE_P(BA);
+                cell.h[2] = NOISE_P(AB);   cell.h[3] = NOISE_P(BB);
+                cell.h[4] = NOISE_P(AA+1); cell.h[5] = NOISE_P(BA+1);
+                cell.h[6] = NOISE_P(AB+1); cell.h[7] = NOISE_P(BB+1);
+            }
+            for (int c = 0; c < 8; ++c) {
+                hash[c][l] = cell.h[c];
+            }
+            xx[l] = ((uint8_t)(xi)>>1) & 0x7F;
+            u[l] = EASE8((uint8_t)xi);
+        }
+        int8_t g[8][NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l) {
+            g[0][l] = grad8(hash[0][l], xx[l], yy, zz);
+            g[1][l] = grad8(hash[1][l], xx[l] - N, yy, zz);
+            g[2][l] = grad8(hash[2][l], xx[l], yy-N, zz);
+            g[3][l] = grad8(hash[3][l], xx[l] - N, yy - N, zz);
+            g[4][l] = grad8(hash[4][l], xx[l], yy, zz-N);
+            g[5][l] = grad8(hash[5][l], xx[l] - N, yy, zz-N);
+            g[6][l] = grad8(hash[6][l], xx[l], yy-N, zz-N);
+            g[7][l] = grad8(hash[7][l], xx[l] - N, yy - N, zz - N);
+        }
+        for (uint16_t l = 0; l < n; ++l) {
+            int8_t X1 = lerp7by8(g[0][l], g[1][l], u[l]);
+            int8_t X2 = lerp7by8(g[2][l], g[3][l], u[l]);
+            int8_t X3 = lerp7by8(g[4][l], g[5][l], u[l]);
+            int8_t X4 = lerp7by8(g[6][l], g[7][l], u[l]);
+            int8_t Y1 = lerp7by8(X1,X2,v);
+            int8_t Y2 = lerp7by8(X3,X4,v);
+            out[base + l] = lerp7by8(Y1,Y2,w);
+        }
+    }
+}
+
+static void inoise8_raw_row(int8_t *out, uint16_t count, uint16_t x, int dx, uint16_t y) {
+    const uint8_t Y = y>>8;
+    uint8_t v = y;
+    const int8_t yy = ((uint8_t)(y)>>1) & 0x7F;
+    const uint8_t N = 0x80;
+    v = EASE8(v);
+
+    noise_detail::CellHashes cell;
+    uint16_t xi = x;
+    for (uint16_t base = 0; base < count; base += NOISE_LANES) {
+        const uint16_t n = (count - base) < NOISE_LANES ? (count - base) : NOISE_LANES;
+        uint8_t hash[4][NOISE_LANES];
+        uint8_t u[NOISE_LANES];
+        int8_t xx[NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l, xi += dx) {
+            const uint8_t X = xi>>8;
+            if (X != cell.cell) {
+                uint8_t A = NOISE_P(X)+Y;
+                uint8_t AA = NOISE_P(A);
+                uint8_t AB = NOISE_P(A+1);
+                uint8_t B = NOISE_P(X+1)+Y;
+                uint8_t BA = NOISE_P(B);
+                uint8_t BB = NOISE_P(B+1);
+                cell.cell = X;
+                cell.h[0] = NOISE_P(AA); cell.h[1] = NOISE_P(BA);
+                cell.h[2] = NOISE_P(AB); cell.h[3] = NOISE_P(BB);
+            }
+            for (int c = 0; c < 4; ++c) {
+                hash[c][l] = cell.h[c];
+            }
+            xx[l] = ((uint8_t)(xi)>>1) & 0x7F;
+            u[l] = EASE8((uint8_t)xi);
+        }
+        int8_t g[4][NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l) {
+            g[0][l] = grad8(hash[0][l], xx[l], yy);
+            g[1][l] = grad8(hash[1][l], xx[l] - N, yy);
+            g[2][l] = grad8(hash[2][l], xx[l], yy-N);
+            g[3][l] = grad8(hash[3][l], xx[l] - N, yy - N);
+        }
+        for (uint16_t l = 0; l < n; ++l) {
+            int8_t X1 = lerp7by8(g[0][l], g[1][l], u[l]);
+            int8_t X2 = lerp7by8(g[2][l], g[3][l], u[l]);
+            out[base + l] = lerp7by8(X1,X2,v);
+        }
+    }
+}
+
+static void inoise8_raw_row(int8_t *out, uint16_t count, uint16_t x, int dx) {
+    const uint8_t N = 0x80;
+    noise_detail::CellHashes cell;
+    uint16_t xi = x;
+    for (uint16_t base = 0; base < count; base += NOISE_LANES) {
+        const uint16_t n = (count - base) < NOISE_LANES ? (count - base) : NOISE_LANES;
+        uint8_t hash[2][NOISE_LANES];
+        uint8_t u[NOISE_LANES];
+        int8_t xx[NOISE_LANES];
+        for (uint16_t l = 0; l < n; ++l, xi += dx) {
+            const uint8_t X = xi>>8;
+            if (X != cell.cell) {
+                uint8_t A = NOISE_P(X);
+                uint8_t AA = NOISE_P(A);
+                uint8_t B = NOISE_P(X+1);
+                uint8_t BA = NOISE_P(B);
+                cell.cell = X;
+                cell.h[0] = NOISE_P(AA); cell.h[1] = NOISE_P(BA);
+            }
+            hash[0][l] = cell.h[0];
+            hash[1][l] = cell.h[1];
+            xx[l] = ((uint8_t)(xi)>>1) & 0x7F;
+            u[l] = EASE8((uint8_t)xi);
+        }
+        for (uint16_t l = 0; l < n; ++l) {
+            out[base + l] = lerp7by8(grad8(hash[0][l], xx[l]), grad8(hash[1][l], xx[l] - N), u[l]);
+        }
+    }
+}
+
+// The raw rows are produced in chunks on the stack and scaled in place
+#if SKETCH_HAS_LOTS_OF_MEMORY
+#define NOISE_CHUNK 64
+#else
+#define NOISE_CHUNK 8
+#endif
+
+void inoise16_row(uint16_t *out, uint16_t count, uint32_t x, int32_t dx, uint32_t y, uint32_t z) {
+    int16_t raw[NOISE_CHUNK];
+    for (uint16_t i = 0; i < count; i += NOISE_CHUNK) {
+        const uint16_t n = (count - i) < NOISE_CHUNK ? (count - i) : NOISE_CHUNK;
+        inoise16_raw_row(raw, n, x + (uint32_t)i * (uint32_t)dx, dx, y, z);
+        for (uint16_t k = 0; k < n; ++k) {
+            out[i + k] = scale_noise16_3d(raw[k]);
+        }
+    }
+}
+
+void inoise16_row(uint16_t *out, uint16_t count, uint32_t x, int32_t dx, uint32_t y) {
+    int16_t raw[NOISE_CHUNK];
+    for (uint16_t i = 0; i < count; i += NOISE_CHUNK) {
+        const uint16_t n = (count - i) < NOISE_CHUNK ? (count - i) : NOISE_CHUNK;
+        inoise16_raw_row(raw, n, x + (uint32_t)i * (uint32_t)dx, dx, y);
+        for (uint16_t k = 0; k < n; ++k) {
+            out[i + k] = scale_noise16_2d(raw[k]);
+        }
+    }
+}
+
+void inoise16_row(uint16_t *out, uint16_t count, uint32_t x, int32_t dx) {
+    int16_t raw[NOISE_CHUNK];
+    for (uint16_t i = 0; i < count; i += NOISE_CHUNK) {
+        const uint16_t n = (count - i) < NOISE_CHUNK ? (count - i) : NOISE_CHUNK;
+        inoise16_raw_row(raw, n, x + (uint32_t)i * (uint32_t)dx, dx);
+        for (uint16_t k = 0; k < n; ++k) {
+            out[i + k] = scale_noise16_1d(raw[k]);
+        }
+    }
+}
+
+void inoise8_row(uint8_t *out, uint16_t count, uint16_t x, int dx, uint16_t y, uint16_t z) {
+    int8_t raw[NOISE_CHUNK];
+    for (uint16_t i = 0; i < count; i += NOISE_CHUNK) {
+        const uint16_t n = (count - i) < NOISE_CHUNK ? (count - i) : NOISE_CHUNK;
+        inoise8_raw_row(raw, n, (uint16_t)(x + i * dx), dx, y, z);
+        for (uint16_t k = 0; k < n; ++k) {
+            out[i + k] = scale_noise8(raw[k]);
+        }
+    }
+}
+
+void inoise8_row(uint8_t *out, uint16_t count, uint16_t x, int dx, uint16_t y) {
+    int8_t raw[NOISE_CHUNK];
+    for (uint16_t i = 0; i < count; i += NOISE_CHUNK) {
+        const uint16_t n = (count - i) < NOISE_CHUNK ? (count - i) : NOISE_CHUNK;
+        inoise8_raw_row(raw, n, (uint16_t)(x + i * dx), dx, y);
+        for (uint16_t k = 0; k < n; ++k) {
+            out[i + k] = scale_noise8(raw[k]);
+        }
+    }
+}
+
+void inoise8_row(uint8_t *out, uint16_t count, uint16_t x, int dx) {
+    int8_t raw[NOISE_CHUNK];
+    for (uint16_t i = 0; i < count; i += NOISE_CHUNK) {
+        const uint16_t n = (count - i) < NOISE_CHUNK ? (count - i) : NOISE_CHUNK;
+        inoise8_raw_row(raw, n, (uint16_t)(x + i * dx), dx);
+        for (uint16_t k = 0; k < n; ++k) {
+            out[i + k] = scale_noise8(raw[k]);
+        }
+    }
+}
+
+void inoise16_grid(uint16_t *out, uint16_t width, uint16_t height, uint32_t x, int32_t dx, uint32_t y, int32_t dy, uint32_t z) {
+    for (uint16_t j = 0; j < height; ++j, y += dy) {
+        inoise16_row(out + (uint32_t)j * width, width, x, dx, y, z);
+    }
+}
+
+void inoise16_grid(uint16_t *out, uint16_t width, uint16_t height, uint32_t x, int32_t dx, uint32_t y, int32_t dy) {
+    for (uint16_t j = 0; j < height; ++j, y += dy) {
+        inoise16_row(out + (uint32_t)j * width, width, x, dx, y);
+    }
+}
+
+void inoise8_grid(uint8_t *out, uint16_t width, uint16_t height, uint16_t x, int dx, uint16_t y, int dy, uint16_t z) {
+    for (uint16_t j = 0; j < height; ++j, y += dy) {
+        inoise8_row(out + (uint32_t)j * width, width, x, dx, y, z);
+    }
+}
+
+void inoise8_grid(uint8_t *out, uint16_t width, uint16_t height, uint16_t x, int dx, uint16_t y, int dy) {
+    for (uint16_t j = 0; j < height; ++j, y += dy) {
+        inoise8_row(out + (uint32_t)j * width, width, x, dx, y);
+    }
 }
 
 
@@ -670,9 +1082,14 @@ uint8_t inoise8(uint16_t x) {
 void fill_raw_noise8(uint8_t *pData, uint8_t num_points, uint8_t octaves, uint16_t x, int scale, uint16_t time) {
   uint32_t _xx = x;
   uint32_t scx = scale;
+  uint8_t noise[NOISE_CHUNK];
   for(int o = 0; o < octaves; ++o) {
-    for(int i = 0,xx=_xx; i < num_points; ++i, xx+=scx) {
-          pData[i] = fl::qadd8(pData[i],inoise8(xx,time)>>o);
+    for(int i = 0; i < num_points; i += NOISE_CHUNK) {
+      const int n = (num_points - i) < NOISE_CHUNK ? (num_points - i) : NOISE_CHUNK;
+      inoise8_row(noise, n, _xx + i * scx, scx, time);
+      for(int k = 0; k < n; ++k) {
+        pData[i+k] = fl::qadd8(pData[i+k],noise[k]>>o);
+      }
     }
 
     _xx <<= 1;
@@ -683,6 +1100,8 @@ void fill_raw_noise8(uint8_t *pData, uint8_t num_points, uint8_t octaves, uint16
 void fill_raw_noise16into8(uint8_t *pData, uint8_t num_points, uint8_t octaves, uint32_t x, int scale, uint32_t time) {
   uint32_t _xx = x;
   uint32_t scx = scale;
+#if defined(__AVR__)
+  // int is 16 bits here, so x has always wrapped at 16 bits: keep that
   for(int o = 0; o < octaves; ++o) {
     for(int i = 0,xx=_xx; i < num_points; ++i, xx+=scx) {
       uint32_t accum = (inoise16(xx,time))>>o;
@@ -690,6 +1109,20 @@ void fill_raw_noise16into8(uint8_t *pData, uint8_t num_points, uint8_t octaves,
       if(accum > 65535) { accum = 65535; }
       pData[i] = accum>>8;
     }
+#else
+  uint16_t noise[NOISE_CHUNK];
+  for(int o = 0; o < octaves; ++o) {
+    for(int i = 0; i < num_points; i += NOISE_CHUNK) {
+      const int n = (num_points - i) < NOISE_CHUNK ? (num_points - i) : NOISE_CHUNK;
+      inoise16_row(noise, n, _xx + i * scx, scx, time);
+      for(int k = 0; k < n; ++k) {
+        uint32_t accum = noise[k]>>o;
+        accum += (pData[i+k]<<8);
+        if(accum > 65535) { accum = 65535; }
+        pData[i+k] = accum>>8;
+      }
+    }
+#endif
 
     _xx <<= 1;
     scx <<= 1;
@@ -722,12 +1155,15 @@ void fill_raw_2dnoise8(uint8_t *pData, int width, int height, uint8_t octaves, f
   scaley *= skip;
 
   fract8 invamp = 255-amplitude;
-  uint16_t xx = x;
+  uint8_t noise[NOISE_CHUNK];
   for(int i = 0; i < height; ++i, y+=scaley) {
     uint8_t *pRow = pData + (i*width);
-    xx = x;
-    for(int j = 0; j < width; ++j, xx+=scalex) {
-      uint8_t noise_base = inoise8(xx,y,time);
+    for(int j = 0; j < width; ++j) {
+      if(j % NOISE_CHUNK == 0) {
+        const int n = (width - j) < NOISE_CHUNK ? (width - j) : NOISE_CHUNK;
+        inoise8_row(noise, n, x + j * scalex, scalex, y, time);
+      }
+      uint8_t noise_base = noise[j % NOISE_CHUNK];
       noise_base = (0x80 & noise_base) ? (noise_base - 127) : (127 - noise_base);
       noise_base = scale8(noise_base<<1,amplitude);
       if(skip == 1) {
@@ -759,10 +1195,24 @@ void fill_raw_2dnoise16(uint16_t *pData, int width, int height, uint8_t octaves,
   scalex *= skip;
   scaley *= skip;
   fract16 invamp = 65535-amplitude;
+#if !defined(__AVR__)
+  const int points = (width + skip - 1) / skip;
+  uint16_t noise[NOISE_CHUNK];
+#endif
   for(int i = 0; i < height; i+=skip, y+=scaley) {
     uint16_t *pRow = pData + (i*width);
+#if defined(__AVR__)
+    // int is 16 bits here, so x has always wrapped at 16 bits: keep that
     for(int j = 0,xx=x; j < width; j+=skip, xx+=scalex) {
       uint16_t noise_base = inoise16(xx,y,time);
+#else
+    for(int j = 0,p = 0; j < width; j+=skip, ++p) {
+      if(p % NOISE_CHUNK == 0) {
+        const int n = (points - p) < NOISE_CHUNK ? (points - p) : NOISE_CHUNK;
+        inoise16_row(noise, n, x + p * scalex, scalex, y, time);
+      }
+      uint16_t noise_base = noise[p % NOISE_CHUNK];
+#endif
       noise_base = (0x8000 & noise_base) ? noise_base - (32767) : 32767 - noise_base;
       noise_base = scale16(noise_base<<1, amplitude);
       if(skip==1) {
@@ -796,13 +1246,17 @@ void fill_raw_2dnoise16into8(uint8_t *pData, int width, int height, uint8_t octa
 
   scalex *= skip;
   scaley *= skip;
-  uint32_t xx;
   fract8 invamp = 255-amplitude;
+  const int points = (width + skip - 1) / skip;
+  uint16_t noise[NOISE_CHUNK];
   for(int i = 0; i < height; i+=skip, y+=scaley) {
     uint8_t *pRow = pData + (i*width);
-    xx = x;
-    for(int j = 0; j < width; j+=skip, xx+=scalex) {
-      uint16_t noise_base = inoise16(xx,y,time);
+    for(int j = 0,p = 0; j < width; j+=skip, ++p) {
+      if(p % NOISE_CHUNK == 0) {
+        const int n = (points - p) < NOISE_CHUNK ? (points - p) : NOISE_CHUNK;
+        inoise16_row(noise, n, x + p * scalex, scalex, y, time);
+      }
+      uint16_t noise_base = noise[p % NOISE_CHUNK];
       noise_base = (0x8000 & noise_base) ? noise_base - (32767) : 32767 - noise_base;
       noise_base = scale8(noise_base>>7,amplitude);
       if(skip==1) {
@@ -115,6 +115,49 @@ extern int8_t inoise8_raw(uint16_t x);
 /// @} 8-Bit Raw Noise Functions
 
 
+/// @name Batch Noise Functions
+/// Evaluate a whole row or grid of points in one call. The results are
+/// identical to calling the single-point functions at each point, but the
+/// lattice hashes are computed once per noise cell instead of once per
+/// point, and the rest of the work runs in fixed-width blocks.
+/// @{
+
+/// Fills `out` with inoise16(x + i * dx, y, z) for i in [0, count)
+/// @param out destination, `count` values
+/// @param count number of points
+/// @param x x-axis coordinate of the first point
+/// @param dx step between points along the x-axis, may be negative
+/// @param y y-axis coordinate of the row (2D)
+/// @param z z-axis coordinate of the row (3D)
+extern void inoise16_row(uint16_t *out, uint16_t count, uint32_t x, int32_t dx, uint32_t y, uint32_t z);
+/// @copydoc inoise16_row(uint16_t*, uint16_t, uint32_t, int32_t, uint32_t, uint32_t)
+extern void inoise16_row(uint16_t *out, uint16_t count, uint32_t x, int32_t dx, uint32_t y);
+/// @copydoc inoise16_row(uint16_t*, uint16_t, uint32_t, int32_t, uint32_t, uint32_t)
+extern void inoise16_row(uint16_t *out, uint16_t count, uint32_t x, int32_t dx);
+
+/// Fills `out` with inoise8(x + i * dx, y, z) for i in [0, count)
+/// @copydetails inoise16_row(uint16_t*, uint16_t, uint32_t, int32_t, uint32_t, uint32_t)
+extern void inoise8_row(uint8_t *out, uint16_t count, uint16_t x, int dx, uint16_t y, uint16_t z);
+/// @copydoc inoise8_row(uint8_t*, uint16_t, uint16_t, int, uint16_t, uint16_t)
+extern void inoise8_row(uint8_t *out, uint16_t count, uint16_t x, int dx, uint16_t y);
+/// @copydoc inoise8_row(uint8_t*, uint16_t, uint16_t, int, uint16_t, uint16_t)
+extern void inoise8_row(uint8_t *out, uint16_t count, uint16_t x, int dx);
+
+/// Fills the row-major `out` with inoise16(x + i * dx, y + j * dy, z)
+/// for i in [0, width) and j in [0, height)
+extern void inoise16_grid(uint16_t *out, uint16_t width, uint16_t height, uint32_t x, int32_t dx, uint32_t y, int32_t dy, uint32_t z);
+/// @copydoc inoise16_grid(uint16_t*, uint16_t, uint16_t, uint32_t, int32_t, uint32_t, int32_t, uint32_t)
+extern void inoise16_grid(uint16_t *out, uint16_t width, uint16_t height, uint32_t x, int32_t dx, uint32_t y, int32_t dy);
+
+/// Fills the row-major `out` with inoise8(x + i * dx, y + j * dy, z)
+/// for i in [0, width) and j in [0, height)
+extern void inoise8_grid(uint8_t *out, uint16_t width, uint16_t height, uint16_t x, int dx, uint16_t y, int dy, uint16_t z);
+/// @copydoc inoise8_grid(uint8_t*, uint16_t, uint16_t, uint16_t, int, uint16_t, int, uint16_t)
+extern void inoise8_grid(uint8_t *out, uint16_t width, uint16_t height, uint16_t x, int dx, uint16_t y, int dy);
+
+/// @} Batch Noise Functions
+
+
 /// @name 32-Bit Simplex Noise Functions
 /// @{
 
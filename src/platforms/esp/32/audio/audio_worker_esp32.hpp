@@ -0,0 +1,75 @@
+#pragma once
+
+#include "fl/atomic.h"
+#include "fl/audio/audio_worker.h"
+#include "fl/warn.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace fl {
+
+// Runs the worker loop in a FreeRTOS task, pinned to config.core so the
+// render loop (usually on the other core) keeps its own CPU.
+class Esp32AudioWorker : public IAudioWorker {
+  public:
+    Esp32AudioWorker(fl::function<bool()> step, const AudioWorkerConfig& config)
+        : mStep(step), mIdleTicks(pdMS_TO_TICKS(config.idleMs)), mStopping(false),
+          mExited(false), mTask(nullptr) {
+        if (mIdleTicks == 0) {
+            mIdleTicks = 1;
+        }
+        const BaseType_t core = config.core < 0 ? tskNO_AFFINITY : config.core;
+        if (xTaskCreatePinnedToCore(&Esp32AudioWorker::taskMain, config.name,
+                                    config.stackSize, this, config.priority,
+                                    &mTask, core) != pdPASS) {
+            FL_WARN("Esp32AudioWorker: failed to create task " << config.name);
+            mTask = nullptr;
+            mExited = true;
+        }
+    }
+
+    ~Esp32AudioWorker() override { stop(); }
+
+    void stop() override {
+        mStopping = true;
+        while (!mExited.load()) {
+            vTaskDelay(1);
+        }
+    }
+
+    bool running() const override { return !mExited.load(); }
+
+  private:
+    static void taskMain(void* arg) {
+        Esp32AudioWorker* self = static_cast<Esp32AudioWorker*>(arg);
+        while (!self->mStopping.load()) {
+            if (!self->mStep()) {
+                vTaskDelay(self->mIdleTicks);
+            }
+        }
+        self->mExited = true;
+        vTaskDelete(nullptr);
+    }
+
+    fl::function<bool()> mStep;
+    TickType_t mIdleTicks;
+    fl::atomic_bool mStopping;
+    fl::atomic_bool mExited;
+    TaskHandle_t mTask;
+};
+
+inline fl::shared_ptr<IAudioWorker>
+platform_create_audio_worker(fl::function<bool()> step,
+                             const AudioWorkerConfig& config) {
+    fl::shared_ptr<Esp32AudioWorker> worker =
+        fl::make_shared<Esp32AudioWorker>(step, config);
+    if (!worker->running()) {
+        return nullptr;
+    }
+    return worker;
+}
+
+inline u32 platform_audio_worker_concurrency() { return portNUM_PROCESSORS; }
+
+} // namespace fl
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "fl/row_band_pool.h"
+#include "fl/vector.h"
+#include "fl/warn.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+namespace fl {
+
+// Worker tasks for RowBandPool. Each task waits on its own start
+// semaphore, runs band k + 1 and gives the shared done semaphore. Tasks
+// are unpinned so the scheduler spreads them over the cores, and run at
+// the creating task's priority.
+struct RowBandPool::Workers {
+    explicit Workers(u8 count) : mDone(xSemaphoreCreateCounting(count, 0)) {
+        mSlots.reserve(count);
+        if (!mDone) {
+            FL_WARN("RowBandPool: failed to create semaphore");
+            return;
+        }
+        for (u8 k = 0; k < count; ++k) {
+            mSlots.push_back(Slot());
+            Slot &slot = mSlots.back();
+            slot.owner = this;
+            slot.index = k;
+            slot.start = xSemaphoreCreateBinary();
+            if (slot.start &&
+                xTaskCreatePinnedToCore(&Workers::taskMain, "row_band",
+                                        kStackSize, &slot,
+                                        uxTaskPriorityGet(nullptr),
+                                        nullptr, tskNO_AFFINITY) == pdPASS) {
+                continue;
+            }
+            FL_WARN("RowBandPool: failed to create worker task " << k);
+            if (slot.start) {
+                vSemaphoreDelete(slot.start);
+            }
+            mSlots.pop_back();
+            break;
+        }
+    }
+
+    ~Workers() {
+        mStopping = true;
+        for (fl::size k = 0; k < mSlots.size(); ++k) {
+            xSemaphoreGive(mSlots[k].start);
+        }
+        // Each task gives mDone once more on its way out
+        for (fl::size k = 0; k < mSlots.size(); ++k) {
+            xSemaphoreTake(mDone, portMAX_DELAY);
+        }
+        for (fl::size k = 0; k < mSlots.size(); ++k) {
+            vSemaphoreDelete(mSlots[k].start);
+        }
+        if (mDone) {
+            vSemaphoreDelete(mDone);
+        }
+    }
+
+    u8 count() const { return u8(mSlots.size()); }
+
+    // Starts the workers the bands need, runs band 0 on the caller and
+    // waits for the rest. The semaphores order the shared fields.
+    void run(u32 rows, u8 bands, const fl::function<void(u32, u32)> &kernel) {
+        mKernel = &kernel;
+        mRows = rows;
+        mBands = bands;
+        for (u8 k = 0; k + 1 < bands; ++k) {
+            xSemaphoreGive(mSlots[k].start);
+        }
+        kernel(0, band(rows, bands, 1));
+        for (u8 k = 0; k + 1 < bands; ++k) {
+            xSemaphoreTake(mDone, portMAX_DELAY);
+        }
+        mKernel = nullptr;
+    }
+
+    static u32 band(u32 rows, u8 bands, u32 k) {
+        return u32((u64(rows) * k) / bands);
+    }
+
+  private:
+    static const u32 kStackSize = 4096;
+
+    struct Slot {
+        Workers *owner = nullptr;
+        u8 index = 0;
+        SemaphoreHandle_t start = nullptr;
+    };
+
+    static void taskMain(void *arg) {
+        const Slot *slot = static_cast<const Slot *>(arg);
+        Workers *self = slot->owner;
+        const u32 k = u32(slot->index) + 1;
+        for (;;) {
+            xSemaphoreTake(slot->start, portMAX_DELAY);
+            if (self->mStopping) {
+                break;
+            }
+            (*self->mKernel)(band(self->mRows, self->mBands, k),
+                             band(self->mRows, self->mBands, k + 1));
+            xSemaphoreGive(self->mDone);
+        }
+        xSemaphoreGive(self->mDone);
+        vTaskDelete(nullptr);
+    }
+
+    fl::vector<Slot> mSlots;
+    SemaphoreHandle_t mDone;
+    const fl::function<void(u32, u32)> *mKernel = nullptr;
+    u32 mRows = 0;
+    u8 mBands = 0;
+    volatile bool mStopping = false;
+};
+
+} // namespace fl
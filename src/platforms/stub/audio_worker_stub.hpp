@@ -0,0 +1,59 @@
+#pragma once
+
+#include "fl/atomic.h"
+#include "fl/audio/audio_worker.h"
+#include "fl/unique_ptr.h"
+
+#include <chrono>  // ok include
+#include <thread>  // ok include
+
+namespace fl {
+
+// Host worker: a plain thread. Priority and core affinity are left to the OS.
+class ThreadAudioWorker : public IAudioWorker {
+  public:
+    ThreadAudioWorker(fl::function<bool()> step, const AudioWorkerConfig& config)
+        : mStep(step), mIdleMs(config.idleMs), mStopping(false) {
+        mThread.reset(new std::thread(&ThreadAudioWorker::run, this));
+    }
+
+    ~ThreadAudioWorker() override { stop(); }
+
+    void stop() override {
+        mStopping = true;
+        if (mThread && mThread->joinable()) {
+            mThread->join();
+        }
+    }
+
+    bool running() const override {
+        return mThread && mThread->joinable() && !mStopping.load();
+    }
+
+  private:
+    void run() {
+        while (!mStopping.load()) {
+            if (!mStep()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(mIdleMs));
+            }
+        }
+    }
+
+    fl::function<bool()> mStep;
+    u32 mIdleMs;
+    fl::atomic_bool mStopping;
+    fl::unique_ptr<std::thread> mThread;
+};
+
+inline fl::shared_ptr<IAudioWorker>
+platform_create_audio_worker(fl::function<bool()> step,
+                             const AudioWorkerConfig& config) {
+    return fl::make_shared<ThreadAudioWorker>(step, config);
+}
+
+inline u32 platform_audio_worker_concurrency() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n ? u32(n) : 1;  // 0 when the count is unknown
+}
+
+} // namespace fl
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "fl/row_band_pool.h"
+#include "fl/vector.h"
+
+#include <condition_variable>  // ok include
+#include <mutex>  // ok include
+#include <thread>  // ok include
+
+namespace fl {
+
+// Worker threads for RowBandPool. Each run() publishes the kernel under a
+// new generation number; worker k runs band k + 1 and reports back.
+struct RowBandPool::Workers {
+    explicit Workers(u8 count) {
+        mThreads.reserve(count);
+        for (u8 k = 0; k < count; ++k) {
+            mThreads.emplace_back(&Workers::loop, this, k);
+        }
+    }
+
+    ~Workers() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mStart.notify_all();
+        for (fl::size k = 0; k < mThreads.size(); ++k) {
+            mThreads[k].join();
+        }
+    }
+
+    u8 count() const { return u8(mThreads.size()); }
+
+    // Publishes the bands, runs band 0 on the caller and waits for the rest
+    void run(u32 rows, u8 bands, const fl::function<void(u32, u32)> &kernel) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mKernel = &kernel;
+            mRows = rows;
+            mBands = bands;
+            mPending = bands - 1;
+            ++mGeneration;
+        }
+        mStart.notify_all();
+        kernel(0, band(rows, bands, 1));
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mPending == 0; });
+        mKernel = nullptr;
+    }
+
+    static u32 band(u32 rows, u8 bands, u32 k) {
+        return u32((u64(rows) * k) / bands);
+    }
+
+  private:
+    void loop(u8 index) {
+        u32 seen = 0;
+        for (;;) {
+            const fl::function<void(u32, u32)> *kernel;
+            u32 rows;
+            u8 bands;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mStart.wait(lock, [&]() {
+                    return mStopping || mGeneration != seen;
+                });
+                if (mStopping) {
+                    return;
+                }
+                seen = mGeneration;
+                kernel = mKernel;
+                rows = mRows;
+                bands = mBands;
+            }
+            const u32 k = u32(index) + 1;
+            if (k < bands) {
+                (*kernel)(band(rows, bands, k), band(rows, bands, k + 1));
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (--mPending == 0) {
+                    mDone.notify_one();
+                }
+            }
+        }
+    }
+
+    fl::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mStart;
+    std::condition_variable mDone;
+    const fl::function<void(u32, u32)> *mKernel = nullptr;
+    u32 mRows = 0;
+    u8 mBands = 0;
+    u8 mPending = 0;
+    u32 mGeneration = 0;
+    bool mStopping = false;
+};
+
+} // namespace fl
@@ -13,17 +13,10 @@ namespace fl {
 static WasmAudioInput* g_wasmAudioInput = nullptr;
 
 WasmAudioInput::WasmAudioInput()
-    : mHead(0)
-    , mTail(0)
+    : mQueue(RING_BUFFER_SLOTS, BLOCK_SIZE)
     , mRunning(false)
     , mHasError(false)
-    , mDroppedBlocks(0)
 {
-    // Initialize ring buffer
-    for (int i = 0; i < RING_BUFFER_SLOTS; i++) {
-        mRingBuffer[i].valid = false;
-    }
-
     // Set global instance for C callback
     g_wasmAudioInput = this;
 
@@ -46,12 +39,7 @@ void WasmAudioInput::start() {
 
 void WasmAudioInput::stop() {
     mRunning = false;
-    // Clear ring buffer
-    mHead = 0;
-    mTail = 0;
-    for (int i = 0; i < RING_BUFFER_SLOTS; i++) {
-        mRingBuffer[i].valid = false;
-    }
+    mQueue.clear();
     FL_DBG("WasmAudioInput stopped");
 }
 
@@ -63,26 +51,11 @@ bool WasmAudioInput::error(fl::string* msg) {
 }
 
 AudioSample WasmAudioInput::read() {
-    if (!mRunning || isEmpty()) {
+    // readAll() drains until an invalid sample, which is not an underrun
+    if (!mRunning || mQueue.empty()) {
         return AudioSample();  // Return invalid sample
     }
-
-    // Read from tail
-    AudioBlock& block = mRingBuffer[mTail];
-
-    if (!block.valid) {
-        return AudioSample();  // Shouldn't happen, but safety check
-    }
-
-    // Create AudioSample from block data
-    fl::span<const fl::i16> samples(block.samples, BLOCK_SIZE);
-    AudioSample result(samples, block.timestamp);
-
-    // Mark block as consumed and advance tail
-    block.valid = false;
-    mTail = nextIndex(mTail);
-
-    return result;
+    return mQueue.pop();
 }
 
 void WasmAudioInput::pushSamples(const fl::i16* samples, int count, fl::u32 timestamp) {
@@ -95,36 +68,13 @@ void WasmAudioInput::pushSamples(const fl::i16* samples, int count, fl::u32 time
         return;
     }
 
-    if (isFull()) {
-        // Ring buffer is full - drop oldest block
-        mDroppedBlocks++;
-        if (mDroppedBlocks % 100 == 1) {  // Log every 100 drops
-            FL_WARN("WasmAudioInput ring buffer overflow - dropped " << mDroppedBlocks << " blocks total");
+    if (!mQueue.push(fl::span<const fl::i16>(samples, count), timestamp)) {
+        // Queue is full - the newest block is dropped
+        const fl::u32 dropped = mQueue.overruns();
+        if (dropped % 100 == 1) {  // Log every 100 drops
+            FL_WARN("WasmAudioInput ring buffer overflow - dropped " << dropped << " blocks total");
         }
-        // Advance tail to drop oldest
-        mTail = nextIndex(mTail);
     }
-
-    // Write to head
-    AudioBlock& block = mRingBuffer[mHead];
-    fl::memcpy(block.samples, samples, BLOCK_SIZE * sizeof(fl::i16));
-    block.timestamp = timestamp;
-    block.valid = true;
-
-    // Advance head
-    mHead = nextIndex(mHead);
-}
-
-bool WasmAudioInput::isFull() const {
-    return nextIndex(mHead) == mTail;
-}
-
-bool WasmAudioInput::isEmpty() const {
-    return mHead == mTail && !mRingBuffer[mTail].valid;
-}
-
-int WasmAudioInput::nextIndex(int index) const {
-    return (index + 1) % RING_BUFFER_SLOTS;
 }
 
 fl::shared_ptr<IAudioInput> wasm_create_audio_input(const AudioConfig& config, fl::string* error_message) {
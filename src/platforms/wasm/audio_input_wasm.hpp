@@ -12,7 +12,8 @@ namespace fl {
 
 // WASM Audio Input Implementation
 // Receives 512-sample Int16 PCM blocks from JavaScript via pushAudioSamples()
-// Stores up to 16 blocks in a ring buffer for consumption by FastLED engine
+// Stores up to 16 blocks in an AudioSampleQueue for consumption by FastLED
+// engine; read() hands out the queued blocks without copying them.
 class WasmAudioInput : public IAudioInput {
 public:
     static constexpr int BLOCK_SIZE = 512;
@@ -31,25 +32,10 @@ public:
     void pushSamples(const fl::i16* samples, int count, fl::u32 timestamp);
 
 private:
-    struct AudioBlock {
-        fl::i16 samples[BLOCK_SIZE];
-        fl::u32 timestamp;
-        bool valid;
-
-        AudioBlock() : timestamp(0), valid(false) {}
-    };
-
-    AudioBlock mRingBuffer[RING_BUFFER_SLOTS];
-    int mHead;  // Write position
-    int mTail;  // Read position
+    AudioSampleQueue mQueue;
     bool mRunning;
     bool mHasError;
     fl::string mErrorMessage;
-    fl::u32 mDroppedBlocks;
-
-    bool isFull() const;
-    bool isEmpty() const;
-    int nextIndex(int index) const;
 };
 
 // Factory function for creating WASM audio input
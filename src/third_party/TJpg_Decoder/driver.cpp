@@ -101,23 +101,25 @@ bool TJpgInstanceDecoder::initializeDecoder() {
         return false;
     }
 
-    // Get image dimensions
-    fl::u16 width = jdec->width;
-    fl::u16 height = jdec->height;
-
-
-    // Apply scaling based on jpg_scale setting
-    if (embedded_tjpg_.jpg_scale > 1) {
-        width /= embedded_tjpg_.jpg_scale;
-        height /= embedded_tjpg_.jpg_scale;
+    if (target_width_ > 0 && target_height_ > 0) {
+        embedded_tjpg_.jpg_scale = chooseScale(jdec->width, jdec->height,
+                                               target_width_, target_height_);
     }
 
+    // TJpgDec shifts every MCU rect by the scale, so the decoded image is
+    // exactly the source size shifted down.
+    fl::u16 width = jdec->width >> embedded_tjpg_.jpg_scale;
+    fl::u16 height = jdec->height >> embedded_tjpg_.jpg_scale;
 
-    // Allocate frame buffer
-    allocateFrameBuffer(width, height);
+    setupTargetScaling(width, height);
+    if (!accumulator_.empty()) {
+        width = static_cast<fl::u16>(column_footprint_[width - 1].index + 1);
+        height = static_cast<fl::u16>(row_footprint_[height - 1].index + 1);
+    }
 
-    // Create frame object
-    current_frame_ = fl::make_shared<Frame>(frame_buffer_.get(), width, height, pixel_format_);
+    // Create a zero-initialized frame object; the output callback writes into
+    // its CRGB buffer directly, so no intermediate byte buffer is needed.
+    current_frame_ = fl::make_shared<Frame>(nullptr, width, height, pixel_format_);
 
     if (!current_frame_->isValid()) {
         setError("Failed to create frame");
@@ -163,6 +165,7 @@ bool TJpgInstanceDecoder::processChunk() {
         );
 
         if (processing_complete) {
+            resolveAccumulator();
             state_ = State::Complete;
             progress_ = 1.0f;
             return false;
@@ -193,6 +196,8 @@ bool TJpgInstanceDecoder::processChunk() {
         JRESULT res = jd_decomp(jdec, outputCallback, embedded_tjpg_.jpg_scale);
 
         if (res == JDR_OK) {
+            resolveAccumulator();
+
             // Check if any pixels were actually set by sampling the first pixel
             CRGB* pixels = current_frame_->rgb();
             fl::u8 first_pixel_sum = 0;
@@ -224,8 +229,10 @@ bool TJpgInstanceDecoder::processChunk() {
 void TJpgInstanceDecoder::endDecoding() {
     input_stream_.reset();
     input_buffer_.reset();
-    frame_buffer_.reset();
     current_frame_.reset();
+    column_footprint_.clear();
+    row_footprint_.clear();
+    accumulator_.clear();
     state_ = State::NotStarted;
     progress_ = 0.0f;
 }
@@ -268,16 +275,74 @@ fl::size TJpgInstanceDecoder::getBytesProcessed() const {
     return embedded_tjpg_.array_index;
 }
 
-void TJpgInstanceDecoder::allocateFrameBuffer(fl::u16 width, fl::u16 height) {
-    frame_buffer_size_ = static_cast<fl::size>(width) * height * getBytesPerPixel();
-    if (frame_buffer_size_ > 0) {
-        frame_buffer_.reset(new fl::u8[frame_buffer_size_]);
-        fl::memset(frame_buffer_.get(), 0, frame_buffer_size_);
+fl::u8 TJpgInstanceDecoder::chooseScale(fl::u16 image_width, fl::u16 image_height,
+                                        fl::u16 target_width, fl::u16 target_height) {
+    for (fl::u8 scale = 3; scale > 0; --scale) {
+        if ((image_width >> scale) >= target_width &&
+            (image_height >> scale) >= target_height) {
+            return scale;
+        }
     }
+    return 0;
+}
+
+// Output pixel i covers decoded range [i * in / out, (i + 1) * in / out). Since
+// out < in, a decoded pixel overlaps at most two output pixels.
+void TJpgInstanceDecoder::buildFootprints(fl::u16 in, fl::u16 out,
+                                          fl::vector<Footprint>* footprints) {
+    footprints->resize(in);
+    for (fl::u16 i = 0; i < in; ++i) {
+        const fl::u32 first = (static_cast<fl::u32>(i) * out) / in;
+        // Distance from i to the end of output pixel `first`, in units of 1/out
+        const fl::u32 remaining = (first + 1) * in - static_cast<fl::u32>(i) * out;
+        Footprint& fp = (*footprints)[i];
+        fp.index = static_cast<fl::u16>(first);
+        fp.weight = static_cast<fl::u16>(remaining >= out ? 256 : (remaining * 256) / out);
+    }
+}
+
+void TJpgInstanceDecoder::setupTargetScaling(fl::u16 decoded_width, fl::u16 decoded_height) {
+    column_footprint_.clear();
+    row_footprint_.clear();
+    accumulator_.clear();
+
+    if (target_width_ == 0 || target_height_ == 0 ||
+        (decoded_width <= target_width_ && decoded_height <= target_height_)) {
+        return; // Native scale already lands on (or under) the target
+    }
+
+    // Never upscale an axis that is already smaller than the target.
+    const fl::u16 out_width = FL_MIN(target_width_, decoded_width);
+    const fl::u16 out_height = FL_MIN(target_height_, decoded_height);
+
+    // Precomputed footprints keep the per-pixel work in the MCU callback to
+    // table loads and multiply-adds.
+    buildFootprints(decoded_width, out_width, &column_footprint_);
+    buildFootprints(decoded_height, out_height, &row_footprint_);
+    accumulator_.resize(static_cast<fl::size>(out_width) * out_height * 4);
+    fl::memset(accumulator_.data(), 0, accumulator_.size() * sizeof(fl::u32));
 }
 
-fl::size TJpgInstanceDecoder::getBytesPerPixel() const {
-    return fl::getBytesPerPixel(pixel_format_);
+void TJpgInstanceDecoder::resolveAccumulator() {
+    if (accumulator_.empty() || !current_frame_) {
+        return;
+    }
+    CRGB* pixels = current_frame_->rgb();
+    const fl::size count = current_frame_->size();
+    const fl::u32* acc = accumulator_.data();
+    for (fl::size i = 0; i < count; ++i, acc += 4) {
+        const fl::u32 n = acc[3];
+        if (n == 0) {
+            continue;
+        }
+        const fl::u32 half = n / 2;
+        pixels[i] = CRGB(static_cast<fl::u8>((acc[0] + half) / n),
+                         static_cast<fl::u8>((acc[1] + half) / n),
+                         static_cast<fl::u8>((acc[2] + half) / n));
+    }
+    // The accumulator is only needed while decoding.
+    fl::vector<fl::u32> released;
+    accumulator_.swap(released);
 }
 
 void TJpgInstanceDecoder::setError(const fl::string& msg) {
@@ -346,6 +411,50 @@ int TJpgInstanceDecoder::outputCallback(JDEC* jd, void* bitmap, JRECT* rect) {
         h = frame_height;
     }
 
+    // Copy pixels (already in RGB888 format since JD_FORMAT=0)
+    const fl::u8* rgb_data = reinterpret_cast<const fl::u8*>(bitmap);
+
+    if (!decoder->accumulator_.empty()) {
+        // Fused area-average downscale into the target resolution
+        if (x + w > decoder->column_footprint_.size() ||
+            y + h > decoder->row_footprint_.size()) {
+            return 0;
+        }
+        const Footprint* cols = decoder->column_footprint_.data() + x;
+        const Footprint* rows = decoder->row_footprint_.data() + y;
+        fl::u32* acc = decoder->accumulator_.data();
+        const fl::size stride = static_cast<fl::size>(frame_width) * 4;
+        for (fl::u16 row = 0; row < h; ++row) {
+            const Footprint& fy = rows[row];
+            fl::u32* acc_row = acc + fy.index * stride;
+            for (fl::u16 col = 0; col < w; ++col, rgb_data += 3) {
+                const Footprint& fx = cols[col];
+                fl::u32* a = acc_row + static_cast<fl::size>(fx.index) * 4;
+                // Split the pixel over up to 2x2 output pixels, Q8 weights
+                const fl::u32 wx[2] = {fx.weight, 256u - fx.weight};
+                const fl::u32 wy[2] = {fy.weight, 256u - fy.weight};
+                for (int j = 0; j < 2; ++j) {
+                    if (wy[j] == 0) {
+                        continue;
+                    }
+                    fl::u32* b = a + j * stride;
+                    for (int i = 0; i < 2; ++i) {
+                        const fl::u32 weight = (wx[i] * wy[j]) >> 8;
+                        if (weight == 0) {
+                            continue;
+                        }
+                        fl::u32* c = b + i * 4;
+                        c[0] += rgb_data[0] * weight;
+                        c[1] += rgb_data[1] * weight;
+                        c[2] += rgb_data[2] * weight;
+                        c[3] += weight;
+                    }
+                }
+            }
+        }
+        return 1;
+    }
+
     // Bounds check
     if (x >= frame_width || y >= frame_height ||
         x + w > frame_width || y + h > frame_height) {
@@ -358,25 +467,10 @@ int TJpgInstanceDecoder::outputCallback(JDEC* jd, void* bitmap, JRECT* rect) {
         return 0;
     }
 
-    // Copy pixels (already in RGB888 format since JD_FORMAT=0)
-    fl::u8* rgb_data = reinterpret_cast<fl::u8*>(bitmap);
-
     for (fl::u16 row = 0; row < h; ++row) {
-        for (fl::u16 col = 0; col < w; ++col) {
-            fl::u16 src_idx = (row * w + col) * 3;  // RGB888 is 3 bytes per pixel
-
-            // Calculate destination position
-            int pixel_x = x + col;
-            int pixel_y = y + row;
-            int frame_idx = pixel_y * frame_width + pixel_x;
-
-            // Get RGB888 values directly
-            fl::u8 r = rgb_data[src_idx + 0];
-            fl::u8 g = rgb_data[src_idx + 1];
-            fl::u8 b = rgb_data[src_idx + 2];
-
-            // Set pixel in frame buffer
-            frame_pixels[frame_idx] = CRGB(r, g, b);
+        CRGB* out = frame_pixels + static_cast<fl::size>(y + row) * frame_width + x;
+        for (fl::u16 col = 0; col < w; ++col, rgb_data += 3) {
+            out[col] = CRGB(rgb_data[0], rgb_data[1], rgb_data[2]);
         }
     }
 
@@ -10,6 +10,7 @@
 #include "fl/codec/pixel.h"
 #include "fx/frame.h"
 #include "fl/bytestream.h"
+#include "fl/vector.h"
 #include "src/tjpgd.h"
 
 namespace fl {
@@ -70,8 +71,19 @@ private:
 
     // Frame management
     fl::shared_ptr<Frame> current_frame_;
-    fl::scoped_array<fl::u8> frame_buffer_;
-    fl::size frame_buffer_size_ = 0;
+
+    // Target-size decoding. When a target is set the largest native IDCT
+    // scale that still covers it is used, and any remaining reduction is an
+    // area average accumulated directly in the MCU output callback.
+    fl::u16 target_width_ = 0;
+    fl::u16 target_height_ = 0;
+    struct Footprint {
+        fl::u16 index;   // first output pixel this decoded pixel overlaps
+        fl::u16 weight;  // Q8 share of it; the rest goes to index + 1
+    };
+    fl::vector<Footprint> column_footprint_;  // per decoded column
+    fl::vector<Footprint> row_footprint_;     // per decoded row
+    fl::vector<fl::u32> accumulator_;         // r, g, b, weight per output pixel
 
     // State tracking
     State state_ = State::NotStarted;
@@ -90,8 +102,9 @@ private:
     // Internal methods
     bool readStreamData();
     bool initializeDecoder();
-    void allocateFrameBuffer(fl::u16 width, fl::u16 height);
-    fl::size getBytesPerPixel() const;
+    static void buildFootprints(fl::u16 in, fl::u16 out, fl::vector<Footprint>* footprints);
+    void setupTargetScaling(fl::u16 decoded_width, fl::u16 decoded_height);
+    void resolveAccumulator();
     void setError(const fl::string& msg);
     bool shouldYield() const;
     void startTick();
@@ -115,10 +128,23 @@ public:
     }
 
     // Scale configuration for quality settings
+    // scale is a power of two shift: 0 = 1:1, 1 = 1/2, 2 = 1/4, 3 = 1/8
     void setScale(fl::u8 scale) {
         embedded_tjpg_.jpg_scale = scale;
     }
 
+    // Decode straight to the given output size. Overrides setScale().
+    // Pass 0, 0 to decode at the configured scale.
+    void setTargetSize(fl::u16 width, fl::u16 height) {
+        target_width_ = width;
+        target_height_ = height;
+    }
+
+    // Pick the largest TJpgDec scale (0-3) whose output still covers the
+    // target size. Returns 0 if even the full image is smaller.
+    static fl::u8 chooseScale(fl::u16 image_width, fl::u16 image_height,
+                              fl::u16 target_width, fl::u16 target_height);
+
     // State queries
     State getState() const { return state_; }
     bool hasError(fl::string* msg = nullptr) const;
@@ -7,6 +7,11 @@
 namespace fl {
 namespace third_party {
 
+namespace {
+// Sentinel for lastDecodedIndex_ before any frame has been converted.
+const fl::u32 kNoFrameDecoded = 0xFFFFFFFFu;
+}
+
 // Initialize static bitmap callbacks
 nsgif_bitmap_cb_vt SoftwareGifDecoder::bitmapCallbacks_ = {
     SoftwareGifDecoder::bitmapCreate,
@@ -22,6 +27,8 @@ SoftwareGifDecoder::SoftwareGifDecoder(fl::PixelFormat format)
     : gif_(nullptr)
     , stream_(nullptr)
     , currentFrame_(nullptr)
+    , lastDecodedIndex_(kNoFrameDecoded)
+    , bytesTouched_(0)
     , ready_(false)
     , hasError_(false)
     , dataComplete_(false)
@@ -53,6 +60,9 @@ void SoftwareGifDecoder::end() {
     cleanupDecoder();
     stream_ = nullptr;
     currentFrame_ = nullptr;
+    updatedRect_ = fl::rect<fl::u16>();
+    lastDecodedIndex_ = kNoFrameDecoded;
+    bytesTouched_ = 0;
     ready_ = false;
     hasError_ = false;
     dataComplete_ = false;
@@ -89,9 +99,7 @@ fl::DecodeResult SoftwareGifDecoder::decode() {
 
     switch (result) {
         case NSGIF_OK:
-            currentFrame_ = convertBitmapToFrame(bitmap);
-            if (!currentFrame_) {
-                setError("Failed to convert bitmap to frame");
+            if (!updateFrameFromBitmap(bitmap, currentFrameIndex_)) {
                 return fl::DecodeResult::Error;
             }
             currentFrameIndex_++;
@@ -172,6 +180,16 @@ bool SoftwareGifDecoder::seek(fl::u32 frameIndex) {
     return true;
 }
 
+bool SoftwareGifDecoder::getUpdatedRect(fl::rect<fl::u16>* rect) const {
+    if (!currentFrame_) {
+        return false;
+    }
+    if (rect) {
+        *rect = updatedRect_;
+    }
+    return true;
+}
+
 fl::u16 SoftwareGifDecoder::getWidth() const {
     if (!ready_ || hasError_) {
         return 0;
@@ -274,10 +292,53 @@ bool SoftwareGifDecoder::loadMoreData() {
     return true;
 }
 
-fl::shared_ptr<fl::Frame> SoftwareGifDecoder::convertBitmapToFrame(nsgif_bitmap_t* bitmap) {
+fl::rect<fl::u16> SoftwareGifDecoder::computeUpdatedRect(fl::u32 frameIndex) const {
+    const nsgif_info_t* info = nsgif_get_info(gif_);
+    const fl::u16 width = static_cast<fl::u16>(info->width);
+    const fl::u16 height = static_cast<fl::u16>(info->height);
+    const fl::rect<fl::u16> full(0, 0, width, height);
+
+    // libnsgif clears the whole canvas when (re)starting at frame 0 and
+    // replays from the start when seeking, so anything other than a
+    // sequential step invalidates everything.
+    if (!currentFrame_ || frameIndex == 0 || frameIndex != lastDecodedIndex_ + 1) {
+        return full;
+    }
+
+    auto clip = [width, height](const nsgif_rect_t& r) {
+        fl::u16 x0 = static_cast<fl::u16>(FL_MIN(r.x0, width));
+        fl::u16 y0 = static_cast<fl::u16>(FL_MIN(r.y0, height));
+        fl::u16 x1 = static_cast<fl::u16>(FL_MIN(r.x1, width));
+        fl::u16 y1 = static_cast<fl::u16>(FL_MIN(r.y1, height));
+        return fl::rect<fl::u16>(x0, y0, FL_MAX(x0, x1), FL_MAX(y0, y1));
+    };
+
+    const nsgif_frame_info_t* frame = nsgif_get_frame_info(gif_, frameIndex);
+    const nsgif_frame_info_t* prev = nsgif_get_frame_info(gif_, frameIndex - 1);
+    if (!frame || !prev) {
+        return full;
+    }
+
+    fl::rect<fl::u16> dirty = clip(frame->rect);
+    // Restore-to-background and restore-to-previous both rewrite the
+    // previous frame's area before this frame is plotted.
+    if (prev->disposal == NSGIF_DISPOSAL_RESTORE_BG ||
+        prev->disposal == NSGIF_DISPOSAL_RESTORE_PREV ||
+        prev->disposal == NSGIF_DISPOSAL_RESTORE_QUIRK) {
+        fl::rect<fl::u16> prevRect = clip(prev->rect);
+        if (dirty.width() == 0 || dirty.height() == 0) {
+            dirty = prevRect;
+        } else if (prevRect.width() > 0 && prevRect.height() > 0) {
+            dirty.expand(prevRect);
+        }
+    }
+    return dirty;
+}
+
+bool SoftwareGifDecoder::updateFrameFromBitmap(nsgif_bitmap_t* bitmap, fl::u32 frameIndex) {
     if (!bitmap) {
-        setError("convertBitmapToFrame called with null bitmap");
-        return nullptr;
+        setError("updateFrameFromBitmap called with null bitmap");
+        return false;
     }
 
     GifBitmap* gifBitmap = static_cast<GifBitmap*>(bitmap);
@@ -285,31 +346,44 @@ fl::shared_ptr<fl::Frame> SoftwareGifDecoder::convertBitmapToFrame(nsgif_bitmap_
     // Validate bitmap data
     if (!gifBitmap->pixels || gifBitmap->width == 0 || gifBitmap->height == 0) {
         setError("GIF bitmap has invalid data or dimensions");
-        return nullptr;
+        return false;
     }
 
-    fl::u8* rawData = gifBitmap->pixels.get();
-
-    // Since libnsgif outputs RGBA8888, we need to handle the conversion properly
-    // The Frame constructor expects the format we specify (outputFormat_)
-    // but libnsgif always gives us RGBA8888 data
-
-    // Create Frame with RGBA8888 format since that's what libnsgif provides
-    // The Frame constructor will handle conversion to outputFormat_ via convertPixelsToRgb
-    auto frame = fl::make_shared<fl::Frame>(
-        rawData,
-        gifBitmap->width,
-        gifBitmap->height,
-        fl::PixelFormat::RGBA8888,  // What libnsgif actually provides
-        currentFrameIndex_ // Use frame index as timestamp
-    );
+    if (!currentFrame_ || currentFrame_->getWidth() != gifBitmap->width ||
+        currentFrame_->getHeight() != gifBitmap->height) {
+        // Zero-initialized CRGB canvas, reused for every following frame.
+        currentFrame_ = fl::make_shared<fl::Frame>(
+            nullptr, gifBitmap->width, gifBitmap->height,
+            fl::PixelFormat::RGB888, frameIndex);
+        if (!currentFrame_ || !currentFrame_->isValid()) {
+            currentFrame_ = nullptr;
+            setError("Failed to allocate Frame for GIF canvas");
+            return false;
+        }
+        lastDecodedIndex_ = kNoFrameDecoded;
+    }
 
-    if (!frame || !frame->isValid()) {
-        setError("Failed to create valid Frame from GIF bitmap");
-        return nullptr;
+    const fl::rect<fl::u16> dirty = computeUpdatedRect(frameIndex);
+
+    // libnsgif outputs R8G8B8A8; the alpha channel is dropped, which matches
+    // the full-frame RGBA8888 conversion in Frame.
+    const fl::u8* src = gifBitmap->pixels.get();
+    CRGB* dst = currentFrame_->rgb();
+    const fl::u16 width = gifBitmap->width;
+    for (fl::u16 y = dirty.mMin.y; y < dirty.mMax.y; ++y) {
+        const fl::size row = static_cast<fl::size>(y) * width;
+        const fl::u8* in = src + (row + dirty.mMin.x) * 4;
+        CRGB* out = dst + row + dirty.mMin.x;
+        for (fl::u16 x = dirty.mMin.x; x < dirty.mMax.x; ++x, in += 4) {
+            *out++ = CRGB(in[0], in[1], in[2]);
+        }
     }
 
-    return frame;
+    currentFrame_->setTimestamp(frameIndex); // Use frame index as timestamp
+    updatedRect_ = dirty;
+    lastDecodedIndex_ = frameIndex;
+    bytesTouched_ += static_cast<fl::u64>(dirty.width()) * dirty.height() * sizeof(CRGB);
+    return true;
 }
 
 // Static callback implementations
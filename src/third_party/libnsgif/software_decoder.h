@@ -37,12 +37,21 @@ namespace third_party {
      * This decoder provides full animated GIF support through the FastLED IDecoder
      * interface, enabling streaming decode of GIF animations with proper frame timing
      * and disposal method handling.
+     *
+     * libnsgif composes each frame onto its own RGBA canvas. Rather than
+     * converting that canvas into a new Frame every decode, the decoder keeps
+     * one persistent CRGB Frame and only converts the rectangle touched by the
+     * current frame plus whatever the previous frame's disposal cleared.
+     * getUpdatedRect() reports that rectangle to downstream stages.
      */
     class SoftwareGifDecoder : public fl::IDecoder {
     private:
         nsgif_t* gif_;
         fl::ByteStreamPtr stream_;
         fl::shared_ptr<fl::Frame> currentFrame_;
+        fl::rect<fl::u16> updatedRect_;
+        fl::u32 lastDecodedIndex_;
+        fl::u64 bytesTouched_;
         fl::string errorMessage_;
         bool ready_;
         bool hasError_;
@@ -63,7 +72,8 @@ namespace third_party {
         void cleanupDecoder();
         void setError(const fl::string& message);
         bool loadMoreData();
-        fl::shared_ptr<fl::Frame> convertBitmapToFrame(nsgif_bitmap_t* bitmap);
+        bool updateFrameFromBitmap(nsgif_bitmap_t* bitmap, fl::u32 frameIndex);
+        fl::rect<fl::u16> computeUpdatedRect(fl::u32 frameIndex) const;
 
         // Static callbacks for libnsgif
         static nsgif_bitmap_t* bitmapCreate(int width, int height);
@@ -82,12 +92,19 @@ namespace third_party {
 
         fl::DecodeResult decode() override;
         fl::Frame getCurrentFrame() override;
+        // Persistent frame that decode() updates in place (dirty rect only)
+        fl::FramePtr getCurrentFramePtr() override { return currentFrame_; }
         bool hasMoreFrames() const override;
 
         // Animation support methods
         fl::u32 getFrameCount() const override;
         fl::u32 getCurrentFrameIndex() const override { return currentFrameIndex_; }
         bool seek(fl::u32 frameIndex) override;
+        bool getUpdatedRect(fl::rect<fl::u16>* rect) const override;
+
+        // Total bytes of CRGB output written since begin(). Useful for
+        // measuring how much work the partial updates save.
+        fl::u64 getBytesTouched() const { return bytesTouched_; }
 
         // Get GIF properties
         fl::u16 getWidth() const;
@@ -19,45 +19,91 @@
 namespace fl {
 namespace third_party {
 
-// Helper function to convert YUV to RGB
-static void yuv_to_rgb(const fl::third_party::plm_frame_t* frame, fl::u8* rgb_buffer) {
-    fl::u32 width = frame->width;
-    fl::u32 height = frame->height;
-
-    // YUV to RGB conversion coefficients (ITU-R BT.601 standard, scaled by 1000)
-    const fl::i32 YUV_TO_RGB_MATRIX[9] = {
-        1164,    0, 1596,  // Y, U, V coefficients for R
-        1164, -391, -813,  // Y, U, V coefficients for G
-        1164, 2017,    0   // Y, U, V coefficients for B (fixed: 2018 -> 2017)
-    };
+// YUV to RGB conversion (ITU-R BT.601), coefficients scaled by 1000.
+// Y, U and V are already offset by -16, -128 and -128.
+static inline void store_rgb(fl::i32 Y, fl::i32 U, fl::i32 V, fl::u8* out) {
+    fl::i32 R = (1164 * Y + 1596 * V) / 1000;
+    fl::i32 G = (1164 * Y - 391 * U - 813 * V) / 1000;
+    fl::i32 B = (1164 * Y + 2017 * U) / 1000;
+
+    out[0] = static_cast<fl::u8>(R < 0 ? 0 : (R > 255 ? 255 : R));
+    out[1] = static_cast<fl::u8>(G < 0 ? 0 : (G > 255 ? 255 : G));
+    out[2] = static_cast<fl::u8>(B < 0 ? 0 : (B > 255 ? 255 : B));
+}
+
+void Mpeg1FrameScaler::buildSpans(fl::u16 src, fl::u16 out, fl::vector<Span>* spans) {
+    spans->resize(out);
+    for (fl::u16 i = 0; i < out; ++i) {
+        Span& span = (*spans)[i];
+        span.begin = static_cast<fl::u16>((static_cast<fl::u32>(i) * src) / out);
+        span.end = static_cast<fl::u16>((static_cast<fl::u32>(i + 1) * src) / out);
+        if (span.end <= span.begin) {
+            span.end = span.begin + 1;
+        }
+        span.chromaBegin = span.begin / 2;
+        span.chromaEnd = static_cast<fl::u16>((span.end - 1) / 2 + 1);
+    }
+}
 
+void Mpeg1FrameScaler::configure(fl::u16 srcWidth, fl::u16 srcHeight,
+                                 fl::u16 outWidth, fl::u16 outHeight) {
+    outWidth = (outWidth == 0 || outWidth > srcWidth) ? srcWidth : outWidth;
+    outHeight = (outHeight == 0 || outHeight > srcHeight) ? srcHeight : outHeight;
+    srcWidth_ = srcWidth;
+    srcHeight_ = srcHeight;
+    buildSpans(srcWidth, outWidth, &cols_);
+    buildSpans(srcHeight, outHeight, &rows_);
+}
+
+void Mpeg1FrameScaler::convertNative(const plm_frame_t* frame, fl::u8* rgb) const {
+    const fl::u32 width = srcWidth_;
+    const fl::u32 height = srcHeight_;
     for (fl::u32 y = 0; y < height; y++) {
-        for (fl::u32 x = 0; x < width; x++) {
-            // Get Y, U, V values
-            fl::u32 y_index = y * frame->y.width + x;
-            fl::u32 uv_x = x / 2;
-            fl::u32 uv_y = y / 2;
-            fl::u32 uv_index = uv_y * frame->cr.width + uv_x;
-
-            fl::i32 Y = frame->y.data[y_index] - 16;
-            fl::i32 U = frame->cb.data[uv_index] - 128;
-            fl::i32 V = frame->cr.data[uv_index] - 128;
-
-            // Convert to RGB
-            fl::i32 R = (YUV_TO_RGB_MATRIX[0] * Y + YUV_TO_RGB_MATRIX[1] * U + YUV_TO_RGB_MATRIX[2] * V) / 1000;
-            fl::i32 G = (YUV_TO_RGB_MATRIX[3] * Y + YUV_TO_RGB_MATRIX[4] * U + YUV_TO_RGB_MATRIX[5] * V) / 1000;
-            fl::i32 B = (YUV_TO_RGB_MATRIX[6] * Y + YUV_TO_RGB_MATRIX[7] * U + YUV_TO_RGB_MATRIX[8] * V) / 1000;
-
-            // Clamp values
-            R = R < 0 ? 0 : (R > 255 ? 255 : R);
-            G = G < 0 ? 0 : (G > 255 ? 255 : G);
-            B = B < 0 ? 0 : (B > 255 ? 255 : B);
-
-            // Store RGB values
-            fl::u32 rgb_index = (y * width + x) * 3;
-            rgb_buffer[rgb_index + 0] = static_cast<fl::u8>(R);
-            rgb_buffer[rgb_index + 1] = static_cast<fl::u8>(G);
-            rgb_buffer[rgb_index + 2] = static_cast<fl::u8>(B);
+        const fl::u8* luma = frame->y.data + y * frame->y.width;
+        const fl::u8* cb = frame->cb.data + (y / 2) * frame->cb.width;
+        const fl::u8* cr = frame->cr.data + (y / 2) * frame->cr.width;
+        for (fl::u32 x = 0; x < width; x++, rgb += 3) {
+            store_rgb(luma[x] - 16, cb[x / 2] - 128, cr[x / 2] - 128, rgb);
+        }
+    }
+}
+
+void Mpeg1FrameScaler::convert(const plm_frame_t* frame, fl::u8* rgb) const {
+    if (cols_.size() == srcWidth_ && rows_.size() == srcHeight_) {
+        convertNative(frame, rgb);
+        return;
+    }
+
+    // Box filter: average Y, Cb and Cr over each output footprint, then run
+    // the color conversion once per output pixel. The conversion is linear
+    // so this matches averaging in RGB, apart from clamping.
+    for (const Span& row : rows_) {
+        for (const Span& col : cols_) {
+            fl::u32 ySum = 0;
+            for (fl::u16 y = row.begin; y < row.end; ++y) {
+                const fl::u8* luma = frame->y.data + static_cast<fl::u32>(y) * frame->y.width;
+                for (fl::u16 x = col.begin; x < col.end; ++x) {
+                    ySum += luma[x];
+                }
+            }
+            fl::u32 cbSum = 0;
+            fl::u32 crSum = 0;
+            for (fl::u16 y = row.chromaBegin; y < row.chromaEnd; ++y) {
+                const fl::u8* cb = frame->cb.data + static_cast<fl::u32>(y) * frame->cb.width;
+                const fl::u8* cr = frame->cr.data + static_cast<fl::u32>(y) * frame->cr.width;
+                for (fl::u16 x = col.chromaBegin; x < col.chromaEnd; ++x) {
+                    cbSum += cb[x];
+                    crSum += cr[x];
+                }
+            }
+            const fl::u32 yCount = static_cast<fl::u32>(row.end - row.begin) * (col.end - col.begin);
+            const fl::u32 cCount = static_cast<fl::u32>(row.chromaEnd - row.chromaBegin) *
+                                   (col.chromaEnd - col.chromaBegin);
+            const fl::i32 Y = static_cast<fl::i32>((ySum + yCount / 2) / yCount) - 16;
+            const fl::i32 U = static_cast<fl::i32>((cbSum + cCount / 2) / cCount) - 128;
+            const fl::i32 V = static_cast<fl::i32>((crSum + cCount / 2) / cCount) - 128;
+            store_rgb(Y, U, V, rgb);
+            rgb += 3;
         }
     }
 }
@@ -77,9 +123,10 @@ struct SoftwareMpeg1Decoder::Mpeg1DecoderData {
     fl::size inputSize = 0;
     fl::size totalSize = 0;
 
-    // Current decoded frame data (RGB)
+    // Current decoded frame data (RGB), at the scaler's output size
     fl::scoped_array<fl::u8> rgbFrameBuffer;
     fl::size rgbFrameSize = 0;
+    Mpeg1FrameScaler scaler;
 
     // Decoder state
     bool headerParsed = false;
@@ -100,9 +147,14 @@ void SoftwareMpeg1Decoder::videoDecodeCallback(fl::third_party::plm_t* plm_ptr,
         decoder->decoderData_->hasNewFrame = true;
         decoder->decoderData_->lastFrameTime = frame->time;
 
+        // The first frame may arrive while headers are still being parsed,
+        // so size the scaler and RGB buffer from the frame itself.
+        decoder->configureScaler(static_cast<fl::u16>(frame->width),
+                                 static_cast<fl::u16>(frame->height));
+
         // Convert YUV to RGB and store in buffer
         if (decoder->decoderData_->rgbFrameBuffer.get()) {
-            yuv_to_rgb(frame, decoder->decoderData_->rgbFrameBuffer.get());
+            decoder->decoderData_->scaler.convert(frame, decoder->decoderData_->rgbFrameBuffer.get());
         }
     }
 }
@@ -210,18 +262,22 @@ DecodeResult SoftwareMpeg1Decoder::decode() {
 }
 
 Frame SoftwareMpeg1Decoder::getCurrentFrame() {
-    if (config_.mode == Mpeg1Config::Streaming && !config_.immediateMode && !frameBuffer_.empty() && currentFrameIndex_ > 0) {
-        Frame result = *frameBuffer_[lastDecodedIndex_];
-        return result;
-    }
-    if (currentFrame_) {
-        Frame result = *currentFrame_;
+    FramePtr frame = getCurrentFramePtr();
+    if (frame) {
+        Frame result = *frame;
         return result;
     }
     // Return an invalid frame if no frame has been decoded yet
     return Frame(0);
 }
 
+FramePtr SoftwareMpeg1Decoder::getCurrentFramePtr() {
+    if (config_.mode == Mpeg1Config::Streaming && !config_.immediateMode && !frameBuffer_.empty() && currentFrameIndex_ > 0) {
+        return frameBuffer_[lastDecodedIndex_];
+    }
+    return currentFrame_;
+}
+
 bool SoftwareMpeg1Decoder::hasMoreFrames() const {
     return !endOfStream_ && ready_ && !hasError_;
 }
@@ -232,9 +288,152 @@ fl::u32 SoftwareMpeg1Decoder::getFrameCount() const {
 }
 
 bool SoftwareMpeg1Decoder::seek(fl::u32 frameIndex) {
-    (void)frameIndex; // Suppress unused parameter warning
-    // Seeking not supported in this simplified implementation
-    return false;
+    if (!ready_ || hasError_ || !decoderData_->plmpeg || gopIndex_.empty()) {
+        return false;
+    }
+
+    // Last intra frame shown at or before the requested frame. Entries are
+    // in stream order, which keeps I-frames in display order.
+    fl::size pick = 0;
+    for (fl::size i = 1; i < gopIndex_.size(); ++i) {
+        if (gopIndex_[i].displayIndex > frameIndex) {
+            break;
+        }
+        pick = i;
+    }
+    const GopEntry& entry = gopIndex_[pick];
+    // Pictures come out of the decoder in display order, starting with the
+    // B-frames stored after the I-frame but shown before it. Frames ahead
+    // of that, e.g. leading B-frames at the very start of the stream, can't
+    // be reached from an I-frame.
+    const fl::u32 firstShown = entry.displayIndex - entry.leadingBFrames;
+    if (frameIndex < firstShown) {
+        return false;
+    }
+
+    // Several pictures often share one PES packet, so pl_mpeg's PTS based
+    // seek cannot reach every I-frame. Re-read the indexed packet and feed the
+    // video decoder from the picture start code onwards instead.
+    fl::third_party::plm_t* plm = decoderData_->plmpeg;
+    if (!fl::third_party::plm_init_decoders(plm) || !plm->video_packet_type) {
+        return false;
+    }
+    const int type = plm->video_packet_type;
+    fl::third_party::plm_demux_buffer_seek(plm->demux, entry.packetPos);
+    if (fl::third_party::plm_buffer_find_start_code(plm->demux->buffer, type) == -1) {
+        return false;
+    }
+    fl::third_party::plm_packet_t* packet = fl::third_party::plm_demux_decode_packet(plm->demux, type);
+    if (!packet || packet->length <= entry.payloadOffset) {
+        return false;
+    }
+
+    // Keep audio out of the buffer while the video decoder catches up
+    const int audioPacketType = plm->audio_packet_type;
+    plm->audio_packet_type = 0;
+    fl::third_party::plm_video_rewind(plm->video_decoder);
+    fl::third_party::plm_video_set_time(plm->video_decoder, entry.time);
+    fl::third_party::plm_buffer_write(plm->video_buffer, packet->data + entry.payloadOffset,
+                                      packet->length - entry.payloadOffset);
+    fl::third_party::plm_frame_t* frame = fl::third_party::plm_video_decode(plm->video_decoder);
+    // Decode forward to the requested frame; the skipped pictures, among
+    // them an open GOP's leading B-frames, are never converted to RGB
+    for (fl::u32 shown = firstShown; frame && shown < frameIndex; ++shown) {
+        frame = fl::third_party::plm_video_decode(plm->video_decoder);
+    }
+    plm->audio_packet_type = audioPacketType;
+    if (!frame) {
+        return false;
+    }
+    // Playback clock follows the decoder so the next decode() advances by
+    // exactly one picture
+    plm->time = fl::third_party::plm_video_get_time(plm->video_decoder);
+    plm->has_ended = 0;
+
+    decoderData_->hasNewFrame = false;
+    videoDecodeCallback(plm, frame, this);
+    endOfStream_ = false;
+    currentFrameIndex_ = frameIndex;
+    return decodeFrame();
+}
+
+void SoftwareMpeg1Decoder::buildGopIndex() {
+    gopIndex_.clear();
+
+    // Scan with a private demuxer over the same memory so the playback
+    // demuxer's position is untouched; positions are shared between the two.
+    fl::third_party::plm_buffer_t* buffer = fl::third_party::plm_buffer_create_with_memory(
+        decoderData_->inputBuffer.get(), decoderData_->totalSize, 0);
+    if (!buffer) {
+        return;
+    }
+    fl::third_party::plm_demux_t* demux = fl::third_party::plm_demux_create(buffer, 1);
+    if (!demux) {
+        fl::third_party::plm_buffer_destroy(buffer);
+        return;
+    }
+
+    const int type = fl::third_party::PLM_DEMUX_PACKET_VIDEO_1;
+    const double fps = decoderData_->frameRate > 0 ? decoderData_->frameRate : config_.targetFps;
+    fl::third_party::plm_demux_rewind(demux);
+
+    // A picture is shown at the start of its GOP plus its temporal
+    // reference. A start code split across two packets is missed, which
+    // costs that one index entry, or for a GOP header, shifts the frame
+    // numbers of its GOP.
+    fl::u32 gopStart = 0;       // display index of the GOP's first picture
+    fl::u32 gopPictures = 0;    // pictures seen in the GOP so far
+    bool countLeading = false;  // B-frames still follow the last I-frame
+    fl::size packetPos = fl::third_party::plm_buffer_tell(buffer);
+    fl::third_party::plm_packet_t* packet;
+    while ((packet = fl::third_party::plm_demux_decode(demux)) != nullptr) {
+        const fl::size nextPacketPos = fl::third_party::plm_buffer_tell(buffer);
+        if (packet->type == type) {
+            for (fl::size i = 0; i + 6 <= packet->length; ++i) {
+                const fl::u8* d = packet->data + i;
+                if (d[0] != 0x00 || d[1] != 0x00 || d[2] != 0x01) {
+                    continue;
+                }
+                if (d[3] == 0xB8) {  // group of pictures
+                    gopStart += gopPictures;
+                    gopPictures = 0;
+                    countLeading = false;
+                    i += 3;
+                    continue;
+                }
+                if (d[3] != 0x00) {
+                    continue;
+                }
+                // temporal_reference is the first 10 bits of the picture
+                // header, picture_coding_type the next 3: 1 = intra, 3 = B
+                const fl::u32 temporalReference = (fl::u32(d[4]) << 2) | (d[5] >> 6);
+                const int codingType = (d[5] >> 3) & 0x07;
+                if (codingType == 1) {
+                    GopEntry entry;
+                    entry.displayIndex = gopStart + temporalReference;
+                    entry.leadingBFrames = 0;
+                    entry.packetPos = packetPos;
+                    entry.payloadOffset = static_cast<fl::u32>(i);
+                    gopIndex_.push_back(entry);
+                    countLeading = true;
+                } else if (codingType == 3 && countLeading) {
+                    ++gopIndex_.back().leadingBFrames;
+                } else {
+                    countLeading = false;
+                }
+                ++gopPictures;
+                i += 3;
+            }
+        }
+        packetPos = nextPacketPos;
+    }
+
+    fl::third_party::plm_demux_destroy(demux);
+
+    for (GopEntry& entry : gopIndex_) {
+        const fl::u32 firstShown = entry.displayIndex - entry.leadingBFrames;
+        entry.time = fps > 0 ? firstShown / fps : 0.0;
+    }
 }
 
 fl::u16 SoftwareMpeg1Decoder::getWidth() const {
@@ -249,6 +448,14 @@ fl::u16 SoftwareMpeg1Decoder::getFrameRate() const {
     return decoderData_->frameRate;
 }
 
+fl::u16 SoftwareMpeg1Decoder::getOutputWidth() const {
+    return decoderData_->scaler.getOutputWidth();
+}
+
+fl::u16 SoftwareMpeg1Decoder::getOutputHeight() const {
+    return decoderData_->scaler.getOutputHeight();
+}
+
 bool SoftwareMpeg1Decoder::initializeDecoder() {
     if (!stream_) {
         setError("No input stream available");
@@ -313,12 +520,8 @@ bool SoftwareMpeg1Decoder::initializeDecoder() {
     // some frames before audio headers are found
     // Note: Video callback must be set first so we can capture frame dimensions
     if (!fl::third_party::plm_has_headers(decoderData_->plmpeg)) {
-        // Temporarily allocate a minimal buffer for header decoding
-        // We'll reallocate properly once we know dimensions
-        fl::size temp_buffer_size = static_cast<fl::size>(1920ul * 1080ul * 3ul); // Max reasonable size for header decode
-        decoderData_->rgbFrameBuffer.reset(new fl::u8[temp_buffer_size]);
-
-        // Decode one frame to get headers
+        // Decode one frame to get headers; the video callback allocates the
+        // RGB buffer once it sees the frame size.
         fl::third_party::plm_decode(decoderData_->plmpeg, decoderData_->targetFrameDuration);
     }
 
@@ -344,6 +547,7 @@ bool SoftwareMpeg1Decoder::initializeDecoder() {
 
     // Now allocate properly sized buffers based on actual video dimensions
     allocateFrameBuffers();
+    buildGopIndex();
     decoderData_->initialized = true;
     decoderData_->headerParsed = true;
     return true;
@@ -399,16 +603,16 @@ bool SoftwareMpeg1Decoder::decodeFrame() {
         fl::u8 bufferIndex = currentFrameIndex_ % config_.bufferFrames;
         // Create a new Frame using shared_ptr
         frameBuffer_[bufferIndex] = fl::make_shared<Frame>(decoderData_->rgbFrameBuffer.get(),
-                                                           decoderData_->width,
-                                                           decoderData_->height,
+                                                           getOutputWidth(),
+                                                           getOutputHeight(),
                                                            PixelFormat::RGB888,
                                                            timestampMs);
         lastDecodedIndex_ = bufferIndex;
     } else {
         // Create a new frame as shared_ptr (for SingleFrame mode or immediate mode)
         currentFrame_ = fl::make_shared<Frame>(decoderData_->rgbFrameBuffer.get(),
-                                              decoderData_->width,
-                                              decoderData_->height,
+                                              getOutputWidth(),
+                                              getOutputHeight(),
                                               PixelFormat::RGB888,
                                               timestampMs);
     }
@@ -417,12 +621,23 @@ bool SoftwareMpeg1Decoder::decodeFrame() {
     return true;
 }
 
-void SoftwareMpeg1Decoder::allocateFrameBuffers() {
-    fl::size frameSize = decoderData_->width * decoderData_->height * 3; // RGB888
-    decoderData_->rgbFrameSize = frameSize;
+void SoftwareMpeg1Decoder::configureScaler(fl::u16 width, fl::u16 height) {
+    Mpeg1FrameScaler& scaler = decoderData_->scaler;
+    if (decoderData_->rgbFrameBuffer.get() &&
+        scaler.getSourceWidth() == width && scaler.getSourceHeight() == height) {
+        return;
+    }
+    scaler.configure(width, height, config_.targetWidth, config_.targetHeight);
 
     // Allocate RGB frame buffer for converted frames
+    fl::size frameSize = static_cast<fl::size>(scaler.getOutputWidth()) *
+                         scaler.getOutputHeight() * 3; // RGB888
+    decoderData_->rgbFrameSize = frameSize;
     decoderData_->rgbFrameBuffer.reset(new fl::u8[frameSize]);
+}
+
+void SoftwareMpeg1Decoder::allocateFrameBuffers() {
+    configureScaler(decoderData_->width, decoderData_->height);
 
     if (config_.mode == Mpeg1Config::Streaming && !config_.immediateMode) {
         frameBuffer_.resize(config_.bufferFrames);
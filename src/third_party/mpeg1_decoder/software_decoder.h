@@ -19,12 +19,47 @@ struct Mpeg1Config {
     bool immediateMode = true;  // For real-time LED applications - bypass frame buffering
     fl::u8 bufferFrames = 2;  // Only used when immediateMode = false
     AudioFrameCallback audioCallback;  // Optional callback for audio frames (default-constructed is empty)
+    // Optional output size. When set, YCbCr is box filtered straight down to
+    // this resolution instead of converting the full frame. Axes are never
+    // upscaled. 0 keeps the native size.
+    fl::u16 targetWidth = 0;
+    fl::u16 targetHeight = 0;
 
     Mpeg1Config() = default;
     Mpeg1Config(FrameMode m, fl::u16 fps = 30)
         : mode(m), targetFps(fps) {}
 };
 
+// Converts decoded pl_mpeg frames from YCbCr 4:2:0 to RGB888 at an output size
+// no larger than the source. Each output pixel averages the luma and chroma
+// samples under its footprint and is converted once, so no full-size RGB
+// intermediate is needed. The footprint tables are built by configure().
+class Mpeg1FrameScaler {
+public:
+    void configure(fl::u16 srcWidth, fl::u16 srcHeight, fl::u16 outWidth, fl::u16 outHeight);
+    void convert(const plm_frame_t* frame, fl::u8* rgb) const;
+
+    fl::u16 getSourceWidth() const { return srcWidth_; }
+    fl::u16 getSourceHeight() const { return srcHeight_; }
+    fl::u16 getOutputWidth() const { return static_cast<fl::u16>(cols_.size()); }
+    fl::u16 getOutputHeight() const { return static_cast<fl::u16>(rows_.size()); }
+
+private:
+    struct Span {
+        fl::u16 begin;        // first luma sample
+        fl::u16 end;          // one past the last luma sample
+        fl::u16 chromaBegin;  // same range in the half resolution chroma planes
+        fl::u16 chromaEnd;
+    };
+    static void buildSpans(fl::u16 src, fl::u16 out, fl::vector<Span>* spans);
+    void convertNative(const plm_frame_t* frame, fl::u8* rgb) const;
+
+    fl::u16 srcWidth_ = 0;
+    fl::u16 srcHeight_ = 0;
+    fl::vector<Span> cols_;
+    fl::vector<Span> rows_;
+};
+
 // Software MPEG1 decoder implementation
 // Based on pl_mpeg library concepts but simplified for microcontrollers
 class SoftwareMpeg1Decoder : public IDecoder {
@@ -40,10 +75,21 @@ private:
 
     // Frame buffering for streaming mode
     fl::vector<fl::shared_ptr<Frame>> frameBuffer_;
-    fl::u8 currentFrameIndex_ = 0;
+    fl::u32 currentFrameIndex_ = 0;
     fl::u8 lastDecodedIndex_ = 0;
     bool endOfStream_ = false;
 
+    // Intra frames found by scanning the stream once in begin(), used by
+    // seek() to jump to the closest preceding I-frame and decode forward.
+    struct GopEntry {
+        double time;             // display time of the first picture decoded from here
+        fl::u32 displayIndex;    // position of the I-frame in display order
+        fl::u32 leadingBFrames;  // B-frames after it in the stream, shown before it
+        fl::size packetPos;      // demuxer position just before the packet
+        fl::u32 payloadOffset;   // picture start code offset in the packet
+    };
+    fl::vector<GopEntry> gopIndex_;
+
     // Internal methods
     bool initializeDecoder();
     bool decodeNextFrame();
@@ -53,6 +99,8 @@ private:
     bool decodePictureHeader();
     bool decodeFrame();
     void allocateFrameBuffers();
+    void configureScaler(fl::u16 width, fl::u16 height);
+    void buildGopIndex();
 
 public:
     explicit SoftwareMpeg1Decoder(const Mpeg1Config& config);
@@ -66,11 +114,15 @@ public:
 
     DecodeResult decode() override;
     Frame getCurrentFrame() override;
+    FramePtr getCurrentFramePtr() override;
     bool hasMoreFrames() const override;
 
     // MPEG1-specific methods
     fl::u32 getFrameCount() const override;
     fl::u32 getCurrentFrameIndex() const override { return currentFrameIndex_; }
+    // Decodes frame `frameIndex`, counted in display order, by decoding
+    // forward from the closest I-frame shown at or before it.
+    // getCurrentFrameIndex() is then frameIndex + 1, as after decode().
     bool seek(fl::u32 frameIndex) override;
 
     // Get video properties
@@ -78,6 +130,14 @@ public:
     fl::u16 getHeight() const;
     fl::u16 getFrameRate() const;
 
+    // Size of the frames returned by getCurrentFrame(); differs from
+    // getWidth()/getHeight() when a target size is configured.
+    fl::u16 getOutputWidth() const;
+    fl::u16 getOutputHeight() const;
+
+    // Number of I-frames found in the stream
+    fl::u32 getKeyFrameCount() const { return static_cast<fl::u32>(gopIndex_.size()); }
+
     // Static callback for pl_mpeg video decoding
     static void videoDecodeCallback(fl::third_party::plm_t* plm, fl::third_party::plm_frame_t* frame, void* user);
 
@@ -34,6 +34,8 @@ def discover_test_files(tests_dir: Path, excluded: Set[str]) -> List[str]:
         subdir_path = tests_dir / subdir
         if subdir_path.exists():
             for f in sorted(subdir_path.glob("*.cpp")):
+                if f.name in excluded:
+                    continue
                 rel_path = f.resolve().relative_to(tests_dir)
                 test_files.append(rel_path.as_posix())
 
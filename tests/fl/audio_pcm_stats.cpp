@@ -0,0 +1,172 @@
+#include "test.h"
+
+#include "fl/audio.h"
+#include "fl/audio/pcm_stats.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+#include "platforms/stub/time_stub.h"
+
+#include <math.h>
+
+using namespace fl;
+
+namespace {
+
+// The per-sample loops AudioSampleImpl and SoundLevelMeter used before the
+// fused kernels
+struct Reference {
+    u64 sumSquares = 0;
+    i64 sum = 0;
+    i32 peak = 0;
+    u32 zeroCrossings = 0;
+    float rms = 0.0f;
+    double power = 0.0;
+};
+
+Reference reference(const fl::vector<i16>& pcm) {
+    Reference r;
+    for (fl::size i = 1; i < pcm.size(); ++i) {
+        const bool crossed = (pcm[i - 1] < 0 && pcm[i] >= 0) ||
+                             (pcm[i - 1] >= 0 && pcm[i] < 0);
+        if (crossed) {
+            ++r.zeroCrossings;
+        }
+    }
+    double sumSq = 0.0;
+    for (fl::size i = 0; i < pcm.size(); ++i) {
+        const i32 x = pcm[i];
+        r.sumSquares += x * x;
+        r.sum += x;
+        r.peak = FL_MAX(r.peak, x < 0 ? -x : x);
+        const double s = pcm[i] / 32768.0;
+        sumSq += s * s;
+    }
+    if (!pcm.empty()) {
+        r.rms = ::sqrtf(float(r.sumSquares) / int(pcm.size()));
+        r.power = sumSq / pcm.size();
+    }
+    return r;
+}
+
+u32 gSeed = 12345;
+i16 nextSample(int kind) {
+    gSeed = gSeed * 1664525u + 1013904223u;
+    switch (kind) {
+    case 0:  // full range noise
+        return i16(gSeed >> 16);
+    case 1:  // rails, including -32768
+        return (gSeed >> 31) ? i16(-32768) : i16(32767);
+    default:  // small values hovering around zero
+        return i16(i32((gSeed >> 16) & 7) - 4);
+    }
+}
+
+fl::vector<i16> makeBlock(fl::size n, int kind) {
+    fl::vector<i16> pcm(n);
+    for (fl::size i = 0; i < n; ++i) {
+        pcm[i] = nextSample(kind);
+    }
+    return pcm;
+}
+
+void checkExact(const fl::vector<i16>& pcm, const PcmStats& stats) {
+    const Reference r = reference(pcm);
+    CHECK_EQ(stats.count, pcm.size());
+    CHECK_EQ(stats.sumSquares, r.sumSquares);
+    CHECK_EQ(stats.sum, r.sum);
+    CHECK_EQ(stats.peak, r.peak);
+    CHECK_EQ(stats.zeroCrossings, r.zeroCrossings);
+    CHECK_EQ(stats.rms(), r.rms);
+    if (!pcm.empty()) {
+        CHECK_EQ(stats.meanPowerFS(), r.power);
+    }
+}
+
+} // namespace
+
+TEST_CASE("PcmStats - kernels match the per-sample loops exactly") {
+    const fl::size sizes[] = {0, 1, 2, 7, 8, 9, 15, 16, 17, 255, 512, 1023, 70001};
+    for (int kind = 0; kind < 3; ++kind) {
+        for (fl::size n : sizes) {
+            const fl::vector<i16> pcm = makeBlock(n, kind);
+            PcmStats fast;
+            PcmStats portable;
+            computePcmStats(pcm.data(), pcm.size(), &fast);
+            computePcmStatsPortable(pcm.data(), pcm.size(), &portable);
+            checkExact(pcm, fast);
+            checkExact(pcm, portable);
+        }
+    }
+
+    // More crossings than an i16 counter holds
+    fl::vector<i16> alternating(100000);
+    for (fl::size i = 0; i < alternating.size(); ++i) {
+        alternating[i] = (i & 1) ? -1 : 1;
+    }
+    PcmStats stats;
+    computePcmStats(alternating.data(), alternating.size(), &stats);
+    CHECK_EQ(stats.zeroCrossings, 99999u);
+    CHECK_EQ(stats.dcOffset(), 0.0f);
+}
+
+TEST_CASE("AudioSample and SoundLevelMeter - statistics from one pass") {
+    fl::vector<i16> pcm = makeBlock(512, 0);
+    for (fl::size i = 0; i < pcm.size(); ++i) {
+        pcm[i] = i16(pcm[i] / 4 + 1000);
+    }
+    pcm[100] = -32768;
+    const Reference r = reference(pcm);
+    AudioSample sample(span<const i16>(pcm.data(), pcm.size()));
+    CHECK_EQ(sample.rms(), r.rms);
+    CHECK_EQ(sample.zcf(), float(r.zeroCrossings) / 511.0f);
+    CHECK_EQ(sample.peak(), 32768);
+    CHECK(sample.dcOffset() == doctest::Approx(double(r.sum) / 512.0));
+
+    SoundLevelMeter meter;
+    meter.processBlock(pcm.data(), pcm.size());
+    CHECK_EQ(meter.getDBFS(), 10.0 * ::log10(r.power + 1e-12));
+}
+
+TEST_CASE("PcmStats - fused kernel benchmark") {
+    const int kBlock = 1024;
+    const int kRounds = 2000;
+    const fl::vector<i16> pcm = makeBlock(kBlock, 0);
+    u64 sink = 0;
+
+    // Previous per-sample loops: zero crossings, integer RMS, double power
+    u32 start = micros();
+    for (int round = 0; round < kRounds; ++round) {
+        const Reference r = reference(pcm);
+        sink += r.zeroCrossings + r.sumSquares + u64(r.power);
+    }
+    const u32 referenceUs = micros() - start;
+
+    PcmStats portable;
+    start = micros();
+    for (int round = 0; round < kRounds; ++round) {
+        portable = PcmStats();
+        computePcmStatsPortable(pcm.data(), pcm.size(), &portable);
+        sink += portable.zeroCrossings + portable.sumSquares +
+                u64(portable.meanPowerFS());
+    }
+    const u32 portableUs = micros() - start;
+
+    PcmStats fast;
+    start = micros();
+    for (int round = 0; round < kRounds; ++round) {
+        fast = PcmStats();
+        computePcmStats(pcm.data(), pcm.size(), &fast);
+        sink += fast.zeroCrossings + fast.sumSquares + u64(fast.meanPowerFS());
+    }
+    const u32 fastUs = micros() - start;
+
+    const double perBlock = 1.0 / kRounds;
+    MESSAGE("PCM block statistics, " << kBlock << " samples: per-sample loops "
+            << referenceUs * perBlock << " us, portable kernel "
+            << portableUs * perBlock << " us, vector kernel "
+            << fastUs * perBlock << " us (sink " << unsigned(sink & 1) << ")");
+
+    // The timed kernels computed the reference statistics
+    checkExact(pcm, portable);
+    checkExact(pcm, fast);
+}
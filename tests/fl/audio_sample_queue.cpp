@@ -0,0 +1,195 @@
+#include "test.h"
+
+#include "fl/allocator.h"
+#include "fl/atomic.h"
+#include "fl/audio.h"
+#include "fl/vector.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+using namespace fl;
+
+namespace {
+
+// Deterministic block contents derived from the block's sequence number,
+// standing in for a WAV file replayed by a host driver thread.
+i16 patternSample(u32 seq, fl::size i) {
+    return static_cast<i16>((seq * 131u + i * 7u) & 0x7fff) - 0x4000;
+}
+
+void fillPattern(u32 seq, fl::size n, i16 *dst) {
+    for (fl::size i = 0; i < n; ++i) {
+        dst[i] = patternSample(seq, i);
+    }
+}
+
+bool matchesPattern(const AudioSample &sample, u32 seq) {
+    const AudioSample::VectorPCM &pcm = sample.pcm();
+    for (fl::size i = 0; i < pcm.size(); ++i) {
+        if (pcm[i] != patternSample(seq, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class CountingHook : public MallocFreeHook {
+  public:
+    void onMalloc(void *, fl::size) override { mallocs.fetch_add(1); }
+    void onFree(void *) override {}
+    atomic_u32 mallocs;
+};
+
+struct ReplayThread {
+    AudioSampleQueue *queue;
+    fl::size blockSize;
+    u32 blocks;
+    atomic_u32 pushed;
+    atomic_bool done;
+};
+
+void *replayMain(void *arg) {
+    ReplayThread *replay = static_cast<ReplayThread *>(arg);
+    for (u32 seq = 1; seq <= replay->blocks; ++seq) {
+        // The timestamp carries the sequence number for the consumer to check
+        replay->queue->push(replay->blockSize, seq, [seq, replay](i16 *dst) {
+            fillPattern(seq, replay->blockSize, dst);
+        });
+        replay->pushed.fetch_add(1);
+        if (seq % 16 == 0) {
+            sched_yield();
+        }
+    }
+    replay->done.store(true);
+    return nullptr;
+}
+
+} // namespace
+
+TEST_CASE("AudioSampleQueue - FIFO order, overruns and underruns") {
+    AudioSampleQueue queue(3, 64);
+    CHECK_EQ(queue.capacity(), 3u);
+    CHECK(queue.empty());
+
+    CHECK_FALSE(queue.pop().isValid());
+    CHECK_EQ(queue.underruns(), 1u);
+
+    for (u32 seq = 1; seq <= 4; ++seq) {
+        const bool accepted = queue.push(
+            64, seq * 10, [seq](i16 *dst) { fillPattern(seq, 64, dst); });
+        CHECK_EQ(accepted, seq <= 3);
+    }
+    CHECK_EQ(queue.size(), 3u);
+    CHECK_EQ(queue.overruns(), 1u);
+
+    // Blocks larger than the preallocated size are refused
+    fl::vector<i16> big(65, 1);
+    CHECK_FALSE(queue.push(fl::span<const i16>(big.data(), big.size()), 0));
+
+    for (u32 seq = 1; seq <= 3; ++seq) {
+        AudioSample sample = queue.pop();
+        REQUIRE(sample.isValid());
+        CHECK_EQ(sample.timestamp(), seq * 10);
+        CHECK_EQ(sample.size(), 64u);
+        CHECK(matchesPattern(sample, seq));
+    }
+    CHECK(queue.empty());
+
+    // Positions wrap around the ring
+    for (u32 seq = 5; seq <= 12; ++seq) {
+        CHECK(queue.push(16, seq, [seq](i16 *dst) { fillPattern(seq, 16, dst); }));
+        AudioSample sample = queue.pop();
+        CHECK_EQ(sample.timestamp(), seq);
+        CHECK(matchesPattern(sample, seq));
+    }
+    CHECK_EQ(queue.underruns(), 1u);
+}
+
+TEST_CASE("AudioSampleQueue - a block held by the consumer is not overwritten") {
+    AudioSampleQueue queue(2, 32);
+    queue.push(32, 1, [](i16 *dst) { fillPattern(1, 32, dst); });
+    AudioSample held = queue.pop();
+
+    CHECK(queue.push(32, 2, [](i16 *dst) { fillPattern(2, 32, dst); }));
+    // The next free slot is the one `held` still points at
+    CHECK_FALSE(queue.push(32, 3, [](i16 *dst) { fillPattern(3, 32, dst); }));
+    CHECK_EQ(queue.overruns(), 1u);
+    CHECK(matchesPattern(held, 1));
+    CHECK_EQ(held.timestamp(), 1u);
+
+    held = AudioSample();
+    CHECK_EQ(queue.pop().timestamp(), 2u);
+    CHECK(queue.push(32, 4, [](i16 *dst) { fillPattern(4, 32, dst); }));
+    CHECK_EQ(queue.pop().timestamp(), 4u);
+}
+
+TEST_CASE("AudioSampleQueue - threaded replay without heap activity") {
+    const fl::size blockSize = 256;
+    AudioSampleQueue queue(8, blockSize);
+
+    // Every popped block must live in one of the preallocated buffers
+    fl::vector<const i16 *> buffers;
+    for (u32 seq = 0; seq < queue.capacity(); ++seq) {
+        queue.push(blockSize, 0, [](i16 *dst) { fillPattern(0, blockSize, dst); });
+        buffers.push_back(queue.pop().pcm().data());
+    }
+
+    CountingHook hook;
+    SetMallocFreeHook(&hook);
+    // Sanity check that the hook sees fl allocations
+    {
+        fl::vector<int> probe;
+        probe.push_back(1);
+    }
+    const u32 probeMallocs = hook.mallocs.load();
+    CHECK_GT(probeMallocs, 0u);
+
+    ReplayThread replay;
+    replay.queue = &queue;
+    replay.blockSize = blockSize;
+    replay.blocks = 20000;
+    pthread_t thread;
+    REQUIRE_EQ(pthread_create(&thread, nullptr, replayMain, &replay), 0);
+
+    u32 received = 0;
+    u32 lastSeq = 0;
+    bool ordered = true;
+    bool intact = true;
+    bool preallocated = true;
+    while (true) {
+        const bool finished = replay.done.load();
+        AudioSample sample = queue.pop();
+        if (!sample.isValid()) {
+            // Everything was pushed before `done`, so the queue is drained
+            if (finished) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        const u32 seq = sample.timestamp();
+        ordered = ordered && seq > lastSeq;
+        intact = intact && sample.size() == blockSize && matchesPattern(sample, seq);
+        bool known = false;
+        for (fl::size i = 0; i < buffers.size(); ++i) {
+            known = known || buffers[i] == sample.pcm().data();
+        }
+        preallocated = preallocated && known;
+        lastSeq = seq;
+        ++received;
+    }
+    pthread_join(thread, nullptr);
+    const u32 steadyMallocs = hook.mallocs.load() - probeMallocs;
+    ClearMallocFreeHook();
+
+    MESSAGE("received " << received << " of " << replay.pushed.load()
+                        << " blocks, overruns " << queue.overruns()
+                        << ", underruns " << queue.underruns());
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK(preallocated);
+    CHECK_EQ(steadyMallocs, 0u);
+    CHECK_EQ(received + queue.overruns(), replay.pushed.load());
+    CHECK_GT(received, 0u);
+}
@@ -0,0 +1,217 @@
+#include "test.h"
+
+#include "fl/audio.h"
+#include "fl/audio/audio_context.h"
+#include "fl/audio/stft.h"
+#include "fl/fft.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+#include "fx/audio/audio_processor.h"
+
+#include <math.h>
+#include <stdio.h>
+
+using namespace fl;
+
+namespace {
+
+const int kSampleRate = 44100;
+
+fl::vector<i16> makeNoise(int n, u32 seed) {
+    fl::vector<i16> pcm(n);
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        pcm[i] = static_cast<i16>(static_cast<i32>(seed >> 16) - 32768);
+    }
+    return pcm;
+}
+
+// Short broadband clicks at every sample in `clicks` over a quiet tone. The
+// tone repeats every 128 samples, so it adds no spectral flux at either hop
+// size used below and only the clicks can trigger the beat detector.
+fl::vector<i16> makeClickTrack(int n, const fl::vector<int>& clicks) {
+    fl::vector<i16> pcm(n);
+    for (int i = 0; i < n; ++i) {
+        pcm[i] = static_cast<i16>(800.0 * ::sin(2.0 * FL_PI * (i % 128) / 128.0));
+    }
+    for (int start : clicks) {
+        for (int i = 0; i < 64 && start + i < n; ++i) {
+            const int decay = 20000 * (64 - i) / 64;
+            pcm[start + i] = static_cast<i16>(i % 2 ? -decay : decay);
+        }
+    }
+    return pcm;
+}
+
+struct LatencyStats {
+    int detected = 0;
+    double mean = 0.0;
+    double max = 0.0;
+    double stddev = 0.0;
+};
+
+// Matches each click to the first detection at or after it (within 100 ms)
+LatencyStats latencyStats(const fl::vector<int>& clicks,
+                          const fl::vector<double>& detections) {
+    LatencyStats stats;
+    fl::vector<double> latencies;
+    for (int click : clicks) {
+        const double clickMs = click * 1000.0 / kSampleRate;
+        for (double d : detections) {
+            // Frame timestamps are whole milliseconds
+            if (d >= clickMs - 1.0 && d < clickMs + 100.0) {
+                latencies.push_back(FL_MAX(0.0, d - clickMs));
+                break;
+            }
+        }
+    }
+    stats.detected = static_cast<int>(latencies.size());
+    if (latencies.empty()) {
+        return stats;
+    }
+    for (double l : latencies) {
+        stats.mean += l;
+        stats.max = FL_MAX(stats.max, l);
+    }
+    stats.mean /= latencies.size();
+    for (double l : latencies) {
+        stats.stddev += (l - stats.mean) * (l - stats.mean);
+    }
+    stats.stddev = ::sqrt(stats.stddev / latencies.size());
+    return stats;
+}
+
+} // namespace
+
+TEST_CASE("StftBuffer - frames are the newest window every hop") {
+    const int window = 64;
+    const int hop = 16;
+    const fl::vector<i16> pcm = makeNoise(1000, 7);
+    StftBuffer stft(window, hop, 1000);
+
+    int frames = 0;
+    fl::size consumed = 0;
+    // Uneven block sizes so frames straddle block boundaries
+    const int blocks[] = {10, 100, 37, 333, 520};
+    for (int size : blocks) {
+        const fl::size base = consumed;
+        stft.push(span<const i16>(pcm.data() + base, size), u32(base),
+                  [&](span<const i16> frame, u32 timestamp) {
+                      frames++;
+                      const int end = frames * hop;  // samples seen so far
+                      CHECK_EQ(timestamp, u32(end));
+                      REQUIRE_EQ(frame.size(), fl::size(window));
+                      for (int i = 0; i < window; ++i) {
+                          const int src = end - window + i;
+                          CHECK_EQ(frame[i], src < 0 ? 0 : pcm[src]);
+                      }
+                      if (end >= window) {
+                          // Running stats match a fresh pass over the frame
+                          AudioSample sample(frame);
+                          CHECK(stft.rms() == doctest::Approx(sample.rms()).epsilon(1e-4));
+                          CHECK(stft.zcf() == doctest::Approx(sample.zcf()));
+                      }
+                  });
+        consumed += size;
+    }
+    CHECK_EQ(frames, 1000 / hop);
+}
+
+TEST_CASE("StftBuffer - unconfigured buffer produces nothing") {
+    StftBuffer stft;
+    CHECK_FALSE(stft.isConfigured());
+    const fl::vector<i16> pcm = makeNoise(256, 1);
+    int frames = 0;
+    stft.push(span<const i16>(pcm.data(), pcm.size()), 0,
+              [&](span<const i16>, u32) { frames++; });
+    CHECK_EQ(frames, 0);
+    stft.configure(0, 128);
+    CHECK_FALSE(stft.isConfigured());
+}
+
+TEST_CASE("AudioContext - STFT history holds the overlapped frames") {
+    const int window = 512;
+    const int hop = 128;
+    const fl::vector<i16> pcm = makeNoise(2048, 3);
+
+    AudioContext ctx{AudioSample()};
+    ctx.setSTFT(window, hop);
+    ctx.getFFTHistory(8);
+    int frames = 0;
+    for (int block = 0; block < 2; ++block) {
+        AudioSample sample(span<const i16>(pcm.data() + block * 1024, 1024),
+                           static_cast<u32>(block * 1024 * 1000 / kSampleRate));
+        ctx.pushSample(sample, [&]() {
+            frames++;
+            CHECK_EQ(ctx.getPCM().size(), fl::size(window));
+            ctx.getFFT(16);
+        });
+    }
+    CHECK_EQ(frames, 2048 / hop);
+
+    // getHistoricalFFT(k) is the frame k hops before the current one
+    FFT reference;
+    FFTBins expected(16);
+    for (int back = 0; back < 8; ++back) {
+        const int end = 2048 - hop * (back + 1);
+        reference.run(span<const i16>(pcm.data() + end - window, window),
+                      &expected, FFT_Args(window, 16));
+        const FFTBins* historical = ctx.getHistoricalFFT(back);
+        REQUIRE(historical != nullptr);
+        REQUIRE_EQ(historical->bins_raw.size(), expected.bins_raw.size());
+        for (fl::size i = 0; i < expected.bins_raw.size(); ++i) {
+            CHECK_EQ(historical->bins_raw[i], expected.bins_raw[i]);
+        }
+    }
+}
+
+TEST_CASE("AudioProcessor - STFT mode cuts click-track onset latency") {
+    const int blockSize = 1024;
+    const int seconds = 12;
+    const int total = kSampleRate * seconds / blockSize * blockSize;
+
+    // 120 BPM with a drifting offset so clicks land all over the blocks
+    fl::vector<int> clicks;
+    for (int k = 0; k < seconds * 2 - 1; ++k) {
+        clicks.push_back(kSampleRate / 4 + k * (kSampleRate / 2) + k * 311);
+    }
+    const fl::vector<i16> pcm = makeClickTrack(total, clicks);
+
+    auto run = [&](bool stft) {
+        AudioProcessor processor;
+        if (stft) {
+            processor.setSTFT(512, 128, kSampleRate);
+        }
+        fl::vector<double> detections;
+        double blockEndMs = 0.0;
+        auto context = processor.getContext();
+        processor.onBeat([&]() {
+            // When the analysed audio became available
+            detections.push_back(stft ? double(context->getTimestamp())
+                                      : blockEndMs);
+        });
+        for (int start = 0; start < total; start += blockSize) {
+            blockEndMs = (start + blockSize) * 1000.0 / kSampleRate;
+            const u32 timestamp =
+                static_cast<u32>(u64(start) * 1000 / kSampleRate);
+            processor.update(AudioSample(
+                span<const i16>(pcm.data() + start, blockSize), timestamp));
+        }
+        return latencyStats(clicks, detections);
+    };
+
+    const LatencyStats block = run(false);
+    const LatencyStats stft = run(true);
+    printf("Click-track onset latency over %d clicks:\n", int(clicks.size()));
+    printf("  blocks of %d: detected %d, mean %.2f ms, max %.2f ms, stddev %.2f ms\n",
+           blockSize, block.detected, block.mean, block.max, block.stddev);
+    printf("  STFT 512/128: detected %d, mean %.2f ms, max %.2f ms, stddev %.2f ms\n",
+           stft.detected, stft.mean, stft.max, stft.stddev);
+
+    const int required = int(clicks.size()) * 9 / 10;
+    CHECK_GE(block.detected, required);
+    CHECK_GE(stft.detected, required);
+    // A hop is 2.9 ms; whole-millisecond frame timestamps add up to 1 ms
+    CHECK_LT(stft.max, 128 * 1000.0 / kSampleRate + 1.5);
+    CHECK_LT(stft.mean * 2.0, block.mean);
+}
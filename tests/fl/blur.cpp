@@ -0,0 +1,186 @@
+#include "test.h"
+
+#include "FastLED.h"
+#include "fl/blur.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
+
+using namespace fl;
+
+namespace {
+
+fl::vector<CRGB> makeImage(u16 width, u16 height, u32 seed = 1) {
+    fl::vector<CRGB> image(fl::size(width) * height);
+    for (fl::size i = 0; i < image.size(); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        image[i] = CRGB(u8(seed >> 24), u8(seed >> 16), u8(seed >> 8));
+    }
+    return image;
+}
+
+// Window average over one axis with the edge pixel repeated, rounded to
+// nearest, computed window by window
+u8 lineAverage(const fl::vector<CRGB>& image, u16 width, u16 height, int x,
+               int y, int dx, int dy, int r, int c) {
+    u32 sum = 0;
+    for (int k = -r; k <= r; ++k) {
+        const int xx = fl::clamp(x + k * dx, 0, width - 1);
+        const int yy = fl::clamp(y + k * dy, 0, height - 1);
+        sum += image[fl::size(yy) * width + xx].raw[c];
+    }
+    const u32 window = 2 * r + 1;
+    return u8((sum + window / 2) / window);
+}
+
+fl::vector<CRGB> referenceBox(const fl::vector<CRGB>& image, u16 width,
+                              u16 height, int r) {
+    fl::vector<CRGB> rows(image.size());
+    fl::vector<CRGB> out(image.size());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                rows[fl::size(y) * width + x].raw[c] =
+                    lineAverage(image, width, height, x, y, 1, 0, r, c);
+            }
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                out[fl::size(y) * width + x].raw[c] =
+                    lineAverage(rows, width, height, x, y, 0, 1, r, c);
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("boxBlur2d - matches a window-by-window average") {
+    const u16 sizes[][2] = {{1, 1}, {7, 3}, {70, 9}, {300, 5}};
+    for (const auto& size : sizes) {
+        const u16 width = size[0];
+        const u16 height = size[1];
+        for (u16 radius : {1, 2, 5, 40}) {
+            fl::vector<CRGB> image = makeImage(width, height, radius);
+            const fl::vector<CRGB> expected = referenceBox(image, width, height, radius);
+            boxBlur2d(image.data(), width, height, radius);
+            bool same = true;
+            for (fl::size i = 0; i < image.size(); ++i) {
+                same = same && image[i] == expected[i];
+            }
+            CHECK_MESSAGE(same, width << "x" << height << " radius " << radius);
+        }
+    }
+
+    // A flat image stays flat
+    fl::vector<CRGB> flat(64 * 64, CRGB(255, 128, 1));
+    gaussianBlur2d(flat.data(), 64, 64, 6.0f);
+    bool unchanged = true;
+    for (const CRGB& c : flat) {
+        unchanged = unchanged && c == CRGB(255, 128, 1);
+    }
+    CHECK(unchanged);
+}
+
+TEST_CASE("boxBlur2d - mapped layouts are gathered and scattered once") {
+    const u16 width = 40;
+    const u16 height = 30;
+    const fl::vector<CRGB> grid = makeImage(width, height);
+    const XYMap serpentine = XYMap::constructSerpentine(width, height);
+    fl::vector<CRGB> leds(grid.size());
+    for (u16 y = 0; y < height; ++y) {
+        for (u16 x = 0; x < width; ++x) {
+            leds[serpentine.mapToIndex(x, y)] = grid[fl::size(y) * width + x];
+        }
+    }
+    fl::vector<CRGB> expected = grid;
+    gaussianBlur2d(expected.data(), width, height, 3.0f);
+    gaussianBlur2d(leds.data(), serpentine, 3.0f);
+    bool same = true;
+    for (u16 y = 0; y < height; ++y) {
+        for (u16 x = 0; x < width; ++x) {
+            same = same && leds[serpentine.mapToIndex(x, y)] ==
+                               expected[fl::size(y) * width + x];
+        }
+    }
+    CHECK(same);
+
+    // Line-by-line maps blur in place, offset included
+    fl::vector<CRGB> strip(5 + grid.size());
+    for (fl::size i = 0; i < grid.size(); ++i) {
+        strip[5 + i] = grid[i];
+    }
+    boxBlur2d(strip.data(), XYMap::constructRectangularGrid(width, height, 5), 2);
+    fl::vector<CRGB> direct = grid;
+    boxBlur2d(direct.data(), width, height, 2);
+    for (fl::size i = 0; i < grid.size(); ++i) {
+        same = same && strip[5 + i] == direct[i];
+    }
+    CHECK(same);
+}
+
+TEST_CASE("gaussianBlur2d - three boxes carry the Gaussian's variance") {
+    for (float sigma : {0.8f, 1.0f, 2.5f, 4.0f, 9.0f}) {
+        u16 radii[3];
+        BlurEngine::gaussianRadii(sigma, radii);
+        float variance = 0.0f;
+        for (u16 r : radii) {
+            const float w = 2.0f * r + 1.0f;
+            variance += (w * w - 1.0f) / 12.0f;
+        }
+        CHECK(variance == doctest::Approx(sigma * sigma).epsilon(0.2));
+    }
+}
+
+TEST_CASE("blur2d - grids wider than 255") {
+    const u16 width = 300;
+    const u16 height = 2;
+    fl::vector<CRGB> leds(width * height);
+    leds[299] = CRGB(200, 200, 200);
+    blur2d(leds.data(), width, height, 172,
+           XYMap::constructRectangularGrid(width, height));
+    CHECK(leds[298].r > 0);
+    CHECK(leds[width + 299].r > 0);
+}
+
+TEST_CASE("boxBlur2d / gaussianBlur2d - benchmark") {
+    BlurEngine engine;
+    printf("Blur ms/frame  radius or sigma: 1       2       4       8      16\n");
+    for (u16 size : {64, 256, 512}) {
+        fl::vector<CRGB> image = makeImage(size, size);
+        const int frames = size == 512 ? 4 : (size == 256 ? 16 : 200);
+        for (int gaussian = 0; gaussian < 2; ++gaussian) {
+            printf("%3ux%-3u %-22s", size, size, gaussian ? "gaussian" : "box");
+            for (u16 radius : {1, 2, 4, 8, 16}) {
+                const u32 start = micros();
+                for (int f = 0; f < frames; ++f) {
+                    if (gaussian) {
+                        engine.gaussian(image.data(), size, size, float(radius));
+                    } else {
+                        engine.box(image.data(), size, size, radius);
+                    }
+                }
+                const double ms = double(micros() - start) / frames / 1000.0;
+                printf(" %7.3f", ms);
+            }
+            printf("\n");
+        }
+    }
+
+    // The engine, its buffers grown by the 512x512 runs, still blurs exactly
+    for (u16 radius : {1, 16}) {
+        fl::vector<CRGB> image = makeImage(64, 48, radius);
+        const fl::vector<CRGB> expected = referenceBox(image, 64, 48, radius);
+        engine.box(image.data(), 64, 48, radius);
+        bool same = true;
+        for (fl::size i = 0; i < image.size(); ++i) {
+            same = same && image[i] == expected[i];
+        }
+        CHECK_MESSAGE(same, "radius " << radius);
+    }
+}
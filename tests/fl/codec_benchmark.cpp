@@ -0,0 +1,289 @@
+// Throughput, peak heap and allocation counts for every codec over the files
+// in tests/data/codec. Results are printed and, when FASTLED_CODEC_BENCH_JSON
+// names a file, written there as JSON for ci/perf/codec_perf.py to gate on.
+
+#include "test.h"
+#include "fl/allocator.h"
+#include "fl/bytestreammemory.h"
+#include "fl/codec/gif.h"
+#include "fl/codec/jpeg.h"
+#include "fl/codec/mp3.h"
+#include "fl/codec/mpeg1.h"
+#include "fl/codec/pixel.h"
+#include "fl/file_system.h"
+#include "fl/str.h"
+#include "fx/frame.h"
+#include "platforms/stub/fs_stub.hpp"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+// Tracks live heap bytes without allocating itself. Blocks allocated before
+// the hook was installed are unknown to it and ignored when freed.
+class HeapTracker : public fl::MallocFreeHook {
+public:
+    void onMalloc(void* ptr, fl::size size) override {
+        mallocs++;
+        live += size;
+        if (live > peak) {
+            peak = live;
+        }
+        if (count < kMaxBlocks) {
+            ptrs[count] = ptr;
+            sizes[count] = size;
+            count++;
+        }
+    }
+    void onFree(void* ptr) override {
+        for (int i = 0; i < count; ++i) {
+            if (ptrs[i] == ptr) {
+                live -= sizes[i];
+                count--;
+                ptrs[i] = ptrs[count];
+                sizes[i] = sizes[count];
+                return;
+            }
+        }
+    }
+    // Starts a new measurement window relative to the current live bytes
+    void mark() {
+        mallocs = 0;
+        peak = live;
+    }
+
+    static const int kMaxBlocks = 4096;
+    void* ptrs[kMaxBlocks];
+    fl::size sizes[kMaxBlocks];
+    int count = 0;
+    fl::size live = 0;
+    fl::size peak = 0;
+    fl::u32 mallocs = 0;
+};
+
+struct BenchResult {
+    const char* codec;
+    const char* input;
+    fl::u16 width;
+    fl::u16 height;
+    const char* unit;       // what throughput counts per second
+    fl::u32 frames;         // frames decoded over all iterations
+    double units;           // pixels or samples produced over all iterations
+    fl::u32 elapsedUs;
+    fl::size peakHeap;      // bytes above the starting live size
+    fl::u32 decodeMallocs;  // allocations while decoding, excluding setup
+};
+
+fl::vector<fl::u8> loadCodecFile(const char* path) {
+    fl::setTestFileSystemRoot("tests");
+    fl::FileSystem fs;
+    REQUIRE(fs.beginSd(5));
+    fl::FileHandlePtr handle = fs.openRead(path);
+    REQUIRE(handle != nullptr);
+    fl::vector<fl::u8> data(handle->size());
+    handle->read(data.data(), data.size());
+    handle->close();
+    fs.end();
+    return data;
+}
+
+fl::ByteStreamPtr memoryStream(const fl::vector<fl::u8>& data) {
+    auto stream = fl::make_shared<fl::ByteStreamMemory>(data.size());
+    stream->write(data.data(), data.size());
+    return stream;
+}
+
+// Runs a begin/decode-all/end cycle `iterations` times on a video decoder.
+// Setup allocations count toward the peak but not toward decodeMallocs.
+BenchResult benchDecoder(const char* codec, const char* input,
+                         const fl::vector<fl::u8>& data, int iterations,
+                         fl::IDecoderPtr (*make)(fl::u16, fl::u16),
+                         fl::u16 targetW, fl::u16 targetH) {
+    BenchResult r = {codec, input, 0, 0, "pixels/s", 0, 0, 0, 0, 0};
+    HeapTracker tracker;
+    fl::u32 elapsed = 0;
+    fl::SetMallocFreeHook(&tracker);
+    tracker.mark();
+    for (int i = 0; i < iterations; ++i) {
+        fl::IDecoderPtr decoder = make(targetW, targetH);
+        REQUIRE(decoder);
+        fl::ByteStreamPtr stream = memoryStream(data);
+        const fl::u32 start = micros();
+        REQUIRE(decoder->begin(stream));
+        const fl::u32 mallocsBefore = tracker.mallocs;
+        // Single image codecs report no further frames once decoded
+        do {
+            if (decoder->decode() != fl::DecodeResult::Success) {
+                break;
+            }
+            fl::Frame frame = decoder->getCurrentFrame();
+            r.width = frame.getWidth();
+            r.height = frame.getHeight();
+            r.units += double(frame.getWidth()) * frame.getHeight();
+            r.frames++;
+        } while (decoder->hasMoreFrames());
+        r.decodeMallocs += tracker.mallocs - mallocsBefore;
+        decoder->end();
+        elapsed += micros() - start;
+    }
+    fl::ClearMallocFreeHook();
+    r.elapsedUs = elapsed;
+    r.peakHeap = tracker.peak;
+    return r;
+}
+
+fl::IDecoderPtr makeGif(fl::u16, fl::u16) {
+    return fl::Gif::createDecoder(fl::GifConfig());
+}
+
+fl::IDecoderPtr makeMpeg1(fl::u16 w, fl::u16 h) {
+    fl::Mpeg1Config config;
+    config.skipAudio = true;
+    config.targetWidth = w;
+    config.targetHeight = h;
+    return fl::Mpeg1::createDecoder(config);
+}
+
+fl::IDecoderPtr makeJpeg(fl::u16 w, fl::u16 h) {
+    return fl::Jpeg::createDecoder(w ? fl::JpegConfig(w, h) : fl::JpegConfig());
+}
+
+BenchResult benchMp3(const char* input, const fl::vector<fl::u8>& data) {
+    BenchResult r = {"mp3", input, 0, 0, "samples/s", 0, 0, 0, 0, 0};
+    HeapTracker tracker;
+    fl::SetMallocFreeHook(&tracker);
+    tracker.mark();
+    fl::Mp3Decoder decoder;
+    const fl::u32 start = micros();
+    REQUIRE(decoder.begin(memoryStream(data)));
+    const fl::u32 mallocsBefore = tracker.mallocs;
+    fl::AudioSample sample;
+    while (decoder.decodeNextFrame(&sample)) {
+        r.units += sample.size();
+        r.frames++;
+    }
+    r.decodeMallocs = tracker.mallocs - mallocsBefore;
+    decoder.end();
+    r.elapsedUs = micros() - start;
+    fl::ClearMallocFreeHook();
+    r.peakHeap = tracker.peak;
+    return r;
+}
+
+BenchResult benchPixel(fl::u16 w, fl::u16 h, int iterations) {
+    BenchResult r = {"pixel", "rgb565", w, h, "pixels/s", 0, 0, 0, 0, 0};
+    const fl::size n = fl::size(w) * h;
+    fl::vector<fl::u16> src(n);
+    fl::vector<fl::u8> dst(n * 3);
+    for (fl::size i = 0; i < n; ++i) {
+        src[i] = static_cast<fl::u16>(i * 2654435761u >> 16);
+    }
+    HeapTracker tracker;
+    fl::SetMallocFreeHook(&tracker);
+    tracker.mark();
+    const fl::u32 start = micros();
+    for (int it = 0; it < iterations; ++it) {
+        for (fl::size i = 0; i < n; ++i) {
+            fl::rgb565ToRgb888(src[i], dst[i * 3], dst[i * 3 + 1], dst[i * 3 + 2]);
+        }
+        r.units += double(n);
+        r.frames++;
+    }
+    r.elapsedUs = micros() - start;
+    fl::ClearMallocFreeHook();
+    r.decodeMallocs = tracker.mallocs;
+    r.peakHeap = tracker.peak;
+    // The expansion keeps the top bits, so packing it again is lossless
+    for (fl::size i = 0; i < n; ++i) {
+        CHECK_EQ(fl::rgb888ToRgb565(dst[i * 3], dst[i * 3 + 1], dst[i * 3 + 2]),
+                 src[i]);
+    }
+    return r;
+}
+
+double throughput(const BenchResult& r) {
+    return r.elapsedUs ? r.units * 1e6 / r.elapsedUs : 0.0;
+}
+
+double allocsPerFrame(const BenchResult& r) {
+    return r.frames ? double(r.decodeMallocs) / r.frames : 0.0;
+}
+
+fl::string toJson(const fl::vector<BenchResult>& results) {
+    fl::string out = "{\"benchmarks\":[";
+    char name[128];
+    char line[512];
+    for (fl::size i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        if (r.width) {
+            snprintf(name, sizeof(name), "%s/%s/%ux%u", r.codec, r.input,
+                     unsigned(r.width), unsigned(r.height));
+        } else {
+            snprintf(name, sizeof(name), "%s/%s", r.codec, r.input);
+        }
+        snprintf(line, sizeof(line),
+                 "%s{\"name\":\"%s\",\"codec\":\"%s\",\"input\":\"%s\","
+                 "\"width\":%u,\"height\":%u,\"frames\":%u,\"unit\":\"%s\","
+                 "\"throughput\":%.1f,\"peak_heap_bytes\":%u,"
+                 "\"allocs_per_frame\":%.3f}",
+                 i ? "," : "", name, r.codec, r.input, unsigned(r.width),
+                 unsigned(r.height), unsigned(r.frames), r.unit, throughput(r),
+                 unsigned(r.peakHeap), allocsPerFrame(r));
+        out += line;
+    }
+    out += "]}";
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("Codec throughput benchmark") {
+    fl::vector<BenchResult> results;
+
+    const fl::vector<fl::u8> gif = loadCodecFile("data/codec/file.gif");
+    results.push_back(benchDecoder("gif", "file.gif", gif, 200, makeGif, 0, 0));
+
+    const fl::vector<fl::u8> jpeg = loadCodecFile("data/codec/progressive.jpg");
+    const fl::u16 jpegSizes[] = {0, 64, 32, 16};
+    for (fl::u16 size : jpegSizes) {
+        results.push_back(benchDecoder("jpeg", "progressive.jpg", jpeg, 20,
+                                       makeJpeg, size, size));
+    }
+
+    const fl::vector<fl::u8> mpeg = loadCodecFile("data/codec/test_audio_video.mpg");
+    const fl::u16 mpegSizes[] = {0, 1};
+    for (fl::u16 size : mpegSizes) {
+        results.push_back(benchDecoder("mpeg1", "test_audio_video.mpg", mpeg, 20,
+                                       makeMpeg1, size, size));
+    }
+
+    const char* mp3Files[] = {"jazzy_percussion.mp3", "edm_beat.mp3"};
+    for (const char* name : mp3Files) {
+        fl::string path = "data/codec/";
+        path += name;
+        const fl::vector<fl::u8> mp3 = loadCodecFile(path.c_str());
+        results.push_back(benchMp3(name, mp3));
+    }
+
+    results.push_back(benchPixel(64, 64, 100));
+    results.push_back(benchPixel(256, 256, 10));
+
+    for (const BenchResult& r : results) {
+        CHECK_GT(r.frames, 0u);
+        printf("%s %s %ux%u: %.0f %s, peak heap %u bytes, %.2f allocs/frame\n",
+               r.codec, r.input, unsigned(r.width), unsigned(r.height),
+               throughput(r), r.unit, unsigned(r.peakHeap), allocsPerFrame(r));
+    }
+
+    // Throughput floors depend on the build and the runner; they are checked
+    // by ci/perf/codec_perf.py, never here.
+    if (const char* path = getenv("FASTLED_CODEC_BENCH_JSON")) {
+        const fl::string json = toJson(results);
+        FILE* f = fopen(path, "w");
+        REQUIRE(f != nullptr);
+        fputs(json.c_str(), f);
+        fclose(f);
+    }
+}
@@ -4,6 +4,8 @@
 #include "fx/frame.h"
 #include "fl/bytestreammemory.h"
 #include "platforms/stub/fs_stub.hpp"
+#include "platforms/stub/time_stub.h"
+#include "third_party/libnsgif/software_decoder.h"
 
 
 // Helper function to set up filesystem for codec tests
@@ -228,4 +230,258 @@ TEST_CASE("GIF metadata parsing without decoding") {
 
     handle->close();
     fs.end();
-}
\ No newline at end of file
+}
+
+namespace {
+
+// Builds a minimal 4-colour animated GIF. Each frame is a solid rectangle of
+// one palette index. LZW data is emitted with a clear code every two pixels so
+// the code width stays at 3 bits, which keeps the encoder trivial.
+struct GifFrameSpec {
+    fl::u16 x, y, w, h;
+    fl::u8 colorIndex;
+    fl::u8 disposal;
+};
+
+void appendLzwSolid(fl::vector<fl::u8>& out, fl::u32 pixelCount, fl::u8 index) {
+    fl::vector<fl::u8> packed;
+    fl::u32 bitBuf = 0;
+    int bitCount = 0;
+    auto emit = [&](fl::u32 code) {
+        bitBuf |= code << bitCount;
+        bitCount += 3;
+        while (bitCount >= 8) {
+            packed.push_back(static_cast<fl::u8>(bitBuf & 0xFF));
+            bitBuf >>= 8;
+            bitCount -= 8;
+        }
+    };
+    for (fl::u32 i = 0; i < pixelCount; ++i) {
+        if (i % 2 == 0) {
+            emit(4); // clear
+        }
+        emit(index);
+    }
+    emit(5); // end of information
+    if (bitCount > 0) {
+        packed.push_back(static_cast<fl::u8>(bitBuf & 0xFF));
+    }
+    out.push_back(2); // LZW minimum code size
+    for (fl::size i = 0; i < packed.size(); i += 255) {
+        fl::size n = FL_MIN(static_cast<fl::size>(255), packed.size() - i);
+        out.push_back(static_cast<fl::u8>(n));
+        for (fl::size j = 0; j < n; ++j) {
+            out.push_back(packed[i + j]);
+        }
+    }
+    out.push_back(0);
+}
+
+fl::vector<fl::u8> buildAnimatedGif(fl::u16 width, fl::u16 height,
+                                    const fl::vector<GifFrameSpec>& frames) {
+    fl::vector<fl::u8> out;
+    const char* header = "GIF89a";
+    for (int i = 0; i < 6; ++i) {
+        out.push_back(static_cast<fl::u8>(header[i]));
+    }
+    out.push_back(width & 0xFF);
+    out.push_back(width >> 8);
+    out.push_back(height & 0xFF);
+    out.push_back(height >> 8);
+    out.push_back(0x81); // global colour table, 4 entries
+    out.push_back(0);    // background index (black)
+    out.push_back(0);
+    const fl::u8 palette[12] = {0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255};
+    for (fl::u8 c : palette) {
+        out.push_back(c);
+    }
+    for (const GifFrameSpec& f : frames) {
+        const fl::u8 gce[8] = {0x21, 0xF9, 0x04,
+                               static_cast<fl::u8>(f.disposal << 2), 1, 0, 0, 0};
+        for (fl::u8 b : gce) {
+            out.push_back(b);
+        }
+        const fl::u8 desc[10] = {0x2C,
+                                 static_cast<fl::u8>(f.x & 0xFF), static_cast<fl::u8>(f.x >> 8),
+                                 static_cast<fl::u8>(f.y & 0xFF), static_cast<fl::u8>(f.y >> 8),
+                                 static_cast<fl::u8>(f.w & 0xFF), static_cast<fl::u8>(f.w >> 8),
+                                 static_cast<fl::u8>(f.h & 0xFF), static_cast<fl::u8>(f.h >> 8),
+                                 0};
+        for (fl::u8 b : desc) {
+            out.push_back(b);
+        }
+        appendLzwSolid(out, static_cast<fl::u32>(f.w) * f.h, f.colorIndex);
+    }
+    out.push_back(0x3B);
+    return out;
+}
+
+fl::IDecoderPtr beginGif(const fl::vector<fl::u8>& data) {
+    fl::IDecoderPtr decoder = fl::Gif::createDecoder();
+    auto stream = fl::make_shared<fl::ByteStreamMemory>(data.size());
+    stream->write(data.data(), data.size());
+    if (!decoder || !decoder->begin(stream)) {
+        return nullptr;
+    }
+    return decoder;
+}
+
+} // namespace
+
+TEST_CASE("GIF partial updates report disposal-aware rects") {
+    fl::vector<GifFrameSpec> frames;
+    frames.push_back({0, 0, 8, 8, 1, 1}); // full red, keep
+    frames.push_back({3, 3, 2, 2, 3, 2}); // blue square, then restore to bg
+    frames.push_back({0, 0, 1, 1, 2, 1}); // green corner pixel
+    fl::vector<fl::u8> data = buildAnimatedGif(8, 8, frames);
+
+    fl::IDecoderPtr decoder = beginGif(data);
+    REQUIRE(decoder != nullptr);
+    REQUIRE_EQ(decoder->getFrameCount(), 3u);
+
+    fl::rect<fl::u16> rect;
+    CHECK_FALSE(decoder->getUpdatedRect(&rect));
+
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    REQUIRE(decoder->getUpdatedRect(&rect));
+    CHECK(rect == fl::rect<fl::u16>(0, 0, 8, 8));
+    fl::Frame f0 = decoder->getCurrentFrame();
+    CHECK(f0.rgb()[0] == CRGB(255, 0, 0));
+    CHECK(f0.rgb()[63] == CRGB(255, 0, 0));
+
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    REQUIRE(decoder->getUpdatedRect(&rect));
+    CHECK(rect == fl::rect<fl::u16>(3, 3, 5, 5));
+    fl::Frame f1 = decoder->getCurrentFrame();
+    CHECK(f1.rgb()[3 * 8 + 3] == CRGB(0, 0, 255));
+    CHECK(f1.rgb()[0] == CRGB(255, 0, 0));
+
+    // Frame 1 is disposed to background, so its area joins frame 2's rect.
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    REQUIRE(decoder->getUpdatedRect(&rect));
+    CHECK(rect == fl::rect<fl::u16>(0, 0, 5, 5));
+    fl::Frame f2 = decoder->getCurrentFrame();
+    CHECK(f2.rgb()[0] == CRGB(0, 255, 0));
+    CHECK(f2.rgb()[3 * 8 + 3] == CRGB(0, 0, 0));
+    CHECK(f2.rgb()[7 * 8 + 7] == CRGB(255, 0, 0));
+
+    // Drawing just the updated rect reproduces the full frame.
+    CRGB leds[64];
+    f1.draw(leds);
+    f2.drawRect(leds, rect);
+    for (int i = 0; i < 64; ++i) {
+        CHECK(leds[i] == f2.rgb()[i]);
+    }
+
+    // Seeking back invalidates the whole canvas.
+    REQUIRE(decoder->seek(0));
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    REQUIRE(decoder->getUpdatedRect(&rect));
+    CHECK(rect == fl::rect<fl::u16>(0, 0, 8, 8));
+    decoder->end();
+}
+
+TEST_CASE("GIF current frame is shared, not copied") {
+    fl::vector<GifFrameSpec> frames;
+    frames.push_back({0, 0, 8, 8, 1, 1});
+    frames.push_back({3, 3, 2, 2, 3, 1});
+    fl::vector<fl::u8> data = buildAnimatedGif(8, 8, frames);
+
+    fl::IDecoderPtr decoder = beginGif(data);
+    REQUIRE(decoder != nullptr);
+    CHECK_FALSE(decoder->getCurrentFramePtr());
+
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    fl::FramePtr view = decoder->getCurrentFramePtr();
+    REQUIRE(view);
+    CHECK(view->rgb()[3 * 8 + 3] == CRGB(255, 0, 0));
+
+    // The same frame is updated in place by the next decode
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    CHECK(decoder->getCurrentFramePtr().get() == view.get());
+    CHECK(view->rgb()[3 * 8 + 3] == CRGB(0, 0, 255));
+    fl::Frame copy = decoder->getCurrentFrame();
+    for (int i = 0; i < 64; ++i) {
+        CHECK(copy.rgb()[i] == view->rgb()[i]);
+    }
+    decoder->end();
+}
+
+TEST_CASE("GIF decode benchmark") {
+    // The tests/data fixture: two 2x2 frames, so this mostly times the
+    // per-decode overhead.
+    fl::FileSystem fs = setupCodecFilesystem();
+    fl::FileHandlePtr handle = fs.openRead("data/codec/file.gif");
+    REQUIRE(handle != nullptr);
+    fl::vector<fl::u8> fixture(handle->size());
+    handle->read(fixture.data(), fixture.size());
+    handle->close();
+    fs.end();
+
+    fl::IDecoderPtr decoder = beginGif(fixture);
+    REQUIRE(decoder != nullptr);
+    const int kFixtureLoops = 2000;
+    fl::u32 decoded = 0;
+    fl::u32 start = micros();
+    for (int loop = 0; loop < kFixtureLoops; ++loop) {
+        REQUIRE(decoder->seek(0));
+        while (decoder->hasMoreFrames() &&
+               decoder->decode() == fl::DecodeResult::Success) {
+            ++decoded;
+        }
+    }
+    fl::u32 elapsed = micros() - start;
+    MESSAGE("GIF file.gif: " << decoded << " frames in " << elapsed << "us ("
+            << (elapsed ? decoded * 1e6 / elapsed : 0.0) << " frames/s)");
+    CHECK_EQ(decoded, static_cast<fl::u32>(kFixtureLoops) * decoder->getFrameCount());
+    fl::FramePtr fixtureFrame = decoder->getCurrentFramePtr();
+    REQUIRE(fixtureFrame);
+    REQUIRE_EQ(fixtureFrame->getWidth(), 2);
+    REQUIRE_EQ(fixtureFrame->getHeight(), 2);
+    // The second frame rotates the first one's red-white-blue-black
+    CHECK(fixtureFrame->rgb()[0] == CRGB(255, 255, 255));
+    CHECK(fixtureFrame->rgb()[1] == CRGB(0, 0, 255));
+    CHECK(fixtureFrame->rgb()[2] == CRGB(0, 0, 0));
+    CHECK(fixtureFrame->rgb()[3] == CRGB(255, 0, 0));
+    decoder->end();
+
+    // The fixture is too small to show partial updates, so those are measured
+    // on a synthetic animation: one full frame, then small moving squares.
+    const fl::u16 kSize = 64;
+    fl::vector<GifFrameSpec> frames;
+    frames.push_back({0, 0, kSize, kSize, 1, 1});
+    for (fl::u16 i = 0; i < 30; ++i) {
+        frames.push_back({static_cast<fl::u16>(i * 2), static_cast<fl::u16>(i), 4, 4,
+                          static_cast<fl::u8>(2 + (i & 1)), 2});
+    }
+    fl::vector<fl::u8> data = buildAnimatedGif(kSize, kSize, frames);
+
+    decoder = beginGif(data);
+    REQUIRE(decoder != nullptr);
+    auto* gif = static_cast<fl::third_party::SoftwareGifDecoder*>(decoder.get());
+
+    const int kLoops = 20;
+    decoded = 0;
+    start = micros();
+    for (int loop = 0; loop < kLoops; ++loop) {
+        REQUIRE(decoder->seek(0));
+        while (decoder->hasMoreFrames() &&
+               decoder->decode() == fl::DecodeResult::Success) {
+            ++decoded;
+        }
+    }
+    elapsed = micros() - start;
+    const fl::u64 fullBytes = static_cast<fl::u64>(decoded) * kSize * kSize * sizeof(CRGB);
+    const double fps = elapsed ? decoded * 1e6 / elapsed : 0.0;
+    MESSAGE("GIF " << kSize << "x" << kSize << ": " << decoded << " frames in "
+            << elapsed << "us (" << fps << " frames/s), bytes touched "
+            << gif->getBytesTouched() << " of " << fullBytes << " for full-frame conversion");
+    CHECK_EQ(decoded, static_cast<fl::u32>(kLoops * frames.size()));
+    CHECK(gif->getBytesTouched() < fullBytes);
+    // Last frame: its square on the red background left by the first frame
+    fl::FramePtr last = decoder->getCurrentFramePtr();
+    REQUIRE(last);
+    CHECK(last->rgb()[29 * kSize + 58] == CRGB(0, 0, 255));
+    CHECK(last->rgb()[kSize * kSize - 1] == CRGB(255, 0, 0));
+    decoder->end();
+}
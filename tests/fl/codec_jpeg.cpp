@@ -3,7 +3,11 @@
 #include "fl/codec/jpeg.h"
 #include "fl/bytestreammemory.h"
 #include "fx/frame.h"
+#include "fl/downscale.h"
+#include "fl/xymap.h"
 #include "platforms/stub/fs_stub.hpp"
+#include "platforms/stub/time_stub.h"
+#include "third_party/TJpg_Decoder/driver.h"
 
 
 // Helper function to set up filesystem for codec tests
@@ -133,3 +137,110 @@ TEST_CASE("JPEG file loading and decoding") {
     handle->close();
     fs.end();
 }
+
+static fl::vector<fl::u8> loadCodecFile(const char* path) {
+    fl::FileSystem fs = setupCodecFilesystem();
+    fl::FileHandlePtr handle = fs.openRead(path);
+    REQUIRE(handle != nullptr);
+    fl::vector<fl::u8> data(handle->size());
+    handle->read(data.data(), data.size());
+    handle->close();
+    fs.end();
+    return data;
+}
+
+TEST_CASE("JPEG target size picks the largest covering native scale") {
+    using fl::third_party::TJpgInstanceDecoder;
+    CHECK_EQ(TJpgInstanceDecoder::chooseScale(128, 128, 16, 16), 3);
+    CHECK_EQ(TJpgInstanceDecoder::chooseScale(128, 128, 17, 16), 2);
+    CHECK_EQ(TJpgInstanceDecoder::chooseScale(128, 128, 64, 64), 1);
+    CHECK_EQ(TJpgInstanceDecoder::chooseScale(128, 128, 65, 10), 0);
+    CHECK_EQ(TJpgInstanceDecoder::chooseScale(128, 64, 32, 16), 2);
+    CHECK_EQ(TJpgInstanceDecoder::chooseScale(2, 2, 16, 16), 0);
+}
+
+TEST_CASE("JPEG decode to target resolution") {
+    fl::vector<fl::u8> data = loadCodecFile("data/codec/progressive.jpg");
+    fl::span<const fl::u8> span(data.data(), data.size());
+
+    fl::string error;
+    fl::FramePtr full = fl::Jpeg::decode(fl::JpegConfig(), span, &error);
+    REQUIRE_MESSAGE(full, error);
+    REQUIRE_EQ(full->getWidth(), 128);
+    REQUIRE_EQ(full->getHeight(), 128);
+
+    // 16 is an exact native scale, 20 and 24x12 need the fused area average.
+    const fl::u16 sizes[][2] = {{16, 16}, {20, 20}, {24, 12}};
+    for (const auto& size : sizes) {
+        const fl::u16 w = size[0];
+        const fl::u16 h = size[1];
+        fl::FramePtr scaled = fl::Jpeg::decode(fl::JpegConfig(w, h), span, &error);
+        REQUIRE_MESSAGE(scaled, error);
+        CHECK_EQ(scaled->getWidth(), w);
+        CHECK_EQ(scaled->getHeight(), h);
+
+        // Compare against full decode + downscale. TJpgDec's reduced IDCT
+        // is not bit-identical to averaging decoded pixels, so bound the mean
+        // error rather than requiring exact matches.
+        fl::vector<CRGB> reference(w * h);
+        fl::XYMap srcXY = fl::XYMap::constructRectangularGrid(128, 128);
+        fl::XYMap dstXY = fl::XYMap::constructRectangularGrid(w, h);
+        fl::downscale(full->rgb(), srcXY, reference.data(), dstXY);
+        fl::u32 total_error = 0;
+        for (fl::size i = 0; i < reference.size(); ++i) {
+            const CRGB& a = scaled->rgb()[i];
+            const CRGB& b = reference[i];
+            total_error += FL_ABS(int(a.r) - int(b.r)) + FL_ABS(int(a.g) - int(b.g)) +
+                           FL_ABS(int(a.b) - int(b.b));
+        }
+        const float mean_error = float(total_error) / float(reference.size() * 3);
+        MESSAGE("target " << w << "x" << h << " mean abs error vs downscale: " << mean_error);
+        CHECK(mean_error < 2.0f);
+    }
+
+    // Targets larger than the image are not upscaled.
+    fl::FramePtr larger = fl::Jpeg::decode(fl::JpegConfig(256, 256), span, &error);
+    REQUIRE(larger);
+    CHECK_EQ(larger->getWidth(), 128);
+    CHECK_EQ(larger->getHeight(), 128);
+}
+
+TEST_CASE("JPEG target size decode benchmark") {
+    fl::vector<fl::u8> data = loadCodecFile("data/codec/progressive.jpg");
+    fl::span<const fl::u8> span(data.data(), data.size());
+    const int kIterations = 50;
+
+    fl::vector<CRGB> out(16 * 16);
+    fl::XYMap srcXY = fl::XYMap::constructRectangularGrid(128, 128);
+    fl::XYMap dstXY = fl::XYMap::constructRectangularGrid(16, 16);
+    fl::u32 start = micros();
+    for (int i = 0; i < kIterations; ++i) {
+        fl::FramePtr full = fl::Jpeg::decode(fl::JpegConfig(), span);
+        REQUIRE(full);
+        fl::downscale(full->rgb(), srcXY, out.data(), dstXY);
+    }
+    const fl::u32 full_us = micros() - start;
+
+    fl::FramePtr scaled;
+    start = micros();
+    for (int i = 0; i < kIterations; ++i) {
+        scaled = fl::Jpeg::decode(fl::JpegConfig(16, 16), span);
+        REQUIRE(scaled);
+    }
+    const fl::u32 scaled_us = micros() - start;
+
+    MESSAGE("128x128 -> 16x16: full decode + downscale " << full_us / kIterations
+            << "us/frame, target decode " << scaled_us / kIterations << "us/frame");
+
+    // Both paths produce the same image, within the reduced IDCT's rounding
+    REQUIRE_EQ(scaled->getWidth(), 16);
+    REQUIRE_EQ(scaled->getHeight(), 16);
+    fl::u32 total_error = 0;
+    for (fl::size i = 0; i < out.size(); ++i) {
+        const CRGB& a = scaled->rgb()[i];
+        const CRGB& b = out[i];
+        total_error += FL_ABS(int(a.r) - int(b.r)) + FL_ABS(int(a.g) - int(b.g)) +
+                       FL_ABS(int(a.b) - int(b.b));
+    }
+    CHECK_LT(float(total_error) / float(out.size() * 3), 2.0f);
+}
@@ -1,6 +1,8 @@
 #include "test.h"
 #include "fl/codec/mp3.h"
 #include "fl/file_system.h"
+#include "fl/allocator.h"
+#include "fl/bytestreammemory.h"
 #ifdef FASTLED_TESTING
 #include "platforms/stub/fs_stub.hpp"
 #endif
@@ -159,3 +161,132 @@ TEST_CASE("Mp3HelixDecoder - Convert to fl::AudioSamples from real file") {
 
     printf("Converted MP3 to %zu fl::AudioSamples\n", samples.size());
 }
+
+namespace {
+
+class CountingMallocHook : public fl::MallocFreeHook {
+public:
+    void onMalloc(void* ptr, fl::size size) override {
+        (void)ptr;
+        (void)size;
+        mallocs++;
+    }
+    void onFree(void* ptr) override {
+        (void)ptr;
+        frees++;
+    }
+    int mallocs = 0;
+    int frees = 0;
+};
+
+} // namespace
+
+TEST_CASE("Mp3Decoder - streaming into the PCM ring does not allocate") {
+    fl::setTestFileSystemRoot("tests/data");
+    fl::FileSystem fs;
+    CHECK(fs.beginSd(0));
+    fl::FileHandlePtr file = fs.openRead("codec/jazzy_percussion.mp3");
+    REQUIRE(file != nullptr);
+    fl::vector<fl::u8> mp3_data(file->size());
+    file->read(mp3_data.data(), mp3_data.size());
+    file->close();
+
+    auto stream = fl::make_shared<fl::ByteStreamMemory>(mp3_data.size());
+    stream->write(mp3_data.data(), mp3_data.size());
+    fl::Mp3Decoder decoder;
+    REQUIRE(decoder.begin(stream));
+
+    // Warm up: fills the ring and creates the cached FFT for this size
+    const fl::size kFftSamples = 512;
+    fl::FFTBins bins(16);
+    fl::AudioSample sample;
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(decoder.decodeNextFrame(&sample));
+    }
+    REQUIRE(decoder.pcmRing().fft(kFftSamples, &bins));
+
+    // Samples share storage with the ring blocks
+    CHECK_EQ(sample.pcm().data(), decoder.pcmRing().block(0).pcm().data());
+
+    CountingMallocHook hook;
+    fl::SetMallocFreeHook(&hook);
+    int frames = 0;
+    for (; frames < 16 && decoder.decodeNextFrame(&sample); ++frames) {
+        decoder.pcmRing().fft(kFftSamples, &bins);
+    }
+    fl::ClearMallocFreeHook();
+
+    CHECK_EQ(frames, 16);
+    CHECK_EQ(hook.mallocs, 0);
+    CHECK_EQ(hook.frees, 0);
+    CHECK_EQ(bins.bins_raw.size(), 16);
+
+    // Windows spanning two blocks match the concatenated PCM
+    const fl::AudioSample newest = decoder.pcmRing().block(0);
+    const fl::AudioSample previous = decoder.pcmRing().block(1);
+    fl::vector<fl::i16> window(newest.size() + 8);
+    REQUIRE(decoder.pcmRing().copyLatest(window));
+    for (fl::size i = 0; i < 8; ++i) {
+        CHECK_EQ(window[i], previous[previous.size() - 8 + i]);
+    }
+    for (fl::size i = 0; i < newest.size(); ++i) {
+        CHECK_EQ(window[8 + i], newest[i]);
+    }
+
+    decoder.end();
+}
+
+namespace {
+
+fl::vector<fl::u8> loadMp3(const char* path) {
+    fl::setTestFileSystemRoot("tests/data");
+    fl::FileSystem fs;
+    CHECK(fs.beginSd(0));
+    fl::FileHandlePtr file = fs.openRead(path);
+    REQUIRE(file != nullptr);
+    fl::vector<fl::u8> data(file->size());
+    file->read(data.data(), data.size());
+    file->close();
+    return data;
+}
+
+int countStreamedFrames(const fl::vector<fl::u8>& data, fl::size bytes) {
+    auto stream = fl::make_shared<fl::ByteStreamMemory>(bytes);
+    stream->write(data.data(), bytes);
+    fl::Mp3Decoder decoder;
+    REQUIRE(decoder.begin(stream));
+    fl::AudioSample sample;
+    int frames = 0;
+    while (decoder.decodeNextFrame(&sample)) {
+        frames++;
+    }
+    decoder.end();
+    return frames;
+}
+
+} // namespace
+
+TEST_CASE("Mp3Decoder - streaming keeps frames split across buffer refills") {
+    const char* files[] = {"codec/jazzy_percussion.mp3", "codec/edm_beat.mp3"};
+    for (const char* path : files) {
+        const fl::vector<fl::u8> data = loadMp3(path);
+        Mp3HelixDecoder reference;
+        REQUIRE(reference.init());
+        int expected = 0;
+        reference.decode(data.data(), data.size(),
+                         [&](const Mp3Frame&) { expected++; });
+        CAPTURE(path);
+        CHECK_GT(expected, 0);
+        CHECK_EQ(countStreamedFrames(data, data.size()), expected);
+    }
+}
+
+TEST_CASE("Mp3Decoder - a truncated last frame ends the stream") {
+    const fl::vector<fl::u8> data = loadMp3("codec/edm_beat.mp3");
+    const int full = countStreamedFrames(data, data.size());
+    // Cut into the middle of the last frames; decoding must stop rather than
+    // retry the partial frame forever
+    const int truncated = countStreamedFrames(data, data.size() - 200);
+    CHECK_GT(truncated, 0);
+    CHECK_LT(truncated, full);
+}
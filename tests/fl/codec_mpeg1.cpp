@@ -4,6 +4,7 @@
 #include "fx/frame.h"
 #include "fl/bytestreammemory.h"
 #include "platforms/stub/fs_stub.hpp"
+#include "platforms/stub/time_stub.h"
 
 
 // Helper function to set up filesystem for codec tests
@@ -351,8 +352,9 @@ TEST_CASE("MPEG1 decoder properties and metadata") {
         // Frame count is 0 for streaming mode (unknown in advance)
         CHECK_EQ(decoder->getFrameCount(), 0);
 
-        // Seeking is not supported
-        CHECK_FALSE(decoder->seek(1));
+        // Seeking decodes the requested frame, counted like decode() does
+        CHECK(decoder->seek(1));
+        CHECK_EQ(decoder->getCurrentFrameIndex(), 2u);
     }
 
     SUBCASE("Decoder state management") {
@@ -838,4 +840,341 @@ TEST_CASE("MPEG1 audio extraction") {
     }
 
     fs.end();
-}
\ No newline at end of file
+}
+namespace {
+
+// Synthetic 4:2:0 frame with smooth luma and blocky chroma
+struct SyntheticYuvFrame {
+    fl::vector<fl::u8> y, cb, cr;
+    fl::third_party::plm_frame_t frame;
+
+    SyntheticYuvFrame(unsigned width, unsigned height) {
+        y.resize(width * height);
+        cb.resize((width / 2) * (height / 2));
+        cr.resize(cb.size());
+        for (unsigned j = 0; j < height; ++j) {
+            for (unsigned i = 0; i < width; ++i) {
+                y[j * width + i] = static_cast<fl::u8>(60 + ((i * 7 + j * 3) % 120));
+            }
+        }
+        for (unsigned j = 0; j < height / 2; ++j) {
+            for (unsigned i = 0; i < width / 2; ++i) {
+                cb[j * (width / 2) + i] = static_cast<fl::u8>(((i / 4) % 2) ? 110 : 146);
+                cr[j * (width / 2) + i] = static_cast<fl::u8>(((j / 4) % 2) ? 115 : 140);
+            }
+        }
+        frame.time = 0;
+        frame.width = width;
+        frame.height = height;
+        frame.y = {width, height, y.data()};
+        frame.cb = {width / 2, height / 2, cb.data()};
+        frame.cr = {width / 2, height / 2, cr.data()};
+    }
+};
+
+// MSB-first bit writer for building MPEG1 video elementary streams
+struct BitWriter {
+    fl::vector<fl::u8> bytes;
+    int used = 8;
+
+    void put(fl::u32 value, int bits) {
+        for (int b = bits - 1; b >= 0; --b) {
+            if (used == 8) {
+                bytes.push_back(0);
+                used = 0;
+            }
+            if ((value >> b) & 1) {
+                bytes.back() |= static_cast<fl::u8>(0x80 >> used);
+            }
+            ++used;
+        }
+    }
+    void startCode(fl::u8 code) {
+        used = 8;  // zero padded to a byte boundary
+        put(0x000001, 24);
+        put(code, 8);
+    }
+};
+
+// One 2x2 picture, a single intra macroblock of flat grey `luma`, so every
+// frame can be told apart whatever its type
+void writePicture(BitWriter& w, fl::u32 temporalReference, int type, int luma) {
+    w.startCode(0x00);
+    w.put(temporalReference, 10);
+    w.put(type, 3);
+    w.put(0xFFFF, 16);  // vbv_delay
+    if (type >= 2) {
+        w.put(0x1, 4);  // full_pel_forward_vector 0, forward_f_code 1
+    }
+    if (type == 3) {
+        w.put(0x1, 4);  // backward
+    }
+    w.put(0, 1);  // extra_bit_picture
+    w.startCode(0x01);  // slice 1
+    w.put(2, 5);        // quantizer_scale
+    w.put(0, 1);        // extra_bit_slice
+    w.put(1, 1);        // macroblock_address_increment 1
+    // Intra macroblock_type: '1' in I, '00011' in P and B pictures
+    if (type == 1) {
+        w.put(1, 1);
+    } else {
+        w.put(0x03, 5);
+    }
+    // First luma block carries the DC difference from 128 (|diff| < 64)
+    static const fl::u8 kSizeCode[7][2] = {  // dct_dc_size_luminance: code, bits
+        {0x4, 3}, {0x0, 2}, {0x1, 2}, {0x5, 3}, {0x6, 3}, {0xE, 4}, {0x1E, 5},
+    };
+    const int diff = luma - 128;
+    int size = 0;
+    while ((1 << size) <= (diff < 0 ? -diff : diff)) {
+        ++size;
+    }
+    w.put(kSizeCode[size][0], kSizeCode[size][1]);
+    if (size > 0) {
+        w.put(static_cast<fl::u32>(diff >= 0 ? diff : diff + (1 << size) - 1), size);
+    }
+    w.put(0x2, 2);  // end_of_block
+    for (int block = 1; block < 4; ++block) {
+        w.put(0x4, 3);  // size 0, same DC
+        w.put(0x2, 2);
+    }
+    for (int block = 4; block < 6; ++block) {
+        w.put(0x0, 2);  // chroma size 0
+        w.put(0x2, 2);
+    }
+}
+
+void append(fl::vector<fl::u8>& out, const fl::u8* data, fl::size size) {
+    for (fl::size i = 0; i < size; ++i) {
+        out.push_back(data[i]);
+    }
+}
+
+struct Picture {
+    fl::u32 temporalReference;
+    int type;  // 1 = I, 2 = P, 3 = B
+};
+
+// Program stream of three GOPs with B-frames, in decode order:
+//   closed  I0 P3 B1 B2 P6 B4 B5
+//   open    I2 B0 B1 P5 B3 B4     (the B0 B1 are shown before the I-frame)
+//   closed  I0 P2 B1 P3
+// Display frame n has luma 72 + 7 * n. Pictures are spread over PES
+// packets of four, so several I-frames sit inside a packet.
+fl::vector<fl::u8> buildBFrameStream() {
+    static const Picture gops[3][7] = {
+        {{0, 1}, {3, 2}, {1, 3}, {2, 3}, {6, 2}, {4, 3}, {5, 3}},
+        {{2, 1}, {0, 3}, {1, 3}, {5, 2}, {3, 3}, {4, 3}, {0, 0}},
+        {{0, 1}, {2, 2}, {1, 3}, {3, 2}, {0, 0}, {0, 0}, {0, 0}},
+    };
+    fl::vector<fl::vector<fl::u8>> pictures;
+    BitWriter header;
+    header.startCode(0xB3);
+    const fl::u8 sequence[] = {0x00, 0x20, 0x02, 0x13, 0xFF, 0xFF, 0xE0, 0xD0};
+    for (fl::u8 b : sequence) {
+        header.put(b, 8);
+    }
+    fl::u32 gopStart = 0;
+    for (int g = 0; g < 3; ++g) {
+        BitWriter w;
+        if (g == 0) {
+            w = header;
+        }
+        w.startCode(0xB8);
+        w.put(0x00080040, 32);  // time code, closed_gop
+        fl::u32 count = 0;
+        for (const Picture& p : gops[g]) {
+            if (p.type == 0) {
+                break;
+            }
+            writePicture(w, p.temporalReference, p.type,
+                         72 + 7 * static_cast<int>(gopStart + p.temporalReference));
+            pictures.push_back(w.bytes);
+            w = BitWriter();
+            ++count;
+        }
+        gopStart += count;
+    }
+
+    // Pack and system header for one video stream
+    const fl::u8 packHeader[] = {
+        0x00, 0x00, 0x01, 0xBA, 0x21, 0x00, 0x01, 0x00, 0x01, 0xC3, 0x33, 0x67,
+        0x00, 0x00, 0x01, 0xBB, 0x00, 0x09, 0xC3, 0x33, 0x67, 0x00, 0x21, 0xFF,
+        0xE0, 0xE0, 0xE6,
+    };
+    fl::vector<fl::u8> stream;
+    append(stream, packHeader, sizeof(packHeader));
+    for (fl::size first = 0; first < pictures.size(); first += 4) {
+        fl::vector<fl::u8> payload;
+        for (fl::size i = first; i < first + 4 && i < pictures.size(); ++i) {
+            append(payload, pictures[i].data(), pictures[i].size());
+        }
+        const fl::size length = payload.size() + 1;
+        const fl::u8 pes[] = {0x00, 0x00, 0x01, 0xE0, static_cast<fl::u8>(length >> 8),
+                              static_cast<fl::u8>(length), 0x0F};  // no timestamps
+        append(stream, pes, sizeof(pes));
+        append(stream, payload.data(), payload.size());
+    }
+    const fl::u8 end[] = {0x00, 0x00, 0x01, 0xB9};
+    append(stream, end, sizeof(end));
+    return stream;
+}
+
+fl::shared_ptr<fl::third_party::SoftwareMpeg1Decoder> openBFrameStream() {
+    const fl::vector<fl::u8> data = buildBFrameStream();
+    fl::Mpeg1Config config;
+    config.skipAudio = true;
+    config.immediateMode = true;
+    config.targetFps = 25;  // one picture per decode()
+    auto decoder = fl::make_shared<fl::third_party::SoftwareMpeg1Decoder>(config);
+    auto stream = fl::make_shared<fl::ByteStreamMemory>(data.size());
+    stream->write(data.data(), data.size());
+    REQUIRE(decoder->begin(stream));
+    return decoder;
+}
+
+} // namespace
+
+TEST_CASE("MPEG1 frame scaler box filters YCbCr at target resolution") {
+    const fl::u16 kW = 64, kH = 48, kOutW = 16, kOutH = 12;
+    SyntheticYuvFrame src(kW, kH);
+
+    fl::third_party::Mpeg1FrameScaler native;
+    native.configure(kW, kH, 0, 0);
+    CHECK_EQ(native.getOutputWidth(), kW);
+    CHECK_EQ(native.getOutputHeight(), kH);
+    fl::vector<fl::u8> full(kW * kH * 3);
+    native.convert(&src.frame, full.data());
+
+    fl::third_party::Mpeg1FrameScaler scaler;
+    scaler.configure(kW, kH, kOutW, kOutH);
+    REQUIRE_EQ(scaler.getOutputWidth(), kOutW);
+    REQUIRE_EQ(scaler.getOutputHeight(), kOutH);
+    fl::vector<fl::u8> small(kOutW * kOutH * 3);
+    scaler.convert(&src.frame, small.data());
+
+    // Averaging in YCbCr and converting once matches averaging the full RGB
+    // frame up to rounding and clamping.
+    int max_diff = 0;
+    for (int oy = 0; oy < kOutH; ++oy) {
+        for (int ox = 0; ox < kOutW; ++ox) {
+            for (int c = 0; c < 3; ++c) {
+                int sum = 0;
+                for (int y = oy * 4; y < oy * 4 + 4; ++y) {
+                    for (int x = ox * 4; x < ox * 4 + 4; ++x) {
+                        sum += full[(y * kW + x) * 3 + c];
+                    }
+                }
+                int diff = FL_ABS(small[(oy * kOutW + ox) * 3 + c] - (sum + 8) / 16);
+                max_diff = FL_MAX(max_diff, diff);
+            }
+        }
+    }
+    MESSAGE("max channel difference vs RGB box average: " << max_diff);
+    CHECK(max_diff <= 3);
+
+    // Targets larger than the source are clamped
+    fl::third_party::Mpeg1FrameScaler clamped;
+    clamped.configure(kW, kH, 100, 10);
+    CHECK_EQ(clamped.getOutputWidth(), kW);
+    CHECK_EQ(clamped.getOutputHeight(), 10);
+}
+
+TEST_CASE("MPEG1 reduced resolution decode and I-frame seek") {
+    fl::FileSystem fs = setupCodecFilesystem();
+    fl::FileHandlePtr handle = fs.openRead("data/codec/test_audio_video.mpg");
+    REQUIRE(handle != nullptr);
+    fl::vector<fl::u8> data(handle->size());
+    handle->read(data.data(), data.size());
+    handle->close();
+
+    fl::Mpeg1Config config;
+    config.skipAudio = true;
+    config.targetWidth = 1;
+    config.targetHeight = 1;
+    auto decoder = fl::make_shared<fl::third_party::SoftwareMpeg1Decoder>(config);
+    auto stream = fl::make_shared<fl::ByteStreamMemory>(data.size());
+    stream->write(data.data(), data.size());
+    REQUIRE(decoder->begin(stream));
+
+    CHECK_EQ(decoder->getWidth(), 2);
+    CHECK_EQ(decoder->getOutputWidth(), 1);
+    CHECK_EQ(decoder->getOutputHeight(), 1);
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    fl::Frame first = decoder->getCurrentFrame();
+    CHECK_EQ(first.getWidth(), 1);
+    CHECK_EQ(first.getHeight(), 1);
+
+    // The clip has an I-frame every 12 pictures
+    REQUIRE_EQ(decoder->getKeyFrameCount(), 3u);
+    REQUIRE(decoder->seek(15));
+    // Frame 15 is current, decoded forward from the I-frame at 12
+    CHECK_EQ(decoder->getCurrentFrameIndex(), 16u);
+    CHECK(decoder->getCurrentFrame().isValid());
+    CHECK(decoder->decode() == fl::DecodeResult::Success);
+    CHECK_EQ(decoder->getCurrentFrameIndex(), 17u);
+
+    REQUIRE(decoder->seek(0));
+    CHECK_EQ(decoder->getCurrentFrameIndex(), 1u);
+
+    decoder->end();
+    fs.end();
+}
+
+TEST_CASE("MPEG1 seek with B-frames follows display order") {
+    auto decoder = openBFrameStream();
+    REQUIRE_EQ(decoder->getKeyFrameCount(), 3u);
+    // Red channel of display frame n, from its luma 72 + 7 * n
+    auto expectedRed = [](fl::u32 n) {
+        return (static_cast<int>(72 + 7 * n) - 16) * 255 / 219;
+    };
+
+    // Playback from the start comes out in display order
+    for (fl::u32 n = 0; n < 5; ++n) {
+        REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+        CHECK_EQ(decoder->getCurrentFrameIndex(), n + 1);
+        const int red = decoder->getCurrentFrame().rgb()[0].r;
+        CHECK_LE(FL_ABS(red - expectedRed(n)), 1);
+    }
+
+    // Forwards, backwards, onto I-frames (0, 9, 13), the leading B-frames of
+    // the open GOP (7, 8) and the frames in between
+    const fl::u32 targets[] = {5, 0, 7, 9, 8, 12, 3, 16, 6, 10, 13, 1, 15, 11};
+    for (fl::u32 n : targets) {
+        REQUIRE(decoder->seek(n));
+        CHECK_EQ(decoder->getCurrentFrameIndex(), n + 1);
+        fl::Frame frame = decoder->getCurrentFrame();
+        REQUIRE(frame.isValid());
+        const int red = frame.rgb()[0].r;
+        CHECK_LE(FL_ABS(red - expectedRed(n)), 1);
+    }
+
+    // Playback carries on from a seek
+    REQUIRE(decoder->seek(9));
+    REQUIRE(decoder->decode() == fl::DecodeResult::Success);
+    CHECK_EQ(decoder->getCurrentFrameIndex(), 11u);
+    CHECK_LE(FL_ABS(decoder->getCurrentFrame().rgb()[0].r - expectedRed(10)), 1);
+
+    // Past the last frame
+    CHECK_FALSE(decoder->seek(17));
+}
+
+TEST_CASE("MPEG1 YCbCr conversion benchmark") {
+    const fl::u16 kW = 320, kH = 240;
+    SyntheticYuvFrame src(kW, kH);
+    const int kIterations = 30;
+    const fl::u16 outSizes[][2] = {{kW, kH}, {kW / 4, kH / 4}};
+    for (const auto& size : outSizes) {
+        fl::third_party::Mpeg1FrameScaler scaler;
+        scaler.configure(kW, kH, size[0], size[1]);
+        fl::vector<fl::u8> rgb(size[0] * size[1] * 3);
+        fl::u32 start = micros();
+        for (int i = 0; i < kIterations; ++i) {
+            scaler.convert(&src.frame, rgb.data());
+        }
+        fl::u32 elapsed = micros() - start;
+        const double fps = elapsed ? kIterations * 1e6 / elapsed : 0.0;
+        MESSAGE(kW << "x" << kH << " -> " << size[0] << "x" << size[1] << ": "
+                << fps << " frames/s, RGB buffer " << rgb.size() << " bytes");
+    }
+}
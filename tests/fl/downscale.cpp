@@ -3,10 +3,17 @@
 
 #include "test.h"
 
+#include "FastLED.h"
 #include "fl/downscale.h"
 #include "fl/dbg.h"
+#include "fl/math_macros.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+#include "platforms/stub/time_stub.h"
 #include "test.h"
 
+#include <stdio.h>
+
 
 TEST_CASE("downscale 2x2 to 1x1") {
 
@@ -123,4 +130,136 @@ TEST_CASE("downscale 11x11 to 2x2") {
         INFO("Dst[" << i << "]: " << dst[i]);
         CHECK(dst[i] == CRGB(129, 0, 0));  // Averaged color
     }
-}
\ No newline at end of file
+}
+namespace {
+
+fl::vector<CRGB> noiseImage(fl::u16 width, fl::u16 height, fl::u32 seed) {
+    fl::vector<CRGB> image(fl::u32(width) * height);
+    fl::u32 state = 0x9E3779B9u ^ seed;
+    for (fl::u32 i = 0; i < image.size(); ++i) {
+        state = state * 1664525u + 1013904223u;
+        image[i] = CRGB(fl::u8(state >> 24), fl::u8(state >> 16), fl::u8(state >> 8));
+    }
+    return image;
+}
+
+int maxChannelDiff(const fl::vector<CRGB> &a, const fl::vector<CRGB> &b) {
+    int worst = 0;
+    for (fl::u32 i = 0; i < a.size(); ++i) {
+        for (int c = 0; c < 3; ++c) {
+            const int d = int(a[i].raw[c]) - int(b[i].raw[c]);
+            worst = FL_MAX(worst, d < 0 ? -d : d);
+        }
+    }
+    return worst;
+}
+
+} // namespace
+
+TEST_CASE("AreaDownscaler - 2:1 is identical to downscaleHalf") {
+    fl::AreaDownscaler downscaler;
+    const fl::u16 sizes[][2] = {{2, 2}, {8, 6}, {30, 18}, {64, 64}};
+    for (const auto &s : sizes) {
+        const fl::vector<CRGB> src = noiseImage(s[0], s[1], s[0]);
+        fl::vector<CRGB> expected(fl::u32(s[0] / 2) * (s[1] / 2));
+        fl::vector<CRGB> actual(expected.size());
+        fl::downscaleHalf(src.data(), s[0], s[1], expected.data());
+        downscaler.downscale(src.data(), s[0], s[1], actual.data(), s[0] / 2, s[1] / 2);
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("AreaDownscaler - integer ratios are box averages") {
+    fl::AreaDownscaler downscaler;
+    const fl::vector<CRGB> src = noiseImage(12, 12, 3);
+    const fl::u16 dstSizes[][2] = {{4, 4}, {3, 6}, {1, 1}, {12, 2}};
+    for (const auto &d : dstSizes) {
+        const fl::u32 kx = 12 / d[0];
+        const fl::u32 ky = 12 / d[1];
+        fl::vector<CRGB> dst(fl::u32(d[0]) * d[1]);
+        downscaler.downscale(src.data(), 12, 12, dst.data(), d[0], d[1]);
+        for (fl::u16 y = 0; y < d[1]; ++y) {
+            for (fl::u16 x = 0; x < d[0]; ++x) {
+                for (int c = 0; c < 3; ++c) {
+                    fl::u32 sum = 0;
+                    for (fl::u32 sy = y * ky; sy < (y + 1) * ky; ++sy) {
+                        for (fl::u32 sx = x * kx; sx < (x + 1) * kx; ++sx) {
+                            sum += src[sy * 12 + sx].raw[c];
+                        }
+                    }
+                    const fl::u32 n = kx * ky;
+                    CHECK_EQ(dst[y * d[0] + x].raw[c], (sum + n / 2) / n);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("AreaDownscaler - within 1 of downscaleArbitrary") {
+    fl::AreaDownscaler downscaler;
+    const fl::u16 sizes[][4] = {
+        {3, 3, 2, 2}, {11, 11, 2, 2}, {17, 13, 5, 4}, {64, 48, 22, 17},
+        {40, 40, 39, 7}, {128, 96, 20, 15},
+    };
+    for (const auto &s : sizes) {
+        const fl::vector<CRGB> src = noiseImage(s[0], s[1], s[2]);
+        XYMap srcMap = XYMap::constructRectangularGrid(s[0], s[1]);
+        XYMap dstMap = XYMap::constructSerpentine(s[2], s[3]);
+        fl::vector<CRGB> expected(fl::u32(s[2]) * s[3]);
+        fl::vector<CRGB> actual(expected.size());
+        fl::downscaleArbitrary(src.data(), srcMap, expected.data(), dstMap);
+        downscaler.downscale(src.data(), srcMap, actual.data(), dstMap);
+        INFO(s[0] << "x" << s[1] << " -> " << s[2] << "x" << s[3]);
+        CHECK_LE(maxChannelDiff(actual, expected), 1);
+    }
+}
+
+TEST_CASE("AreaDownscaler - reads the source through its XYMap") {
+    const fl::vector<CRGB> grid = noiseImage(20, 10, 7);
+    XYMap serpentine = XYMap::constructSerpentine(20, 10);
+    fl::vector<CRGB> leds(grid.size());
+    serpentine.scatter(grid.data(), leds.data());
+
+    fl::AreaDownscaler downscaler;
+    fl::vector<CRGB> fromGrid(6 * 4);
+    fl::vector<CRGB> fromLeds(6 * 4);
+    downscaler.downscale(grid.data(), 20, 10, fromGrid.data(), 6, 4);
+    downscaler.downscale(leds.data(), serpentine, fromLeds.data(),
+                         XYMap::constructRectangularGrid(6, 4));
+    CHECK(fromLeds == fromGrid);
+}
+
+TEST_CASE("AreaDownscaler - benchmark against downscaleArbitrary") {
+    struct Case {
+        const char *name;
+        fl::u16 sw, sh, dw, dh;
+    };
+    const Case cases[] = {
+        {"160x120 -> 22x22 (video to panel)", 160, 120, 22, 22},
+        {"128x128 -> 32x32 (integer 4:1)", 128, 128, 32, 32},
+    };
+    for (const Case &c : cases) {
+        const fl::vector<CRGB> src = noiseImage(c.sw, c.sh, 11);
+        XYMap srcMap = XYMap::constructRectangularGrid(c.sw, c.sh);
+        XYMap dstMap = XYMap::constructSerpentine(c.dw, c.dh);
+        fl::vector<CRGB> dst(fl::u32(c.dw) * c.dh);
+        fl::AreaDownscaler downscaler;
+        downscaler.downscale(src.data(), srcMap, dst.data(), dstMap);
+
+        const int rounds = 10;
+        fl::u32 start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            fl::downscaleArbitrary(src.data(), srcMap, dst.data(), dstMap);
+        }
+        const double arbitraryMs = double(micros() - start) / rounds / 1000.0;
+        const fl::vector<CRGB> expected = dst;
+        start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            downscaler.downscale(src.data(), srcMap, dst.data(), dstMap);
+        }
+        const double tableMs = double(micros() - start) / rounds / 1000.0;
+        printf("Downscale %s, ms per frame: downscaleArbitrary %.3f, "
+               "AreaDownscaler %.3f\n", c.name, arbitraryMs, tableMs);
+        CHECK_LE(maxChannelDiff(dst, expected), 1);
+    }
+}
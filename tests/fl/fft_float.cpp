@@ -0,0 +1,89 @@
+#include "test.h"
+
+#include "fl/fft_float.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+
+#include <math.h>
+
+using namespace fl;
+
+namespace {
+
+fl::vector<float> makeSignal(int n) {
+    fl::vector<float> x(n);
+    for (int i = 0; i < n; ++i) {
+        const double t = double(i) / n;
+        x[i] = static_cast<float>(0.4 * ::sin(2.0 * FL_PI * 21.3 * t) +
+                                  0.25 * ::cos(2.0 * FL_PI * 57.0 * t + 0.3) +
+                                  double((i * 7919) % 2001 - 1000) * 1e-5);
+    }
+    return x;
+}
+
+// Largest bin error against the exact DFT, relative to the largest bin
+double maxRelativeError(const fl::vector<float> &x, const float *spectrum) {
+    const int n = static_cast<int>(x.size());
+    double peak = 0.0;
+    double err = 0.0;
+    for (int k = 0; k <= n / 2; ++k) {
+        double re = 0.0;
+        double im = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const double a = 2.0 * FL_PI * double(k) * i / n;
+            re += x[i] * ::cos(a);
+            im -= x[i] * ::sin(a);
+        }
+        peak = FL_MAX(peak, ::sqrt(re * re + im * im));
+        err = FL_MAX(err, FL_ABS(re - spectrum[2 * k]));
+        err = FL_MAX(err, FL_ABS(im - spectrum[2 * k + 1]));
+    }
+    return err / peak;
+}
+
+} // namespace
+
+TEST_CASE("FFTFloat - size support") {
+    CHECK(FFTFloat::supports(4));
+    CHECK(FFTFloat::supports(4096));
+    CHECK_FALSE(FFTFloat::supports(2));
+    CHECK_FALSE(FFTFloat::supports(500));
+    CHECK_FALSE(FFTFloat().ok());
+    CHECK_FALSE(FFTFloat(300).ok());
+    FFTFloat fft(512);
+    CHECK(fft.ok());
+    CHECK_EQ(fft.samples(), 512u);
+    CHECK_EQ(fft.outputSize(), 514u);
+}
+
+TEST_CASE("FFTFloat - matches the DFT") {
+    const int sizes[] = {4, 8, 64, 256, 1024, 4096};
+    for (int n : sizes) {
+        const fl::vector<float> x = makeSignal(n);
+        fl::vector<float> data = x;
+        FFTFloat fft(n);
+        fl::vector<float> out(fft.outputSize());
+        fft.run(data.data(), out.data());
+        CAPTURE(n);
+        CHECK_LT(maxRelativeError(x, out.data()), 1e-5);
+    }
+}
+
+TEST_CASE("FFTFloat - pure tone lands in its bin") {
+    const int n = 256;
+    fl::vector<float> x(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = static_cast<float>(::cos(2.0 * FL_PI * 10.0 * i / n));
+    }
+    FFTFloat fft(n);
+    fl::vector<float> out(fft.outputSize());
+    fft.run(x.data(), out.data());
+    // A unit cosine shows up as N / 2 in bin k
+    CHECK_LT(FL_ABS(out[2 * 10] - n / 2.0f), 1e-3f);
+    for (int k = 0; k <= n / 2; ++k) {
+        if (k != 10) {
+            CHECK_LT(FL_ABS(out[2 * k]), 1e-3f);
+        }
+        CHECK_LT(FL_ABS(out[2 * k + 1]), 1e-3f);
+    }
+}
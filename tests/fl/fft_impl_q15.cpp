@@ -0,0 +1,103 @@
+// Built with FASTLED_FFT_Q15=1 and linked against fastled_fft_q15_lib (see
+// tests/meson.build), so FFTImpl runs on the Q15 engine here.
+
+#include "test.h"
+
+#include "third_party/cq_kernel/kiss_fftr.h"
+
+#include "fl/fft.h"
+#include "fl/fft_impl.h"
+#include "fl/fft_q15.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+
+#include <math.h>
+
+using namespace fl;
+
+static_assert(FASTLED_FFT_Q15, "this test must be built with FASTLED_FFT_Q15=1");
+
+namespace {
+
+fl::vector<i16> makeSignal(int n) {
+    fl::vector<i16> x(n);
+    for (int i = 0; i < n; ++i) {
+        const double t = double(i) / n;
+        const double v = 12000.0 * ::sin(2.0 * FL_PI * 21.3 * t) +
+                         8000.0 * ::cos(2.0 * FL_PI * 57.0 * t + 0.3) +
+                         double((i * 7919) % 2001 - 1000);
+        x[i] = static_cast<i16>(v);
+    }
+    return x;
+}
+
+FFTSpectrum kissSpectrum(const fl::vector<i16> &x) {
+    const int n = static_cast<int>(x.size());
+    FFTSpectrum spectrum;
+    spectrum.samples = n;
+    spectrum.bins.resize((n / 2 + 1) * 2);
+    kiss_fftr_cfg cfg = kiss_fftr_alloc(n, 0, nullptr, nullptr);
+    kiss_fftr(cfg, x.data(),
+              reinterpret_cast<kiss_fft_cpx *>(spectrum.bins.data()));
+    kiss_fftr_free(cfg);
+    return spectrum;
+}
+
+} // namespace
+
+TEST_CASE("FFTImpl with FASTLED_FFT_Q15 - transform runs on FFTQ15") {
+    const int n = 512;
+    const fl::vector<i16> x = makeSignal(n);
+    const span<const i16> in(x.data(), x.size());
+
+    FFTImpl impl(FFT_Args(n, 16));
+    FFTSpectrum spectrum;
+    REQUIRE(impl.transform(in, &spectrum).ok);
+
+    FFTQ15 q15(n);
+    fl::vector<i16> expected(q15.outputSize());
+    q15.run(in, expected.data());
+    REQUIRE_EQ(spectrum.bins.size(), expected.size());
+    for (fl::size i = 0; i < expected.size(); ++i) {
+        CHECK_EQ(spectrum.bins[i], expected[i]);
+    }
+}
+
+TEST_CASE("FFTImpl with FASTLED_FFT_Q15 - bins match the kiss_fftr path") {
+    const int sizes[] = {256, 512, 1024};
+    for (int n : sizes) {
+        const fl::vector<i16> x = makeSignal(n);
+        FFTImpl impl(FFT_Args(n, 16));
+        FFTBins bins(16);
+        REQUIRE(impl.run(span<const i16>(x.data(), x.size()), &bins).ok);
+
+        // Same kernels, fed the float path's spectrum
+        FFTBins expected(16);
+        REQUIRE(impl.bands(kissSpectrum(x), &expected).ok);
+
+        // Loud bands agree to a few percent; quiet ones to a few LSB of
+        // rounding noise, which grows with the bins each kernel sums.
+        const float slack = float(n) / 128.0f;
+        REQUIRE_EQ(bins.bins_raw.size(), expected.bins_raw.size());
+        for (fl::size i = 0; i < bins.bins_raw.size(); ++i) {
+            const float a = bins.bins_raw[i];
+            const float b = expected.bins_raw[i];
+            CAPTURE(n);
+            CHECK_LE(FL_ABS(a - b), slack + 0.05f * b);
+        }
+    }
+}
+
+TEST_CASE("FFTImpl with FASTLED_FFT_Q15 - unsupported sizes fall back to "
+          "kiss_fftr") {
+    const int n = 2048;
+    const fl::vector<i16> x = makeSignal(n);
+    FFTImpl impl(FFT_Args(n, 16));
+    FFTSpectrum spectrum;
+    REQUIRE(impl.transform(span<const i16>(x.data(), x.size()), &spectrum).ok);
+    const FFTSpectrum expected = kissSpectrum(x);
+    REQUIRE_EQ(spectrum.bins.size(), expected.bins.size());
+    for (fl::size i = 0; i < expected.bins.size(); ++i) {
+        CHECK_EQ(spectrum.bins[i], expected.bins[i]);
+    }
+}
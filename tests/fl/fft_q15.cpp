@@ -0,0 +1,173 @@
+#include "test.h"
+
+#include "third_party/cq_kernel/kiss_fftr.h"
+
+#include "fl/fft.h"
+#include "fl/fft_q15.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+#include "platforms/stub/time_stub.h"
+
+#include <math.h>
+#include <stdio.h>
+
+using namespace fl;
+
+namespace {
+
+// Two tones plus a little deterministic noise, well inside full scale
+fl::vector<i16> makeSignal(int n) {
+    fl::vector<i16> x(n);
+    for (int i = 0; i < n; ++i) {
+        const double t = double(i) / n;
+        const double v = 12000.0 * ::sin(2.0 * FL_PI * 21.3 * t) +
+                         8000.0 * ::cos(2.0 * FL_PI * 57.0 * t + 0.3) +
+                         double((i * 7919) % 2001 - 1000);
+        x[i] = static_cast<i16>(v);
+    }
+    return x;
+}
+
+// SNR of an interleaved re/im spectrum against the exact DFT / N
+double snrDb(const fl::vector<i16> &x, const i16 *spectrum) {
+    const int n = static_cast<int>(x.size());
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int k = 0; k <= n / 2; ++k) {
+        double re = 0.0;
+        double im = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const double a = 2.0 * FL_PI * double(k) * i / n;
+            re += x[i] * ::cos(a);
+            im -= x[i] * ::sin(a);
+        }
+        re /= n;
+        im /= n;
+        const double dr = re - spectrum[2 * k];
+        const double di = im - spectrum[2 * k + 1];
+        signal += re * re + im * im;
+        noise += dr * dr + di * di;
+    }
+    return 10.0 * ::log10(signal / noise);
+}
+
+double kissSnrDb(const fl::vector<i16> &x) {
+    const int n = static_cast<int>(x.size());
+    kiss_fftr_cfg cfg = kiss_fftr_alloc(n, 0, nullptr, nullptr);
+    fl::vector<kiss_fft_cpx> out(n / 2 + 1);
+    kiss_fftr(cfg, x.data(), out.data());
+    kiss_fftr_free(cfg);
+    return snrDb(x, reinterpret_cast<const i16 *>(out.data()));
+}
+
+} // namespace
+
+TEST_CASE("FFTQ15 - size support") {
+    CHECK(FFTQ15::supports(256));
+    CHECK(FFTQ15::supports(512));
+    CHECK(FFTQ15::supports(1024));
+    CHECK_FALSE(FFTQ15::supports(2048));
+    CHECK_FALSE(FFTQ15::supports(500));
+    CHECK_FALSE(FFTQ15(300).ok());
+    FFTQ15 fft(512);
+    CHECK(fft.ok());
+    CHECK_EQ(fft.outputSize(), 514u);
+}
+
+TEST_CASE("FFTQ15 - SNR against the float reference") {
+    const int sizes[] = {16, 32, 64, 128, 256, 512, 1024};
+    for (int n : sizes) {
+        const fl::vector<i16> x = makeSignal(n);
+        FFTQ15 fft(n);
+        fl::vector<i16> out(fft.outputSize());
+        fft.run(span<const i16>(x.data(), x.size()), out.data());
+        const double snr = snrDb(x, out.data());
+        const double kiss = kissSnrDb(x);
+        printf("FFTQ15 N=%d: SNR %.1f dB (kiss_fftr %.1f dB)\n", n, snr, kiss);
+        // Q15 with 1/N scaling loses ~3 dB per doubling; stay on par with
+        // kiss_fftr at every size.
+        CHECK_GT(snr, 50.0);
+        CHECK_GT(snr, kiss - 1.0);
+    }
+}
+
+TEST_CASE("FFTQ15 - pure tone lands in its bin") {
+    const int n = 256;
+    fl::vector<i16> x(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = static_cast<i16>(16000.0 * ::cos(2.0 * FL_PI * 10.0 * i / n));
+    }
+    FFTQ15 fft(n);
+    fl::vector<i16> out(fft.outputSize());
+    fft.run(span<const i16>(x.data(), x.size()), out.data());
+    // A cosine of amplitude A shows up as A / 2 in bin k
+    CHECK_LE(FL_ABS(out[2 * 10] - 8000), 4);
+    CHECK_LE(FL_ABS(out[2 * 10 + 1]), 4);
+    for (int k = 0; k <= n / 2; ++k) {
+        if (k != 10) {
+            CHECK_LE(FL_ABS(out[2 * k]), 4);
+            CHECK_LE(FL_ABS(out[2 * k + 1]), 4);
+        }
+    }
+}
+
+TEST_CASE("FFTQ15 - feeds the constant-Q bands like kiss_fftr") {
+    const int n = 512;
+    const fl::vector<i16> x = makeSignal(n);
+    FFT reference;
+    FFTBins expected(16);
+    reference.run(span<const i16>(x.data(), x.size()), &expected,
+                  FFT_Args(n, 16));
+
+    FFTQ15 fft(n);
+    FFTSpectrum spectrum;
+    spectrum.samples = n;
+    spectrum.bins.resize(fft.outputSize());
+    fft.run(span<const i16>(x.data(), x.size()), spectrum.bins.data());
+    FFTBins bins(16);
+    reference.bands(spectrum, &bins, FFT_Args(n, 16));
+
+    // Both spectra carry a few LSB of rounding noise, which dominates the
+    // quiet bands; loud bands agree to a few percent.
+    REQUIRE_EQ(bins.bins_raw.size(), expected.bins_raw.size());
+    for (fl::size i = 0; i < bins.bins_raw.size(); ++i) {
+        const float a = bins.bins_raw[i];
+        const float b = expected.bins_raw[i];
+        CHECK_LE(FL_ABS(a - b), 2.0f + 0.05f * b);
+    }
+}
+
+TEST_CASE("FFTQ15 - benchmark against kiss_fftr") {
+    const int sizes[] = {256, 512, 1024};
+    for (int n : sizes) {
+        const fl::vector<i16> x = makeSignal(n);
+        const int iterations = 200000 / n;
+        const span<const i16> in(x.data(), x.size());
+
+        FFTQ15 fft(n);
+        fl::vector<i16> out(fft.outputSize());
+        u32 start = micros();
+        for (int i = 0; i < iterations; ++i) {
+            fft.run(in, out.data());
+        }
+        const u32 q15Us = micros() - start;
+
+        kiss_fftr_cfg cfg = kiss_fftr_alloc(n, 0, nullptr, nullptr);
+        fl::vector<kiss_fft_cpx> kissOut(n / 2 + 1);
+        start = micros();
+        for (int i = 0; i < iterations; ++i) {
+            kiss_fftr(cfg, x.data(), kissOut.data());
+        }
+        const u32 kissUs = micros() - start;
+        kiss_fftr_free(cfg);
+
+        // The timed loops computed the same spectrum
+        for (int k = 0; k <= n / 2; ++k) {
+            CHECK_LE(FL_ABS(out[2 * k] - kissOut[k].r), 4);
+            CHECK_LE(FL_ABS(out[2 * k + 1] - kissOut[k].i), 4);
+        }
+        printf("FFT N=%d: Q15 %.0f blocks/s, kiss_fftr %.0f blocks/s\n", n,
+               q15Us ? iterations * 1e6 / q15Us : 0.0,
+               kissUs ? iterations * 1e6 / kissUs : 0.0);
+    }
+}
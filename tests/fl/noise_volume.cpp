@@ -0,0 +1,153 @@
+// Unit tests for NoiseVolume, the keyframed inoise16(x, y, t) cache
+
+#include "test.h"
+#include "fl/noise_volume.h"
+#include "fl/vector.h"
+#include "noise.h"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
+
+using fl::NoiseVolume;
+
+namespace {
+
+const fl::u16 kWidth = 24;
+const fl::u16 kHeight = 16;
+const fl::u32 kX = 0x3000;
+const fl::i32 kDx = 0x2100;
+const fl::u32 kY = 0x7FFF0000u;
+const fl::i32 kDy = -0x1900;
+
+// Largest difference between the cached field and direct evaluation
+int maxDeviation(NoiseVolume &volume, fl::u32 t) {
+    fl::vector<fl::u16> field(fl::u32(kWidth) * kHeight);
+    volume.sample(t, field.data());
+    int worst = 0;
+    for (fl::u16 j = 0; j < kHeight; ++j) {
+        for (fl::u16 i = 0; i < kWidth; ++i) {
+            const int direct = inoise16(kX + i * kDx, kY + j * kDy, t);
+            const int diff = int(field[j * kWidth + i]) - direct;
+            worst = FL_MAX(worst, diff < 0 ? -diff : diff);
+        }
+    }
+    return worst;
+}
+
+} // namespace
+
+TEST_CASE("NoiseVolume - interval grows with the error bound") {
+    CHECK_EQ(NoiseVolume::keyframeShiftFor(0), 0);
+    CHECK_EQ(NoiseVolume::keyframeShiftFor(8), 0);
+    fl::u8 previous = 0;
+    const fl::u16 bounds[] = {32, 64, 128, 256, 1024, 4096, 65535};
+    for (fl::u16 bound : bounds) {
+        const fl::u8 shift = NoiseVolume::keyframeShiftFor(bound);
+        CHECK_GE(shift, previous);
+        CHECK_LE(shift, 15);
+        previous = shift;
+    }
+    NoiseVolume volume(4, 4, 0, 1, 0, 1, 256);
+    CHECK_EQ(volume.keyframeInterval(),
+             fl::u32(1) << NoiseVolume::keyframeShiftFor(256));
+}
+
+TEST_CASE("NoiseVolume - stays within its error bound") {
+    const fl::u16 bounds[] = {32, 64, 256, 1024, 4096};
+    for (fl::u16 bound : bounds) {
+        NoiseVolume volume(kWidth, kHeight, kX, kDx, kY, kDy, bound);
+        int worst = 0;
+        // Uneven steps across many keyframes and noise cells
+        fl::u32 t = 0x12345;
+        for (int frame = 0; frame < 400; ++frame) {
+            worst = FL_MAX(worst, maxDeviation(volume, t));
+            t += 37 + (frame * 97) % 700;
+        }
+        // Across the wrap of t
+        t = 0xFFFFF000u;
+        for (int frame = 0; frame < 60; ++frame) {
+            worst = FL_MAX(worst, maxDeviation(volume, t));
+            t += 211;
+        }
+        printf("NoiseVolume maxError %u (interval %u): worst deviation %d\n",
+               unsigned(bound), unsigned(volume.keyframeInterval()), worst);
+        CHECK_LE(worst, int(bound));
+    }
+}
+
+TEST_CASE("NoiseVolume - jumps and rewinds") {
+    NoiseVolume volume(kWidth, kHeight, kX, kDx, kY, kDy, 128);
+    const fl::u32 times[] = {5000, 4000, 900000, 900001, 3, 0x80000000u, 7};
+    for (fl::u32 t : times) {
+        CHECK_LE(maxDeviation(volume, t), 128);
+    }
+    // Keyframes sit on multiples of the interval, so a sample doesn't
+    // depend on the history of the cache
+    NoiseVolume fresh(kWidth, kHeight, kX, kDx, kY, kDy, 128);
+    fl::vector<fl::u16> a(fl::u32(kWidth) * kHeight), b(a.size());
+    volume.sample(123456, a.data());
+    fresh.sample(123456, b.data());
+    CHECK(a == b);
+    // At a keyframe the cache is exact
+    const fl::u32 key = volume.keyframeInterval() * 40;
+    CHECK_EQ(maxDeviation(volume, key), 0);
+    // No cache at all below the rounding slack
+    volume.setMaxError(0);
+    CHECK_EQ(volume.keyframeInterval(), 1u);
+    CHECK_EQ(maxDeviation(volume, 777), 0);
+    CHECK_EQ(maxDeviation(volume, 778), 0);
+}
+
+TEST_CASE("NoiseVolume - 32x32 animated field benchmark") {
+    const fl::u16 w = 32, h = 32;
+    NoiseVolume volume(w, h, 0, 0x2000, 0, 0x2000, 256);
+    // A scene advancing t by an eighth of the interval per frame
+    const fl::u32 step = volume.keyframeInterval() / 8;
+    fl::vector<fl::u16> field(fl::u32(w) * h);
+    fl::vector<fl::u16> grid(field.size());
+    fl::vector<fl::u16> cached(field.size());
+    volatile fl::u32 sink = 0;
+    const int frames = 64;
+
+    fl::u32 t = 0;
+    fl::u32 start = micros();
+    for (int f = 0; f < frames; ++f, t += step) {
+        for (fl::u16 j = 0; j < h; ++j) {
+            for (fl::u16 i = 0; i < w; ++i) {
+                field[j * w + i] = inoise16(i * 0x2000, j * 0x2000, t);
+            }
+        }
+        sink = sink + field[f];
+    }
+    const double directUs = double(micros() - start) / frames;
+
+    t = 0;
+    start = micros();
+    for (int f = 0; f < frames; ++f, t += step) {
+        inoise16_grid(grid.data(), w, h, 0, 0x2000, 0, 0x2000, t);
+        sink = sink + grid[f];
+    }
+    const double gridUs = double(micros() - start) / frames;
+
+    t = 0;
+    volume.sample(t, cached.data());  // first keyframes
+    start = micros();
+    for (int f = 0; f < frames; ++f, t += step) {
+        volume.sample(t, cached.data());
+        sink = sink + cached[f];
+    }
+    const double cachedUs = double(micros() - start) / frames;
+    (void)sink;
+    printf("Noise field 32x32, us per frame: inoise16 %.1f, inoise16_grid %.1f, "
+           "NoiseVolume %.1f (%.1fx)\n",
+           directUs, gridUs, cachedUs, cachedUs > 0 ? directUs / cachedUs : 0.0);
+
+    // All three ended on the same frame
+    CHECK(grid == field);
+    int worst = 0;
+    for (fl::size i = 0; i < field.size(); ++i) {
+        const int diff = int(cached[i]) - int(field[i]);
+        worst = FL_MAX(worst, diff < 0 ? -diff : diff);
+    }
+    CHECK_LE(worst, 256);
+}
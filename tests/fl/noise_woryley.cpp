@@ -0,0 +1,147 @@
+// Unit tests for the Worley noise functions
+
+#include "test.h"
+#include "fl/noise_woryley.h"
+#include "fl/vector.h"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
+
+using fl::i32;
+using fl::u16;
+using fl::u32;
+
+namespace {
+
+struct Grid {
+    u16 width, height;
+    i32 x, dx, y, dy;
+};
+
+// Fine and coarse steps, both directions, across negative coordinates
+const Grid kGrids[] = {
+    {40, 30, 0, 2000, 0, 2500},
+    {17, 23, -200000, 9000, 150000, -7000},
+    {64, 8, 1000000, -40000, -1000000, 33000},
+    {5, 5, 12345, 0, 6789, 0},
+    {1, 50, 0, 100, -32768, 1500},
+};
+
+} // namespace
+
+TEST_CASE("WorleyGrid - F1 matches worley_noise_2d_q15") {
+    fl::WorleyGrid grid;
+    for (const Grid &g : kGrids) {
+        fl::vector<i32> f1(u32(g.width) * g.height);
+        grid.sample(f1.data(), nullptr, nullptr, g.width, g.height, g.x, g.dx,
+                    g.y, g.dy);
+        for (u16 j = 0; j < g.height; ++j) {
+            for (u16 i = 0; i < g.width; ++i) {
+                REQUIRE_EQ(f1[u32(j) * g.width + i],
+                           fl::worley_noise_2d_q15(g.x + i * g.dx, g.y + j * g.dy));
+            }
+        }
+    }
+}
+
+TEST_CASE("WorleyGrid - F2 and edge distance") {
+    fl::WorleyGrid grid;
+    const Grid &g = kGrids[0];
+    const u32 count = u32(g.width) * g.height;
+    fl::vector<i32> f1(count), f2(count), edge(count);
+    grid.sample(f1.data(), f2.data(), edge.data(), g.width, g.height, g.x,
+                g.dx, g.y, g.dy);
+    i32 minEdge = 0x7FFFFFFF;
+    for (u32 i = 0; i < count; ++i) {
+        CHECK_GE(f2[i], f1[i]);
+        // Normalizing halves the distances, rounding each one down
+        const i32 diff = f2[i] - f1[i];
+        CHECK_GE(edge[i], diff - 1);
+        CHECK_LE(edge[i], diff + 1);
+        minEdge = FL_MIN(minEdge, edge[i]);
+    }
+    // The grid spans several cells, so some points sit near a border
+    CHECK_LT(minEdge, 1000);
+
+    // Outputs don't depend on which others were asked for
+    fl::vector<i32> edgeOnly(count);
+    grid.sample(nullptr, nullptr, edgeOnly.data(), g.width, g.height, g.x,
+                g.dx, g.y, g.dy);
+    CHECK(edgeOnly == edge);
+
+    // Asking for nothing is a no-op
+    grid.sample(nullptr, nullptr, nullptr, g.width, g.height, g.x, g.dx, g.y,
+                g.dy);
+}
+
+TEST_CASE("WorleyGrid - row by row calls reuse the window") {
+    const Grid &g = kGrids[1];
+    const u32 count = u32(g.width) * g.height;
+    fl::vector<i32> whole(count), rows(count);
+    fl::WorleyGrid grid;
+    grid.sample(nullptr, whole.data(), nullptr, g.width, g.height, g.x, g.dx,
+                g.y, g.dy);
+    // Walking the rows backwards slides the window the other way
+    for (u16 j = g.height; j-- > 0;) {
+        grid.sample(nullptr, rows.data() + u32(j) * g.width, nullptr, g.width, 1,
+                    g.x, g.dx, g.y + j * g.dy, g.dy);
+    }
+    CHECK(rows == whole);
+}
+
+TEST_CASE("WorleyGrid - benchmark against per-pixel worley_noise_2d_q15") {
+    const u16 sizes[] = {64, 256};
+    volatile i32 sink = 0;
+    for (u16 size : sizes) {
+        // About 8 pixels per cell
+        const i32 step = 4096;
+        fl::vector<i32> out(u32(size) * size);
+        fl::WorleyGrid grid;
+        const int rounds = size == 64 ? 20 : 2;
+
+        u32 start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            u32 pos = 0;
+            for (u16 j = 0; j < size; ++j) {
+                for (u16 i = 0; i < size; ++i) {
+                    out[pos++] = fl::worley_noise_2d_q15(i * step, (j + r) * step);
+                }
+            }
+            sink = sink + out[r];
+        }
+        const double pixelMs = double(micros() - start) / rounds / 1000.0;
+
+        start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            grid.sample(out.data(), nullptr, nullptr, size, size, 0, step,
+                        r * step, step);
+            sink = sink + out[r];
+        }
+        const double gridMs = double(micros() - start) / rounds / 1000.0;
+
+        fl::vector<i32> f2(out.size()), edge(out.size());
+        start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            grid.sample(out.data(), f2.data(), edge.data(), size, size, 0, step,
+                        r * step, step);
+            sink = sink + edge[r];
+        }
+        const double allMs = double(micros() - start) / rounds / 1000.0;
+        printf("Worley %ux%u, ms per frame: per pixel %.3f, WorleyGrid F1 %.3f "
+               "(%.1fx), F1+F2+edge %.3f\n",
+               unsigned(size), unsigned(size), pixelMs, gridMs,
+               gridMs > 0 ? pixelMs / gridMs : 0.0, allMs);
+
+        // The last timed frame matches the per-pixel evaluator
+        const int r = rounds - 1;
+        bool same = true;
+        for (u16 j = 0; j < size; ++j) {
+            for (u16 i = 0; i < size; ++i) {
+                same = same && out[u32(j) * size + i] ==
+                                   fl::worley_noise_2d_q15(i * step, (j + r) * step);
+            }
+        }
+        CHECK_MESSAGE(same, size);
+    }
+    (void)sink;
+}
@@ -0,0 +1,277 @@
+// Unit tests for PanelLayout: panel geometry, controller ordering and the
+// XYMap / ScreenMap it compiles into
+
+#include "test.h"
+#include "FastLED.h"
+#include "fl/allocator.h"
+#include "fl/panel_layout.h"
+#include "fl/screenmap.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
+
+using fl::PanelLayout;
+
+namespace {
+
+// 64x32 wall of 16x16 serpentine panels. The top row is on controller 0,
+// wired left to right; the bottom row is on controller 1, mounted upside
+// down and wired right to left.
+PanelLayout wall() {
+    PanelLayout layout(16, 16);
+    for (fl::u16 col = 0; col < 4; ++col) {
+        PanelLayout::Panel panel(col * 16, 0);
+        layout.addPanel(panel);
+    }
+    for (fl::u16 col = 4; col-- > 0;) {
+        PanelLayout::Panel panel(col * 16, 16);
+        panel.rotation = PanelLayout::kRotate180;
+        panel.controller = 1;
+        layout.addPanel(panel);
+    }
+    return layout;
+}
+
+// The same wall written the way a sketch would without PanelLayout
+fl::u16 wall_function(fl::u16 x, fl::u16 y, fl::u16 width, fl::u16 height) {
+    (void)width;
+    (void)height;
+    const fl::u16 col = x / 16;
+    const fl::u16 row = y / 16;
+    fl::u16 lx = x % 16;
+    fl::u16 ly = y % 16;
+    fl::u16 chain = col;
+    if (row == 1) {
+        lx = 15 - lx;
+        ly = 15 - ly;
+        chain = 4 + (3 - col);
+    }
+    return chain * 256 + fl::xy_serpentine(lx, ly, 16, 16);
+}
+
+// Every rotation, mirroring and wiring, spread over three controllers
+PanelLayout mixedWall() {
+    PanelLayout layout(8, 8);
+    const PanelLayout::Rotation rotations[4] = {
+        PanelLayout::kRotate0, PanelLayout::kRotate90,
+        PanelLayout::kRotate180, PanelLayout::kRotate270};
+    for (fl::u16 i = 0; i < 8; ++i) {
+        PanelLayout::Panel panel((i % 4) * 8, (i / 4) * 8);
+        panel.rotation = rotations[i % 4];
+        panel.mirror = i >= 4;
+        panel.serpentine = (i % 3) != 0;
+        panel.controller = fl::u8((i * 5) % 3);
+        layout.addPanel(panel);
+    }
+    return layout;
+}
+
+class CountingMallocHook : public fl::MallocFreeHook {
+  public:
+    void onMalloc(void *ptr, fl::size size) override {
+        (void)ptr;
+        (void)size;
+        ++mallocs;
+    }
+    void onFree(void *ptr) override { (void)ptr; }
+    int mallocs = 0;
+};
+
+} // namespace
+
+TEST_CASE("PanelLayout - a single unrotated panel is a plain matrix") {
+    PanelLayout layout(5, 4);
+    layout.addPanel(PanelLayout::Panel());
+    CHECK_EQ(layout.width(), 5);
+    CHECK_EQ(layout.height(), 4);
+    CHECK(layout.isComplete());
+    fl::XYMap xy = layout.toXYMap();
+    for (fl::u16 y = 0; y < 4; ++y) {
+        for (fl::u16 x = 0; x < 5; ++x) {
+            CHECK_EQ(layout.mapToIndex(x, y), fl::xy_serpentine(x, y, 5, 4));
+            CHECK_EQ(xy.mapToIndex(x, y), fl::xy_serpentine(x, y, 5, 4));
+        }
+    }
+
+    PanelLayout linear(5, 4);
+    PanelLayout::Panel panel;
+    panel.serpentine = false;
+    linear.addPanel(panel);
+    CHECK_EQ(linear.mapToIndex(4, 3), fl::xy_line_by_line(4, 3, 5, 4));
+}
+
+TEST_CASE("PanelLayout - rotation and mirroring move the first LED") {
+    // 4 wide, 2 tall panel; LED 0 sits in its top-left corner
+    struct Expect {
+        PanelLayout::Rotation rotation;
+        bool mirror;
+        fl::u16 w, h;   // footprint on the wall
+        fl::u16 x, y;   // where LED 0 ends up
+    };
+    const Expect cases[] = {
+        {PanelLayout::kRotate0, false, 4, 2, 0, 0},
+        {PanelLayout::kRotate90, false, 2, 4, 1, 0},
+        {PanelLayout::kRotate180, false, 4, 2, 3, 1},
+        {PanelLayout::kRotate270, false, 2, 4, 0, 3},
+        {PanelLayout::kRotate0, true, 4, 2, 3, 0},
+        {PanelLayout::kRotate90, true, 2, 4, 0, 0},
+    };
+    for (const Expect &e : cases) {
+        PanelLayout layout(4, 2);
+        PanelLayout::Panel panel;
+        panel.rotation = e.rotation;
+        panel.mirror = e.mirror;
+        layout.addPanel(panel);
+        CHECK_EQ(layout.width(), e.w);
+        CHECK_EQ(layout.height(), e.h);
+        CHECK_EQ(layout.mapToIndex(e.x, e.y), 0);
+    }
+}
+
+TEST_CASE("PanelLayout - controllers own consecutive slices of the buffer") {
+    PanelLayout layout = wall();
+    CHECK_EQ(layout.controllerCount(), 2);
+    CHECK_EQ(layout.controllerOffset(0), 0u);
+    CHECK_EQ(layout.controllerLength(0), 1024u);
+    CHECK_EQ(layout.controllerOffset(1), 1024u);
+    CHECK_EQ(layout.controllerLength(1), 1024u);
+    CHECK_EQ(layout.ledCount(), 2048u);
+
+    // Controller 1's chain starts at the bottom-right panel, which is upside
+    // down, so its first LED is in the wall's bottom-right corner
+    CHECK_EQ(layout.mapToIndex(63, 31), 1024);
+    // Panels added out of controller order still chain per controller
+    PanelLayout interleaved(2, 2);
+    PanelLayout::Panel a(0, 0);
+    a.controller = 1;
+    PanelLayout::Panel b(2, 0);
+    PanelLayout::Panel c(4, 0);
+    c.controller = 1;
+    interleaved.addPanel(a);
+    interleaved.addPanel(b);
+    interleaved.addPanel(c);
+    CHECK_EQ(interleaved.mapToIndex(2, 0), 0);   // controller 0's only panel
+    CHECK_EQ(interleaved.mapToIndex(0, 0), 4);   // controller 1, first
+    CHECK_EQ(interleaved.mapToIndex(4, 0), 8);   // controller 1, second
+
+    // Panel bases are kept with the layout, so per-pixel lookups don't
+    // allocate
+    CountingMallocHook hook;
+    fl::SetMallocFreeHook(&hook);
+    fl::u32 sum = 0;
+    for (fl::u16 y = 0; y < layout.height(); ++y) {
+        for (fl::u16 x = 0; x < layout.width(); ++x) {
+            sum += layout.mapToIndex(x, y);
+        }
+    }
+    fl::ClearMallocFreeHook();
+    CHECK_EQ(hook.mallocs, 0);
+    CHECK_EQ(sum, 2047u * 2048u / 2);
+}
+
+TEST_CASE("PanelLayout - XYMap and ScreenMap round trip") {
+    const PanelLayout layouts[] = {wall(), mixedWall()};
+    for (const PanelLayout &layout : layouts) {
+        REQUIRE(layout.isComplete());
+        const fl::u16 w = layout.width();
+        const fl::u16 h = layout.height();
+        fl::XYMap xy = layout.toXYMap();
+        fl::ScreenMap screen = layout.toScreenMap();
+        REQUIRE_EQ(screen.getLength(), layout.ledCount());
+
+        fl::vector<int> hits(layout.ledCount(), 0);
+        for (fl::u16 y = 0; y < h; ++y) {
+            for (fl::u16 x = 0; x < w; ++x) {
+                const fl::u16 index = xy.mapToIndex(x, y);
+                REQUIRE_LT(index, layout.ledCount());
+                CHECK_EQ(index, layout.mapToIndex(x, y));
+                ++hits[index];
+                // LED -> position -> LED
+                const fl::vec2f p = screen[index];
+                CHECK_EQ(p.x, float(x));
+                CHECK_EQ(p.y, float(y));
+            }
+        }
+        for (fl::u32 i = 0; i < layout.ledCount(); ++i) {
+            CHECK_EQ(hits[i], 1);
+        }
+
+        // The bulk paths agree with the per-pixel mapping
+        fl::vector<CRGB> leds(layout.ledCount());
+        for (fl::u32 i = 0; i < leds.size(); ++i) {
+            leds[i] = CRGB(fl::u8(i), fl::u8(i >> 8), 7);
+        }
+        fl::vector<CRGB> grid(fl::u32(w) * h);
+        xy.gather(leds.data(), grid.data());
+        for (fl::u16 y = 0; y < h; ++y) {
+            for (fl::u16 x = 0; x < w; ++x) {
+                CHECK(grid[fl::u32(y) * w + x] == leds[layout.mapToIndex(x, y)]);
+            }
+        }
+        fl::vector<CRGB> back(leds.size());
+        xy.scatter(grid.data(), back.data());
+        CHECK(back == leds);
+    }
+    // Serpentine panels in a row compile to runs
+    CHECK(wall().toXYMap().isCompiled());
+}
+
+TEST_CASE("PanelLayout - positions no panel covers map past the end") {
+    PanelLayout layout(2, 2);
+    layout.addPanel(PanelLayout::Panel(0, 0));
+    layout.addPanel(PanelLayout::Panel(4, 2));
+    CHECK_FALSE(layout.isComplete());
+    CHECK_EQ(layout.width(), 6);
+    CHECK_EQ(layout.height(), 4);
+    CHECK_EQ(layout.mapToIndex(3, 0), layout.ledCount());
+    CHECK_EQ(layout.toXYMap().mapToIndex(3, 0), layout.ledCount());
+    CHECK_EQ(layout.toXYMap().indexEnd(), layout.ledCount() + 1);
+
+    PanelLayout overlapping(2, 2);
+    overlapping.addPanel(PanelLayout::Panel(0, 0));
+    overlapping.addPanel(PanelLayout::Panel(1, 0));
+    overlapping.addPanel(PanelLayout::Panel(0, 2));
+    CHECK_FALSE(overlapping.isComplete());
+}
+
+TEST_CASE("PanelLayout - compiled wall vs user-function XYMap benchmark") {
+    PanelLayout layout = wall();
+    const fl::u16 w = layout.width();
+    const fl::u16 h = layout.height();
+    fl::XYMap compiled = layout.toXYMap();
+    fl::XYMap function = fl::XYMap::constructWithUserFunction(w, h, wall_function);
+    for (fl::u16 y = 0; y < h; ++y) {
+        for (fl::u16 x = 0; x < w; ++x) {
+            REQUIRE_EQ(function.mapToIndex(x, y), compiled.mapToIndex(x, y));
+        }
+    }
+
+    fl::vector<CRGB> leds(layout.ledCount());
+    for (fl::u32 i = 0; i < leds.size(); ++i) {
+        leds[i] = CRGB(fl::u8(i), fl::u8(i * 3), fl::u8(i * 7));
+    }
+    fl::vector<CRGB> grid(fl::u32(w) * h);
+    const int rounds = 200;
+    fl::u32 start = micros();
+    for (int r = 0; r < rounds; ++r) {
+        fl::u32 pos = 0;
+        for (fl::u16 y = 0; y < h; ++y) {
+            for (fl::u16 x = 0; x < w; ++x) {
+                grid[pos++] = leds[function.mapToIndex(x, y)];
+            }
+        }
+    }
+    const double functionMs = double(micros() - start) / rounds / 1000.0;
+    const fl::vector<CRGB> expected = grid;
+    fl::fill(grid.begin(), grid.end(), CRGB::Black);
+    start = micros();
+    for (int r = 0; r < rounds; ++r) {
+        compiled.gather(leds.data(), grid.data());
+    }
+    const double compiledMs = double(micros() - start) / rounds / 1000.0;
+    printf("PanelLayout 64x32 wall, ms per frame: user function %.4f, "
+           "compiled layout %.4f\n", functionMs, compiledMs);
+    CHECK(grid == expected);
+}
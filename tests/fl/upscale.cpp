@@ -0,0 +1,141 @@
+// Unit tests for the bilinear upscalers
+
+#include "test.h"
+#include "FastLED.h"
+#include "fl/upscale.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
+
+namespace {
+
+fl::vector<CRGB> testImage(fl::u16 width, fl::u16 height, fl::u8 seed) {
+    fl::vector<CRGB> image(fl::u32(width) * height);
+    fl::u32 state = 2463534242u + seed;
+    for (fl::u32 i = 0; i < image.size(); ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        image[i] = CRGB(fl::u8(state), fl::u8(state >> 8), fl::u8(state >> 16));
+    }
+    return image;
+}
+
+fl::u16 xy_column_major(fl::u16 x, fl::u16 y, fl::u16 width, fl::u16 height) {
+    (void)width;
+    return x * height + y;
+}
+
+fl::u16 xy_mirrored(fl::u16 x, fl::u16 y, fl::u16 width, fl::u16 height) {
+    (void)height;
+    return y * width + (width - 1 - x);
+}
+
+} // namespace
+
+TEST_CASE("BilinearUpscaler - matches upscaleRectangular exactly") {
+    const fl::u16 sizes[][4] = {
+        {4, 4, 16, 16}, {3, 5, 17, 11}, {8, 2, 9, 64}, {16, 16, 16, 16},
+        {5, 7, 40, 3},
+    };
+    fl::BilinearUpscaler upscaler;
+    for (const auto &s : sizes) {
+        const fl::vector<CRGB> input = testImage(s[0], s[1], fl::u8(s[2]));
+        fl::vector<CRGB> expected(fl::u32(s[2]) * s[3]);
+        fl::vector<CRGB> actual(expected.size());
+        fl::upscaleRectangular(input.data(), expected.data(), s[0], s[1], s[2], s[3]);
+        upscaler.upscale(input.data(), actual.data(), s[0], s[1], s[2], s[3]);
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("BilinearUpscaler - matches upscaleArbitrary through any XYMap") {
+    fl::vector<fl::u16> lut(20 * 12);
+    for (fl::u16 i = 0; i < lut.size(); ++i) {
+        lut[i] = fl::u16((i * 7) % lut.size());
+    }
+    const fl::XYMap maps[] = {
+        fl::XYMap::constructRectangularGrid(20, 12),
+        fl::XYMap::constructSerpentine(20, 12),
+        fl::XYMap::constructWithUserFunction(20, 12, xy_column_major),
+        fl::XYMap::constructWithLookUpTable(20, 12, lut.data()),
+        // Offsets push part of the map past getTotal(), which is clipped
+        fl::XYMap::constructSerpentine(20, 12, 5),
+    };
+    const fl::vector<CRGB> input = testImage(6, 5, 1);
+    for (const fl::XYMap &map : maps) {
+        fl::BilinearUpscaler upscaler;
+        fl::vector<CRGB> expected(map.getTotal(), CRGB::Black);
+        fl::vector<CRGB> actual(map.getTotal(), CRGB::Black);
+        fl::upscaleArbitrary(input.data(), expected.data(), 6, 5, map);
+        upscaler.upscale(input.data(), actual.data(), 6, 5, map);
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("BilinearUpscaler - tables follow size changes between frames") {
+    fl::BilinearUpscaler upscaler;
+    fl::XYMap map = fl::XYMap::constructSerpentine(24, 24);
+    const fl::u16 inputSizes[] = {6, 6, 8, 3, 8};
+    for (fl::u16 in : inputSizes) {
+        const fl::vector<CRGB> input = testImage(in, in, fl::u8(in));
+        fl::vector<CRGB> expected(map.getTotal());
+        fl::vector<CRGB> actual(map.getTotal());
+        fl::upscaleArbitrary(input.data(), expected.data(), in, in, map);
+        upscaler.upscale(input.data(), actual.data(), in, in, map);
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("BilinearUpscaler - tables follow maps of the same size") {
+    fl::vector<fl::u16> lutA(4 * 4), lutB(4 * 4);
+    for (fl::u16 i = 0; i < lutA.size(); ++i) {
+        lutA[i] = fl::u16((i * 3) % lutA.size());
+        lutB[i] = fl::u16(lutA.size() - 1 - i);
+    }
+    const fl::XYMap maps[] = {
+        fl::XYMap::constructWithUserFunction(4, 4, xy_column_major),
+        fl::XYMap::constructWithUserFunction(4, 4, xy_mirrored),
+        fl::XYMap::constructWithLookUpTable(4, 4, lutA.data()),
+        fl::XYMap::constructWithLookUpTable(4, 4, lutB.data()),
+        fl::XYMap::constructWithUserFunction(4, 4, xy_column_major, 2),
+    };
+    const fl::vector<CRGB> input = testImage(3, 3, 4);
+    fl::BilinearUpscaler upscaler;
+    for (int round = 0; round < 2; ++round) {
+        for (const fl::XYMap &map : maps) {
+            fl::vector<CRGB> expected(map.getTotal(), CRGB::Black);
+            fl::vector<CRGB> actual(map.getTotal(), CRGB::Black);
+            fl::upscaleArbitrary(input.data(), expected.data(), 3, 3, map);
+            upscaler.upscale(input.data(), actual.data(), 3, 3, map);
+            CHECK(actual == expected);
+        }
+    }
+}
+
+TEST_CASE("BilinearUpscaler - 32x32 to 128x128 serpentine benchmark") {
+    const fl::XYMap map = fl::XYMap::constructSerpentine(128, 128);
+    const fl::vector<CRGB> input = testImage(32, 32, 9);
+    fl::vector<CRGB> output(fl::u32(128) * 128);
+    fl::BilinearUpscaler upscaler;
+    upscaler.upscale(input.data(), output.data(), 32, 32, map);  // build tables
+
+    const int rounds = 20;
+    fl::u32 start = micros();
+    for (int r = 0; r < rounds; ++r) {
+        fl::upscaleArbitrary(input.data(), output.data(), 32, 32, map);
+    }
+    const double perPixelMs = double(micros() - start) / rounds / 1000.0;
+    const fl::vector<CRGB> expected = output;
+    fl::fill(output.begin(), output.end(), CRGB::Black);
+    start = micros();
+    for (int r = 0; r < rounds; ++r) {
+        upscaler.upscale(input.data(), output.data(), 32, 32, map);
+    }
+    const double tableMs = double(micros() - start) / rounds / 1000.0;
+    printf("Upscale 32x32 -> 128x128, ms per frame: upscaleArbitrary %.3f, "
+           "BilinearUpscaler %.3f\n", perPixelMs, tableMs);
+    CHECK(output == expected);
+}
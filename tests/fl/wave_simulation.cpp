@@ -0,0 +1,458 @@
+// Unit tests for the 2D wave simulation stepping
+
+#include "test.h"
+#include "fl/vector.h"
+#include "fl/wave_simulation.h"
+#include "fl/wave_simulation_real.h"
+#include "platforms/stub/time_stub.h"
+
+using fl::i16;
+using fl::i32;
+using fl::u32;
+
+namespace {
+
+// The original single-step scalar update, kept as the reference
+struct ReferenceWave {
+    u32 width, height, stride;
+    fl::vector<i16> grid[2];
+    int which = 0;
+    i16 courantSq;
+    int dampening;
+    bool halfDuplex;
+    bool cylindrical;
+
+    ReferenceWave(u32 w, u32 h, i16 c, int d, bool half, bool cyl)
+        : width(w), height(h), stride(w + 2), courantSq(c), dampening(d),
+          halfDuplex(half), cylindrical(cyl) {
+        grid[0].resize((w + 2) * (h + 2), 0);
+        grid[1].resize((w + 2) * (h + 2), 0);
+    }
+
+    void update() {
+        i16 *curr = grid[which].data();
+        i16 *next = grid[which ^ 1].data();
+        for (u32 j = 0; j < height + 2; ++j) {
+            if (cylindrical) {
+                curr[j * stride + 0] = curr[j * stride + width];
+                curr[j * stride + (width + 1)] = curr[j * stride + 1];
+            } else {
+                curr[j * stride + 0] = curr[j * stride + 1];
+                curr[j * stride + (width + 1)] = curr[j * stride + width];
+            }
+        }
+        for (u32 i = 0; i < width + 2; ++i) {
+            curr[0 * stride + i] = curr[1 * stride + i];
+            curr[(height + 1) * stride + i] = curr[height * stride + i];
+        }
+        const i32 factor = 1 << dampening;
+        for (u32 j = 1; j <= height; ++j) {
+            for (u32 i = 1; i <= width; ++i) {
+                const u32 index = j * stride + i;
+                const i32 laplacian = (i32)curr[index + 1] + curr[index - 1] +
+                                      curr[index + stride] + curr[index - stride] -
+                                      ((i32)curr[index] << 2);
+                // Wrapping product, as the simulation computes it
+                const i32 term = i32(u32(i32(courantSq)) * u32(laplacian)) >> 15;
+                i32 f = -(i32)next[index] + ((i32)curr[index] << 1) + term;
+                f = f - (f / factor);
+                if (f > 32767)
+                    f = 32767;
+                else if (f < -32768)
+                    f = -32768;
+                next[index] = (i16)f;
+            }
+        }
+        if (halfDuplex) {
+            for (u32 j = 1; j <= height; ++j) {
+                for (u32 i = 1; i <= width; ++i) {
+                    if (next[j * stride + i] < 0) {
+                        next[j * stride + i] = 0;
+                    }
+                }
+            }
+        }
+        which ^= 1;
+    }
+
+    i16 curr(u32 x, u32 y) const { return grid[which][(y + 1) * stride + x + 1]; }
+    i16 prev(u32 x, u32 y) const { return grid[which ^ 1][(y + 1) * stride + x + 1]; }
+};
+
+fl::u32 gState = 12345;
+i16 randomI16() {
+    gState ^= gState << 13;
+    gState ^= gState >> 17;
+    gState ^= gState << 5;
+    return i16(gState);
+}
+
+struct Config {
+    u32 width, height;
+    float speed;
+    int dampening;
+    bool halfDuplex;
+    bool cylindrical;
+};
+
+const Config kConfigs[] = {
+    {37, 23, 0.16f, 6, true, false},  {16, 16, 0.5f, 3, false, false},
+    {9, 31, 1.0f, 0, false, true},    {64, 5, -0.7f, 10, true, true},
+    {1, 1, 0.3f, 6, false, false},    {3, 40, 0.9f, 1, false, false},
+};
+
+// Steps `sim` and the reference side by side from the same random field
+void checkAgainstReference(const Config &c, fl::u8 threads, u32 steps) {
+    fl::WaveSimulation2D_Real sim(c.width, c.height, c.speed, float(c.dampening));
+    sim.setHalfDuplex(c.halfDuplex);
+    sim.setXCylindrical(c.cylindrical);
+    sim.setThreads(threads);
+    ReferenceWave ref(c.width, c.height, fl::wave_detail::float_to_fixed(c.speed),
+                      c.dampening, c.halfDuplex, c.cylindrical);
+    for (int pass = 0; pass < 3; ++pass) {
+        // Full-scale noise saturates and wraps the Q15 products
+        for (u32 y = 0; y < c.height; ++y) {
+            for (u32 x = 0; x < c.width; ++x) {
+                if (pass == 0 || (randomI16() & 7) == 0) {
+                    const i16 v = randomI16();
+                    sim.seti16(x, y, v);
+                    ref.grid[ref.which][(y + 1) * ref.stride + x + 1] = v;
+                }
+            }
+        }
+        sim.update(steps);
+        for (u32 s = 0; s < steps; ++s) {
+            ref.update();
+        }
+        for (u32 y = 0; y < c.height; ++y) {
+            for (u32 x = 0; x < c.width; ++x) {
+                REQUIRE_EQ(sim.geti16(x, y), ref.curr(x, y));
+                REQUIRE_EQ(sim.geti16Previous(x, y), ref.prev(x, y));
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("WaveSimulation2D_Real - update matches the scalar stencil") {
+    for (const Config &c : kConfigs) {
+        checkAgainstReference(c, 1, 1);
+    }
+}
+
+TEST_CASE("WaveSimulation2D_Real - fused steps match single steps") {
+    const u32 steps[] = {2, 3, 4, 8, 50};
+    for (const Config &c : kConfigs) {
+        for (u32 s : steps) {
+            checkAgainstReference(c, 1, s);
+        }
+    }
+}
+
+TEST_CASE("WaveSimulation2D_Real - row bands on several threads") {
+    for (const Config &c : kConfigs) {
+        checkAgainstReference(c, 3, 1);
+        checkAgainstReference(c, 4, 5);
+    }
+}
+
+TEST_CASE("WaveSimulation2D - extra frames use fused steps") {
+    fl::WaveSimulation2D wave(32, 32, fl::SuperSample::SUPER_SAMPLE_4X);
+    fl::WaveSimulation2D_Real single(128, 128);
+    wave.setf(10, 10, 1.0f);
+    single.seti16(40, 40, wave.real().geti16(40, 40));
+    for (u32 y = 0; y < 4; ++y) {
+        for (u32 x = 0; x < 4; ++x) {
+            single.seti16(40 + x, 40 + y, wave.real().geti16(40 + x, 40 + y));
+        }
+    }
+    for (int frame = 0; frame < 10; ++frame) {
+        wave.update();
+        for (int s = 0; s < 4; ++s) {
+            single.update();
+        }
+    }
+    for (u32 y = 0; y < 128; ++y) {
+        for (u32 x = 0; x < 128; ++x) {
+            REQUIRE_EQ(wave.real().geti16(x, y), single.geti16(x, y));
+        }
+    }
+}
+
+namespace {
+
+// Drops a few small ripples on `a` and `b` alike, leaving most tiles empty
+void dropRipples(fl::WaveSimulation2D_Real &a, fl::WaveSimulation2D_Real &b,
+                 u32 width, u32 height, int count) {
+    for (int n = 0; n < count; ++n) {
+        const u32 cx = u32(randomI16() & 0x7FFF) % width;
+        const u32 cy = u32(randomI16() & 0x7FFF) % height;
+        for (u32 y = cy; y < FL_MIN(cy + 3, height); ++y) {
+            for (u32 x = cx; x < FL_MIN(cx + 3, width); ++x) {
+                const i16 v = randomI16();
+                a.seti16(x, y, v);
+                b.seti16(x, y, v);
+            }
+        }
+    }
+}
+
+void checkTracked(const Config &c, fl::u8 threads, u32 steps) {
+    fl::WaveSimulation2D_Real dense(c.width, c.height, c.speed,
+                                    float(c.dampening));
+    fl::WaveSimulation2D_Real sparse(c.width, c.height, c.speed,
+                                     float(c.dampening));
+    dense.setHalfDuplex(c.halfDuplex);
+    sparse.setHalfDuplex(c.halfDuplex);
+    dense.setXCylindrical(c.cylindrical);
+    sparse.setXCylindrical(c.cylindrical);
+    sparse.setThreads(threads);
+    // Values set before tracking starts are picked up by its scan
+    dropRipples(dense, sparse, c.width, c.height, 1);
+    sparse.setActiveTracking(true);
+    for (int pass = 0; pass < 6; ++pass) {
+        if (pass % 2 == 0) {
+            dropRipples(dense, sparse, c.width, c.height, 2);
+        }
+        dense.update(steps);
+        sparse.update(steps);
+        for (u32 y = 0; y < c.height; ++y) {
+            for (u32 x = 0; x < c.width; ++x) {
+                REQUIRE_EQ(sparse.geti16(x, y), dense.geti16(x, y));
+                REQUIRE_EQ(sparse.geti16Previous(x, y), dense.geti16Previous(x, y));
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("WaveSimulation2D_Real - active tracking matches the dense update") {
+    const Config configs[] = {
+        {100, 70, 0.16f, 6, true, false}, {90, 50, 0.5f, 3, false, true},
+        {33, 17, 1.0f, 0, false, true},   {200, 9, -0.7f, 10, true, false},
+    };
+    for (const Config &c : configs) {
+        checkTracked(c, 1, 1);
+        checkTracked(c, 1, 7);
+        checkTracked(c, 3, 4);
+    }
+    for (const Config &c : kConfigs) {
+        checkTracked(c, 1, 3);
+    }
+}
+
+TEST_CASE("WaveSimulation2D_Real - ripples wake tiles and quiet tiles sleep") {
+    const u32 size = 128;
+    fl::WaveSimulation2D_Real sim(size, size, 0.5f, 3);
+    sim.setActiveTracking(true);
+    sim.update();
+    CHECK_EQ(sim.getActiveFraction(), 0.0f);
+    sim.seti16(60, 60, 20000);
+    sim.update();
+    // The tile and its four neighbours
+    const float tile = 1.0f / ((size / 16) * (size / 16));
+    CHECK_EQ(sim.getActiveFraction(), 5 * tile);
+    sim.update(20);
+    const float spread = sim.getActiveFraction();
+    CHECK_GT(spread, 5 * tile);
+
+    // Truncating dampening leaves small values ringing forever, so only a
+    // sleep threshold lets the tiles settle
+    sim.setSleepThreshold(256);
+    sim.update(400);
+    CHECK_LT(sim.getActiveFraction(), spread);
+    sim.update(2000);
+    CHECK_EQ(sim.getActiveFraction(), 0.0f);
+    for (u32 y = 0; y < size; ++y) {
+        for (u32 x = 0; x < size; ++x) {
+            REQUIRE_EQ(sim.geti16(x, y), 0);
+        }
+    }
+    // A new ripple wakes them again
+    sim.seti16(5, 100, 20000);
+    sim.update();
+    CHECK_GT(sim.getActiveFraction(), 0.0f);
+    CHECK_NE(sim.geti16(5, 100), 0);
+}
+
+TEST_CASE("WaveSimulation2D_Real - tiles that reach zero sleep without a threshold") {
+    // Half duplex clamps the falling half of a ripple to exact zero
+    fl::WaveSimulation2D_Real sim(64, 16);
+    sim.setActiveTracking(true);
+    for (u32 y = 0; y < 16; ++y) {
+        for (u32 x = 0; x < 64; ++x) {
+            sim.seti16(x, y, 1000);
+        }
+    }
+    sim.update();
+    CHECK_EQ(sim.getActiveFraction(), 1.0f);
+    for (u32 y = 0; y < 16; ++y) {
+        for (u32 x = 0; x < 64; ++x) {
+            sim.seti16(x, y, 0);
+        }
+    }
+    // Clear the other grid as well
+    sim.update();
+    for (u32 y = 0; y < 16; ++y) {
+        for (u32 x = 0; x < 64; ++x) {
+            sim.seti16(x, y, 0);
+        }
+    }
+    sim.update();
+    sim.update();
+    CHECK_EQ(sim.getActiveFraction(), 0.0f);
+
+    // A ripple in a big run of tiles that dies out on its own
+    fl::WaveSimulation2D_Real decay(64, 16, 0.16f, 1);
+    decay.setActiveTracking(true);
+    decay.seti16(30, 8, 40);
+    int steps = 0;
+    while (decay.getActiveFraction() > 0.0f && steps < 500) {
+        decay.update();
+        ++steps;
+    }
+    CHECK_LT(steps, 500);
+    CHECK_EQ(decay.getSleepThreshold(), 0);
+}
+
+TEST_CASE("WaveSimulation1D_Real - active tracking matches the dense update") {
+    const u32 length = 1000;
+    fl::WaveSimulation1D_Real dense(length, 0.3f, 2);
+    fl::WaveSimulation1D_Real sparse(length, 0.3f, 2);
+    dense.setHalfDuplex(false);
+    sparse.setHalfDuplex(false);
+    sparse.setActiveTracking(true);
+    for (int pass = 0; pass < 8; ++pass) {
+        const u32 x = u32(randomI16() & 0x7FFF) % length;
+        dense.set(x, 0.8f);
+        sparse.set(x, 0.8f);
+        for (int s = 0; s < 25; ++s) {
+            dense.update();
+            sparse.update();
+        }
+        CHECK_LE(sparse.getActiveFraction(), 1.0f);
+        for (u32 i = 0; i < length; ++i) {
+            REQUIRE_EQ(sparse.geti16(i), dense.geti16(i));
+            REQUIRE_EQ(sparse.geti16Previous(i), dense.geti16Previous(i));
+        }
+    }
+    // Edges, where the Neumann border feeds the first and last segments
+    dense.set(0, -0.5f);
+    sparse.set(0, -0.5f);
+    dense.set(length - 1, 0.5f);
+    sparse.set(length - 1, 0.5f);
+    for (int s = 0; s < 40; ++s) {
+        dense.update();
+        sparse.update();
+    }
+    for (u32 i = 0; i < length; ++i) {
+        REQUIRE_EQ(sparse.geti16(i), dense.geti16(i));
+    }
+
+    fl::WaveSimulation1D_Real quiet(length, 0.3f, 2);
+    quiet.setActiveTracking(true);
+    quiet.setSleepThreshold(128);
+    quiet.set(500, 1.0f);
+    quiet.update();
+    CHECK_LT(quiet.getActiveFraction(), 0.5f);
+    for (int s = 0; s < 3000; ++s) {
+        quiet.update();
+    }
+    CHECK_EQ(quiet.getActiveFraction(), 0.0f);
+}
+
+TEST_CASE("WaveSimulation2D - active tracking survives init") {
+    fl::WaveSimulation2D wave(32, 32, fl::SuperSample::SUPER_SAMPLE_2X);
+    wave.setActiveTracking(true);
+    wave.setSuperSample(fl::SuperSample::SUPER_SAMPLE_4X);
+    CHECK(wave.real().getActiveTracking());
+    wave.setf(3, 3, 1.0f);
+    wave.update();
+    CHECK_GT(wave.real().getActiveFraction(), 0.0f);
+    CHECK_LT(wave.real().getActiveFraction(), 0.5f);
+
+    fl::WaveSimulation1D line(64, fl::SuperSample::SUPER_SAMPLE_2X);
+    line.setActiveTracking(true);
+    line.setSuperSample(fl::SuperSample::SUPER_SAMPLE_8X);
+    CHECK(line.real().getActiveTracking());
+}
+
+TEST_CASE("WaveSimulation2D_Real - active tracking benchmark") {
+    const u32 size = 256;
+    const u32 steps = 4;
+    const int rounds = 5;
+    // Side of the rippling square, as a share of the grid side
+    const float sides[] = {0.22f, 0.5f, 0.71f, 1.0f};
+    for (float side : sides) {
+        const u32 extent = u32(side * size);
+        fl::WaveSimulation2D_Real dense(size, size);
+        fl::WaveSimulation2D_Real sparse(size, size);
+        sparse.setActiveTracking(true);
+        for (u32 y = 0; y < extent; y += 3) {
+            for (u32 x = 0; x < extent; x += 3) {
+                const i16 v = i16(randomI16() & 0x3FFF);
+                dense.seti16(x, y, v);
+                sparse.seti16(x, y, v);
+            }
+        }
+        fl::u32 start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            dense.update(steps);
+        }
+        const double denseMs = double(micros() - start) / (rounds * steps) / 1000.0;
+        start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            sparse.update(steps);
+        }
+        const double sparseMs =
+            double(micros() - start) / (rounds * steps) / 1000.0;
+        MESSAGE("Wave 256x256, " << sparse.getActiveFraction() * 100.0f
+                << "% of tiles active, ms per step: dense " << denseMs
+                << ", tracked " << sparseMs);
+        for (u32 y = 0; y < size; y += 17) {
+            for (u32 x = 0; x < size; x += 13) {
+                REQUIRE_EQ(sparse.geti16(x, y), dense.geti16(x, y));
+            }
+        }
+    }
+}
+
+TEST_CASE("WaveSimulation2D_Real - 256x256 stepping benchmark") {
+    const u32 size = 256;
+    const u32 steps = 4;
+    const int rounds = 5;
+    fl::WaveSimulation2D_Real sim(size, size);
+    ReferenceWave ref(size, size, fl::wave_detail::float_to_fixed(0.16f), 6, true,
+                      false);
+    for (u32 y = 0; y < size; y += 7) {
+        for (u32 x = 0; x < size; x += 5) {
+            const i16 v = i16(randomI16() & 0x3FFF);
+            sim.seti16(x, y, v);
+            ref.grid[0][(y + 1) * ref.stride + x + 1] = v;
+        }
+    }
+
+    fl::u32 start = micros();
+    for (int r = 0; r < rounds; ++r) {
+        for (u32 s = 0; s < steps; ++s) {
+            ref.update();
+        }
+    }
+    const double scalarMs = double(micros() - start) / rounds / 1000.0;
+    start = micros();
+    for (int r = 0; r < rounds; ++r) {
+        for (u32 s = 0; s < steps; ++s) {
+            sim.update();
+        }
+    }
+    const double rowMs = double(micros() - start) / rounds / 1000.0;
+    start = micros();
+    for (int r = 0; r < rounds; ++r) {
+        sim.update(steps);
+    }
+    const double fusedMs = double(micros() - start) / rounds / 1000.0;
+    MESSAGE("Wave 256x256, " << steps << " steps, ms per frame: scalar "
+            << scalarMs << ", vector rows " << rowMs << ", fused " << fusedMs);
+}
@@ -2,6 +2,11 @@
 
 #include "test.h"
 #include "FastLED.h"
+#include "fl/vector.h"
+#include "fl/xymap.h"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
 
 
 namespace {
@@ -175,3 +180,124 @@ TEST_CASE("XYMap - composing two 4x3 serpentine segments into a 4x6 matrix") {
         }
     }
 }
+
+namespace {
+
+fl::u16 xy_serpentine_function(fl::u16 x, fl::u16 y, fl::u16 width, fl::u16 height) {
+    return fl::xy_serpentine(x, y, width, height);
+}
+
+// The layouts every bulk remap is checked against, all 128 x 128 except
+// for the odd-sized one
+struct RemapCase {
+    const char* name;
+    fl::XYMap map;
+};
+
+// Columns wired top to bottom and back up, a common panel layout that
+// needs a look-up table
+void fill_vertical_serpentine_lut(fl::u16* out, fl::u16 width, fl::u16 height) {
+    for (fl::u16 y = 0; y < height; ++y) {
+        for (fl::u16 x = 0; x < width; ++x) {
+            const fl::u16 yy = (x & 1) ? fl::u16(height - 1 - y) : y;
+            out[y * width + x] = fl::u16(x * height + yy);
+        }
+    }
+}
+
+fl::vector<RemapCase> remapCases(fl::vector<fl::u16>* lutStorage, fl::u16 w, fl::u16 h) {
+    lutStorage->resize(w * h);
+    fill_vertical_serpentine_lut(lutStorage->data(), w, h);
+    fl::vector<RemapCase> cases;
+    cases.push_back({"line-by-line", fl::XYMap::constructRectangularGrid(w, h, 3)});
+    cases.push_back({"serpentine", fl::XYMap::constructSerpentine(w, h, 3)});
+    cases.push_back({"function", fl::XYMap::constructWithUserFunction(w, h, xy_serpentine_function, 3)});
+    cases.push_back({"LUT", fl::XYMap::constructWithLookUpTable(w, h, lutStorage->data(), 3)});
+    fl::XYMap compiledFunction = fl::XYMap::constructWithUserFunction(w, h, xy_serpentine_function, 3);
+    compiledFunction.compile();
+    cases.push_back({"function, compiled", compiledFunction});
+    fl::XYMap compiledLut = fl::XYMap::constructWithLookUpTable(w, h, lutStorage->data(), 3);
+    compiledLut.compile();
+    cases.push_back({"LUT, compiled", compiledLut});
+    return cases;
+}
+
+fl::vector<CRGB> numberedLeds(fl::size n) {
+    fl::vector<CRGB> leds(n);
+    for (fl::size i = 0; i < n; ++i) {
+        leds[i] = CRGB(fl::u8(i), fl::u8(i >> 8), fl::u8(i * 7));
+    }
+    return leds;
+}
+
+} // namespace
+
+TEST_CASE("XYMap - gather and scatter match mapToIndex for every layout") {
+    for (fl::u16 w : {7, 128}) {
+        const fl::u16 h = w == 7 ? 5 : 128;
+        fl::vector<fl::u16> lut;
+        const fl::vector<RemapCase> cases = remapCases(&lut, w, h);
+        for (const RemapCase& c : cases) {
+            const fl::u32 total = fl::u32(w) * h;
+            CHECK_EQ(c.map.indexEnd(), total + 3);
+            const fl::vector<CRGB> leds = numberedLeds(total + 3);
+            fl::vector<CRGB> grid(total);
+            c.map.gather(leds.data(), grid.data());
+            bool gathered = true;
+            for (fl::u16 y = 0; y < h; ++y) {
+                for (fl::u16 x = 0; x < w; ++x) {
+                    gathered = gathered && grid[y * w + x] == leds[c.map.mapToIndex(x, y)];
+                }
+            }
+            CHECK_MESSAGE(gathered, c.name);
+
+            fl::vector<CRGB> back(total + 3, CRGB::Black);
+            c.map.scatter(grid.data(), back.data());
+            bool scattered = true;
+            for (fl::u32 i = 3; i < total + 3; ++i) {
+                scattered = scattered && back[i] == leds[i];
+            }
+            CHECK_MESSAGE(scattered, c.name);
+        }
+    }
+
+    // Re-typing a compiled map drops the runs
+    fl::XYMap map = fl::XYMap::constructWithUserFunction(4, 4, xy_serpentine_function);
+    map.compile();
+    CHECK(map.isCompiled());
+    map.setRectangularGrid();
+    CHECK_FALSE(map.isCompiled());
+    CHECK_EQ(map.mapToIndex(1, 1), 5);
+}
+
+TEST_CASE("XYMap - bulk remap benchmark, 128x128") {
+    const fl::u16 w = 128;
+    const fl::u16 h = 128;
+    const int rounds = 200;
+    fl::vector<fl::u16> lut;
+    const fl::vector<RemapCase> cases = remapCases(&lut, w, h);
+    const fl::vector<CRGB> leds = numberedLeds(w * h + 3);
+    fl::vector<CRGB> grid(w * h);
+    printf("XYMap remap of 128x128, ms:  per-pixel mapToIndex   gather\n");
+    for (const RemapCase& c : cases) {
+        fl::u32 start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            fl::u32 pos = 0;
+            for (fl::u16 y = 0; y < h; ++y) {
+                for (fl::u16 x = 0; x < w; ++x) {
+                    grid[pos++] = leds[c.map.mapToIndex(x, y)];
+                }
+            }
+        }
+        const double perPixelMs = double(micros() - start) / rounds / 1000.0;
+        const fl::vector<CRGB> expected = grid;
+        fl::fill(grid.begin(), grid.end(), CRGB::Black);
+        start = micros();
+        for (int r = 0; r < rounds; ++r) {
+            c.map.gather(leds.data(), grid.data());
+        }
+        const double gatherMs = double(micros() - start) / rounds / 1000.0;
+        printf("  %-20s %20.4f %10.4f\n", c.name, perPixelMs, gatherMs);
+        CHECK_MESSAGE(grid == expected, c.name);
+    }
+}
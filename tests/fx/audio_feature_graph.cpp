@@ -0,0 +1,170 @@
+#include "test.h"
+
+#include "fl/audio.h"
+#include "fl/audio/audio_context.h"
+#include "fl/audio/audio_features.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+#include "fx/audio/audio_processor.h"
+#include "fx/audio/detectors/chord.h"
+#include "fx/audio/detectors/key.h"
+#include "platforms/stub/time_stub.h"
+
+#include <math.h>
+#include <stdio.h>
+
+using namespace fl;
+
+namespace {
+
+const float kSampleRate = 44100.0f;
+
+// Sum of equal-amplitude sines, `block` blocks into the signal
+AudioSample makeChordBlock(const fl::vector<float>& freqs, int block,
+                           int samples = 1024) {
+    fl::vector<i16> pcm(samples);
+    for (int i = 0; i < samples; ++i) {
+        const double t = double(block * samples + i) / kSampleRate;
+        double v = 0.0;
+        for (float f : freqs) {
+            v += 6000.0 * ::sin(2.0 * FL_PI * f * t);
+        }
+        pcm[i] = static_cast<i16>(v);
+    }
+    return AudioSample(span<const i16>(pcm.data(), pcm.size()),
+                       static_cast<u32>(block * samples * 1000 / 44100));
+}
+
+int argmax(span<const float> values) {
+    int best = 0;
+    for (int i = 1; i < int(values.size()); ++i) {
+        if (values[i] > values[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+AudioFeatureMask bits(AudioFeature a) { return audioFeatureBit(a); }
+
+} // namespace
+
+TEST_CASE("AudioFeature - dependency closure") {
+    CHECK_EQ(audioFeatureClosure(bits(AudioFeature::RMS)), bits(AudioFeature::RMS));
+    CHECK_EQ(audioFeatureClosure(bits(AudioFeature::Chroma)),
+             bits(AudioFeature::Chroma) | bits(AudioFeature::Spectrum));
+    CHECK_EQ(audioFeatureClosure(bits(AudioFeature::SpectralFlux)),
+             bits(AudioFeature::SpectralFlux) | bits(AudioFeature::Bands) |
+                 bits(AudioFeature::Spectrum));
+    CHECK_EQ(audioFeatureClosure(0), 0u);
+}
+
+TEST_CASE("AudioProcessor - shared features are computed once per block") {
+    const fl::vector<float> tone = {440.0f, 1250.0f};
+    const int blocks = 20;
+
+    // Beat and tempo share one flux; nothing asks for chroma. RMS is always
+    // live for the snapshot.
+    AudioProcessor rhythm;
+    rhythm.onBeat([]() {});
+    rhythm.onTempo([](float) {});
+    CHECK_EQ(rhythm.getActiveFeatures(),
+             bits(AudioFeature::Spectrum) | bits(AudioFeature::Bands) |
+                 bits(AudioFeature::SpectralFlux) | bits(AudioFeature::RMS));
+    for (int b = 0; b < blocks; ++b) {
+        rhythm.update(makeChordBlock(tone, b));
+    }
+    CHECK_EQ(rhythm.getFeatureStats(AudioFeature::Spectrum).computations, u32(blocks));
+    CHECK_EQ(rhythm.getFeatureStats(AudioFeature::SpectralFlux).computations, u32(blocks));
+    CHECK_EQ(rhythm.getFeatureStats(AudioFeature::Chroma).computations, 0u);
+    CHECK_EQ(rhythm.getFeatureStats(AudioFeature::RMS).computations, u32(blocks));
+
+    // Chord and key share one chroma
+    AudioProcessor harmony;
+    harmony.onChord([](const Chord&) {});
+    harmony.onKey([](const Key&) {});
+    CHECK_EQ(harmony.getActiveFeatures(),
+             bits(AudioFeature::Spectrum) | bits(AudioFeature::Chroma) |
+                 bits(AudioFeature::RMS));
+    for (int b = 0; b < blocks; ++b) {
+        harmony.update(makeChordBlock(tone, b));
+    }
+    CHECK_EQ(harmony.getFeatureStats(AudioFeature::Chroma).computations, u32(blocks));
+    CHECK_EQ(harmony.getFeatureStats(AudioFeature::Spectrum).computations, u32(blocks));
+    CHECK_EQ(harmony.getFeatureStats(AudioFeature::SpectralFlux).computations, 0u);
+
+    // Level-only detectors never run an FFT
+    AudioProcessor level;
+    level.onEnergy([](float) {});
+    level.onSilence([](bool) {});
+    level.onDynamicTrend([](float) {});
+    CHECK_EQ(level.getActiveFeatures(), bits(AudioFeature::RMS));
+    for (int b = 0; b < blocks; ++b) {
+        level.update(makeChordBlock(tone, b));
+    }
+    CHECK_EQ(level.getFeatureStats(AudioFeature::RMS).computations, u32(blocks));
+    CHECK_EQ(level.getFeatureStats(AudioFeature::Spectrum).computations, 0u);
+}
+
+TEST_CASE("AudioContext - chroma follows the pitch classes of the input") {
+    const fl::vector<float> a4 = {440.0f};
+    AudioSample sample = makeChordBlock(a4, 0, 2048);
+    AudioContext ctx(sample);
+    span<const float> chroma = ctx.getChroma();
+    REQUIRE_EQ(chroma.size(), 12u);
+    CHECK_EQ(argmax(chroma), 9);  // A
+    CHECK_EQ(chroma[9], doctest::Approx(1.0f));
+
+    // C major triad: C4 E4 G4
+    const fl::vector<float> triad = {261.63f, 329.63f, 392.0f};
+    AudioContext triadCtx(makeChordBlock(triad, 0, 2048));
+    chroma = triadCtx.getChroma();
+    float weakestTone = 1.0f;
+    for (int pc : {0, 4, 7}) {
+        weakestTone = FL_MIN(weakestTone, chroma[pc]);
+    }
+    CHECK_GT(weakestTone, 0.5f);
+    for (int pc = 0; pc < 12; ++pc) {
+        if (pc != 0 && pc != 4 && pc != 7) {
+            CHECK_LT(chroma[pc], weakestTone);
+        }
+    }
+
+    // At 16 kHz the same samples are a 440 Hz tone, since pitch classes
+    // follow the STFT sample rate
+    const fl::vector<float> scaled = {440.0f * kSampleRate / 16000.0f};
+    AudioContext slowCtx(makeChordBlock(scaled, 0, 2048));
+    slowCtx.setSTFT(2048, 2048, 16000);
+    int frames = 0;
+    slowCtx.pushSample(makeChordBlock(scaled, 0, 2048), [&]() {
+        ++frames;
+        CHECK_EQ(argmax(slowCtx.getChroma()), 9);  // A
+    });
+    CHECK_EQ(frames, 1);
+}
+
+TEST_CASE("AudioProcessor - per-feature cost readout") {
+    const fl::vector<float> tone = {261.63f, 329.63f, 392.0f};
+    AudioProcessor processor;
+    processor.onBeat([]() {});
+    processor.onTempo([](float) {});
+    processor.onChord([](const Chord&) {});
+    processor.onKey([](const Key&) {});
+    processor.onEnergy([](float) {});
+    processor.setFeatureProfiling(true);
+    const int blocks = 200;
+    for (int b = 0; b < blocks; ++b) {
+        processor.update(makeChordBlock(tone, b));
+    }
+    printf("Shared audio features over %d blocks of 1024 samples:\n", blocks);
+    u32 total = 0;
+    for (u8 i = 0; i < u8(AudioFeature::Count); ++i) {
+        const AudioFeature feature = AudioFeature(i);
+        const AudioFeatureStats& stats = processor.getFeatureStats(feature);
+        printf("  %-13s %5u runs, %7.2f us each\n", audioFeatureName(feature),
+               stats.computations, stats.meanMicros());
+        CHECK_EQ(stats.computations, u32(blocks));
+        total += stats.totalMicros;
+    }
+    CHECK_GT(total, 0u);
+}
@@ -0,0 +1,195 @@
+#include "test.h"
+
+#include "fl/audio.h"
+#include "fl/audio/audio_context.h"
+#include "fl/fft.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+#include "fx/audio/audio_processor.h"
+#include "fx/audio/detectors/buildup.h"
+#include "fx/audio/detectors/chord.h"
+#include "fx/audio/detectors/key.h"
+#include "fx/audio/detectors/mood_analyzer.h"
+#include "fx/audio/multi_audio_input.h"
+#include "platforms/stub/time_stub.h"
+
+#include <math.h>
+
+using namespace fl;
+
+namespace {
+
+const int kBlock = 512;
+
+// A typical show setup: every stream or the fused mix drives these
+void addDetectors(AudioProcessor& p) {
+    p.onFrequencyBands([](float, float, float) {});
+    p.onEnergy([](float) {});
+    p.onBeat([]() {});
+    p.onTempo([](float) {});
+    p.onChord([](const Chord&) {});
+    p.onKey([](const Key&) {});
+    p.onMood([](const Mood&) {});
+    p.onBuildup([](const Buildup&) {});
+}
+
+// Stream `stream`: its own tone, plus a click on every 4th block for even
+// streams
+AudioSample makeBlock(int stream, int block) {
+    fl::vector<i16> pcm(kBlock);
+    const double freq = 220.0 * (1 + stream) + 37.0 * stream;
+    for (int i = 0; i < kBlock; ++i) {
+        const double t = double(block * kBlock + i) / 44100.0;
+        double v = 5000.0 * ::sin(2.0 * FL_PI * freq * t);
+        if (stream % 2 == 0 && block % 4 == 0 && i < 48) {
+            v += (i % 2 ? -9000.0 : 9000.0);
+        }
+        pcm[i] = static_cast<i16>(v);
+    }
+    return AudioSample(span<const i16>(pcm.data(), pcm.size()),
+                       static_cast<u32>(block * 12));
+}
+
+fl::vector<AudioSample> makeBlocks(int streams, int block) {
+    fl::vector<AudioSample> blocks;
+    for (int s = 0; s < streams; ++s) {
+        blocks.push_back(makeBlock(s, block));
+    }
+    return blocks;
+}
+
+} // namespace
+
+TEST_CASE("FFT batch - matches per-stream transform and bands exactly") {
+    const int streams = 5;
+    fl::vector<AudioSample> blocks = makeBlocks(streams, 0);
+    fl::vector<span<const i16>> pcm;
+    for (const AudioSample& b : blocks) {
+        pcm.push_back(span<const i16>(b.pcm().data(), b.pcm().size()));
+    }
+    FFT fft;
+    FFTSpectrumBatch batch;
+    fft.transformBatch(pcm, &batch);
+    REQUIRE_EQ(batch.streams, fl::size(streams));
+    REQUIRE_EQ(batch.binCount(), fl::size(kBlock / 2 + 1));
+
+    for (int bands : {16, 32}) {
+        const FFT_Args args(kBlock, bands);
+        fl::vector<float> magnitudes;
+        fft.bandsBatch(batch, &magnitudes, args);
+        REQUIRE_EQ(magnitudes.size(), fl::size(bands * streams));
+        for (int s = 0; s < streams; ++s) {
+            FFTSpectrum single;
+            FFTSpectrum extracted;
+            fft.transform(pcm[s], &single);
+            batch.extract(s, &extracted);
+            CHECK(single.bins == extracted.bins);
+
+            FFTBins expected(bands);
+            fft.run(pcm[s], &expected, args);
+            for (int b = 0; b < bands; ++b) {
+                CHECK_EQ(magnitudes[b * streams + s], expected.bins_raw[b]);
+            }
+        }
+    }
+}
+
+TEST_CASE("MultiAudioInput - per-stream and fused features") {
+    const int streams = 3;
+    MultiAudioInput input(streams);
+    input.setWeight(1, 0.5f);
+    fl::vector<shared_ptr<AudioContext>> contexts;
+    for (int s = 0; s < streams; ++s) {
+        contexts.push_back(make_shared<AudioContext>(AudioSample()));
+    }
+
+    for (int block = 0; block < 8; ++block) {
+        const fl::vector<AudioSample> blocks = makeBlocks(streams, block);
+        REQUIRE(input.update(blocks));
+        float fusedFlux = 0.0f;
+        for (int s = 0; s < streams; ++s) {
+            // The same numbers a context per stream would produce
+            contexts[s]->setSample(blocks[s]);
+            const FFTBins& bins = contexts[s]->getFFT(16);
+            for (int b = 0; b < 16; ++b) {
+                CHECK_EQ(input.bandMagnitude(s, b), bins.bins_raw[b]);
+            }
+            CHECK_EQ(input.flux(s), contexts[s]->getSpectralFlux());
+            CHECK_EQ(input.rms(s), blocks[s].rms());
+            fusedFlux += input.getWeight(s) * input.flux(s);
+        }
+        CHECK(input.fusedFlux() == doctest::Approx(fusedFlux));
+        const float fusedBand = input.bandMagnitude(0, 3) +
+                                0.5f * input.bandMagnitude(1, 3) +
+                                input.bandMagnitude(2, 3);
+        CHECK(input.fusedBands()[3] == doctest::Approx(fusedBand));
+    }
+
+    // The mixed spectrum stands in for transforming the mixdown
+    FFT fft;
+    FFTSpectrum direct;
+    const AudioSample& mix = input.mix();
+    REQUIRE_EQ(mix.size(), fl::size(kBlock));
+    fft.transform(span<const i16>(mix.pcm().data(), mix.size()), &direct);
+    const FFTSpectrum& mixed = input.mixSpectrum();
+    REQUIRE_EQ(mixed.bins.size(), direct.bins.size());
+    int worst = 0;
+    for (fl::size i = 0; i < direct.bins.size(); ++i) {
+        const int diff = mixed.bins[i] - direct.bins[i];
+        worst = FL_MAX(worst, diff < 0 ? -diff : diff);
+    }
+    CHECK_LE(worst, 4);  // Q15 rounding in the transform, per stream
+
+    // Mismatched input leaves the features alone
+    fl::vector<AudioSample> bad = makeBlocks(2, 0);
+    CHECK_FALSE(input.update(bad));
+}
+
+TEST_CASE("MultiAudioInput - batched analysis benchmark") {
+    const int kBlocks = 200;
+    for (int streams : {1, 2, 4, 8}) {
+        fl::vector<fl::vector<AudioSample>> input;
+        for (int block = 0; block < 16; ++block) {
+            input.push_back(makeBlocks(streams, block));
+        }
+
+        // One processor per stream
+        fl::vector<shared_ptr<AudioProcessor>> processors;
+        for (int s = 0; s < streams; ++s) {
+            shared_ptr<AudioProcessor> p = make_shared<AudioProcessor>();
+            addDetectors(*p);
+            processors.push_back(p);
+        }
+        u32 start = micros();
+        for (int block = 0; block < kBlocks; ++block) {
+            const fl::vector<AudioSample>& blocks = input[block % 16];
+            for (int s = 0; s < streams; ++s) {
+                processors[s]->update(blocks[s]);
+            }
+        }
+        const double separateUs = double(micros() - start) / kBlocks;
+
+        // One batched pass plus one processor on the fused mix
+        MultiAudioInput multi(streams);
+        AudioProcessor fused;
+        addDetectors(fused);
+        start = micros();
+        for (int block = 0; block < kBlocks; ++block) {
+            REQUIRE(multi.update(input[block % 16]));
+            multi.feed(fused);
+        }
+        const double batchedUs = double(micros() - start) / kBlocks;
+
+        MESSAGE(streams << " streams of " << kBlock << "-sample blocks, 8 "
+                << "detectors: " << streams << " processors " << separateUs
+                << " us, batched " << batchedUs << " us");
+
+        // Every timed block was analysed, and the batch ended on the last one
+        const fl::vector<AudioSample>& last = input[(kBlocks - 1) % 16];
+        for (int s = 0; s < streams; ++s) {
+            CHECK_EQ(processors[s]->snapshot().sequence, u32(kBlocks));
+            CHECK_EQ(multi.rms(s), last[s].rms());
+        }
+        CHECK_EQ(fused.snapshot().sequence, u32(kBlocks));
+    }
+}
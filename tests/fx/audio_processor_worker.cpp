@@ -0,0 +1,207 @@
+#include "test.h"
+
+#include "fl/algorithm.h"
+#include "fl/audio.h"
+#include "fl/engine_events.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+#include "fx/audio/audio_processor.h"
+#include "fx/audio/detectors/chord.h"
+#include "fx/audio/detectors/key.h"
+#include "fx/audio/detectors/mood_analyzer.h"
+#include "fx/audio/detectors/buildup.h"
+#include "platforms/stub/time_stub.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>  // ok include
+#include <chrono>  // ok include
+
+using namespace fl;
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBlockSize = 2048;  // long enough for PitchDetector's 80 Hz floor
+
+// Clicks every half second over a quiet tone, like the STFT latency test
+fl::vector<i16> makeClickTrack(int n) {
+    fl::vector<i16> pcm(n);
+    for (int i = 0; i < n; ++i) {
+        pcm[i] = static_cast<i16>(800.0 * ::sin(2.0 * FL_PI * (i % 128) / 128.0));
+    }
+    for (int start = kSampleRate / 4; start < n; start += kSampleRate / 2) {
+        for (int i = 0; i < 64 && start + i < n; ++i) {
+            const int decay = 20000 * (64 - i) / 64;
+            pcm[start + i] = static_cast<i16>(i % 2 ? -decay : decay);
+        }
+    }
+    return pcm;
+}
+
+AudioSample blockAt(const fl::vector<i16>& pcm, int block) {
+    const int start = (block * kBlockSize) % (int(pcm.size()) - kBlockSize);
+    return AudioSample(span<const i16>(pcm.data() + start, kBlockSize),
+                       static_cast<u32>(u64(block) * kBlockSize * 1000 / kSampleRate));
+}
+
+// Detectors whose implementations are safe to combine in one processor
+void addDetectors(AudioProcessor& processor, bool many) {
+    processor.onBeat([]() {});
+    if (!many) {
+        return;
+    }
+    processor.onFrequencyBands([](float, float, float) {});
+    processor.onEnergy([](float) {});
+    processor.onTempo([](float) {});
+    processor.onSilence([](bool) {});
+    processor.onDynamicTrend([](float) {});
+    processor.onPitch([](float) {});
+    processor.onDownbeat([]() {});
+    processor.onBackbeat([](u8, float, float) {});
+    processor.onChord([](const Chord&) {});
+    processor.onKey([](const Key&) {});
+    processor.onMood([](const Mood&) {});
+    processor.onBuildup([](const Buildup&) {});
+}
+
+// Median time the render loop spends in update() per frame
+double medianUpdateUs(bool many, bool worker, const fl::vector<i16>& pcm) {
+    AudioProcessor processor;
+    addDetectors(processor, many);
+    if (worker) {
+        REQUIRE(processor.startWorker(AudioWorkerConfig(), kBlockSize));
+    }
+    fl::vector<u32> times;
+    for (int frame = 0; frame < 60; ++frame) {
+        const AudioSample sample = blockAt(pcm, frame);
+        const u32 start = micros();
+        processor.update(sample);
+        times.push_back(micros() - start);
+        EngineEvents::onEndFrame();
+        // The rest of the frame: rendering and show()
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    processor.stopWorker();
+    fl::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+} // namespace
+
+TEST_CASE("AudioProcessor worker - same results as inline processing") {
+    const fl::vector<i16> pcm = makeClickTrack(kSampleRate * 3);
+    const int blocks = int(pcm.size()) / kBlockSize;
+
+    AudioProcessor inlineProcessor;
+    addDetectors(inlineProcessor, true);
+    for (int block = 0; block < blocks; ++block) {
+        inlineProcessor.update(blockAt(pcm, block));
+    }
+
+    AudioProcessor worker;
+    addDetectors(worker, true);
+    REQUIRE(worker.startWorker(AudioWorkerConfig(), kBlockSize, blocks));
+    for (int block = 0; block < blocks; ++block) {
+        worker.update(blockAt(pcm, block));
+    }
+    for (int i = 0; i < 400 && worker.snapshot().sequence < u32(blocks); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    worker.stopWorker();
+
+    // The worker runs the same detectors on copies of the same blocks
+    const AudioSnapshot a = inlineProcessor.snapshot();
+    const AudioSnapshot b = worker.snapshot();
+    CHECK_EQ(b.sequence, u32(blocks));
+    CHECK_EQ(a.sequence, b.sequence);
+    CHECK_EQ(a.timestamp, b.timestamp);
+    CHECK_EQ(a.rms, b.rms);
+    CHECK_EQ(a.beatCount, b.beatCount);
+    CHECK_EQ(a.bpm, b.bpm);
+    CHECK_EQ(a.bass, b.bass);
+    CHECK_EQ(a.pitch, b.pitch);
+    CHECK_EQ(a.voiced, b.voiced);
+}
+
+// Render-thread cost of update() with 1 and 13 detectors, inline and on the
+// worker. Timing only, so it runs when FASTLED_AUDIO_WORKER_BENCH_JSON names an
+// output file; ci/perf/audio_worker_perf.py checks the results.
+TEST_CASE("AudioProcessor worker - render time benchmark") {
+    const char* path = getenv("FASTLED_AUDIO_WORKER_BENCH_JSON");
+    if (!path) {
+        return;
+    }
+    const fl::vector<i16> pcm = makeClickTrack(kSampleRate * 2);
+    const double inlineOne = medianUpdateUs(false, false, pcm);
+    const double inlineMany = medianUpdateUs(true, false, pcm);
+    const double workerOne = medianUpdateUs(false, true, pcm);
+    const double workerMany = medianUpdateUs(true, true, pcm);
+    MESSAGE("AudioProcessor update() median per " << kBlockSize
+            << "-sample frame: inline " << inlineOne << " / " << inlineMany
+            << " us, worker " << workerOne << " / " << workerMany
+            << " us (1 / 13 detectors)");
+
+    FILE* f = fopen(path, "w");
+    REQUIRE(f != nullptr);
+    fprintf(f,
+            "{\"block_size\":%d,\"inline_one_us\":%.1f,\"inline_many_us\":%.1f,"
+            "\"worker_one_us\":%.1f,\"worker_many_us\":%.1f}\n",
+            kBlockSize, inlineOne, inlineMany, workerOne, workerMany);
+    fclose(f);
+}
+
+TEST_CASE("AudioProcessor worker - callbacks run on the render thread") {
+    const fl::vector<i16> pcm = makeClickTrack(kSampleRate * 3);
+    AudioProcessor processor;
+    const std::thread::id renderThread = std::this_thread::get_id();
+    int beats = 0;
+    int energies = 0;
+    bool onRenderThread = true;
+    processor.onBeat([&]() {
+        beats++;
+        onRenderThread = onRenderThread && std::this_thread::get_id() == renderThread;
+    });
+    processor.onEnergy([&](float) {
+        energies++;
+        onRenderThread = onRenderThread && std::this_thread::get_id() == renderThread;
+    });
+    REQUIRE(processor.startWorker(AudioWorkerConfig(), kBlockSize, 16));
+    CHECK(processor.isWorkerRunning());
+
+    const int blocks = int(pcm.size()) / kBlockSize;
+    u32 lastSequence = 0;
+    bool monotonic = true;
+    for (int block = 0; block < blocks; ++block) {
+        processor.update(blockAt(pcm, block));
+        const AudioSnapshot snap = processor.snapshot();
+        monotonic = monotonic && snap.sequence >= lastSequence;
+        lastSequence = snap.sequence;
+        // FastLED.show() ends the frame and runs the queued callbacks
+        EngineEvents::onEndFrame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    // Let the worker drain the queue before stopping
+    for (int i = 0; i < 200 && processor.snapshot().sequence < u32(blocks); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    processor.stopWorker();
+    CHECK_FALSE(processor.isWorkerRunning());
+
+    const AudioSnapshot snap = processor.snapshot();
+    CHECK(onRenderThread);
+    CHECK(monotonic);
+    CHECK_EQ(snap.sequence, u32(blocks));
+    CHECK_EQ(energies, blocks);
+    CHECK_GT(beats, 0);
+    CHECK_EQ(snap.beatCount, u32(beats));
+    CHECK_GT(snap.rms, 0.0f);
+
+    // Stopped: back to inline processing with direct callbacks
+    const int before = energies;
+    processor.update(blockAt(pcm, 0));
+    CHECK_EQ(energies, before + 1);
+    CHECK_EQ(processor.dispatchEvents(), 0u);
+    CHECK_EQ(processor.snapshot().sequence, u32(blocks) + 1);
+}
@@ -0,0 +1,284 @@
+#include "test.h"
+
+#include "fx/audio/audio_timeline.h"
+#include "fl/audio/audio_worker.h"
+#include "fl/file_system.h"
+#include "fl/math.h"
+#include "fl/vector.h"
+#include "platforms/stub/time_stub.h"
+#ifdef FASTLED_TESTING
+#include "platforms/stub/fs_stub.hpp"
+#endif
+
+#include <math.h>
+
+using namespace fl;
+
+namespace {
+
+const int kSampleRate = 44100;
+
+// 120 BPM clicks over a quiet 128-sample-periodic tone
+fl::vector<i16> makeClickTrack(int seconds) {
+    const int n = kSampleRate * seconds;
+    fl::vector<i16> pcm(n);
+    for (int i = 0; i < n; ++i) {
+        pcm[i] = static_cast<i16>(800.0 * ::sin(2.0 * FL_PI * (i % 128) / 128.0));
+    }
+    for (int start = kSampleRate / 4; start < n; start += kSampleRate / 2) {
+        for (int i = 0; i < 64 && start + i < n; ++i) {
+            const int decay = 20000 * (64 - i) / 64;
+            pcm[start + i] = static_cast<i16>(i % 2 ? -decay : decay);
+        }
+    }
+    return pcm;
+}
+
+// The drop detector's translation unit is out of step with its header, so
+// tests leave it off
+OfflineAnalysisOptions testOptions(u8 segments) {
+    OfflineAnalysisOptions options;
+    options.drop = false;
+    options.segments = segments;
+    options.warmupMs = 4000;
+    return options;
+}
+
+fl::vector<u32> beatTimes(const AudioTimeline& timeline) {
+    fl::vector<u32> times;
+    for (const AudioTimelineEvent& event : timeline.events()) {
+        if (event.type == AudioEventType::Beat) {
+            times.push_back(event.timeMs);
+        }
+    }
+    return times;
+}
+
+void putLE(fl::vector<u8>* out, u32 v, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out->push_back(u8(v >> (8 * i)));
+    }
+}
+
+fl::vector<u8> makeStereoWav(const fl::vector<i16>& mono) {
+    fl::vector<u8> wav;
+    const u32 dataBytes = u32(mono.size()) * 4;
+    wav.push_back('R'); wav.push_back('I'); wav.push_back('F'); wav.push_back('F');
+    putLE(&wav, 36 + dataBytes, 4);
+    wav.push_back('W'); wav.push_back('A'); wav.push_back('V'); wav.push_back('E');
+    wav.push_back('f'); wav.push_back('m'); wav.push_back('t'); wav.push_back(' ');
+    putLE(&wav, 16, 4);
+    putLE(&wav, 1, 2);                // PCM
+    putLE(&wav, 2, 2);                // channels
+    putLE(&wav, kSampleRate, 4);
+    putLE(&wav, kSampleRate * 4, 4);  // byte rate
+    putLE(&wav, 4, 2);                // block align
+    putLE(&wav, 16, 2);               // bits per sample
+    wav.push_back('d'); wav.push_back('a'); wav.push_back('t'); wav.push_back('a');
+    putLE(&wav, dataBytes, 4);
+    for (i16 s : mono) {
+        putLE(&wav, u16(s), 2);
+        putLE(&wav, u16(s), 2);
+    }
+    return wav;
+}
+
+} // namespace
+
+TEST_CASE("OfflineAudioAnalyzer - segmented analysis matches a single pass") {
+    const fl::vector<i16> pcm = makeClickTrack(30);
+    AudioTimeline single;
+    AudioTimeline segmented;
+    REQUIRE(OfflineAudioAnalyzer::analyze(pcm, kSampleRate, &single, testOptions(1)));
+    REQUIRE(OfflineAudioAnalyzer::analyze(pcm, kSampleRate, &segmented, testOptions(4)));
+    CHECK_EQ(single.durationMs(), 30000u);
+
+    // The default splits by IAudioWorker::concurrency()
+    AudioTimeline automatic;
+    REQUIRE(OfflineAudioAnalyzer::analyze(pcm, kSampleRate, &automatic, testOptions(0)));
+    CHECK_GT(automatic.count(AudioEventType::Beat), 0u);
+    CHECK_GE(IAudioWorker::concurrency(), 1u);
+
+    const fl::vector<u32> a = beatTimes(single);
+    const fl::vector<u32> b = beatTimes(segmented);
+    MESSAGE("beats: single pass " << a.size() << ", 4 segments " << b.size()
+                                  << ", tempo events " << segmented.count(AudioEventType::Tempo));
+    // A click every 500 ms; the detectors need a few seconds to lock on
+    CHECK_GT(a.size(), 45u);
+    CHECK_GT(b.size(), 45u);
+
+    // Sorted, and no doubled beats where segments meet
+    bool sorted = true;
+    bool spaced = true;
+    for (fl::size i = 1; i < segmented.size(); ++i) {
+        sorted = sorted && segmented.events()[i - 1].timeMs <= segmented.events()[i].timeMs;
+    }
+    for (fl::size i = 1; i < b.size(); ++i) {
+        spaced = spaced && b[i] - b[i - 1] > 250;
+    }
+    CHECK(sorted);
+    CHECK(spaced);
+
+    // After the first segment's warm-up both runs see the same beats
+    int matched = 0;
+    int compared = 0;
+    for (u32 t : a) {
+        if (t < 8000) {
+            continue;
+        }
+        ++compared;
+        for (u32 u : b) {
+            if (u + 30 >= t && u <= t + 30) {
+                ++matched;
+                break;
+            }
+        }
+    }
+    CHECK_GE(matched * 10, compared * 9);
+}
+
+TEST_CASE("AudioTimeline - binary and JSON round trips") {
+    AudioTimeline timeline;
+    timeline.setDurationMs(12345);
+    AudioTimelineEvent event;
+    event.timeMs = 500;
+    event.type = AudioEventType::Beat;
+    timeline.add(event);
+    event.timeMs = 100;
+    event.type = AudioEventType::Tempo;
+    event.value = 128.5f;
+    event.value2 = 0.75f;
+    timeline.add(event);
+    event.timeMs = 900;
+    event.type = AudioEventType::Key;
+    event.arg = 9 | 0x80;  // A minor
+    event.value = 0.5f;
+    event.value2 = 0.0f;
+    timeline.add(event);
+    REQUIRE_EQ(timeline.size(), 3u);
+    CHECK_EQ(timeline.events()[0].type, AudioEventType::Tempo);
+
+    fl::vector<u8> blob;
+    timeline.toBinary(&blob);
+    CHECK_EQ(blob.size(), 16u + 3u * 14u);
+    AudioTimeline fromBinary;
+    REQUIRE(fromBinary.fromBinary(blob));
+    CHECK_EQ(fromBinary.durationMs(), 12345u);
+    REQUIRE_EQ(fromBinary.size(), 3u);
+    for (fl::size i = 0; i < 3; ++i) {
+        CHECK(fromBinary.events()[i] == timeline.events()[i]);
+    }
+    blob[4] = 99;  // unknown version
+    CHECK_FALSE(fromBinary.fromBinary(blob));
+
+    const fl::string json = timeline.toJson();
+    AudioTimeline fromJson;
+    REQUIRE(fromJson.fromJson(json));
+    CHECK_EQ(fromJson.durationMs(), 12345u);
+    REQUIRE_EQ(fromJson.size(), 3u);
+    for (fl::size i = 0; i < 3; ++i) {
+        const AudioTimelineEvent& x = fromJson.events()[i];
+        const AudioTimelineEvent& y = timeline.events()[i];
+        CHECK_EQ(x.timeMs, y.timeMs);
+        CHECK_EQ(x.type, y.type);
+        CHECK_EQ(x.arg, y.arg);
+        CHECK(x.value == doctest::Approx(y.value));
+        CHECK(x.value2 == doctest::Approx(y.value2));
+    }
+    CHECK_FALSE(fromJson.fromJson("{\"events\":[[0,\"bogus\",0,0,0]]}"));
+    // Entries of the wrong shape are rejected before any field is read
+    CHECK_FALSE(fromJson.fromJson("{\"events\":[5]}"));
+    CHECK_FALSE(fromJson.fromJson("{\"events\":[{\"1\":\"beat\"}]}"));
+    CHECK_FALSE(fromJson.fromJson("{\"events\":[[0,\"beat\"]]}"));
+    CHECK_EQ(fromJson.size(), 0u);
+}
+
+TEST_CASE("AudioTimelinePlayer - replays in sync with the playback position") {
+    const fl::vector<i16> pcm = makeClickTrack(12);
+    AudioTimeline timeline;
+    REQUIRE(OfflineAudioAnalyzer::analyze(pcm, kSampleRate, &timeline, testOptions(2)));
+    const fl::vector<u32> expected = beatTimes(timeline);
+    REQUIRE_GT(expected.size(), 10u);
+
+    AudioTimelinePlayer player;
+    fl::vector<u8> blob;
+    timeline.toBinary(&blob);
+    REQUIRE(player.load(blob));
+    fl::vector<u32> fired;
+    u32 position = 0;
+    player.onBeat([&]() { fired.push_back(position); });
+
+    // 60 fps frames
+    for (position = 0; position <= timeline.durationMs(); position += 16) {
+        player.update(position);
+    }
+    REQUIRE_EQ(fired.size(), expected.size());
+    for (fl::size i = 0; i < fired.size(); ++i) {
+        CHECK_GE(fired[i], expected[i]);
+        CHECK_LT(fired[i] - expected[i], 16u);
+    }
+
+    // Jumping back replays from there without firing what was skipped
+    fired.clear();
+    position = 6000;
+    player.update(position);
+    CHECK(fired.empty());
+    for (position = 6000; position < 7000; position += 16) {
+        player.update(position);
+    }
+    int inRange = 0;
+    for (u32 t : expected) {
+        inRange += (t > 6000 && t < 7000) ? 1 : 0;
+    }
+    CHECK_EQ(int(fired.size()), inRange);
+    CHECK_GT(player.getBPM(), 0.0f);
+}
+
+TEST_CASE("OfflineAudioAnalyzer - WAV input matches the mono PCM") {
+    const fl::vector<i16> pcm = makeClickTrack(10);
+    const fl::vector<u8> wav = makeStereoWav(pcm);
+    fl::vector<i16> decoded;
+    u32 rate = 0;
+    REQUIRE(OfflineAudioAnalyzer::decodeWav(wav, &decoded, &rate));
+    CHECK_EQ(rate, u32(kSampleRate));
+    REQUIRE_EQ(decoded.size(), pcm.size());
+    CHECK(decoded == pcm);
+
+    AudioTimeline fromWav;
+    AudioTimeline fromPcm;
+    REQUIRE(OfflineAudioAnalyzer::analyzeWav(wav, &fromWav, testOptions(2)));
+    REQUIRE(OfflineAudioAnalyzer::analyze(pcm, kSampleRate, &fromPcm, testOptions(2)));
+    REQUIRE_EQ(fromWav.size(), fromPcm.size());
+    for (fl::size i = 0; i < fromWav.size(); ++i) {
+        CHECK(fromWav.events()[i] == fromPcm.events()[i]);
+    }
+
+    fl::string error;
+    const u8 junk[] = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'A', 'V', 'I', ' '};
+    CHECK_FALSE(OfflineAudioAnalyzer::decodeWav(junk, &decoded, &rate, &error));
+    CHECK_FALSE(error.empty());
+}
+
+TEST_CASE("OfflineAudioAnalyzer - MP3 file") {
+    setTestFileSystemRoot("tests/data");
+    FileSystem fs;
+    REQUIRE(fs.beginSd(0));
+    FileHandlePtr file = fs.openRead("codec/edm_beat.mp3");
+    REQUIRE(file != nullptr);
+    fl::vector<u8> mp3(file->size());
+    REQUIRE_EQ(file->read(mp3.data(), mp3.size()), mp3.size());
+    file->close();
+
+    AudioTimeline timeline;
+    const u32 start = micros();
+    fl::string error;
+    REQUIRE(OfflineAudioAnalyzer::analyzeMp3(mp3, &timeline, testOptions(4), &error));
+    const u32 elapsedUs = micros() - start;
+    const double realtime = timeline.durationMs() * 1000.0 / FL_MAX(elapsedUs, 1u);
+    MESSAGE("Offline analysis of " << timeline.durationMs() << " ms of MP3: "
+            << elapsedUs / 1000.0 << " ms, " << realtime << "x realtime, "
+            << timeline.size() << " events ("
+            << timeline.count(AudioEventType::Beat) << " beats)");
+    CHECK_GT(timeline.durationMs(), 1000u);
+    CHECK_GT(timeline.count(AudioEventType::Beat), 0u);
+}
@@ -0,0 +1,246 @@
+// The row/grid noise functions must match the single-point ones bit for bit
+
+#include "test.h"
+#include "FastLED.h"
+#include "noise.h"
+#include "fl/stdint.h"
+#include "fl/vector.h"
+#include "platforms/stub/time_stub.h"
+
+#include <stdio.h>
+
+using namespace fl;
+
+namespace {
+
+struct Walk {
+    uint32_t x;
+    int32_t dx;
+    uint16_t count;
+};
+
+// Steps well below, around and above one noise cell, both directions,
+// and runs that wrap around the 16.16 / 8.8 coordinate space
+const Walk kWalks16[] = {
+    {0, 97, 300},         {0x1234567, 1000, 130}, {0x00FFF000, 0x10000, 70},
+    {5, 0x23456, 64},     {0x400000, -777, 129},  {0xFFFF8000u, 0x3001, 33},
+    {0x20000, 0, 9},      {42, 1, 1},
+};
+
+const Walk kWalks8[] = {
+    {0, 7, 300},    {0x1234, 100, 130}, {0x0FF0, 0x100, 70}, {5, 0x345, 64},
+    {0x4000, -77, 129}, {0xFF80, 0x31, 33}, {0x200, 0, 9},   {42, 1, 1},
+};
+
+} // namespace
+
+TEST_CASE("inoise16_row matches inoise16") {
+    const uint32_t ys[] = {0, 0x18000, 0xABCDEF};
+    for (const Walk &w : kWalks16) {
+        fl::vector<uint16_t> out(w.count);
+        for (uint32_t y : ys) {
+            const uint32_t z = y * 3 + 0x777;
+            inoise16_row(out.data(), w.count, w.x, w.dx, y, z);
+            for (uint16_t i = 0; i < w.count; ++i) {
+                REQUIRE_EQ(out[i], inoise16(w.x + i * w.dx, y, z));
+            }
+            inoise16_row(out.data(), w.count, w.x, w.dx, y);
+            for (uint16_t i = 0; i < w.count; ++i) {
+                REQUIRE_EQ(out[i], inoise16(w.x + i * w.dx, y));
+            }
+        }
+        inoise16_row(out.data(), w.count, w.x, w.dx);
+        for (uint16_t i = 0; i < w.count; ++i) {
+            REQUIRE_EQ(out[i], inoise16(w.x + i * w.dx));
+        }
+    }
+}
+
+TEST_CASE("inoise8_row matches inoise8") {
+    const uint16_t ys[] = {0, 0x180, 0xABCD};
+    for (const Walk &w : kWalks8) {
+        const uint16_t x = uint16_t(w.x);
+        const int dx = int(w.dx);
+        fl::vector<uint8_t> out(w.count);
+        for (uint16_t y : ys) {
+            const uint16_t z = uint16_t(y * 3 + 0x77);
+            inoise8_row(out.data(), w.count, x, dx, y, z);
+            for (uint16_t i = 0; i < w.count; ++i) {
+                REQUIRE_EQ(out[i], inoise8(uint16_t(x + i * dx), y, z));
+            }
+            inoise8_row(out.data(), w.count, x, dx, y);
+            for (uint16_t i = 0; i < w.count; ++i) {
+                REQUIRE_EQ(out[i], inoise8(uint16_t(x + i * dx), y));
+            }
+        }
+        inoise8_row(out.data(), w.count, x, dx);
+        for (uint16_t i = 0; i < w.count; ++i) {
+            REQUIRE_EQ(out[i], inoise8(uint16_t(x + i * dx)));
+        }
+    }
+}
+
+TEST_CASE("inoise16_grid and inoise8_grid match the single-point functions") {
+    const uint16_t w = 21, h = 13;
+    fl::vector<uint16_t> out16(w * h);
+    inoise16_grid(out16.data(), w, h, 0x10000, 3000, 0xFFFF0000u, 5000, 1234);
+    for (uint16_t j = 0; j < h; ++j) {
+        for (uint16_t i = 0; i < w; ++i) {
+            REQUIRE_EQ(out16[j * w + i],
+                       inoise16(0x10000 + i * 3000, 0xFFFF0000u + j * 5000, 1234));
+        }
+    }
+    inoise16_grid(out16.data(), w, h, 77, -3000, 99, 5000);
+    for (uint16_t j = 0; j < h; ++j) {
+        for (uint16_t i = 0; i < w; ++i) {
+            REQUIRE_EQ(out16[j * w + i], inoise16(77 - i * 3000, 99 + j * 5000));
+        }
+    }
+
+    fl::vector<uint8_t> out8(w * h);
+    inoise8_grid(out8.data(), w, h, 0xFF00, 30, 100, -50, 12);
+    for (uint16_t j = 0; j < h; ++j) {
+        for (uint16_t i = 0; i < w; ++i) {
+            REQUIRE_EQ(out8[j * w + i],
+                       inoise8(uint16_t(0xFF00 + i * 30), uint16_t(100 - j * 50), 12));
+        }
+    }
+    inoise8_grid(out8.data(), w, h, 5, 30, 100, 50);
+    for (uint16_t j = 0; j < h; ++j) {
+        for (uint16_t i = 0; i < w; ++i) {
+            REQUIRE_EQ(out8[j * w + i],
+                       inoise8(uint16_t(5 + i * 30), uint16_t(100 + j * 50)));
+        }
+    }
+}
+
+TEST_CASE("fill_raw_noise functions are unchanged by the batch kernels") {
+    // Reference: the per-point loops the fill functions used before
+    const uint8_t points = 150;
+    for (uint8_t octaves = 1; octaves <= 3; ++octaves) {
+        fl::vector<uint8_t> expected(points, 10), actual(points, 10);
+        uint32_t xx0 = 1000, scx = 300;
+        for (int o = 0; o < octaves; ++o, xx0 <<= 1, scx <<= 1) {
+            for (int i = 0; i < points; ++i) {
+                expected[i] = qadd8(expected[i],
+                                    inoise8(uint16_t(xx0 + i * scx), 4321) >> o);
+            }
+        }
+        fill_raw_noise8(actual.data(), points, octaves, 1000, 300, 4321);
+        CHECK(actual == expected);
+
+        fl::vector<uint8_t> expected16(points, 10), actual16(points, 10);
+        xx0 = 100000;
+        scx = 9000;
+        for (int o = 0; o < octaves; ++o, xx0 <<= 1, scx <<= 1) {
+            for (int i = 0; i < points; ++i) {
+                uint32_t accum = inoise16(xx0 + i * scx, 654321) >> o;
+                accum += expected16[i] << 8;
+                if (accum > 65535) {
+                    accum = 65535;
+                }
+                expected16[i] = accum >> 8;
+            }
+        }
+        fill_raw_noise16into8(actual16.data(), points, octaves, 100000, 9000, 654321);
+        CHECK(actual16 == expected16);
+    }
+}
+
+TEST_CASE("fill_raw_2dnoise functions are unchanged by the batch kernels") {
+    // Single octave: every point is inoise8/inoise16 folded around the middle
+    const int w = 70, h = 5;
+    fl::vector<uint8_t> data8(w * h, 0);
+    fill_raw_2dnoise8(data8.data(), w, h, 1, 0x1234, 40, 0x4321, 60, 99);
+    for (int i = 0; i < h; ++i) {
+        for (int j = 0; j < w; ++j) {
+            uint8_t n = inoise8(uint16_t(0x1234 + j * 40), uint16_t(0x4321 + i * 60), 99);
+            n = (0x80 & n) ? (n - 127) : (127 - n);
+            REQUIRE_EQ(data8[i * w + j], scale8(n << 1, 255));
+        }
+    }
+
+    fl::vector<uint8_t> data16into8(w * h, 0);
+    fill_raw_2dnoise16into8(data16into8.data(), w, h, 1, 0x12345, 4000, 0x54321, 6000, 999);
+    for (int i = 0; i < h; ++i) {
+        for (int j = 0; j < w; ++j) {
+            uint16_t n = inoise16(0x12345 + j * 4000, 0x54321 + i * 6000, 999);
+            n = (0x8000 & n) ? n - 32767 : 32767 - n;
+            REQUIRE_EQ(data16into8[i * w + j], scale8(n >> 7, 255));
+        }
+    }
+
+    // Skipped octaves evaluate every skip-th point and fill the block
+    fl::vector<uint16_t> data16(w * h, 0);
+    fill_raw_2dnoise16(data16.data(), w, h, 1, fl::q88(2, 0), 65535, 3,
+                       0x12345, 4000, 0x54321, 6000, 999);
+    for (int i = 0; i < h; ++i) {
+        for (int j = 0; j < w; ++j) {
+            const int bi = i - i % 3, bj = j - j % 3;
+            uint16_t n = inoise16(0x12345 + (bj / 3) * 12000,
+                                  0x54321 + (bi / 3) * 18000, 999);
+            n = (0x8000 & n) ? n - 32767 : 32767 - n;
+            REQUIRE_EQ(data16[i * w + j], scale16(n << 1, 65535));
+        }
+    }
+}
+
+TEST_CASE("Batch noise benchmark, Mpoints/s") {
+    const uint16_t w = 64, h = 64;
+    const int rounds = 4;
+    fl::vector<uint16_t> layer(w * h);
+    fl::vector<uint16_t> accum(w * h);
+    volatile uint32_t sink = 0;
+    for (int dims = 1; dims <= 3; ++dims) {
+        for (int octaves = 1; octaves <= 4; ++octaves) {
+            double mpps[2];
+            fl::vector<uint16_t> result[2];
+            for (int batch = 0; batch < 2; ++batch) {
+                const uint32_t start = micros();
+                for (int r = 0; r < rounds; ++r) {
+                    for (uint32_t i = 0; i < accum.size(); ++i) {
+                        accum[i] = 0;
+                    }
+                    // One pass per octave at doubled frequency, half weight
+                    for (int o = 0; o < octaves; ++o) {
+                        const uint32_t x = 0x8000u << o, dx = 0x1800u << o;
+                        const uint32_t z = 0x30000u * r;
+                        for (uint16_t j = 0; j < h; ++j) {
+                            const uint32_t y = (j * 0x1800u) << o;
+                            uint16_t *row = layer.data() + j * w;
+                            if (batch) {
+                                if (dims == 1) {
+                                    inoise16_row(row, w, x + j * 0x400000u, dx);
+                                } else if (dims == 2) {
+                                    inoise16_row(row, w, x, dx, y);
+                                } else {
+                                    inoise16_row(row, w, x, dx, y, z);
+                                }
+                            } else {
+                                for (uint16_t i = 0; i < w; ++i) {
+                                    const uint32_t xi = x + i * dx;
+                                    row[i] = dims == 1   ? inoise16(xi + j * 0x400000u)
+                                             : dims == 2 ? inoise16(xi, y)
+                                                         : inoise16(xi, y, z);
+                                }
+                            }
+                        }
+                        for (uint32_t i = 0; i < accum.size(); ++i) {
+                            accum[i] += layer[i] >> (o + 1);
+                        }
+                    }
+                    sink = sink + accum[r];
+                }
+                const uint32_t elapsed = micros() - start;
+                const double points = double(rounds) * octaves * w * h;
+                mpps[batch] = elapsed ? points / elapsed : 0.0;
+                result[batch] = accum;
+            }
+            printf("inoise16 %dD, %d octave(s): scalar %.2f, batch %.2f Mpoints/s\n",
+                   dims, octaves, mpps[0], mpps[1]);
+            // Both timed paths summed the same octaves
+            CHECK(result[0] == result[1]);
+        }
+    }
+    (void)sink;
+}
@@ -13,7 +13,9 @@ from typing import List, Set
 # ============================================================================
 
 # Files to exclude from test discovery (special tests with custom build rules)
-EXCLUDED_TEST_FILES: Set[str] = set()
+EXCLUDED_TEST_FILES: Set[str] = {
+    "fft_impl_q15.cpp",  # Links fastled_fft_q15_lib (see tests/meson.build)
+}
 
 # Subdirectories containing tests that should be discovered
 TEST_SUBDIRS: List[str] = ["fl", "fx"]